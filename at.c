@@ -0,0 +1,100 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                               AT.C                                -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the parsing of AT command replies from the 3G module, kept apart
+ *   from sim5218.c so it can be tested off the MCU.
+ *
+ *   A reply is any number of <CR><LF> wrapped information lines followed by
+ *   a final result code line: OK, ERROR, +CME ERROR: <err> or
+ *   +CMS ERROR: <err>. Some commands (e.g. AT+COPS=0 and AT+NETCLOSE) take
+ *   seconds between their information and final result, so the end of a
+ *   reply is its final result, not a pause in it.
+ *
+ * Table of Contents:
+ *   (local)
+ *   StartsWith   - does a line start with a string?
+ *
+ *   (public)
+ *   AtFinal      - does a reply so far end in a final result code?
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "general.h"
+#include "at.h"
+
+
+/* local functions */
+static uint8_t StartsWith(const unsigned char *line, uint16_t len,
+                          const char *str);
+
+
+/*
+ * StartsWith
+ * Description: Does a line start with a string?
+ *
+ * Arguments:   line - line, not NULL-terminated
+ *              len  - chars in line
+ *              str  - NULL-terminated string
+ * Return:      TRUE/FALSE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t StartsWith(const unsigned char *line, uint16_t len,
+                          const char *str)
+{
+  uint16_t i;
+
+  for (i = 0; str[i] != '\0'; i++) {
+    if ((i >= len) || (line[i] != (unsigned char) str[i]))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+
+/*
+ * AtFinal
+ * Description: Does a reply received so far end in a final result code?
+ *
+ * Arguments:   buf - reply bytes
+ *              len - bytes in buf
+ * Return:      TRUE:  the last line is complete and is a final result code
+ *              FALSE: more of the reply is still to come
+ *
+ * Operation:   The last line is only complete once its <CR><LF> (or either of
+ *              them) is in, so skip back over the line ends, then back over
+ *              the line to the end of the one before it.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t AtFinal(const unsigned char *buf, uint16_t len)
+{
+  uint16_t end, start;
+
+  end = len;                                    /* skip line ends */
+  while ((end > 0) && ((buf[end-1] == '\r') || (buf[end-1] == '\n')))
+    end--;
+  if ((end == 0) || (end == len))               /* empty or incomplete */
+    return FALSE;
+
+  start = end;                                  /* find start of last line */
+  while ((start > 0) && (buf[start-1] != '\r') && (buf[start-1] != '\n'))
+    start--;
+
+  len = end - start;
+  return (((len == 2) && StartsWith(&buf[start], len, "OK")) ||
+          ((len == 5) && StartsWith(&buf[start], len, "ERROR")) ||
+          StartsWith(&buf[start], len, "+CME ERROR") ||
+          StartsWith(&buf[start], len, "+CMS ERROR"));
+}
@@ -0,0 +1,36 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                               AT.H                                -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for at.c, the parsing of AT command replies from
+ *   the 3G module.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef AT_H
+#define AT_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* does a reply so far end in a final result code? */
+extern uint8_t AtFinal(const unsigned char *buf, uint16_t len);
+
+
+#endif                                                                /* AT_H */
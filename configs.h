@@ -15,6 +15,8 @@
  *
  * Revision History:
  *  Apr. 28, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Enabled the watchdog
+ *  Oct. 17, 2026      Nnoduka Eruchalu     SOSC crystal on RC0/RC1 for RTCC
  */
 
 #ifndef EASYPAY_CONFIGS_H
@@ -29,14 +31,14 @@
  *  As of today, this datasheet can be found here:
  *      http://ww1.microchip.com/downloads/en/DeviceDoc/39960d.pdf
  */
-#define EASYPAY_CONFIG1L 0x11     /* 0------- Unimplemented                   */
+#define EASYPAY_CONFIG1L 0x09     /* 0------- Unimplemented                   */
                                   /* -0------ HI-TECH doesn't support XINST   */
                                   /* --0----- Unimplemented                   */
-                                  /* ---10--- RC0 and RC1 are I/O             */
+                                  /* ---01--- Low-power SOSC on RC0 and RC1   */
                                   /* -----0-- LF-INTOSC in Low-Power in Sleep */
                                   /* ------0- Unimplemented                   */
                                   /* -------1 VREG sleep enabled              */
-                                  /* 00010001 = 0x11                          */
+                                  /* 00001001 = 0x09                          */
 
 #define EASYPAY_CONFIG1H 0x05     /* 0------- 2-speed start-up disabled       */
                                   /* -0------ fail-safe clock monitor disabled*/
@@ -52,10 +54,10 @@
                                   /* -------1 Power-up timer is disabled      */
                                   /* 01111001 = 0x79                          */
 
-#define EASYPAY_CONFIG2H 0x3C     /* 0------- Unimplemented                   */
-                                  /* -01111-- WDT postscale is 1:32768        */
-                                  /* ------00 WatchDog Timer is disabled      */
-                                  /* 00111100 = 0x3C                          */
+#define EASYPAY_CONFIG2H 0x27     /* 0------- Unimplemented                   */
+                                  /* -01001-- WDT postscale is 1:512 (~2s)    */
+                                  /* ------11 WatchDog Timer is enabled       */
+                                  /* 00100111 = 0x27                          */
       
 #define EASYPAY_CONFIG3L 0x01     /* 0000000- Unimplemented                   */
                                   /* -------1 RTCC reference clock is SOSC    */
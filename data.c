@@ -7,23 +7,34 @@
  * File Description:
  *  This is the library of functions for interfacing the PIC18F67K22 with the
  *  Http Server.
+ *  A failed request, including one failed fast by the module's circuit
+ *  breaker, gives an offline result (e.g. an invalid card, a FALSE pin check)
+ *  instead of whatever the last response held.
  *  Makes calls like:
  *    SimHttpGet("/test/", "p1=trust&p2=me", &http_response);
  *    SimHttpGet("/test/json/", NULL, &http_response);
  *    SimHttpPost("/test/", "p5=stay&p6=positive", &http_response);
  *
  * Table of Contents:
- * (private)
- *   UidToString      - convert int array UID to a char array
+ * (local)
+ *   DataHttp         - perform a server request and keep the clock set
+ *   DataClockPoll    - set the clock from the network when it's stale
+ *   DataDenylistPoll - keep the card denylist in step with the server's
  *
  * (public)
- *   DataInit         - initializes the data module and it's variables
+ *   DataInit         - start bringing up the data module
+ *   DataPoll         - move data module startup along
+ *   DataReady        - is the data module ready for server requests?
+ *   DataOnline       - is the server being reached?
+ *   DataSignalWeak   - is the network signal weak?
  *   DataCardValidate - determine smartcard type server side
  *   DataPinValidate  - validate pin on server side
  *   DataAcctBalance  - get account balance (in kobos)
  *   DataAcctRecharge - recharge account with EasyTopup card
  *   DataParkDetails  - get parking space & time if they exist 
  *   DataParkPay      - pay for/extend a parking space
+ *   DataTariffSync   - bring the local parking tariff table up to date
+ *   DataDenylistSync - bring the local card denylist a change closer to date
  *   DataAlertPark    - send notification Email for successful parking payment
  *
  * Assumptions:
@@ -38,17 +49,42 @@
  * Revision History:
  *   May  14, 2013      Nnoduka Eruchalu     Initial Revision
  *   Mar 30, 2014      Nnoduka Eruchalu     Cleaned up comments
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataTariffSync
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Build params with format.c instead
+ *                                           of sprintf/strcpy/strlen
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Non-blocking module startup
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Resume module on warm restart
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline results when requests fail
+ *                                           and background network probes
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Background modem health polls
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Keep the RTCC set from the server
+ *                                           and network time
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataDenylistSync
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Redo module setup after a warm
+ *                                           restart that came before it
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed DataRam; diag.c takes
+ *                                           RAM from the map file
  */
 #include "general.h"
 #include <stdint.h>
 #include "data.h"
 #include "sim5218.h"
 #include "mifare.h"
+#include "smartcard.h"
 #include "eventproc.h"
+#include "tariff.h"
+#include "format.h"
+#include "restart.h"
+#include "rtcc.h"
+#include "denylist.h"
 
 /* shared variables have to be local to this file */
 static http_data http_response; /* Http Response struct */
-static sim_data module;         /* SIM5218 module       */
+static persistent sim_data module; /* SIM5218 module; kept on warm restart */
+static uint8_t data_ready;      /* (bool) module set up */
+static uint32_t clock_next;     /* RTCC uptime of next network time check */
+static uint32_t denylist_next;  /* RTCC uptime of next denylist check */
 
 static const char *card_validate_url = "/card/validate/";
 static const char *pin_validate_url = "/pin/validate/";
@@ -56,57 +92,122 @@ static const char *acct_balance_url = "/account/balance/";
 static const char *acct_recharge_url = "/account/recharge/";
 static const char *park_details_url = "/park/details/";
 static const char *park_pay_url = "/park/pay/";
+static const char *tariff_rules_url = "/tariff/rules/";
+static const char *card_denylist_url = "/card/denylist/";
 
 static const char *alert_park_url = "/alert/park/";
 
 
-/* local functions that need not be public */
-static void UidToString(uint8_t *uid, char *buffer);
+/* local functions */
+static int DataHttp(uint8_t method, const char *url, const char *param_str);
+static void DataClockPoll(void);
+static void DataDenylistPoll(void);
 
 
 /*
- * UidToString
- * Description: Save Mifare tag's UID in a string buffer array
+ * DataHttp
+ * Description: Perform a server request, and set the clock from the server's
+ *              time (Date header, or response frame on the socket) while at
+ *              it.
  *
- * Arguments:   uid:    UID to convert to string
- *              buffer: array to save string in [must be at least 14 bytes long]
+ * Arguments:   method    - SIM_HTTP_GET/SIM_HTTP_POST
+ *              url       - GET/POST URL
+ *              param_str - complete parameter string
+ * Return:      SUCCESS/FAIL, with the response in http_response
+ *
+ * Operation:   The date is read as the response arrives, so it's set right
+ *              away rather than after the session, when it would be stale.
+ *
+ * Shared:      http_response [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int DataHttp(uint8_t method, const char *url, const char *param_str)
+{
+  if (SimHttp(method, url, param_str, &http_response) < 0)
+    return FAIL;
+  
+  if (http_response.date != 0)
+    RtccSync(http_response.date);
+  return SUCCESS;
+}
+
+
+/*
+ * DataClockPoll
+ * Description: Set the clock from the network time (AT+CCLK) once it hasn't
+ *              been set for DATA_CLOCK_AGE, e.g. the terminal has been idle or
+ *              the server sends no time.
+ *
+ * Arguments:   None
  * Return:      None
  *
- * Operation:   Loop through UID bytes and save as hex string.
- *  
+ * Operation:   The network may never send the module its time, so tries are
+ *              at least DATA_CLOCK_RETRY apart. The first try is right away.
+ *
+ * Shared:      clock_next [modified]
+ *
  * Revision History:
- *   May 15, 2013      Nnoduka Eruchalu     Initial Revision
- *   Mar 30, 2014      Nnoduka Eruchalu     Cleaned up comments
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
  */
-static void UidToString(uint8_t *uid, char *buffer)
+static void DataClockPoll(void)
 {
-  char nibble, num;
-  size_t i;
-  for(i=0; i < 7;i++) {
-    num = uid[i];
-    
-    /* extract high nibble and write out numeric or alpha */
-    nibble = (num & 0xF0) >> 4;
-    if (nibble < 10) buffer[2*i] = '0'+nibble;
-    else             buffer[2*i] = nibble-10+'A';
-    
-    /* extract low nibble and write out numeric or alpha */
-    nibble = (num & 0x0F);
-    if (nibble < 10) buffer[2*i+1] = '0'+nibble;
-    else             buffer[2*i+1] = nibble-10+'A';
-  }
+  uint32_t now = RtccUptime();
+  uint32_t epoch;
+  
+  if ((RtccSyncAge() < DATA_CLOCK_AGE) || ((int32_t) (now - clock_next) < 0))
+    return;
+  
+  clock_next = now + DATA_CLOCK_RETRY;
+  if (SimClock(&epoch) == SUCCESS)
+    RtccSync(epoch);
+}
+
+
+/*
+ * DataDenylistPoll
+ * Description: Keep the card denylist in step with the server's. Check for
+ *              changes every DATA_DENYLIST_PERIOD, and while there are more,
+ *              apply one change per call.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   A change at a time keeps each call to about one request, so a
+ *              long catch up never keeps a tapped card waiting for long.
+ *              Nothing is tried while offline; the first check is right away.
+ *
+ * Shared:      denylist_next [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Carry on past skipped changes
+ */
+static void DataDenylistPoll(void)
+{
+  int result;
+  
+  if (!DataOnline() || ((int32_t) (RtccUptime() - denylist_next) < 0))
+    return;
+  
+  result = DataDenylistSync();
+  if ((result != DATA_SYNC_MORE) && (result != DATA_SYNC_SKIPPED))
+    denylist_next = RtccUptime() + DATA_DENYLIST_PERIOD; /* done, or failed */
 }
 
 
 /*
  * DataInit
- * Description: This procedure initializes the shared variables, and clears the 
- *              data transfer timer.
+ * Description: This procedure clears the data transfer timer and starts
+ *              bringing up the SIM5218 module. It returns right away; the rest
+ *              of the setup is done by DataPoll once the module is ready.
  *
  * Arguments:   None
  * Return:      None
  *
- * Operation:   Initialize the module representation.
+ * Operation:   Reset the timer, then power on the module. After a warm
+ *              restart with the module up and idle, just carry on with it.
  *
  * Assumptions: Called after setting up Serial channel 2 and interrupts are 
  *              enabled
@@ -114,11 +215,134 @@ static void UidToString(uint8_t *uid, char *buffer)
  * Revision History:
  *   May 14, 2013      Nnoduka Eruchalu     Initial Revision
  *   Mar 30, 2014      Nnoduka Eruchalu     Cleaned up comments
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start module instead of waiting
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Resume module on warm restart
  */
 void DataInit(void)
 {
+  data_ready = FALSE;
   SimStartTimer(0);            /* reset SIMCOM module Timer */
-  SimDataInit(&module);        /* initialize module object */
+  
+  if (RestartIsWarm() && RestartModemReady()) {
+    SimResume();               /* module never went down */
+  } else {
+    RestartSetModem(FALSE);
+    SimPowerOn();              /* start module, don't wait on it */
+  }
+}
+
+
+/*
+ * DataPoll
+ * Description: This procedure moves the SIM5218 module startup along. Once the
+ *              module is ready it initializes the module representation and
+ *              syncs the tariff table, and from then on does nothing.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   Until data_ready, poll the module. When it reports
+ *              SIM_STATE_READY, do the setup that needs AT commands (this
+ *              does wait on the module) and set data_ready.
+ *              After a warm restart that setup may already be done, with its
+ *              results still in persistent RAM and EEPROM; the persistent
+ *              RAM block says if it was, since the reset may have come
+ *              before the module was first ready.
+ *              Once ready, let the module probe the network in the background
+ *              whenever its circuit breaker has requests failing fast, and
+ *              poll its health otherwise. Also keep the clock set and the
+ *              card denylist up to date.
+ *
+ * Shared:      data_ready [modified]
+ *              module     [modified]
+ *
+ * Assumptions: Called often while idle, e.g. on the welcome page
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Probe network while offline
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Poll module health
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Poll network time
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Poll card denylist changes
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Skip setup only if it was done
+ */
+void DataPoll(void)
+{
+  if (data_ready) {
+    SimProbe();                /* no-op unless requests are failing fast */
+    SimHealthPoll();           /* no-op till it's time for a poll */
+    DataClockPoll();           /* no-op while the clock is fresh */
+    DataDenylistPoll();        /* no-op till it's time for a check */
+    return;
+  }
+  if (SimPoll() != SIM_STATE_READY)
+    return;
+  
+  if (!RestartDataInit()) {
+    SimDataInit(&module);      /* initialize module object */
+    DataTariffSync();          /* catch up on tariff changes; keep old on fail */
+    RestartSetDataInit(TRUE);
+  }
+  RestartSetModem(TRUE);       /* module is up and idle */
+  data_ready = TRUE;
+}
+
+
+/*
+ * DataReady
+ * Description: Is the data module ready for server requests?
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE
+ *
+ * Shared:      data_ready [read only]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DataReady(void)
+{
+  return data_ready;
+}
+
+
+/*
+ * DataOnline
+ * Description: Is the server being reached? Requests fail right away while
+ *              it isn't, so callers can skip straight to offline behaviour.
+ *
+ * Arguments:   None
+ * Return:      TRUE:  module is ready and requests are going out
+ *              FALSE: module is starting, requests have kept failing and
+ *                     the network is being probed in the background, or the
+ *                     last health poll found the module off the network
+ *
+ * Shared:      data_ready [read only]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline when health poll is down
+ */
+uint8_t DataOnline(void)
+{
+  return (data_ready && SimOnline() && (SimHealth() != SIM_HEALTH_DOWN));
+}
+
+
+/*
+ * DataSignalWeak
+ * Description: Is the network signal weak? Requests still go out, but may be
+ *              slow or fail, so users can be warned up front.
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DataSignalWeak(void)
+{
+  return (SimHealth() == SIM_HEALTH_WEAK);
 }
 
 
@@ -140,6 +364,8 @@ void DataInit(void)
  * Revision History:
  *   May 15, 2013      Nnoduka Eruchalu     Initial Revision
  *   Mar 30, 2014      Nnoduka Eruchalu     Cleaned up comments
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
  */
 uint8_t DataCardValidate(mifare_tag *tag)
 {
@@ -150,11 +376,13 @@ uint8_t DataCardValidate(mifare_tag *tag)
    * NULL-terminator [1]
    */
   char param_str[4+14+1];          /* allocate space for param */
-  strcpy(param_str, "uid=");       /* load in UID key    */
-  UidToString(tag->uid, &param_str[4]); /* load in UID string */
-  param_str[sizeof(param_str)-1] = '\0'; /* add NULL-terminator */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");       /* load in UID key    */
+  FormatBufHex(&fb, tag->uid, 7);  /* load in UID string */
     
-  SimHttpPost(card_validate_url, param_str, &http_response);
+  if (DataHttp(SIM_HTTP_POST, card_validate_url, param_str) < 0)
+    return CARD_INVALID;             /* offline: can't tell, so no session */
   
   return ((uint8_t) http_response.number);
 }
@@ -178,6 +406,8 @@ uint8_t DataCardValidate(mifare_tag *tag)
  *  
  * Revision History:
  *   May 15, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
  */
 uint8_t DataPinValidate(uint8_t *uid, uint16_t pin)
 {
@@ -189,13 +419,15 @@ uint8_t DataPinValidate(uint8_t *uid, uint16_t pin)
    * NULL-terminator [1]
    */
   char param_str[4+14+5+NUM_PIN_DIGITS+1];   /* allocate space for params */
-  strcpy(param_str, "uid=");          /* load in UID key    */
-  UidToString(uid, &param_str[4]);    /* load in UID string */
-  strcpy(&param_str[18], "&pin="); 
-  sprintf(&param_str[23], "%u", pin); /* automatically adds NULL-terminator */
-  param_str[sizeof(param_str)-1] = '\0'; /* add NULL-terminator: just because */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");          /* load in UID key    */
+  FormatBufHex(&fb, uid, 7);          /* load in UID string */
+  FormatBufStr(&fb, "&pin=");         /* load in pin key and value */
+  FormatBufUint(&fb, pin);
   
-  SimHttpPost(pin_validate_url, param_str, &http_response);
+  if (DataHttp(SIM_HTTP_POST, pin_validate_url, param_str) < 0)
+    return FALSE;                     /* offline */
   return http_response.boolean;
 }
 
@@ -205,7 +437,9 @@ uint8_t DataPinValidate(uint8_t *uid, uint16_t pin)
  * Description: Get account balance (in Kobos)
  * 
  * Arguments:   uid: UID of EasyCard
- * Return:      account balance (in kobos)
+ *              balance: account balance (in kobos) [modified on SUCCESS]
+ * Return:      SUCCESS: got the balance
+ *              FAIL:    server couldn't be reached; balance unchanged
  *
  * Operation:   Convert UID to a string.
  *              Do a HTTP GET with the string UID as a parameter.
@@ -213,8 +447,12 @@ uint8_t DataPinValidate(uint8_t *uid, uint16_t pin)
  *  
  * Revision History:
  *   May 16, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Return a status, so offline isn't
+ *                                           a zero balance
  */
-uint32_t DataAcctBalance(uint8_t *uid)
+int DataAcctBalance(uint8_t *uid, uint32_t *balance)
 {
   /*
    * "uid=" [4]
@@ -222,12 +460,15 @@ uint32_t DataAcctBalance(uint8_t *uid)
    * NULL-terminator [1]
    */
   char param_str[4+14+1];             /* allocate space for params */
-  strcpy(param_str, "uid=");          /* load in UID key    */
-  UidToString(uid, &param_str[4]);    /* load in UID string */
-  param_str[sizeof(param_str)-1] = '\0'; /* add NULL-terminator */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");          /* load in UID key    */
+  FormatBufHex(&fb, uid, 7);          /* load in UID string */
   
-  SimHttpGet(acct_balance_url, param_str, &http_response);
-  return http_response.number;
+  if (DataHttp(SIM_HTTP_GET, acct_balance_url, param_str) < 0)
+    return FAIL;                      /* offline */
+  *balance = http_response.number;
+  return SUCCESS;
 }
 
 
@@ -250,6 +491,8 @@ uint32_t DataAcctBalance(uint8_t *uid)
  *  
  * Revision History:
  *   May 16, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
  */
 uint8_t DataAcctRecharge(uint8_t *uid, uint8_t *topup_id, 
                          uint32_t *recharge_value)
@@ -262,13 +505,15 @@ uint8_t DataAcctRecharge(uint8_t *uid, uint8_t *topup_id,
    * NULL-terminator [1]
    */
   char param_str[4+14+5+14+1];           /* allocate space for params */
-  strcpy(param_str, "uid=");             /* load in UID key        */
-  UidToString(uid, &param_str[4]);       /* load in UID string     */
-  strcpy(&param_str[18], "&tid=");       /* load in TopupID key    */
-  UidToString(topup_id, &param_str[23]); /* load in TopupID string */
-  param_str[sizeof(param_str)-1] = '\0'; /* add NULL-terminator: just because */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");             /* load in UID key        */
+  FormatBufHex(&fb, uid, 7);             /* load in UID string     */
+  FormatBufStr(&fb, "&tid=");            /* load in TopupID key    */
+  FormatBufHex(&fb, topup_id, 7);        /* load in TopupID string */
   
-  SimHttpPost(acct_recharge_url, param_str, &http_response);
+  if (DataHttp(SIM_HTTP_POST, acct_recharge_url, param_str) < 0)
+    return FALSE;                        /* offline */
   
   if (http_response.boolean)          /* if recharge was successful, update */
     *recharge_value = http_response.number;  /* get value of EasyTopup card */
@@ -284,18 +529,23 @@ uint8_t DataAcctRecharge(uint8_t *uid, uint8_t *topup_id,
  *              space: (ptr) for storing space number [modified]
  *              time:  (ptr) for storing time (in seconds) [modified]
  *
- * Return:      TRUE: if user has currently running parking space
- *              FALSE: user doesn't currently have parking time left at a space
+ * Return:      SUCCESS: got the details; space and time are 0 if the user
+ *                       doesn't currently have parking time left at a space
+ *              FAIL:    server couldn't be reached; space and time unchanged
  *
  * Operation:   Do a HTTP GET with the UID as a parameter
+ *              HTTP response's boolean says if the user has a running space.
  *              The space number will be in the HTTP response's number
  *              The time left will be in the HTTP response's number2
- *              HTTP response's boolean will be the return value.
  *  
  * Revision History:
  *   May 16, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Return a status, so offline isn't
+ *                                           no running space
  */
-uint8_t DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time)
+int DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time)
 {
   /*
    * "uid=" [4]
@@ -303,18 +553,22 @@ uint8_t DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time)
    * NULL-terminator [1]
    */
   char param_str[4+14+1];             /* allocate space for params */
-  strcpy(param_str, "uid=");          /* load in UID key    */
-  UidToString(uid, &param_str[4]);    /* load in UID string */
-  param_str[sizeof(param_str)-1] = '\0'; /* add NULL-terminator */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");          /* load in UID key    */
+  FormatBufHex(&fb, uid, 7);          /* load in UID string */
   
-  SimHttpGet(park_details_url, param_str, &http_response);
+  if (DataHttp(SIM_HTTP_GET, park_details_url, param_str) < 0)
+    return FAIL;                      /* offline */
   
   if(http_response.boolean) {         /* if user has time left at a space */
     *space = http_response.number;    /* save those details */
     *time = http_response.number2;
+  } else {                            /* else there's no running space */
+    *space = 0;
+    *time = 0;
   }
-  
-  return http_response.boolean;
+  return SUCCESS;
 }
 
 
@@ -338,6 +592,8 @@ uint8_t DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time)
  *  
  * Revision History:
  *   May 16, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline result on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
  */
 void DataParkPay(uint8_t *uid, uint32_t space, int32_t *time)
 {
@@ -354,20 +610,17 @@ void DataParkPay(uint8_t *uid, uint32_t space, int32_t *time)
   
   /* allocate space for params */
   char param_str[4+ 14 +7 +NUM_PARK_SPACE_DIGITS +6 +NUM_PARK_TIME_DIGITS+2 +1];
-  strcpy(param_str, "uid=");             /* load in UID key, values */
-  UidToString(uid, &param_str[4]);       /* load in UID string     */
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "uid=");             /* load in UID key, values */
+  FormatBufHex(&fb, uid, 7);             /* load in UID string     */
+  FormatBufStr(&fb, "&space=");          /* load in space key and value */
+  FormatBufUint(&fb, space);
+  FormatBufStr(&fb, "&time=");           /* load time key and value */
+  FormatBufUint(&fb, (uint32_t) *time);
   
-  /*
-   * Load in key,value pairs utilizing the fact that strcpy and sprintf append
-   * NULLs and so strlen will be used to get the next index to start writing
-   * from. Start writing over last NULL character.
-   */
-  strcpy(&param_str[18], "&space=");     /* load in space key and value */
-  sprintf(&param_str[25], "%u", space);  
-  strcpy(&param_str[strlen(param_str)], "&time="); /* load time key and value */
-  sprintf(&param_str[strlen(param_str)], "%u", *time);
-  
-  SimHttpPost(park_pay_url, param_str, &http_response);
+  if (DataHttp(SIM_HTTP_POST, park_pay_url, param_str) < 0)
+    return;                              /* offline: time unchanged */
   
   if (http_response.boolean)             /* if time was extended, update it */
     *time = http_response.number;        
@@ -377,6 +630,144 @@ void DataParkPay(uint8_t *uid, uint32_t space, int32_t *time)
 
 
 
+/*
+ * DataTariffSync
+ * Description: Bring the local parking tariff table up to date with the
+ *              server's, one changed rule at a time.
+ *
+ * Arguments:   None
+ * Return:      SUCCESS: table is up to date
+ *              FAIL:    server couldn't be reached, sent a bad rule or kept
+ *                       sending changes; the table holds whatever updates
+ *                       made it in
+ *
+ * Operation:   Do a HTTP GET with the local table version and the terminal's
+ *              zone as parameters. The server replies with the next change
+ *              since that version:
+ *              - HTTP response's boolean is FALSE once there are no changes
+ *              - number is the table version this change brings us up to
+ *              - number2's low byte is the index of the changed rule, and its
+ *                next byte is the number of rules in the new table
+ *              - message is the changed rule in hex, or empty if the change
+ *                only drops rules off the end of the table
+ *              - a change that adds a rule puts it in the slot past the end,
+ *                and raises the number of rules by one
+ *              Apply each change and ask again, for at most one change per
+ *              rule and a count-only change.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Fail on failed request
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
+ */
+int DataTariffSync(void)
+{
+  /*
+   * "ver=" [4]
+   * version number max out at 5 digits
+   * "&zone=" [6]
+   * zone number max out at 3 digits
+   * NULL-terminator [1]
+   */
+  char param_str[4 +5 +6 +3 +1];      /* allocate space for params */
+  format_buf fb;
+  tariff_rule rule;
+  tariff_rule *new_rule;
+  uint8_t i;
+  
+  for (i = 0; i <= TARIFF_MAX_RULES; i++) {
+    FormatBufInit(&fb, param_str, sizeof(param_str));
+    FormatBufStr(&fb, "ver=");        /* load in version key and value */
+    FormatBufUint(&fb, TariffVersion());
+    FormatBufStr(&fb, "&zone=");      /* load zone key, value */
+    FormatBufUint(&fb, TARIFF_ZONE);
+    
+    if (DataHttp(SIM_HTTP_GET, tariff_rules_url, param_str) < 0)
+      return FAIL;                    /* offline: keep what we have */
+    if (!http_response.boolean)       /* no more changes */
+      return SUCCESS;
+    
+    new_rule = NULL;                  /* assume a count-only change */
+    if (http_response.message[0] != '\0') {
+      if (TariffDecodeRule((const char *) http_response.message, &rule) < 0)
+        return FAIL;
+      new_rule = &rule;
+    }
+    
+    if (TariffUpdate((uint8_t) http_response.number2,
+                     (uint8_t) (http_response.number2 >> 8),
+                     (uint16_t) http_response.number, new_rule) < 0)
+      return FAIL;
+  }
+  
+  return FAIL;                        /* server didn't stop sending changes */
+}
+
+
+/*
+ * DataDenylistSync
+ * Description: Bring the local card denylist a change closer to the server's.
+ *
+ * Arguments:   None
+ * Return:      DATA_SYNC_DONE: list is up to date
+ *              DATA_SYNC_MORE: a change was applied; ask again for the next
+ *              DATA_SYNC_SKIPPED: a change couldn't be applied (full list, or
+ *                              a bad UID or op); the list moved past it and
+ *                              fails closed if it may miss a blocked card.
+ *                              Ask again for the next.
+ *              FAIL:           server couldn't be reached; the list is
+ *                              unchanged
+ *
+ * Operation:   Do a HTTP GET with the local list version as parameter. The
+ *              server replies with the next change since that version:
+ *              - HTTP response's boolean is FALSE once there are no changes
+ *              - number is the list version this change brings us up to
+ *              - number2 is DENYLIST_OP_ADD or DENYLIST_OP_REMOVE, or
+ *                DENYLIST_OP_CLEAR when our version is too old to catch up
+ *                on, before the adds that rebuild the whole list
+ *              - message is the card UID in hex, empty for a clear
+ *              A change that can't be applied is skipped instead of failed,
+ *              else the sync would ask for it forever.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Skip changes that can't be applied
+ */
+int DataDenylistSync(void)
+{
+  /*
+   * "ver=" [4]
+   * version number max out at 5 digits
+   * NULL-terminator [1]
+   */
+  char param_str[4 +5 +1];            /* allocate space for params */
+  format_buf fb;
+  uint8_t uid[DENYLIST_UID_BYTES];
+  const uint8_t *change_uid = uid;    /* UID for the change, NULL if bad */
+  uint8_t op;
+  
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "ver=");          /* load in version key and value */
+  FormatBufUint(&fb, DenylistVersion());
+  
+  if (DataHttp(SIM_HTTP_GET, card_denylist_url, param_str) < 0)
+    return FAIL;                      /* offline: keep what we have */
+  if (!http_response.boolean)         /* no more changes */
+    return DATA_SYNC_DONE;
+  
+  op = (uint8_t) http_response.number2;
+  if ((op != DENYLIST_OP_CLEAR) &&
+      (DenylistDecodeUid((const char *) http_response.message, uid) < 0))
+    change_uid = NULL;
+  
+  if (DenylistUpdate(op, (uint16_t) http_response.number, change_uid) < 0)
+    return DATA_SYNC_SKIPPED;
+  
+  return DATA_SYNC_MORE;
+}
+
+
+
 /* ALERT ROUTINES */
 /*
  * DataAlertPark
@@ -392,6 +783,7 @@ void DataParkPay(uint8_t *uid, uint32_t space, int32_t *time)
  * Revision History:
  *   May 16, 2013      Nnoduka Eruchalu     Initial Revision
  *   Mar 30, 2014      Nnoduka Eruchalu     Cleaned up comments
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Set clock from server's date
  */
 void DataAlertPark(uint32_t space, int32_t time)
 {
@@ -406,18 +798,14 @@ void DataAlertPark(uint32_t space, int32_t time)
   
   /* allocate space for params */
   char param_str[3 +NUM_PARK_SPACE_DIGITS +3 +NUM_PARK_TIME_DIGITS+2 +1];
-    
-  /*
-   * Load in key,value pairs utilizing the fact that strcpy and sprintf append
-   * NULLs and so strlen will be used to get the next index to start writing
-   * from. Start writing over last NULL character.
-   */
-  strcpy(param_str, "&s=");     /* load in space key and value */
-  sprintf(&param_str[strlen(param_str)], "%u", space);  
-  strcpy(&param_str[strlen(param_str)], "&t="); /* load time key and value */
-  sprintf(&param_str[strlen(param_str)], "%u", time);
+  format_buf fb;
+  FormatBufInit(&fb, param_str, sizeof(param_str));
+  FormatBufStr(&fb, "&s=");     /* load in space key and value */
+  FormatBufUint(&fb, space);
+  FormatBufStr(&fb, "&t=");     /* load time key and value */
+  FormatBufUint(&fb, (uint32_t) time);
   
-  SimHttpPost(alert_park_url, param_str, &http_response);
+  DataHttp(SIM_HTTP_POST, alert_park_url, param_str);
       
   return;
 }
@@ -16,6 +16,17 @@
  *
  * Revision History:
  *   May  14, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataPoll and DataReady
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataOnline
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataSignalWeak
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added network time settings
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataDenylistSync
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DataRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DATA_SYNC_SKIPPED
+ *   Oct. 17, 2026      Nnoduka Eruchalu     DataAcctBalance returns a status
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed DataRam; diag.c takes
+ *                                           RAM from the map file
+ *   Oct. 17, 2026      Nnoduka Eruchalu     DataParkDetails returns a status
  */
 
 #ifndef DATA_H
@@ -29,13 +40,34 @@
 
 
 /* DATA CONSTANTS */
-/* none */
+#define DATA_CLOCK_AGE    21600UL  /* seconds (6 hours) before the clock is */
+                                   /* set from the network time */
+#define DATA_CLOCK_RETRY  600      /* seconds between network time tries */
+#define DATA_DENYLIST_PERIOD 900   /* seconds between denylist checks */
+
+/* results of a step of a sync with the server */
+#define DATA_SYNC_DONE    0        /* local copy is up to date */
+#define DATA_SYNC_MORE    1        /* a change was applied, more may follow */
+#define DATA_SYNC_SKIPPED 2        /* a change couldn't be applied and was */
+                                   /* skipped, more may follow */
 
 
 /* FUNCTION PROTOTYPES */
-/* initializes the module and http_response structs */
+/* start bringing up the data module */
 extern void DataInit(void);
 
+/* move data module startup along; finishes setting up once it's ready */
+extern void DataPoll(void);
+
+/* is the data module ready for server requests? */
+extern uint8_t DataReady(void);
+
+/* is the server being reached? */
+extern uint8_t DataOnline(void);
+
+/* is the network signal weak? */
+extern uint8_t DataSignalWeak(void);
+
 /* determine smartcard type server side */
 extern uint8_t DataCardValidate(mifare_tag *tag);
 
@@ -43,17 +75,23 @@ extern uint8_t DataCardValidate(mifare_tag *tag);
 extern uint8_t DataPinValidate(uint8_t *uid, uint16_t pin);
 
 /* get account balance (in kobos) */
-extern uint32_t DataAcctBalance(uint8_t *uid);
+extern int DataAcctBalance(uint8_t *uid, uint32_t *balance);
 
 /* recharge account with EasyTopup card */
 extern uint8_t DataAcctRecharge(uint8_t *uid, uint8_t *topup_id, 
                                 uint32_t *recharge_value);
 /* get parking details */
-extern uint8_t DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time);
+extern int DataParkDetails(uint8_t *uid, uint32_t *space, int32_t *time);
 
 /* pay for time at parking space */
 extern void DataParkPay(uint8_t *uid, uint32_t space, int32_t *time);
 
+/* bring the local parking tariff table up to date */
+extern int DataTariffSync(void);
+
+/* bring the local card denylist a change closer to date */
+extern int DataDenylistSync(void);
+
 
 /* alert routines */
 void DataAlertPark(uint32_t space, int32_t time);
@@ -0,0 +1,380 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DATETIME.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for converting between calendar dates and
+ *   Unix epoch seconds, and for parsing the dates the server sends in its HTTP
+ *   Date header and the modem reports for AT+CCLK?. The RTCC keeps calendar
+ *   fields while journals and card logs want epoch seconds, so this is the
+ *   bridge between the two.
+ *
+ * Table of Contents:
+ *   (local)
+ *   DateTimeLeap      - check for a leap year
+ *   DateTimeMonthDays - get the days in a month
+ *   DateTimeDigits    - parse a fixed number of decimal digits
+ *   DateTimeUpper     - upper case a letter
+ *
+ *   (public)
+ *   DateTimeValid     - check a calendar date and time
+ *   DateTimeToEpoch   - convert a calendar date and time to epoch seconds
+ *   DateTimeFromEpoch - convert epoch seconds to a calendar date and time
+ *   DateTimeParseHttp - parse an HTTP Date header value
+ *   DateTimeParseCclk - parse a modem AT+CCLK time
+ *
+ * Limitations:
+ *   Only the years 2000 to 2099 are handled, so every 4th year is a leap
+ *   year. Leap seconds are not accepted.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "general.h"
+#include "datetime.h"
+
+
+/* days before the start of each month, in a common year */
+static const uint16_t MonthStart[12] = {
+  0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+};
+
+/* month names, as in an HTTP date */
+static const char MonthNames[] = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
+
+
+/* local functions */
+static uint8_t DateTimeLeap(uint8_t year);
+static uint8_t DateTimeMonthDays(uint8_t year, uint8_t month);
+static int DateTimeDigits(const char *s, uint8_t n, uint16_t *val);
+static char DateTimeUpper(char c);
+
+
+/*
+ * DateTimeLeap
+ * Description: Check for a leap year
+ *
+ * Arguments:   year - years after 2000
+ * Return:      TRUE if year is a leap year, else FALSE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t DateTimeLeap(uint8_t year)
+{
+  return ((year & 0x03) == 0) ? TRUE : FALSE;
+}
+
+
+/*
+ * DateTimeMonthDays
+ * Description: Get the days in a month
+ *
+ * Arguments:   year  - years after 2000
+ *              month - [1, 12]
+ * Return:      days in the month
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t DateTimeMonthDays(uint8_t year, uint8_t month)
+{
+  if (month == 2)
+    return DateTimeLeap(year) ? 29 : 28;
+  if (month == 12)
+    return 31;
+
+  return (uint8_t) (MonthStart[month] - MonthStart[month-1]);
+}
+
+
+/*
+ * DateTimeDigits
+ * Description: Parse a fixed number of decimal digits
+ *
+ * Arguments:   s   - digits, not necessarily NULL-terminated
+ *              n   - number of digits, at most 4
+ *              val - parsed value [modified]
+ * Return:      SUCCESS: n digits parsed
+ *              FAIL:    a non-digit in the first n chars
+ *
+ * Operation:   Stop at the first non-digit, so a short string is never read
+ *              past its NULL-terminator.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int DateTimeDigits(const char *s, uint8_t n, uint16_t *val)
+{
+  *val = 0;
+  while (n--) {
+    if ((*s < '0') || (*s > '9'))
+      return FAIL;
+    *val = 10*(*val) + (uint16_t) (*s++ - '0');
+  }
+
+  return SUCCESS;
+}
+
+
+/*
+ * DateTimeUpper
+ * Description: Upper case a letter
+ *
+ * Arguments:   c - char to upper case
+ * Return:      c in upper case, other chars unchanged
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static char DateTimeUpper(char c)
+{
+  return ((c >= 'a') && (c <= 'z')) ? (char) (c - 'a' + 'A') : c;
+}
+
+
+/*
+ * DateTimeValid
+ * Description: Check a calendar date and time. The weekday is not checked.
+ *
+ * Arguments:   dt - date and time to check
+ * Return:      TRUE if every field is in range, else FALSE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int DateTimeValid(const datetime *dt)
+{
+  if ((dt->year > DATETIME_MAX_YEAR) || (dt->month < 1) || (dt->month > 12))
+    return FALSE;
+  if ((dt->day < 1) || (dt->day > DateTimeMonthDays(dt->year, dt->month)))
+    return FALSE;
+  if ((dt->hour > 23) || (dt->minute > 59) || (dt->second > 59))
+    return FALSE;
+
+  return TRUE;
+}
+
+
+/*
+ * DateTimeToEpoch
+ * Description: Convert a calendar date and time to epoch seconds
+ *
+ * Arguments:   dt - valid date and time
+ * Return:      seconds since 1970-01-01 00:00:00
+ *
+ * Operation:   Count the days since 2000-01-01: 365 per whole year, 1 more for
+ *              each leap year before this one (2000 was one), then the days
+ *              before this month and before today. Add the time of day and the
+ *              epoch of 2000.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t DateTimeToEpoch(const datetime *dt)
+{
+  uint16_t days;
+
+  days = 365*(uint16_t)dt->year + ((uint16_t)dt->year + 3)/4;
+  days += MonthStart[dt->month-1] + dt->day - 1;
+  if ((dt->month > 2) && DateTimeLeap(dt->year))
+    days++;
+
+  return DATETIME_EPOCH_2000 + days*DATETIME_DAY_SECS +
+    3600UL*dt->hour + 60*(uint16_t)dt->minute + dt->second;
+}
+
+
+/*
+ * DateTimeFromEpoch
+ * Description: Convert epoch seconds to a calendar date and time
+ *
+ * Arguments:   epoch - seconds since 1970-01-01 00:00:00
+ *              dt    - date and time [modified]
+ * Return:      SUCCESS: dt filled in
+ *              FAIL:    epoch before 2000 or after 2099
+ *
+ * Operation:   Split off the time of day. Split the days since 2000 into
+ *              4 year cycles of 1461 days, each starting with a leap year, then
+ *              into years and months. 2000-01-01 was a Saturday.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int DateTimeFromEpoch(uint32_t epoch, datetime *dt)
+{
+  uint32_t secs;
+  uint16_t days;
+  uint8_t month;
+
+  if (epoch < DATETIME_EPOCH_2000)
+    return FAIL;
+  epoch -= DATETIME_EPOCH_2000;
+  if (epoch / DATETIME_DAY_SECS >= 25*1461UL)
+    return FAIL;
+
+  days = (uint16_t) (epoch / DATETIME_DAY_SECS);
+  secs = epoch % DATETIME_DAY_SECS;
+  dt->hour = (uint8_t) (secs / 3600);
+  secs %= 3600;
+  dt->minute = (uint8_t) (secs / 60);
+  dt->second = (uint8_t) (secs % 60);
+  dt->weekday = (uint8_t) ((days + 6) % 7);
+
+  dt->year = (uint8_t) (4*(days / 1461));
+  days %= 1461;
+  if (days >= 366) {                         /* past the cycle's leap year */
+    days -= 366;
+    dt->year += (uint8_t) (1 + days / 365);
+    days %= 365;
+  }
+
+  for (month = 12; month > 1; month--) {
+    if (days >= MonthStart[month-1] +
+        (((month > 2) && DateTimeLeap(dt->year)) ? 1 : 0))
+      break;
+  }
+  days -= MonthStart[month-1];
+  if ((month > 2) && DateTimeLeap(dt->year))
+    days--;
+  dt->month = month;
+  dt->day = (uint8_t) (days + 1);
+
+  return SUCCESS;
+}
+
+
+/*
+ * DateTimeParseHttp
+ * Description: Parse an HTTP Date header value, in the fixed format
+ *              "Sun, 06 Nov 1994 08:49:37 GMT"
+ *
+ * Arguments:   s     - header value, not necessarily NULL-terminated but at
+ *                      least DATETIME_HTTP_LEN chars or a NULL
+ *              epoch - parsed time [modified]
+ * Return:      SUCCESS: epoch set
+ *              FAIL:    not a date in that format, or before
+ *                       DATETIME_EPOCH_MIN
+ *
+ * Operation:   Skip the day name, which is implied by the date. Check each
+ *              field and separator in turn, matching the month and "GMT" in
+ *              any case as the modem may have lower cased the headers.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int DateTimeParseHttp(const char *s, uint32_t *epoch)
+{
+  datetime dt;
+  uint16_t val;
+  uint8_t i;
+
+  for (i = 0; i < 3; i++)                    /* day name */
+    if (s[i] == '\0') return FAIL;
+  if ((s[3] != ',') || (s[4] != ' ')) return FAIL;
+
+  if (DateTimeDigits(&s[5], 2, &val) < 0) return FAIL;
+  dt.day = (uint8_t) val;
+  if (s[7] != ' ') return FAIL;
+
+  for (i = 0; i < 12; i++) {
+    if ((DateTimeUpper(s[8]) == MonthNames[3*i]) &&
+        (DateTimeUpper(s[9]) == MonthNames[3*i+1]) &&
+        (DateTimeUpper(s[10]) == MonthNames[3*i+2]))
+      break;
+  }
+  if (i == 12) return FAIL;
+  dt.month = i + 1;
+  if (s[11] != ' ') return FAIL;
+
+  if (DateTimeDigits(&s[12], 4, &val) < 0) return FAIL;
+  if ((val < 2000) || (val > 2000+DATETIME_MAX_YEAR)) return FAIL;
+  dt.year = (uint8_t) (val - 2000);
+  if (s[16] != ' ') return FAIL;
+
+  if (DateTimeDigits(&s[17], 2, &val) < 0) return FAIL;
+  dt.hour = (uint8_t) val;
+  if (s[19] != ':') return FAIL;
+  if (DateTimeDigits(&s[20], 2, &val) < 0) return FAIL;
+  dt.minute = (uint8_t) val;
+  if (s[22] != ':') return FAIL;
+  if (DateTimeDigits(&s[23], 2, &val) < 0) return FAIL;
+  dt.second = (uint8_t) val;
+
+  if ((s[25] != ' ') || (DateTimeUpper(s[26]) != 'G') ||
+      (DateTimeUpper(s[27]) != 'M') || (DateTimeUpper(s[28]) != 'T'))
+    return FAIL;
+
+  if (!DateTimeValid(&dt)) return FAIL;
+  *epoch = DateTimeToEpoch(&dt);
+
+  return (*epoch < DATETIME_EPOCH_MIN) ? FAIL : SUCCESS;
+}
+
+
+/*
+ * DateTimeParseCclk
+ * Description: Parse a modem AT+CCLK time, in the format
+ *              "yy/MM/dd,hh:mm:ss+zz", where zz is the local time zone in
+ *              quarter hours from UTC.
+ *
+ * Arguments:   s     - time, without the quotes, not necessarily
+ *                      NULL-terminated but at least DATETIME_CCLK_LEN chars or
+ *                      a NULL
+ *              epoch - parsed time, in UTC [modified]
+ * Return:      SUCCESS: epoch set
+ *              FAIL:    not a time in that format, or before
+ *                       DATETIME_EPOCH_MIN as a modem that was never told the
+ *                       time by the network reports its power on default
+ *
+ * Operation:   Check each field and separator in turn, then take the time
+ *              zone off the local time.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int DateTimeParseCclk(const char *s, uint32_t *epoch)
+{
+  datetime dt;
+  uint16_t val;
+  uint32_t zone;
+
+  if (DateTimeDigits(&s[0], 2, &val) < 0) return FAIL;
+  dt.year = (uint8_t) val;
+  if (s[2] != '/') return FAIL;
+  if (DateTimeDigits(&s[3], 2, &val) < 0) return FAIL;
+  dt.month = (uint8_t) val;
+  if (s[5] != '/') return FAIL;
+  if (DateTimeDigits(&s[6], 2, &val) < 0) return FAIL;
+  dt.day = (uint8_t) val;
+  if (s[8] != ',') return FAIL;
+
+  if (DateTimeDigits(&s[9], 2, &val) < 0) return FAIL;
+  dt.hour = (uint8_t) val;
+  if (s[11] != ':') return FAIL;
+  if (DateTimeDigits(&s[12], 2, &val) < 0) return FAIL;
+  dt.minute = (uint8_t) val;
+  if (s[14] != ':') return FAIL;
+  if (DateTimeDigits(&s[15], 2, &val) < 0) return FAIL;
+  dt.second = (uint8_t) val;
+
+  if (((s[17] != '+') && (s[17] != '-')) ||
+      (DateTimeDigits(&s[18], 2, &val) < 0) || (val > 56))
+    return FAIL;
+  zone = 900UL*val;                          /* quarter hours to seconds */
+
+  if (!DateTimeValid(&dt)) return FAIL;
+  *epoch = DateTimeToEpoch(&dt);
+  if (s[17] == '+')
+    *epoch -= zone;
+  else
+    *epoch += zone;
+
+  return (*epoch < DATETIME_EPOCH_MIN) ? FAIL : SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DATETIME.H                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for datetime.c, the library of functions for
+ *   converting between calendar dates and Unix epoch seconds, and for parsing
+ *   the dates the server and the modem report.
+ *
+ * Assumptions:
+ *   Dates are in the years 2000 to 2099, which is all the RTCC can hold.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef DATETIME_H
+#define DATETIME_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * DATETIME CONSTANTS
+ * --------------------------------------
+ */
+#define DATETIME_EPOCH_2000  946684800UL  /* epoch of 2000-01-01 00:00:00 */
+#define DATETIME_EPOCH_MIN   1767225600UL /* 2026-01-01: older clocks are */
+                                          /* unset, not wrong */
+#define DATETIME_MAX_YEAR    99           /* last year after 2000 */
+
+#define DATETIME_HTTP_LEN    29   /* chars in "Sun, 06 Nov 1994 08:49:37 GMT" */
+#define DATETIME_CCLK_LEN    20   /* chars in "14/03/30,12:34:56+04" */
+
+#define DATETIME_DAY_SECS    86400UL      /* seconds in a day */
+#define DATETIME_DAY_MINS    1440         /* minutes in a day */
+
+
+/* --------------------------------------
+ * DATETIME DATA OBJECTS
+ * --------------------------------------
+ */
+/* a calendar date and time, in UTC unless stated otherwise */
+typedef struct {
+  uint8_t year;       /* years after 2000, [0, 99] */
+  uint8_t month;      /* [1, 12] */
+  uint8_t day;        /* day of month, [1, 31] */
+  uint8_t hour;       /* [0, 23] */
+  uint8_t minute;     /* [0, 59] */
+  uint8_t second;     /* [0, 59] */
+  uint8_t weekday;    /* days after Sunday, [0, 6] */
+} datetime;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* check a calendar date and time */
+extern int DateTimeValid(const datetime *dt);
+
+/* convert a calendar date and time to epoch seconds */
+extern uint32_t DateTimeToEpoch(const datetime *dt);
+
+/* convert epoch seconds to a calendar date and time */
+extern int DateTimeFromEpoch(uint32_t epoch, datetime *dt);
+
+/* parse an HTTP Date header value */
+extern int DateTimeParseHttp(const char *s, uint32_t *epoch);
+
+/* parse a modem AT+CCLK time */
+extern int DateTimeParseCclk(const char *s, uint32_t *epoch);
+
+
+#endif                                                          /* DATETIME_H */
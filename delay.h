@@ -16,6 +16,7 @@
  *
  * Revision History:
  *   Apr. 25, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     __delay_s clears the watchdog
  */
 
 #ifndef DELAY_H
@@ -28,11 +29,12 @@
  * __delay_s(x)
  * max number of __delay_ms is 40ms
  * so each second requires 25 loops of __delay_ms(40)
+ * a long delay is on purpose, so keep the watchdog from timing out
  */
 #define __delay_s(x)                             \
   do {                                           \
     unsigned long n;                             \
-    for(n=0; n < (unsigned long) 25*x; n++) {__delay_ms(40);}    \
+    for(n=0; n < (unsigned long) 25*x; n++) {CLRWDT(); __delay_ms(40);} \
   } while(0)
 
 
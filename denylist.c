@@ -0,0 +1,462 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DENYLIST.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the local list of blocked (lost, stolen or closed) cards. A tapped
+ *   card that isn't on the list is accepted right away, with no server round
+ *   trip; only a card on the list is checked with the server.
+ *
+ *   The list is a compact array of 32-bit fingerprints (FNV-1a hashes) of the
+ *   blocked UIDs, kept in data EEPROM. A fingerprint is 4 bytes instead of the
+ *   UID's 7, and a hash collision only costs a valid card an online check,
+ *   never lets a blocked card through. Unlike a Bloom filter, entries can be
+ *   removed when a card is unblocked.
+ *
+ *   The server keeps the master list and sends the terminal one change at a
+ *   time, each tagged with the list version it brings the terminal up to (see
+ *   DataDenylistSync).
+ *
+ *   A change that can't be applied (an add to a full list, or one without a
+ *   usable UID) still moves the list to its version, so the sync never gets
+ *   stuck on it. Since a blocked card would then be missing, the list is
+ *   marked incomplete and fails closed: every card is checked with the
+ *   server until a full resync (DENYLIST_OP_CLEAR) rebuilds the list.
+ *
+ * Table of Contents:
+ *   (local)
+ *   ReadEntry         - read a fingerprint from data EEPROM
+ *   WriteEntry        - write a fingerprint to data EEPROM
+ *   FindEntry         - find a fingerprint in the list
+ *   WriteHeader       - save the list's count and version
+ *   HexValue          - get the value of a hex digit
+ *
+ *   (public)
+ *   DenylistInit      - load the denylist header from data EEPROM
+ *   DenylistVersion   - get the version of the denylist
+ *   DenylistCount     - get the number of blocked card fingerprints
+ *   DenylistHash      - get the fingerprint of a card UID
+ *   DenylistCheck     - might a card be blocked?
+ *   DenylistIncomplete - is the denylist missing a blocked card?
+ *   DenylistUpdate    - apply a server update to the denylist
+ *   DenylistDecodeUid - decode a card UID from its hex string form
+ *
+ * Limitations:
+ *   At most DENYLIST_MAX cards. The list is not kept sorted: a lookup scans
+ *   at most DENYLIST_MAX*DENYLIST_ENTRY_SIZE bytes of EEPROM, which takes well
+ *   under a millisecond, while a sorted list would have to shift (and so
+ *   rewrite, at 4ms a byte) up to all of it on every change.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DenylistRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Skip changes that can't be applied
+ *                                           and fail closed
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed DenylistRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#include "general.h"
+#include "eeprom.h"
+#include "denylist.h"
+
+
+/* EEPROM list layout: header then fingerprints */
+#define DENYLIST_FORMAT_OFS  0      /* DENYLIST_FORMAT */
+#define DENYLIST_COUNT_OFS   1      /* number of fingerprints in use */
+#define DENYLIST_VERSION_OFS 2      /* list version, LSB first */
+#define DENYLIST_FLAGS_OFS   4      /* DENYLIST_FLAG_* */
+#define DENYLIST_ENTRIES_OFS 8      /* first fingerprint */
+
+#define DENYLIST_FLAG_INCOMPLETE 0x01  /* a blocked card couldn't be added */
+
+#define DENYLIST_NOT_FOUND   DENYLIST_MAX  /* FindEntry: no such entry */
+
+#define FNV_OFFSET_BASIS     2166136261UL  /* FNV-1a 32-bit parameters */
+#define FNV_PRIME            16777619UL
+
+
+/* shared variables have to be local to this file */
+static uint8_t entry_count;        /* fingerprints in use */
+static uint16_t list_version;      /* server's version of list */
+static uint8_t list_flags;         /* DENYLIST_FLAG_* */
+
+
+/* local functions */
+static uint32_t ReadEntry(uint8_t index);
+static void WriteEntry(uint8_t index, uint32_t hash);
+static uint8_t FindEntry(uint32_t hash);
+static void WriteHeader(void);
+static int HexValue(char c);
+
+
+/*
+ * ReadEntry
+ * Description: Read a fingerprint from data EEPROM
+ *
+ * Arguments:   index - entry index, less than DENYLIST_MAX
+ * Return:      fingerprint, stored LSB first
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint32_t ReadEntry(uint8_t index)
+{
+  uint8_t bytes[DENYLIST_ENTRY_SIZE];
+
+  EepromRead(EEPROM_DENYLIST_ADDR + DENYLIST_ENTRIES_OFS +
+             (uint16_t) index*DENYLIST_ENTRY_SIZE, bytes, sizeof(bytes));
+
+  return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) |
+    ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+
+/*
+ * WriteEntry
+ * Description: Write a fingerprint to data EEPROM
+ *
+ * Arguments:   index - entry index, less than DENYLIST_MAX
+ *              hash  - fingerprint, stored LSB first
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void WriteEntry(uint8_t index, uint32_t hash)
+{
+  uint8_t bytes[DENYLIST_ENTRY_SIZE];
+
+  bytes[0] = (uint8_t) hash;
+  bytes[1] = (uint8_t) (hash >> 8);
+  bytes[2] = (uint8_t) (hash >> 16);
+  bytes[3] = (uint8_t) (hash >> 24);
+  EepromWrite(EEPROM_DENYLIST_ADDR + DENYLIST_ENTRIES_OFS +
+              (uint16_t) index*DENYLIST_ENTRY_SIZE, bytes, sizeof(bytes));
+}
+
+
+/*
+ * FindEntry
+ * Description: Find a fingerprint in the list
+ *
+ * Arguments:   hash - fingerprint to find
+ * Return:      index of the entry, or DENYLIST_NOT_FOUND
+ *
+ * Shared:      entry_count
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t FindEntry(uint32_t hash)
+{
+  uint8_t i;
+
+  for (i = 0; i < entry_count; i++) {
+    if (ReadEntry(i) == hash)
+      return i;
+  }
+
+  return DENYLIST_NOT_FOUND;
+}
+
+
+/*
+ * WriteHeader
+ * Description: Save the list's count, version and flags in data EEPROM
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      entry_count, list_version, list_flags
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void WriteHeader(void)
+{
+  uint8_t header[DENYLIST_ENTRIES_OFS];
+
+  header[DENYLIST_FORMAT_OFS] = DENYLIST_FORMAT;
+  header[DENYLIST_COUNT_OFS] = entry_count;
+  header[DENYLIST_VERSION_OFS] = (uint8_t) list_version;
+  header[DENYLIST_VERSION_OFS+1] = (uint8_t) (list_version >> 8);
+  header[DENYLIST_FLAGS_OFS] = list_flags;
+  header[DENYLIST_FLAGS_OFS+1] = 0;
+  header[DENYLIST_FLAGS_OFS+2] = 0;
+  header[DENYLIST_FLAGS_OFS+3] = 0;
+  EepromWrite(EEPROM_DENYLIST_ADDR, header, sizeof(header));
+}
+
+
+/*
+ * HexValue
+ * Description: Get the value of a hex digit
+ *
+ * Arguments:   c - hex digit, either case
+ * Return:      value in [0, 15], or FAIL if c isn't a hex digit
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int HexValue(char c)
+{
+  if ((c >= '0') && (c <= '9')) return c - '0';
+  if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+  if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+  return FAIL;
+}
+
+
+/*
+ * DenylistInit
+ * Description: Load the denylist header from data EEPROM
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   A never written EEPROM, or a list in an unknown format or with
+ *              too many entries, is taken as an empty list at version 0, so the
+ *              server sends the whole list again.
+ *
+ * Shared:      entry_count, list_version, list_flags [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Load flags
+ */
+void DenylistInit(void)
+{
+  uint8_t header[DENYLIST_ENTRIES_OFS];
+
+  EepromRead(EEPROM_DENYLIST_ADDR, header, sizeof(header));
+  if ((header[DENYLIST_FORMAT_OFS] != DENYLIST_FORMAT) ||
+      (header[DENYLIST_COUNT_OFS] > DENYLIST_MAX)) {
+    entry_count = 0;
+    list_version = 0;
+    list_flags = 0;
+    return;
+  }
+
+  entry_count = header[DENYLIST_COUNT_OFS];
+  list_version = (uint16_t) header[DENYLIST_VERSION_OFS] |
+    ((uint16_t) header[DENYLIST_VERSION_OFS+1] << 8);
+  list_flags = header[DENYLIST_FLAGS_OFS];
+}
+
+
+/*
+ * DenylistVersion
+ * Description: Get the version of the denylist
+ *
+ * Arguments:   None
+ * Return:      server's version of the local list, 0 if never synced
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t DenylistVersion(void)
+{
+  return list_version;
+}
+
+
+/*
+ * DenylistCount
+ * Description: Get the number of blocked card fingerprints
+ *
+ * Arguments:   None
+ * Return:      fingerprints in the list
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DenylistCount(void)
+{
+  return entry_count;
+}
+
+
+/*
+ * DenylistHash
+ * Description: Get the fingerprint of a card UID
+ *
+ * Arguments:   uid - DENYLIST_UID_BYTES bytes
+ * Return:      32-bit FNV-1a hash of the UID
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t DenylistHash(const uint8_t *uid)
+{
+  uint32_t hash = FNV_OFFSET_BASIS;
+  uint8_t i;
+
+  for (i = 0; i < DENYLIST_UID_BYTES; i++) {
+    hash ^= uid[i];
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+
+/*
+ * DenylistCheck
+ * Description: Might a card be blocked?
+ *
+ * Arguments:   uid - DENYLIST_UID_BYTES bytes
+ * Return:      TRUE if the card's fingerprint is on the list, or the list is
+ *              incomplete, so the server has to decide; FALSE if the card is
+ *              certainly not blocked
+ *
+ * Shared:      list_flags
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Fail closed while incomplete
+ */
+uint8_t DenylistCheck(const uint8_t *uid)
+{
+  if (list_flags & DENYLIST_FLAG_INCOMPLETE)
+    return TRUE;
+  return (FindEntry(DenylistHash(uid)) != DENYLIST_NOT_FOUND) ? TRUE : FALSE;
+}
+
+
+/*
+ * DenylistIncomplete
+ * Description: Is the denylist missing a blocked card it couldn't take?
+ *
+ * Arguments:   None
+ * Return:      TRUE from a change that couldn't be applied till the next full
+ *              resync, FALSE otherwise
+ *
+ * Shared:      list_flags
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DenylistIncomplete(void)
+{
+  return (list_flags & DENYLIST_FLAG_INCOMPLETE) ? TRUE : FALSE;
+}
+
+
+/*
+ * DenylistUpdate
+ * Description: Apply a server update to the denylist, and save it to data
+ *              EEPROM.
+ *
+ * Arguments:   op      - DENYLIST_OP_CLEAR, DENYLIST_OP_ADD or
+ *                        DENYLIST_OP_REMOVE
+ *              version - list version after this update
+ *              uid     - card to add or remove, unused for DENYLIST_OP_CLEAR,
+ *                        or NULL if the server's UID couldn't be decoded
+ * Return:      SUCCESS: update applied
+ *              FAIL:    update skipped (list full, no UID or unknown op); the
+ *                       version still moves on
+ *
+ * Operation:   A clear drops every entry and the incomplete flag. An add
+ *              appends the fingerprint, unless it's already there. A remove
+ *              moves the last fingerprint into the removed one's slot.
+ *              Either way the fingerprint is written before the header, so a
+ *              reset in between leaves either the old list or, for a remove,
+ *              a harmless duplicate entry.
+ *              A skipped add (or unknown op, which may have been one) marks
+ *              the list incomplete. A skipped remove only leaves an extra
+ *              entry, which costs that card an online check.
+ *
+ * Shared:      entry_count, list_version, list_flags [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Skip changes that can't be applied
+ */
+int DenylistUpdate(uint8_t op, uint16_t version, const uint8_t *uid)
+{
+  uint32_t hash = 0;
+  uint8_t index = DENYLIST_NOT_FOUND;
+  int result = SUCCESS;
+
+  if (((op == DENYLIST_OP_ADD) || (op == DENYLIST_OP_REMOVE)) &&
+      (uid != NULL)) {
+    hash = DenylistHash(uid);
+    index = FindEntry(hash);
+  }
+
+  switch (op) {
+  case DENYLIST_OP_CLEAR:
+    entry_count = 0;
+    list_flags = 0;
+    break;
+
+  case DENYLIST_OP_ADD:
+    if ((uid == NULL) ||
+        ((index == DENYLIST_NOT_FOUND) && (entry_count >= DENYLIST_MAX))) {
+      list_flags |= DENYLIST_FLAG_INCOMPLETE;
+      result = FAIL;
+    } else if (index == DENYLIST_NOT_FOUND) {
+      WriteEntry(entry_count, hash);
+      entry_count++;
+    }
+    break;
+
+  case DENYLIST_OP_REMOVE:
+    if (uid == NULL) {
+      result = FAIL;
+    } else if (index != DENYLIST_NOT_FOUND) {
+      if (index != entry_count - 1)
+        WriteEntry(index, ReadEntry(entry_count - 1));
+      entry_count--;
+    }
+    break;
+
+  default:
+    list_flags |= DENYLIST_FLAG_INCOMPLETE;
+    result = FAIL;
+    break;
+  }
+
+  list_version = version;
+  WriteHeader();
+
+  return result;
+}
+
+
+/*
+ * DenylistDecodeUid
+ * Description: Decode a card UID from its hex string form
+ *
+ * Arguments:   hex - DENYLIST_UID_HEX hex digits, NULL-terminated
+ *              uid - DENYLIST_UID_BYTES bytes [modified]
+ * Return:      SUCCESS: UID decoded
+ *              FAIL:    wrong length or bad digit
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int DenylistDecodeUid(const char *hex, uint8_t *uid)
+{
+  int hi, lo;
+  uint8_t i;
+
+  for (i = 0; i < DENYLIST_UID_BYTES; i++) {
+    if ((hex[0] == '\0') || (hex[1] == '\0'))     /* too short */
+      return FAIL;
+    hi = HexValue(hex[0]);
+    lo = HexValue(hex[1]);
+    if ((hi < 0) || (lo < 0))
+      return FAIL;
+    uid[i] = (uint8_t) ((hi << 4) | lo);
+    hex += 2;
+  }
+
+  return (*hex == '\0') ? SUCCESS : FAIL;         /* not too long */
+}
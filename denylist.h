@@ -0,0 +1,77 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DENYLIST.H                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for denylist.c, the local list of blocked cards.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DenylistRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DenylistIncomplete; format 2
+ *                                           keeps its flag
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed DenylistRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#ifndef DENYLIST_H
+#define DENYLIST_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * DENYLIST CONSTANTS
+ * --------------------------------------
+ */
+#define DENYLIST_MAX         120    /* fingerprints kept in data EEPROM */
+#define DENYLIST_FORMAT      2      /* EEPROM list format written by code */
+#define DENYLIST_UID_BYTES   7      /* bytes of a card UID */
+#define DENYLIST_UID_HEX     (2*DENYLIST_UID_BYTES) /* hex digits of a UID */
+#define DENYLIST_ENTRY_SIZE  4      /* bytes of a fingerprint in EEPROM */
+
+/* server updates */
+#define DENYLIST_OP_CLEAR    0      /* drop every entry (full resync) */
+#define DENYLIST_OP_ADD      1      /* block a card */
+#define DENYLIST_OP_REMOVE   2      /* unblock a card */
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* load the denylist header from data EEPROM */
+extern void DenylistInit(void);
+
+/* get the version of the denylist */
+extern uint16_t DenylistVersion(void);
+
+/* get the number of blocked card fingerprints */
+extern uint8_t DenylistCount(void);
+
+/* get the fingerprint of a card UID */
+extern uint32_t DenylistHash(const uint8_t *uid);
+
+/* might a card be blocked? */
+extern uint8_t DenylistCheck(const uint8_t *uid);
+
+/* is the denylist missing a blocked card it couldn't take? */
+extern uint8_t DenylistIncomplete(void);
+
+/* apply a server update to the denylist */
+extern int DenylistUpdate(uint8_t op, uint16_t version, const uint8_t *uid);
+
+/* decode a card UID from its hex string form */
+extern int DenylistDecodeUid(const char *hex, uint8_t *uid);
+
+
+#endif                                                          /* DENYLIST_H */
@@ -0,0 +1,215 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              DIAG.C                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the diagnostics interface, for finding out how much headroom the
+ *   PIC18's RAM and hardware stack have left before adding features.
+ *
+ *   The hardware return stack is 31 levels deep, and with CONFIG4L's STVREN
+ *   set, a call past the last level resets the MCU. The deepest paths are
+ *   StateDriver -> action -> Data* -> SimHttp, and card reads, with the
+ *   Timer0 and serial interrupts on top. At startup every level not in use is
+ *   painted with a return address no call can push (DIAG_PAINT_*); a call
+ *   overwrites its level and a return leaves it overwritten. DiagStackPeak
+ *   looks for the deepest level that isn't paint any more, so it catches
+ *   every call ever made, interrupts included, without sampling.
+ *   A stack reset leaves STKFUL or STKUNF set, so DiagInit counts them in
+ *   persistent RAM across warm restarts.
+ *
+ *   HI-TECH C overlays automatic variables in a compiled stack that the
+ *   linker sizes from the call graph, so there is no data stack to paint:
+ *   the deepest path's autos (e.g. edata[] and Cmac's buffer[]) show up as
+ *   the compiled stack size in the map file. What is reported is each
+ *   module's static RAM as linked: host/mapram reads it from the map file
+ *   into diag_ram.h, a table in program memory, after each link.
+ *
+ * Table of Contents:
+ *   (public)
+ *   DiagInit        - note a stack reset, and paint the unused stack levels
+ *   DiagStackPeak   - get the deepest hardware stack level used
+ *   DiagStackResets - get the stack resets since power-on
+ *   DiagRamModules  - get the number of modules with static RAM
+ *   DiagRamModule   - get a module's name and static RAM
+ *   DiagRamTotal    - get the static RAM of all modules
+ *
+ * Assumptions:
+ *   RestartInit has been called, so RestartIsWarm is known.
+ *
+ * Limitations:
+ *   The RAM figures are from the last map file diag_ram.h was made from, so
+ *   are out of date till it's made again after a link that changes them.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     RAM figures from the map file, not
+ *                                           from a <Module>Ram per module
+ */
+
+#include "general.h"
+#include <htc.h>
+#include "diag.h"
+#include "restart.h"
+#include "diag_ram.h"   /* for diagRam, made from the map file */
+
+
+/* shared variables have to be local to this file */
+static persistent uint8_t stackResets; /* stack resets since power-on */
+
+
+/*
+ * DiagInit
+ * Description: Count a stack full/underflow reset if that's how the MCU came
+ *              out of reset, and paint the hardware stack levels above the
+ *              current one.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   The stack pointer is moved up a level at a time and the paint
+ *              written to the top of stack, then it's put back. Nothing in
+ *              here may make a call or take an interrupt while it's moved.
+ *              Writing STKPTR also clears STKFUL and STKUNF for next time.
+ *
+ * Assumptions: Called from main before interrupts are enabled.
+ *
+ * Shared:      stackResets [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void DiagInit(void)
+{
+  uint8_t sp = STKPTR;
+  uint8_t level;
+
+  if (!RestartIsWarm())                  /* RAM is undefined on power-on */
+    stackResets = 0;
+  if ((sp & (DIAG_STKPTR_FULL | DIAG_STKPTR_UNDER)) && (stackResets < 0xFF))
+    stackResets++;
+
+  sp &= DIAG_STKPTR_SP;
+  for (level = sp + 1; level <= DIAG_STACK_LEVELS; level++) {
+    STKPTR = level;
+    TOSU = DIAG_PAINT_U;
+    TOSH = DIAG_PAINT_H;
+    TOSL = DIAG_PAINT_L;
+  }
+  STKPTR = sp;
+}
+
+
+/*
+ * DiagStackPeak
+ * Description: Get the deepest hardware stack level used since startup.
+ *
+ * Arguments:   None
+ * Return:      levels used, at most DIAG_STACK_LEVELS
+ *
+ * Operation:   Look down from the top for the first level that isn't paint.
+ *              Interrupts are held off while the stack pointer is moved, as
+ *              an interrupt would push its return address in the wrong place.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DiagStackPeak(void)
+{
+  uint8_t sp, level, gie;
+
+  gie = GIE;
+  GIE = 0;
+  sp = STKPTR & DIAG_STKPTR_SP;
+  for (level = DIAG_STACK_LEVELS; level > sp; level--) {
+    STKPTR = level;
+    if ((TOSU != DIAG_PAINT_U) || (TOSH != DIAG_PAINT_H) ||
+        (TOSL != DIAG_PAINT_L))
+      break;
+  }
+  STKPTR = sp;
+  GIE = gie;
+
+  return level;
+}
+
+
+/*
+ * DiagStackResets
+ * Description: Get the number of stack full/underflow resets since power-on
+ *
+ * Arguments:   None
+ * Return:      resets, up to 255
+ *
+ * Shared:      stackResets [read only]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DiagStackResets(void)
+{
+  return stackResets;
+}
+
+
+/*
+ * DiagRamModules
+ * Description: Get the number of modules with static RAM, for DiagRamModule
+ *
+ * Arguments:   None
+ * Return:      number of modules
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t DiagRamModules(void)
+{
+  return DIAG_RAM_MODULES;
+}
+
+
+/*
+ * DiagRamModule
+ * Description: Get a module's name and the static RAM it uses
+ *
+ * Arguments:   index - [0, DiagRamModules()-1]
+ *              name  - module's name [modified]
+ * Return:      bytes of static RAM, or 0 (and an empty name) for a bad index
+ *
+ * Operation:   A bad index gets the table's empty end entry.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read diagRam
+ */
+uint16_t DiagRamModule(uint8_t index, const char **name)
+{
+  if (index > DIAG_RAM_MODULES)
+    index = DIAG_RAM_MODULES;
+
+  *name = diagRam[index].name;
+  return diagRam[index].bytes;
+}
+
+
+/*
+ * DiagRamTotal
+ * Description: Get the static RAM of all modules, C library ones included.
+ *              Out of DIAG_RAM_SIZE, what is left goes to the compiled stack
+ *              and the free space the map file shows.
+ *
+ * Arguments:   None
+ * Return:      bytes of static RAM
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Total comes with diagRam
+ */
+uint16_t DiagRamTotal(void)
+{
+  return DIAG_RAM_TOTAL;
+}
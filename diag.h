@@ -0,0 +1,83 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              DIAG.H                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for diag.c, the diagnostics interface: how deep
+ *   the hardware return stack has gone, resets from it overflowing, and the
+ *   static RAM each module uses.
+ *
+ * Assumptions:
+ *   Stack full/underflow resets are enabled in CONFIG4L (see configs.h).
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added diag_ram; removed DiagRam
+ */
+
+#ifndef DIAG_H
+#define DIAG_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * DIAG CONSTANTS
+ * --------------------------------------
+ */
+#define DIAG_STACK_LEVELS  31         /* hardware return stack depth */
+#define DIAG_RAM_SIZE      3862       /* bytes of data RAM on a PIC18F67K22 */
+
+/* STKPTR bits */
+#define DIAG_STKPTR_FULL   0x80       /* STKFUL: stack overflowed */
+#define DIAG_STKPTR_UNDER  0x40       /* STKUNF: stack underflowed */
+#define DIAG_STKPTR_SP     0x1F       /* SP4:SP0: levels in use */
+
+/* paint for unused stack levels: a return address past the end of the */
+/* 128 KB program memory, so no call ever pushes it */
+#define DIAG_PAINT_U       0x1F       /* TOSU */
+#define DIAG_PAINT_H       0xFF       /* TOSH */
+#define DIAG_PAINT_L       0xFE       /* TOSL */
+
+
+/* --------------------------------------
+ * DIAG DATA OBJECTS
+ * --------------------------------------
+ */
+/* a module's static RAM, as linked (see diag_ram.h) */
+typedef struct {
+  const char *name;                   /* module's object file, less .obj */
+  uint16_t bytes;                     /* bytes of its data space psects */
+} diag_ram;
+
+
+/* --------------------------------------
+ * DIAG FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* note a stack reset, and paint the unused hardware stack levels */
+extern void DiagInit(void);
+
+/* get the deepest hardware stack level used since startup */
+extern uint8_t DiagStackPeak(void);
+
+/* get the stack full/underflow resets since power-on */
+extern uint8_t DiagStackResets(void);
+
+/* get the number of modules with static RAM */
+extern uint8_t DiagRamModules(void);
+
+/* get a module's name and static RAM */
+extern uint16_t DiagRamModule(uint8_t index, const char **name);
+
+/* get the static RAM of all modules */
+extern uint16_t DiagRamTotal(void);
+
+
+#endif                                                              /* DIAG_H */
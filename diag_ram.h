@@ -0,0 +1,25 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DIAG_RAM.H                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the static RAM of each module as linked, for diag.c only.
+ *   This copy has no figures, as no map file has been read into it yet.
+ *   The firmware build's post-build step makes it from the map with
+ *   host/mapram (see Building in README.md); build again when it changes.
+ */
+
+#ifndef DIAG_RAM_H
+#define DIAG_RAM_H
+
+#define DIAG_RAM_MODULES  0
+#define DIAG_RAM_TOTAL    0
+
+static const diag_ram diagRam[DIAG_RAM_MODULES + 1] = {
+  {"", 0}                                       /* end */
+};
+
+
+#endif                                                          /* DIAG_RAM_H */
@@ -0,0 +1,155 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             EEPROM.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for using the PIC18F67K22 data EEPROM, the
+ *   non-volatile store for caches and tables that must survive a reboot.
+ *
+ * Table of Contents:
+ *   EepromReadByte  - read a byte from data EEPROM
+ *   EepromWriteByte - write a byte to data EEPROM
+ *   EepromRead      - read a block of bytes from data EEPROM
+ *   EepromWrite     - write a block of bytes to data EEPROM
+ *
+ * Limitations:
+ *   Each byte write takes about 4ms, during which the CPU waits.
+ *   Each EEPROM cell is good for about 1,000,000 erase/write cycles.
+ *
+ * Documentation Sources:
+ *   - PIC18F87K22 Family Data Sheet, Section 8: Data EEPROM Memory
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <htc.h>
+#include "general.h"
+#include "eeprom.h"
+
+
+/* local functions */
+static uint8_t EepromReadByte(uint16_t addr);
+static void EepromWriteByte(uint16_t addr, uint8_t value);
+
+
+/*
+ * EepromReadByte
+ * Description: Read a byte from data EEPROM
+ *
+ * Arguments:   addr - data EEPROM address
+ * Return:      byte at addr
+ *
+ * Operation:   Load address, point to data EEPROM (not flash or config bits),
+ *              start the read and return EEDATA which is available on the
+ *              next instruction cycle.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t EepromReadByte(uint16_t addr)
+{
+  EEADRH = (uint8_t)(addr >> 8);    /* load address */
+  EEADR  = (uint8_t) addr;
+  EECON1bits.EEPGD = 0;             /* access data EEPROM memory */
+  EECON1bits.CFGS = 0;
+  EECON1bits.RD = 1;                /* start read */
+  return EEDATA;
+}
+
+
+/*
+ * EepromWriteByte
+ * Description: Write a byte to data EEPROM
+ *
+ * Arguments:   addr  - data EEPROM address
+ *              value - byte to write
+ * Return:      None
+ *
+ * Operation:   Skip the write if the cell already holds value; this saves 4ms
+ *              and a write cycle from the cell's endurance.
+ *              Else load address and data, enable writes, and with interrupts
+ *              disabled do the required 0x55/0xAA unlock sequence then start
+ *              the write. Wait for WR to clear, which marks write completion.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void EepromWriteByte(uint16_t addr, uint8_t value)
+{
+  uint8_t gie;                      /* saved interrupt enable state */
+
+  if(EepromReadByte(addr) == value) /* nothing to do */
+    return;
+
+  EEADRH = (uint8_t)(addr >> 8);    /* load address */
+  EEADR  = (uint8_t) addr;
+  EEDATA = value;                   /* and data */
+  EECON1bits.EEPGD = 0;             /* access data EEPROM memory */
+  EECON1bits.CFGS = 0;
+  EECON1bits.WREN = 1;              /* enable writes */
+
+  gie = GIE;                        /* unlock sequence must not be */
+  GIE = 0;                          /* interrupted */
+  EECON2 = 0x55;
+  EECON2 = 0xAA;
+  EECON1bits.WR = 1;                /* start write */
+  GIE = gie;
+
+  while(EECON1bits.WR);             /* wait for write to complete */
+  EECON1bits.WREN = 0;              /* disable writes */
+}
+
+
+/*
+ * EepromRead
+ * Description: Read a block of bytes from data EEPROM
+ *
+ * Arguments:   addr - data EEPROM address of first byte
+ *              data - buffer to read into [modified]
+ *              size - number of bytes to read
+ * Return:      None
+ *
+ * Operation:   Read bytes one after the other
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void EepromRead(uint16_t addr, void *data, size_t size)
+{
+  uint8_t *p = (uint8_t *) data;
+
+  while(size--) {
+    *p++ = EepromReadByte(addr++);
+  }
+}
+
+
+/*
+ * EepromWrite
+ * Description: Write a block of bytes to data EEPROM
+ *
+ * Arguments:   addr - data EEPROM address of first byte
+ *              data - bytes to write
+ *              size - number of bytes to write
+ * Return:      None
+ *
+ * Operation:   Write bytes one after the other. Only bytes that differ from
+ *              what is already stored are actually written.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void EepromWrite(uint16_t addr, const void *data, size_t size)
+{
+  const uint8_t *p = (const uint8_t *) data;
+
+  while(size--) {
+    EepromWriteByte(addr++, *p++);
+  }
+}
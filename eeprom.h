@@ -0,0 +1,66 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             EEPROM.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for eeprom.c, the library of functions for using
+ *   the PIC18F67K22 data EEPROM. Also holds the map of what lives where in the
+ *   data EEPROM.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DNS cache region
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added card denylist region
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Grew denylist header for its flags
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+#include <stdlib.h>     /* for size_t */
+
+
+/* --------------------------------------
+ * EEPROM CONSTANTS
+ * --------------------------------------
+ */
+#define EEPROM_SIZE          1024   /* bytes of data EEPROM on PIC18F67K22 */
+#define EEPROM_ERASED        0xFF   /* value of a never written byte */
+
+
+/* --------------------------------------
+ * EEPROM MAP: [address, size] of each module's region
+ * --------------------------------------
+ */
+#define EEPROM_MIFARE_DIR_ADDR   0x0000  /* MIFARE card directory cache */
+#define EEPROM_MIFARE_DIR_SIZE   0x0140
+#define EEPROM_TARIFF_ADDR       0x0140  /* parking tariff table */
+#define EEPROM_TARIFF_SIZE       0x0084
+#define EEPROM_DNS_ADDR          0x01C4  /* server IP, dotted decimal string */
+#define EEPROM_DNS_SIZE          0x0010
+#define EEPROM_DENYLIST_ADDR     0x01D4  /* blocked card fingerprints */
+#define EEPROM_DENYLIST_SIZE     0x01E8
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* read a block of bytes from data EEPROM */
+extern void EepromRead(uint16_t addr, void *data, size_t size);
+
+/* write a block of bytes to data EEPROM */
+extern void EepromWrite(uint16_t addr, const void *data, size_t size);
+
+
+#endif                                                            /* EEPROM_H */
@@ -18,22 +18,26 @@
  *   AddDigit            - add a digit to the local number sequence.
  *   MobileGet           - Get Mobile Top-Up of a spefici amount
  *   UpdateExitOrUndo    - switch between *Exit* and *Undo* on number entry page
- *   ElapsedTime         - get number of elapsed milliseconds since last call
+ *   ElapsedTime         - get number of elapsed seconds since last call
  *   ConvertTimeToMin    - convert integer time of hh:mm format to minutes
- *
- *  (interrupt service routine functions)
- *   EventTimer           - elapsed time counter
+ *   PrefetchStart       - start prefetching account data for a new session
+ *   PrefetchDiscard     - discard prefetched account data
+ *   PrefetchStep        - do the next step of the account data prefetch
  *
  *  (update functions)
+ *   PageShown           - note that a page has been drawn in full
  *   NoUpdate            - do nothing
+ *   UpdateWelcome       - bring up data module and show its status
  *   UpdatePin           - flash newest pin digit before hiding it.
  *   UpdateAccount       - write in account balance on Account Page
  *   UpdatePark          - write in parking space and time left
  *   UpdateParkSpace     - write in current space or entered space
  *   UpdateParkTime      - write in entered parking time
+ *   UpdateDiag          - write in stack and RAM figures
  *  
  *  (event processing functions)
  *   NoAction            - do nothing
+ *   ResumeSession       - pick up a session from before a warm restart
  *   ResetAction         - reset system variables excluding state
  *   GetUserData         - get user info from tapped EasyCard
  *   AddPinDigit         - add a digit to the pin number sequence
@@ -47,6 +51,8 @@
  *   AddParkTimeDigit    - add parking time digit
  *   ProcessParkTime     - process parking time number 
  *   GetUtilityData      - get user's utility meter #s
+ *   ShowDiag            - show the Diagnostics Page
+ *   NextDiagModule      - show the static RAM of the next module
  *   MobileGetMtn100     - Get MTN VTU Recharge of 100, 200, 400, 750, 1500
  *   MobileGetMtn200
  *   MobileGetMtn400
@@ -80,6 +86,29 @@
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
  *   May  15, 2013      Nnoduka Eruchalu     Changed name ConvertTime to
  *                                          ConvertTimeToMin
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Prefetch account data during PIN
+ *                                           entry
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Price parking with tariff engine
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Format money and time with format.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Wait on data module from welcome
+ *                                           page, not at boot
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Resume session after warm restart
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Show offline status, no sessions
+ *                                           while offline
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Warn of weak signal
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Time parking off the RTCC, price it
+ *                                           at the time of day
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added EventprocRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Show network status again after
+ *                                           the Welcome Page is redrawn
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed EventprocRam; diag.c takes
+ *                                           RAM from the map file
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added Diagnostics Page
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Prefetch only once the PIN page is
+ *                                           idle; fetch parking details when
+ *                                           none were prefetched
+ *   Oct. 17, 2026      Nnoduka Eruchalu     uid_easytopup goes in the recharge
+ *                                           TODO till recharge uses it
  */
 #include <stdint.h>     /* for uint*_t */
 #include <stdlib.h>     /* for size_t  */
@@ -91,6 +120,31 @@
 #include "eventproc.h"
 #include "data.h"
 #include "smartcard.h"
+#include "keypad.h"     /* for IsAKey */
+#include "tariff.h"
+#include "format.h"
+#include "restart.h"
+#include "rtcc.h"
+#include "diag.h"
+
+
+/* account data prefetch steps */
+#define PREFETCH_IDLE     0    /* nothing (left) to fetch */
+#define PREFETCH_BALANCE  1    /* fetch account balance next */
+#define PREFETCH_PARK     2    /* fetch parking details next */
+
+/* PIN page idle time (in KeyTicks) before a prefetch step may block it */
+#define PREFETCH_IDLE_TIME  TMR0_FREQ                         /* 1 second */
+
+
+/* network status on the Welcome Page */
+#define NETWORK_UP        0    /* nothing shown */
+#define NETWORK_STARTING  1    /* module is starting */
+#define NETWORK_OFFLINE   2    /* server isn't being reached */
+#define NETWORK_WEAK      3    /* signal is weak; requests may be slow */
+#define NETWORK_UNSHOWN   0xFF /* page was redrawn; show status again */
+
+#define BLANK_ROW  "                    " /* LCD_WIDTH spaces */
 
 
 /* shared variables have to be local to this file */
@@ -102,14 +156,26 @@ static uint32_t balance;           /* account balance (in kobo) */
 static uint8_t  updated_balance;   /* (bool) balance has been updated */
 
 static uint32_t parking_space;     /* parking space number */
-static int32_t parking_time;       /* parking time left  */
-                                   /* (uints of 1/TIME_SCALE seconds) */
+static int32_t parking_time;       /* parking time left (in seconds) */
 static uint8_t  updated_space;     /* (bool) parking space has been updated */
 
-static uint32_t elapsed_ms;        /* elapsed milliseconds */
+static uint32_t elapsed_stamp;     /* RTCC uptime at last ElapsedTime */
 
 static uint8_t uid_easycard[7];   /* UID of EasyCard  */ 
-static uint8_t uid_easytopup[7];  /* UID of EasyTopup */ 
+
+static uint8_t prefetch_step;      /* next account data prefetch step */
+static uint16_t prefetch_ticks;    /* KeyTicks() the PIN page was last busy */
+static uint32_t cached_balance;    /* prefetched account balance (in kobo) */
+static uint8_t cached_balance_ok;  /* (bool) cached_balance is valid */
+static uint32_t cached_space;      /* prefetched parking space number */
+static int32_t cached_time;        /* prefetched parking time (in seconds) */
+static uint8_t cached_park_ok;     /* (bool) cached parking data is valid */
+
+static uint8_t network_shown;      /* NETWORK_* status on display */
+
+static uint8_t diag_module;        /* module shown: 0 is all, i is the i-1th */
+static uint8_t diag_peak;          /* stack peak shown */
+static uint8_t updated_diag;       /* (bool) Diagnostics Page needs redoing */
 
 
 /* static functions local to this file */
@@ -124,6 +190,9 @@ static void AddDigit(eventcode digit, uint8_t num_digits_limit);
 static void MobileGet(uint32_t amount);
 static uint32_t ElapsedTime(void);
 static uint32_t ConvertTimeToMin(uint32_t time, uint8_t num_time_digits);
+static void PrefetchStart(void);
+static void PrefetchDiscard(void);
+static void PrefetchStep(void);
 
 
 /*
@@ -173,11 +242,9 @@ static void UpdateDisplay(uint8_t row, uint8_t col, const char *str)
  * Input:            None
  * Output:           None
  *
- * Operation:        Write exactly 2 digits after a decimal point, and at least
- *                   1 digit before the decimal point. To ensure you get a
- *                   digit before decimal point, use a do-while loop so that
- *                   even if the number starts out as 0, it is written at least
- *                   once.
+ * Operation:        Write the currency logo, then let FormatMoney write exactly
+ *                   2 digits after a decimal point, and at least 1 digit before
+ *                   the decimal point with commas between groups of 3.
  *
  * Error Handling:   None
  *
@@ -188,36 +255,16 @@ static void UpdateDisplay(uint8_t row, uint8_t col, const char *str)
  *
  * Revision History:
  *   Apr. 25, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use FormatMoney
  */
 static void DisplayMoney(uint8_t row, uint8_t col, uint32_t n)
 {
-  char retbuf[30];                    /* allocate space for writing string    */
-  char *p = &retbuf[sizeof(retbuf)-1];/* and prepare to start from end        */
-  int i = 0;                          /* counter of chars written             */
-  
-  
-  *p = '\0';                          /* strings end with a null terminator   */
-  
-  do {                                /* pre-decimal point loop               */
-    *--p = '0' + (n % 10);            /* save next char in ASCII by adding '0'*/
-    n /= 10;                          /* and drop the saved char from number  */
-    i++;                              /* 1 more digit written                 */
-  } while(i<2);                       /* write at least 2 digits b4 decimal pt*/
-  *--p = '.';                         /* write decimal point                  */
-  i = 0;                              /* and reset counter for next loop      */
+  char retbuf[1+FORMAT_MONEY_SIZE];   /* currency logo and amount string      */
   
-  do {                                /* comma insertion loop                 */
-    if ((i%3 == 0) && (i != 0)) {     /* if on a 3rd digit                    */
-      *--p = ',';                     /* then next character is a comma       */
-    }
-    *--p = '0' + (n % 10);            /* save next char in ASCII by adding '0'*/
-    n /= 10;                          /* and drop the saved char from number  */
-    i++;                              /* 1 more digit written                 */
-  } while (n != 0);                   /* keep going till number is exhausted  */
-  
-  *--p = NAIRA_CHAR;                  /* throw in currency logo               */
+  retbuf[0] = NAIRA_CHAR;             /* throw in currency logo               */
+  FormatMoney(&retbuf[1], n);         /* then the amount                      */
   
-  UpdateDisplay(row, col, p);         /* FINALLY, update display              */
+  UpdateDisplay(row, col, retbuf);    /* FINALLY, update display              */
 }
 
 
@@ -238,6 +285,7 @@ static void DisplayMoney(uint8_t row, uint8_t col, uint32_t n)
  * Output:           None
  *
  * Operation:        time-separator is ':'
+ *                   FormatTime does the formatting, with unit/2 fields.
  *
  * Error Handling:   None
  *
@@ -248,29 +296,15 @@ static void DisplayMoney(uint8_t row, uint8_t col, uint32_t n)
  *
  * Revision History:
  *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use FormatTime
  */
 static void DisplayTime(uint8_t row, uint8_t col, uint32_t time, uint8_t unit)
 {
-  char retbuf[9];           /* hh:mm:ss is 8 chars and +1 for null-terminator */
-  char *p = &retbuf[sizeof(retbuf)-1];    /* prepare to start from end        */
-  uint8_t tmp;                            /* saves hour, minutes, seconds     */
-  int i=0;
+  char retbuf[FORMAT_TIME_SIZE];          /* hh:mm:ss and NULL-terminator     */
   
-  *p = '\0';                              /* strings end with NULL            */
-  
-  do {
-    if ((i%2 == 0) && (i != 0)) {        /* write a colon after every 2 chars */
-      *--p = ':';
-    }
+  FormatTime(retbuf, time, unit/2);       /* unit is digits, 2 per field      */
     
-    tmp = time%60;                       /* get a block: hh,mm, or ss         */
-    *--p = '0'+(tmp%10); i++;            /* write lower digit                 */
-    *--p = '0'+(tmp/10); i++;            /* write upper digit                 */
-    time /= 60;                          /* drop the entire block             */
-
-  } while (i < unit);
-    
-  UpdateDisplay(row, col, p);            /* FINALLY, update display           */
+  UpdateDisplay(row, col, retbuf);        /* FINALLY, update display           */
 }
 
 
@@ -326,10 +360,12 @@ static void ClearNumber(void)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Reset to 0, now that the balance is
+ *                                           fetched
  */
 static void ClearBalance(void)
 {
-  balance = 5000000; /* TODO: actually reset to 0 */
+  balance = 0;
   updated_balance = FALSE;
 }
 
@@ -402,9 +438,9 @@ static void UpdateExitOrUndo(void)
 
 
 /*
- * EventTimer
- * Description:      This function keeps count of the number of milliseconds
- *                   passing by. This procedure should be called every 1ms.
+ * PageShown
+ * Description:      Note that the page for a state has just been drawn in
+ *                   full, over anything the update functions wrote on it.
  *
  * Arguments:        None
  * Return:           None
@@ -412,23 +448,22 @@ static void UpdateExitOrUndo(void)
  * Input:            None
  * Output:           None
  *
- * Operation:        increment elapsed_ms
+ * Operation:        Forget the network status shown, so UpdateWelcome writes
+ *                   it again on a fresh Welcome Page.
  *
  * Error Handling:   None
  *
  * Algorithms:       None
  * Data Strutures:   None
  *
- * Shared Variables: elapsed_ms - read and modified
- *
- * Assumptions:      Assumes elapsed_ms will be reset to 0 before it overflows
+ * Shared Variables: network_shown - modified
  *
  * Revision History:
- *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
  */
-void EventTimer(void)
+void PageShown(void)
 {
-  elapsed_ms++;
+  network_shown = NETWORK_UNSHOWN;
 }
 
 
@@ -461,6 +496,65 @@ state NoUpdate(state curr_state)
 }
 
 
+/*
+ * UpdateWelcome
+ * Description:      Bring up the data module in the background and show its
+ *                   status on the Welcome Page.
+ *
+ * Arguments:        curr_state - the current system state
+ * Return:           nextstate  - the next system state
+ *
+ * Input:            None
+ * Output:           None
+ *
+ * Operation:        Poll the data module. Until it's ready show that the
+ *                   network is starting on row 1, and while the server isn't
+ *                   being reached show that it's offline; clear that once it's
+ *                   online. Warn when the signal is weak, before a customer
+ *                   starts a session. Only write to the display when the
+ *                   status changes.
+ *
+ * Error Handling:   None
+ *
+ * Algorithms:       None
+ * Data Strutures:   None
+ *
+ * Shared Variables: network_shown - read and modified
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Show offline status
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Warn of weak signal
+ */
+state UpdateWelcome(state curr_state)
+{
+  uint8_t status = NETWORK_UP;
+  
+  DataPoll();
+  
+  if (!DataReady())
+    status = NETWORK_STARTING;
+  else if (!DataOnline())
+    status = NETWORK_OFFLINE;
+  else if (DataSignalWeak())
+    status = NETWORK_WEAK;
+  
+  if (status != network_shown) {
+    if (status == NETWORK_STARTING)
+      UpdateDisplay(1, 0, "  Network Starting  "); /* row 1, col 0 */
+    else if (status == NETWORK_OFFLINE)
+      UpdateDisplay(1, 0, "  Network Offline   ");
+    else if (status == NETWORK_WEAK)
+      UpdateDisplay(1, 0, "    Weak Signal     ");
+    else
+      UpdateDisplay(1, 0, "                    ");
+    network_shown = status;
+  }
+  
+  return curr_state;
+}
+
+
 /*
  * UpdatePin
  * Description:      Flash the newest pin digit before changing it to a '*'
@@ -476,6 +570,10 @@ state NoUpdate(state curr_state)
  *                   '*'. Follow this up with updating the exit/undo
  *                   functionality and resetting the updated_number flag, since
  *                   the update has been handled.
+ *                   A prefetch step blocks for a server round trip, so it is
+ *                   only done once the page has had nothing to show and no key
+ *                   waiting for PREFETCH_IDLE_TIME: a user still typing isn't
+ *                   held up by it.
  *
  * Error Handling:   None
  *
@@ -486,6 +584,8 @@ state NoUpdate(state curr_state)
  *
  * Revision History:
  *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Prefetch account data when idle
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Prefetch only after an idle time
  */
 state UpdatePin(state curr_state)
 {
@@ -507,6 +607,14 @@ state UpdatePin(state curr_state)
     LcdCursor(1,8+num_digits);
 
     updated_number = FALSE;
+    prefetch_ticks = KeyTicks();    /* page was busy till now */
+    
+  } else if (IsAKey()) {  /* user is typing, so don't block them */
+    prefetch_ticks = KeyTicks();
+    
+  } else if ((uint16_t) (KeyTicks() - prefetch_ticks) >= PREFETCH_IDLE_TIME) {
+    PrefetchStep();       /* page has been idle a while, so prefetch */
+    LcdCursor(1,8+num_digits);
   }
   
   return curr_state;   /* current state doesn't change */
@@ -573,6 +681,7 @@ state UpdateAccount(state curr_state)
  *
  * Revision History:
  *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Count down in whole seconds
  */
 state UpdatePark(state curr_state)
 {
@@ -588,9 +697,9 @@ state UpdatePark(state curr_state)
   if (parking_time < 0)                          /* but keep time         */
     parking_time = 0;                            /* non-negative          */
  
-   /* if time has changed, update it in seconds */
-  if (parking_time/TIME_SCALE != old_parking_time/TIME_SCALE)
-    DisplayTime(1,12,parking_time/TIME_SCALE, DISPLAYTIME_SECS); /* update it (in secs) */
+  /* if time has changed, update it in seconds */
+  if (parking_time != old_parking_time)
+    DisplayTime(1,12,parking_time, DISPLAYTIME_SECS);
   
   return curr_state;
 }
@@ -653,7 +762,8 @@ state UpdateParkSpace(state curr_state)
  * Output:           None
  *
  * Operation:        Only run if there is a changed number digit.
- *                   Display current entered sequence in hh:mm format
+ *                   Display current entered sequence in hh:mm format, and its
+ *                   price from the local tariff table.
  *                   Update Exit/Undo button and clear flag indicating a changed
  *                   digit.
  *
@@ -666,13 +776,21 @@ state UpdateParkSpace(state curr_state)
  *
  * Revision History:
  *   Apr. 27, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Show price of entered time
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Price at the current time of day
  */
 state UpdateParkTime(state curr_state)
 {
+  uint16_t minutes;
+  
   if (updated_number) {  /* only do update if time number has changed */
     UpdateExitOrUndo();
+    minutes = (uint16_t) ConvertTimeToMin(number, num_digits);
+    /* price it, clearing out a possibly longer previous price */
+    UpdateDisplay(1, 0, "           ");
+    DisplayMoney(1, 0, TariffPrice(TARIFF_ZONE, RtccMinuteOfDay(), minutes));
     /* update it (in mins) */
-    DisplayTime(1,11,ConvertTimeToMin(number, num_digits), DISPLAYTIME_MINS);
+    DisplayTime(1,11,minutes, DISPLAYTIME_MINS);
     /* place cursor after last written character and skip colon */
     LcdCursor(1,11+((num_digits <= 2) ? num_digits : (num_digits+1)));
     
@@ -683,6 +801,81 @@ state UpdateParkTime(state curr_state)
 }
 
 
+/*
+ * UpdateDiag
+ * Description:      write in the stack and RAM figures on the Diagnostics Page
+ *
+ * Arguments:        curr_state - the current system state
+ * Return:           nextstate  - the next system state
+ *
+ * Input:            None
+ * Output:           None
+ *
+ * Operation:        Row 1 has the deepest hardware stack level used and the
+ *                   stack resets; it's redone when the peak goes up. Row 2 has
+ *                   the static RAM of all modules, or of the one picked with
+ *                   NextDiagModule; it's redone when the pick changes.
+ *                   Rows are padded out to clear longer earlier writes.
+ *
+ * Error Handling:   If diag_ram.h has no figures, row 2 says so.
+ *
+ * Algorithms:       None
+ * Data Strutures:   None
+ *
+ * Shared Variables: diag_module  - read only
+ *                   diag_peak    - read and modified
+ *                   updated_diag - read and modified
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+state UpdateDiag(state curr_state)
+{
+  char row[LCD_WIDTH+1];          /* row being written */
+  format_buf fb;
+  const char *name;               /* module's name */
+  uint16_t bytes;                 /* module's static RAM */
+  uint8_t peak = DiagStackPeak();
+  
+  if (updated_diag || (peak != diag_peak)) {
+    FormatBufInit(&fb, row, sizeof(row));
+    FormatBufStr(&fb, "Stack ");
+    FormatBufUint(&fb, peak);
+    FormatBufStr(&fb, "/");
+    FormatBufUint(&fb, DIAG_STACK_LEVELS);
+    FormatBufStr(&fb, " Rst ");
+    FormatBufUint(&fb, DiagStackResets());
+    FormatBufStr(&fb, BLANK_ROW);
+    UpdateDisplay(1, 0, row);
+    diag_peak = peak;
+  }
+  
+  if (updated_diag) {
+    FormatBufInit(&fb, row, sizeof(row));
+    FormatBufStr(&fb, "RAM ");
+    if (DiagRamModules() == 0) {
+      FormatBufStr(&fb, "no map figures");
+    } else if (diag_module == 0) {
+      FormatBufStr(&fb, "all ");
+      FormatBufUint(&fb, DiagRamTotal());
+      FormatBufStr(&fb, "/");
+      FormatBufUint(&fb, DIAG_RAM_SIZE);
+    } else {
+      bytes = DiagRamModule(diag_module - 1, &name);
+      FormatBufStr(&fb, name);
+      FormatBufStr(&fb, " ");
+      FormatBufUint(&fb, bytes);
+      FormatBufStr(&fb, "B");
+    }
+    FormatBufStr(&fb, BLANK_ROW);
+    UpdateDisplay(2, 0, row);
+    updated_diag = FALSE;
+  }
+  
+  return curr_state;
+}
+
+
 
 /*
  * NoAction
@@ -746,6 +939,51 @@ state ResetAction(state nextstate, eventcode event)
 }
 
 
+/*
+ * ResumeSession
+ * Description:      Pick up the session from before a warm restart, if any.
+ *
+ * Arguments:        None
+ * Return:           state to start the FSM in
+ *
+ * Input:            None
+ * Output:           None
+ *
+ * Operation:        If the restart was warm and the session got past the Pin
+ *                   page, get its EasyCard UID back and start on the Home
+ *                   page. That page only needs the UID; whatever page the
+ *                   session was on may have needed data that was lost. Else
+ *                   (the Diagnostics Page isn't a session either) start on
+ *                   the Welcome Page.
+ *
+ * Error Handling:   A session needs the server, so it's only resumed if the
+ *                   data module is ready (i.e. it was resumed too).
+ *
+ * Algorithms:       None
+ * Data Strutures:   None
+ *
+ * Shared Variables: uid_easycard - modified
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't resume the Diagnostics Page
+ */
+state ResumeSession(void)
+{
+  state saved_state;            /* state of session before restart */
+  
+  if (!RestartIsWarm() || !DataReady())
+    return STATE_WELCOME;
+  
+  saved_state = RestartSession(uid_easycard);
+  if ((saved_state == STATE_WELCOME) || (saved_state == STATE_PIN) || 
+      (saved_state == STATE_DIAG) || (saved_state >= NUM_STATES))
+    return STATE_WELCOME;
+  
+  return ResetAction(STATE_HOME, 0);
+}
+
+
 /*
  * GetUserData
  * Description:      Get user data from last tapped EasyCard
@@ -758,9 +996,12 @@ state ResetAction(state nextstate, eventcode event)
  * Output:           None
  *
  * Operation:        Get user data from PICC
+ *                   Start prefetching the account data of this new session.
  *                   End with a call to ResetAction()
  *
- * Error Handling:   None
+ * Error Handling:   A session needs the server, so while the data module is
+ *                   still starting or offline the tap is ignored and the
+ *                   Welcome Page stays up (showing the network status).
  *
  * Algorithms:       None
  * Data Strutures:   None
@@ -769,15 +1010,25 @@ state ResetAction(state nextstate, eventcode event)
  *
  * Revision History:
  *   May  16, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start account data prefetch
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Ignore tap till data module ready
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Record UID for warm restart
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Ignore tap while offline
  */
 state GetUserData(state nextstate, eventcode event)
 {
   size_t i;
   mifare_tag *tag; /* EasyCard representation */
+  
+  if (!DataOnline())   /* no session without the server */
+    return STATE_WELCOME;
+  
   tag = GetCardTag();  
   for(i=0; i<7; i++) { /* copy UID from tag */
     uid_easycard[i] = tag->uid[i];
   }
+  RestartSetUid(uid_easycard);
+  PrefetchStart();     /* fetch account data while PIN is entered */
   return ResetAction(nextstate, event); /* perform action reset */
 }
 
@@ -856,41 +1107,38 @@ static void MobileGet(uint32_t amount)
 
 /*
  * ElapsedTime
- * Description:      Get the number of ms that have elapsed since the last
+ * Description:      Get the number of seconds that have elapsed since the last
  *                   time this function was called. 
  *                   
  * Arguments:        None
- * Return:           elapsed milliseconds
+ * Return:           elapsed seconds
  *
  * Input:            None
  * Output:           None
  *
- * Operation:        Ideally: set retval to 0, and exchange its value with
- *                   elapsed_ms. This prevents critical code, gets the elapsed
- *                   time and resets the counter.
- *                   However the asm instruction, EXCH, used 16-bit registers
- *                   So will simply turn off interrupts around critical code.
+ * Operation:        Take the difference of the RTCC uptime from the one saved
+ *                   last call, and save the new one. The uptime never jumps
+ *                   when the wall clock is set, so neither does a countdown.
  *
  * Error Handling:   None
  *
  * Algorithms:       None
  * Data Strutures:   None
  *
- * Shared Variables: None
- * Todo:             Fix Critical code: Ideally this code should be:
- *                   retval = 0;
- *                   XCHG retval, elapsed_ms
- *                   return retval
+ * Shared Variables: elapsed_stamp - read and modified
  *
  * Revision History:
  *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Count seconds of RTCC uptime
+ *                                           instead of Timer2 ticks
  */
 static uint32_t ElapsedTime(void)
 {
+  uint32_t now = RtccUptime();
   uint32_t retval;
   
-  retval = elapsed_ms;     /* get elapsed time and clear counter   */
-  elapsed_ms = 0;
+  retval = now - elapsed_stamp;  /* get elapsed time and restart count */
+  elapsed_stamp = now;
   return retval;
 }
 
@@ -909,9 +1157,7 @@ static uint32_t ElapsedTime(void)
  * Input:            None
  * Output:           None
  *
- * Operation:        Ideally: set retval to 0, and exchange its value with
- *                   elapsed_ms. This prevents critical code, gets the elapsed
- *                   time and resets the counter.
+ * Operation:        Split the digits entered so far into hours and minutes.
  *
  * Error Handling:   None
  *
@@ -924,6 +1170,7 @@ static uint32_t ElapsedTime(void)
  *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
  *   May  15, 2013      Nnoduka Eruchalu     Changed name ConvertTime to
  *                                           ConvertTimeToMin
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Fixed the Operation description
  */
 static uint32_t ConvertTimeToMin(uint32_t time, uint8_t num_time_digits)
 {
@@ -959,6 +1206,93 @@ static uint32_t ConvertTimeToMin(uint32_t time, uint8_t num_time_digits)
 }
 
 
+/*
+ * PrefetchStart
+ * Description:      Start prefetching account data for a new EasyCard session
+ *                   
+ * Arguments:        None
+ * Return:           None
+ *
+ * Operation:        Drop whatever the last session cached, and queue up the
+ *                   balance and parking details fetches. PrefetchStep does the
+ *                   actual fetching when the user pauses during PIN entry.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the PIN page idle time
+ */
+static void PrefetchStart(void)
+{
+  PrefetchDiscard();
+  prefetch_step = PREFETCH_BALANCE;
+  prefetch_ticks = KeyTicks();
+}
+
+
+/*
+ * PrefetchDiscard
+ * Description:      Discard prefetched account data, and stop any prefetch
+ *                   still in progress.
+ *                   
+ * Arguments:        None
+ * Return:           None
+ *
+ * Operation:        Mark cached data invalid and the prefetch idle.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void PrefetchDiscard(void)
+{
+  prefetch_step = PREFETCH_IDLE;
+  cached_balance_ok = FALSE;
+  cached_park_ok = FALSE;
+}
+
+
+/*
+ * PrefetchStep
+ * Description:      Do the next step of the account data prefetch: a single
+ *                   server call.
+ *                   
+ * Arguments:        None
+ * Return:           None
+ *
+ * Operation:        Fetch the balance, then the parking details, one per call,
+ *                   caching whatever comes back. Parking details are cached
+ *                   even when there is no running space (space and time of 0).
+ *                   Data that couldn't be fetched isn't cached, since offline
+ *                   isn't a balance of 0 or no running space; the page that
+ *                   shows it fetches it again.
+ *                   Each step blocks for a server round trip, so it's only
+ *                   called once the PIN page has been idle for a while.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't cache a failed balance fetch
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't cache a failed parking fetch
+ */
+static void PrefetchStep(void)
+{
+  switch (prefetch_step) {
+  case PREFETCH_BALANCE:
+    cached_balance_ok = (DataAcctBalance(uid_easycard, &cached_balance) ==
+                         SUCCESS);
+    prefetch_step = PREFETCH_PARK;
+    break;
+    
+  case PREFETCH_PARK:
+    cached_park_ok = (DataParkDetails(uid_easycard, &cached_space,
+                                      &cached_time) == SUCCESS);
+    prefetch_step = PREFETCH_IDLE;
+    break;
+    
+  default:                       /* nothing to fetch */
+    break;
+  }
+}
+
+
 
 /*
  * AddPinDigit
@@ -1006,6 +1340,7 @@ state AddPinDigit(state nextstate, eventcode event)
  *
  * Operation:        If the pin number is complete, verify the pin number. A
  *                   verified pin number means the FSM can move on to "Home"
+ *                   An invalid pin discards the prefetched account data.
  *                   
  * Error Handling:   None
  *
@@ -1016,6 +1351,7 @@ state AddPinDigit(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Discard prefetch on invalid pin
  */
 state ProcessPin(state nextstate, eventcode event)
 {
@@ -1027,7 +1363,10 @@ state ProcessPin(state nextstate, eventcode event)
     UpdateDisplay(2, 0, "   Verifying Pin    "); /* row 2, col 0   */
     UpdateDisplay(3, 0, "                    "); /* row 3, col 0   */
     
-    /*TODO: Use DataPinValidate(uid_easycard, number) */
+    /* TODO: Use MifarePinVerify(tag, master, number) once the app drives
+     * the DESFire library, falling back to DataPinValidate(uid_easycard,
+     * number) only if the card can't answer (FAIL).
+     */
     if (TRUE) { /* and if is verified, the   */
       __delay_s(0.5);   /* delay to mimic verfication. TODO: remove */
       result = STATE_HOME;         /* nextstate is the homepage */
@@ -1036,6 +1375,7 @@ state ProcessPin(state nextstate, eventcode event)
           
     } else {                          /* if pin number is invalid  */
        result = STATE_WELCOME;        /* go back to welcome page   */
+       PrefetchDiscard();             /* and forget the account data */
       /* flash error message */
       UpdateDisplay(2, 0, "    Invalid  Pin!   "); /* row 2, col 0 */
     }
@@ -1061,6 +1401,7 @@ state ProcessPin(state nextstate, eventcode event)
  *
  * Operation:        If no entered digits, this function is an exit function.
  *                   If there are digits entered, this function will undo it.
+ *                   Exiting discards any prefetched account data.
  *
  * Error Handling:   None
  *
@@ -1071,12 +1412,14 @@ state ProcessPin(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Discard prefetch on exit
  */
 state ExitOrUndoDigit(state nextstate, eventcode event)
 {
   state result = nextstate;
   if (num_digits == 0) {        /* if no digits                */
     result = STATE_WELCOME;  /* exit to welcome page        */
+    PrefetchDiscard();       /* session is over             */
     
   } else {                      /* if however there are digits */
     number /= 10;               /* remove last appended digit  */
@@ -1101,6 +1444,9 @@ state ExitOrUndoDigit(state nextstate, eventcode event)
  *
  * Operation:        Clear balance-releated variables, then get actual account
  *                   balance.
+ *                   A balance prefetched during PIN entry is used instead, but
+ *                   only once, so later refreshes see server balance changes.
+ *                   If the server can't be reached the balance is left clear.
  *
  * Error Handling:   None
  *
@@ -1111,10 +1457,19 @@ state ExitOrUndoDigit(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use prefetched balance
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Fetch balance if none prefetched
  */
 state GetAcctBalance(state nextstate, eventcode event)
 {
-  /* TODO: ClearBalance();  DataAcctBalance(uid_easycard); */
+  if (cached_balance_ok) {      /* use prefetched balance, just once */
+    balance = cached_balance;
+    cached_balance_ok = FALSE;
+    
+  } else {                      /* none, so fetch it now */
+    ClearBalance();
+    DataAcctBalance(uid_easycard, &balance);
+  }
   updated_balance = TRUE;
   
   return nextstate;
@@ -1135,7 +1490,8 @@ state GetAcctBalance(state nextstate, eventcode event)
  *
  * Operation:        get topup card details
  *                   validate topup card, and flash success/fail message.
- *                   Refresh the account balance data, by calling GetAcctBalance
+ *                   Show the balance with the top-up added. The recharge is
+ *                   still mimicked, so the server's balance wouldn't have it.
  *                   
  *
  * Error Handling:   None
@@ -1147,12 +1503,15 @@ state GetAcctBalance(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Show the local balance, since
+ *                                           GetAcctBalance fetches the server's
  */
 state ProcessAcctRecharge(state nextstate, eventcode event)
 {
   uint32_t recharge_value = 0; /* in kobo */
   /* TODO: copy topup card uid */
   /*
+  uint8_t uid_easytopup[7];
   size_t i;
   mifare_tag *tag;     
   
@@ -1183,7 +1542,9 @@ state ProcessAcctRecharge(state nextstate, eventcode event)
   __delay_s(MSG_FLASH_TIME);        /* a msg flash takes time    */
   
   balance += recharge_value;              /* update balance      */
-  return GetAcctBalance(nextstate, event);/* refresh balance data*/
+  updated_balance = TRUE;                 /* and show it         */
+  
+  return nextstate;
 }
 
 
@@ -1200,6 +1561,10 @@ state ProcessAcctRecharge(state nextstate, eventcode event)
  *
  * Operation:        Clear parking-related variables, then get actual parking
  *                   status
+ *                   Parking details prefetched during PIN entry are used
+ *                   instead, but only once. If there are none they are
+ *                   fetched now; if the server can't be reached they are left
+ *                   clear, as no running space.
  *
  * Error Handling:   None. 
  *
@@ -1210,6 +1575,9 @@ state ProcessAcctRecharge(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 24, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use prefetched parking details
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Keep parking time in seconds
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Fetch details if none prefetched
  */
 state GetParkStatus(state nextstate, eventcode event)
 {
@@ -1217,10 +1585,15 @@ state GetParkStatus(state nextstate, eventcode event)
   ClearParking();       /* clear parking related variables */
   
   /* get parking space and time */
-  /* TODO: use DataParkDetails(uid_easycard, &parking_space, &parking_time); */
-  parking_space = 12; parking_time = 79*60;
+  if (cached_park_ok) {         /* use prefetched details, just once */
+    parking_space = cached_space;
+    parking_time = cached_time;
+    cached_park_ok = FALSE;
+    
+  } else {                      /* none, so fetch them now */
+    DataParkDetails(uid_easycard, &parking_space, &parking_time);
+  }
   
-  parking_time *= TIME_SCALE; /* scale time appropriately */
   updated_space = TRUE; 
   
   return nextstate;
@@ -1375,6 +1748,8 @@ state AddParkTimeDigit(state nextstate, eventcode event)
  *
  * Operation:        If there is at least 1 non-zero entered parking time digit
  *                   then can process parking space and time.
+ *                   The charge comes from the local tariff table; the server
+ *                   still gets the final say through DataParkPay.
  *
  * Error Handling:   None
  *
@@ -1385,11 +1760,13 @@ state AddParkTimeDigit(state nextstate, eventcode event)
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Price with tariff engine
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Price at the current time of day,
+ *                                           keep parking time in seconds
  */
 state ProcessParkTime(state nextstate, eventcode event)
 {
   state result = nextstate;
-  uint32_t parking_muls; /* how many multiples of 30 minutes is parking_time? */
   uint32_t parking_time_min;
   if ((num_digits >= 1) && (number != 0)) { /* if parking time is valid */
     /* save parking time in seconds */
@@ -1401,17 +1778,11 @@ state ProcessParkTime(state nextstate, eventcode event)
      * be updated with an extended value.
      */
     
-    /* update balance at N10.00 for 30 minutes by using modulo */
+    /* update balance with the local tariff */
     parking_time_min = parking_time/60;
-    if (parking_time_min % 30)                      /* if not exact multiple of 30*/
-      parking_muls = (parking_time_min/30) + 1;     /* then use ceiling function */
-    else if (parking_time_min > 0)
-      parking_muls = parking_time_min/30;
-    balance -= parking_muls*1000;
+    balance -= TariffPrice(TARIFF_ZONE, RtccMinuteOfDay(), parking_time_min);
     DataAlertPark(parking_space, parking_time_min);
     
-    parking_time *= TIME_SCALE; /* scale time appropriately */
-    
       
     /* go back to parking page to see new parking summary */
     result = STATE_PARKING;
@@ -1456,6 +1827,75 @@ state GetUtilityData(state nextstate, eventcode event)
 }
 
 
+/*
+ * ShowDiag
+ * Description:      Show the Diagnostics Page, starting with the static RAM
+ *                   of all modules.
+ *
+ * Arguments:        nextstate- expected next state
+ *                   event    - current event
+ * Return:           nextstate- actual next state
+ *
+ * Input:            None
+ * Output:           None
+ *
+ * Operation:        Pick all modules, and have UpdateDiag write in the page.
+ *
+ * Error Handling:   None
+ *
+ * Algorithms:       None
+ * Data Strutures:   None
+ *
+ * Shared Variables: diag_module  - modified
+ *                   updated_diag - modified
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+state ShowDiag(state nextstate, eventcode event)
+{
+  diag_module = 0;
+  updated_diag = TRUE;
+  return nextstate;
+}
+
+
+/*
+ * NextDiagModule
+ * Description:      Show the static RAM of the next module on the Diagnostics
+ *                   Page.
+ *
+ * Arguments:        nextstate- expected next state
+ *                   event    - current event
+ * Return:           nextstate- actual next state
+ *
+ * Input:            None
+ * Output:           None
+ *
+ * Operation:        Step through the modules, then back to all of them.
+ *
+ * Error Handling:   None
+ *
+ * Algorithms:       None
+ * Data Strutures:   None
+ *
+ * Shared Variables: diag_module  - read and modified
+ *                   updated_diag - modified
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+state NextDiagModule(state nextstate, eventcode event)
+{
+  if (diag_module < DiagRamModules())
+    diag_module++;
+  else
+    diag_module = 0;
+  updated_diag = TRUE;
+  return nextstate;
+}
+
+
 /*
  * MobileGetMtn****
  * Description:      Get MTN VTU Recharge of 100, 200, 400, 750, 1500
@@ -16,6 +16,15 @@
  *
  * Revision History:
  *   Apr. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added UpdateWelcome
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added ResumeSession
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed EventTimer; parking is
+ *                                           timed off the RTCC
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added EventprocRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added PageShown
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed EventprocRam; diag.c takes
+ *                                           RAM from the map file
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added Diagnostics Page routines
  */
 
 
@@ -27,7 +36,6 @@
 
 /* local include files */
 #include "interface.h"
-#include "interrupts.h"
 
 
 /* CONSTANTS */
@@ -37,25 +45,21 @@
 #define MSG_FLASH_TIME        1    /* time to flash a msg (in seconds)      */
 #define PIN_FLASH_TIME        0.5  /* time to flash a pin digit (in seconds)*/
 
-/* TIMING PARAMETERS 
-   -- assuming Timer2 
-   Counting up to 1s requires counting 1/TMR2_PERIOD == TMR2_FREQ
-*/
-#define ELAPSED_SCALE         TMR2_FREQ
-#define TIME_SCALE            ELAPSED_SCALE
+/* TIMING PARAMETERS */
 #define DISPLAYTIME_SECS      6         /* DisplayTime format is hh:mm:ss */
 #define DISPLAYTIME_MINS      4         /* DisplayTime format is hh:mm    */
 
 /* FUNCTION PROTOTYPES */
-/* Interrupt Service Routine Functions */
-/* time counter */
-void EventTimer(void);
-
+/* note that a page has been drawn in full */
+extern void PageShown(void);
 
 /* UpdateTable Routines */
 /* do nothing */
 extern state NoUpdate(state curr_state);
 
+/* bring up data module and show its status on Welcome Page */
+extern state UpdateWelcome(state curr_state);
+
 /* flash newest digit then hide it */
 extern state UpdatePin(state curr_state);
 
@@ -71,6 +75,14 @@ extern state UpdateParkSpace(state curr_state);
 /* write in entered time sequence */
 extern state UpdateParkTime(state curr_state);
 
+/* write in stack and RAM figures on Diagnostics Page */
+extern state UpdateDiag(state curr_state);
+
+
+/* Startup Routines */
+/* pick up a session from before a warm restart */
+extern state ResumeSession(void);
+
 
 /* State Machine Actions */
 /* do nothing */
@@ -115,6 +127,12 @@ extern state ProcessParkTime(state nextstate, eventcode event);
 /* get user's utility IDs */
 extern state GetUtilityData(state nextstate, eventcode event);
 
+/* show Diagnostics Page */
+extern state ShowDiag(state nextstate, eventcode event);
+
+/* show static RAM of next module on Diagnostics Page */
+extern state NextDiagModule(state nextstate, eventcode event);
+
 
 /* Get MTN VTU Specific Recharge Vouchers */
 extern state MobileGetMtn100(state nextstate, eventcode event);
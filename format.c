@@ -0,0 +1,346 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             FORMAT.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for formatting numbers, money, times and
+ *   hex into strings, and for building strings in bounded buffers. It stands
+ *   in for sprintf, which on PICC-18 drags in a large printf engine and does
+ *   a 32-bit division per decimal digit.
+ *
+ * Table of Contents:
+ *   (local)
+ *   FormatDigits    - write an unsigned integer in decimal
+ *
+ *   (public)
+ *   FormatUint      - write an unsigned integer in decimal
+ *   FormatUintWidth - write an unsigned integer, 0-padded to a minimum width
+ *   FormatMoney     - write a kobo amount as naira
+ *   FormatTime      - write a time as hh:mm or hh:mm:ss
+ *   FormatHex       - write bytes as upper case hex
+ *   FormatBufInit   - start building a string in a buffer
+ *   FormatBufStr    - append a string
+ *   FormatBufUint   - append an unsigned integer in decimal
+ *   FormatBufHex    - append bytes as upper case hex
+ *
+ * Limitations:
+ *   FormatTime shows at most 99 hours.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "general.h"
+#include "format.h"
+
+
+/* powers of 10 that fit a uint32_t, biggest first */
+static const uint32_t Pow10Table[FORMAT_UINT_SIZE-1] = {
+  1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+  10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+
+
+/* local functions */
+static size_t FormatDigits(char *buf, uint32_t n, uint8_t width);
+
+
+/*
+ * FormatDigits
+ * Description: Write an unsigned integer in decimal, 0-padded to a minimum
+ *              width.
+ *
+ * Arguments:   buf   - at least FORMAT_UINT_SIZE chars [modified]
+ *              n     - number to write
+ *              width - minimum digits to write, at most FORMAT_UINT_SIZE-1
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Operation:   Skip leading zero digits beyond the width. Then get each digit
+ *              by counting how many times its power of 10 can be subtracted,
+ *              which is a few 32-bit subtractions instead of a 32-bit division.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static size_t FormatDigits(char *buf, uint32_t n, uint8_t width)
+{
+  char *p = buf;
+  char digit;
+  uint8_t i = 0;
+
+  if (width < 1) width = 1;                  /* always write a digit */
+  while ((i < FORMAT_UINT_SIZE-1-width) && (n < Pow10Table[i]))
+    i++;                                     /* skip leading zeros */
+
+  for (; i < FORMAT_UINT_SIZE-1; i++) {
+    digit = '0';
+    while (n >= Pow10Table[i]) {
+      n -= Pow10Table[i];
+      digit++;
+    }
+    *p++ = digit;
+  }
+  *p = '\0';
+
+  return (size_t) (p - buf);
+}
+
+
+/*
+ * FormatUint
+ * Description: Write an unsigned integer in decimal
+ *
+ * Arguments:   buf - at least FORMAT_UINT_SIZE chars [modified]
+ *              n   - number to write
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t FormatUint(char *buf, uint32_t n)
+{
+  return FormatDigits(buf, n, 1);
+}
+
+
+/*
+ * FormatUintWidth
+ * Description: Write an unsigned integer in decimal, 0-padded to a minimum
+ *              width. Numbers wider than width are written in full.
+ *
+ * Arguments:   buf   - at least FORMAT_UINT_SIZE chars [modified]
+ *              n     - number to write
+ *              width - minimum digits to write
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t FormatUintWidth(char *buf, uint32_t n, uint8_t width)
+{
+  if (width > FORMAT_UINT_SIZE-1) width = FORMAT_UINT_SIZE-1;
+  return FormatDigits(buf, n, width);
+}
+
+
+/*
+ * FormatMoney
+ * Description: Write a kobo amount as naira, with commas and a decimal point
+ *              Example: 123456789 becomes 1,234,567.89
+ *                       5         becomes 0.05
+ *
+ * Arguments:   buf  - at least FORMAT_MONEY_SIZE chars [modified]
+ *              kobo - amount (in kobo)
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Operation:   Write the amount with at least 3 digits, so there is always a
+ *              naira digit. Copy the naira digits, with a comma before each
+ *              group of 3 from the right, then the decimal point and the kobo.
+ *              The currency symbol is left to the caller.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t FormatMoney(char *buf, uint32_t kobo)
+{
+  char digits[FORMAT_UINT_SIZE];
+  char *p = buf;
+  uint8_t len, naira_len, i;
+
+  len = (uint8_t) FormatDigits(digits, kobo, 3);
+  naira_len = len - 2;
+
+  for (i = 0; i < naira_len; i++) {
+    if ((i != 0) && ((naira_len - i) % 3 == 0))
+      *p++ = ',';                            /* comma before group of 3 */
+    *p++ = digits[i];
+  }
+  *p++ = '.';
+  *p++ = digits[naira_len];
+  *p++ = digits[naira_len+1];
+  *p = '\0';
+
+  return (size_t) (p - buf);
+}
+
+
+/*
+ * FormatTime
+ * Description: Write a time as hh:mm or hh:mm:ss
+ *              Example: 721*60 seconds becomes 12:01:00
+ *                       721 minutes    becomes 12:01
+ *
+ * Arguments:   buf    - at least FORMAT_TIME_SIZE chars [modified]
+ *              time   - in minutes for FORMAT_TIME_MINS, or in seconds for
+ *                       FORMAT_TIME_SECS
+ *              fields - FORMAT_TIME_MINS or FORMAT_TIME_SECS
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Operation:   Fill in 2 digit fields from the right, separated by ':'. Every
+ *              field but the hours is base 60. Hours past 99 only keep their
+ *              last 2 digits.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t FormatTime(char *buf, uint32_t time, uint8_t fields)
+{
+  size_t len = 3*fields - 1;                 /* "hh" then ":mm" per field */
+  char *p = buf + len;                       /* fill in from the end */
+  uint8_t tmp;                               /* hours, minutes or seconds */
+
+  *p = '\0';
+  while (fields--) {
+    if (fields != 0) {                       /* a minutes/seconds field */
+      tmp = (uint8_t) (time % 60);
+      time /= 60;
+    } else {                                 /* the hours field */
+      tmp = (uint8_t) (time % 100);
+    }
+
+    *--p = '0' + (tmp % 10);                 /* lower digit */
+    *--p = '0' + (tmp / 10);                 /* upper digit */
+    if (fields != 0)
+      *--p = ':';
+  }
+
+  return len;
+}
+
+
+/*
+ * FormatHex
+ * Description: Write bytes as upper case hex, 2 chars per byte
+ *
+ * Arguments:   buf   - at least 2*n+1 chars [modified]
+ *              bytes - bytes to write
+ *              n     - number of bytes
+ * Return:      number of chars written, not counting the NULL-terminator
+ *
+ * Operation:   For each nibble, high then low, write '0'+nibble if it's in
+ *              [0,9] else nibble-10+'A'.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t FormatHex(char *buf, const uint8_t *bytes, size_t n)
+{
+  char *p = buf;
+  uint8_t nibble;
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    nibble = bytes[i] >> 4;
+    *p++ = (nibble < 10) ? ('0' + nibble) : (nibble - 10 + 'A');
+    nibble = bytes[i] & 0x0F;
+    *p++ = (nibble < 10) ? ('0' + nibble) : (nibble - 10 + 'A');
+  }
+  *p = '\0';
+
+  return (size_t) (p - buf);
+}
+
+
+/*
+ * FormatBufInit
+ * Description: Start building a string in a buffer
+ *
+ * Arguments:   fb   - string builder [modified]
+ *              buf  - buffer to build string in [modified]
+ *              size - bytes in buf, at least 1
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void FormatBufInit(format_buf *fb, char *buf, size_t size)
+{
+  fb->buf = buf;
+  fb->size = size;
+  fb->len = 0;
+  buf[0] = '\0';
+}
+
+
+/*
+ * FormatBufStr
+ * Description: Append a string
+ *
+ * Arguments:   fb - string builder [modified]
+ *              s  - string to append
+ * Return:      SUCCESS: all of s appended
+ *              FAIL:    buffer full, s appended up to what fits
+ *
+ * Operation:   Copy chars while there's room for them and the NULL-terminator,
+ *              keeping track of the length so there's no strlen rescan.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int FormatBufStr(format_buf *fb, const char *s)
+{
+  while (*s != '\0') {
+    if (fb->len + 1 >= fb->size) {
+      fb->buf[fb->len] = '\0';
+      return FAIL;
+    }
+    fb->buf[fb->len++] = *s++;
+  }
+  fb->buf[fb->len] = '\0';
+
+  return SUCCESS;
+}
+
+
+/*
+ * FormatBufUint
+ * Description: Append an unsigned integer in decimal
+ *
+ * Arguments:   fb - string builder [modified]
+ *              n  - number to append
+ * Return:      SUCCESS: all digits appended
+ *              FAIL:    buffer full, digits appended up to what fits
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int FormatBufUint(format_buf *fb, uint32_t n)
+{
+  char digits[FORMAT_UINT_SIZE];
+
+  FormatUint(digits, n);
+  return FormatBufStr(fb, digits);
+}
+
+
+/*
+ * FormatBufHex
+ * Description: Append bytes as upper case hex
+ *
+ * Arguments:   fb    - string builder [modified]
+ *              bytes - bytes to append
+ *              n     - number of bytes
+ * Return:      SUCCESS: all bytes appended
+ *              FAIL:    buffer full, bytes appended up to what fits
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int FormatBufHex(format_buf *fb, const uint8_t *bytes, size_t n)
+{
+  char hex[3];                               /* 1 byte at a time */
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    FormatHex(hex, &bytes[i], 1);
+    if (FormatBufStr(fb, hex) < 0)
+      return FAIL;
+  }
+
+  return SUCCESS;
+}
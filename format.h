@@ -0,0 +1,86 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             FORMAT.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for format.c, the library of functions for
+ *   formatting numbers, money, times and hex into strings.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+#include <stdlib.h>     /* for size_t */
+
+
+/* --------------------------------------
+ * FORMAT CONSTANTS
+ * --------------------------------------
+ */
+#define FORMAT_UINT_SIZE   11  /* chars for any uint32_t, + NULL-terminator */
+#define FORMAT_MONEY_SIZE  14  /* chars for any uint32_t kobo amount, with */
+                               /* commas and decimal point, + NULL */
+#define FORMAT_TIME_SIZE   9   /* chars for hh:mm:ss, + NULL-terminator */
+
+#define FORMAT_TIME_MINS   2   /* FormatTime fields: hh:mm from minutes */
+#define FORMAT_TIME_SECS   3   /* FormatTime fields: hh:mm:ss from seconds */
+
+
+/* --------------------------------------
+ * FORMAT DATA OBJECTS
+ * --------------------------------------
+ */
+/* a bounded string builder */
+typedef struct {
+  char *buf;          /* string being built, always NULL-terminated */
+  size_t size;        /* bytes in buf, including NULL-terminator */
+  size_t len;         /* chars in string so far */
+} format_buf;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* write an unsigned integer in decimal */
+extern size_t FormatUint(char *buf, uint32_t n);
+
+/* write an unsigned integer in decimal, 0-padded to a minimum width */
+extern size_t FormatUintWidth(char *buf, uint32_t n, uint8_t width);
+
+/* write a kobo amount as naira, with commas and a decimal point */
+extern size_t FormatMoney(char *buf, uint32_t kobo);
+
+/* write a time as hh:mm or hh:mm:ss */
+extern size_t FormatTime(char *buf, uint32_t time, uint8_t fields);
+
+/* write bytes as upper case hex */
+extern size_t FormatHex(char *buf, const uint8_t *bytes, size_t n);
+
+/* start building a string in a buffer */
+extern void FormatBufInit(format_buf *fb, char *buf, size_t size);
+
+/* append a string */
+extern int FormatBufStr(format_buf *fb, const char *s);
+
+/* append an unsigned integer in decimal */
+extern int FormatBufUint(format_buf *fb, uint32_t n);
+
+/* append bytes as upper case hex */
+extern int FormatBufHex(format_buf *fb, const uint8_t *bytes, size_t n);
+
+
+#endif                                                            /* FORMAT_H */
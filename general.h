@@ -15,6 +15,7 @@
  *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added READ_STABLE
  */
 
 #ifndef GENERAL_H
@@ -55,6 +56,11 @@ typedef long       off_t;
  */
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
+/* read a multi-byte variable an ISR updates: the ISR can change it between
+ * the reads of its bytes, so read it until two reads agree
+ */
+#define READ_STABLE(dst, src)  do { (dst) = (src); } while ((dst) != (src))
+
 #endif                                                           /* GENERAL_H */
 
 
@@ -0,0 +1,620 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            BACKEND.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is a local reference server for the terminal. It answers every
+ *  endpoint data.c uses, the way the real server should, from an in-memory
+ *  ledger of EasyCard accounts and EasyTopup cards (see backend.h). It lets
+ *  terminals, the simulator's real-network build and the load generator be
+ *  run against a server without one being deployed.
+ *
+ *  It speaks the terminal's kept-open TCP socket protocol (see SimTcpRequest
+ *  in sim5218.c): one request frame
+ *    <len>\n<id> <G|P> <url> <params>
+ *  in, one response frame
+ *    <len>\n<id> <time> {"num1":..,"num2":..,"msg":"..","bool":..}
+ *  out, where len counts the bytes after the \n and time is the server's
+ *  clock in epoch seconds, which the terminal sets its own clock from.
+ *
+ *  Endpoints, with the params data.c sends and what the response holds:
+ *    P /card/validate/    uid         num1: CARD_TAP/CARD_TOPUP/CARD_INVALID
+ *    P /pin/validate/     uid pin     bool: PIN is right
+ *    G /account/balance/  uid         num1: balance (kobo)
+ *    P /account/recharge/ uid tid     bool: recharged, num1: value added
+ *    G /park/details/     uid         bool: parked, num1: space, num2: time
+ *                                     left (s)
+ *    P /park/pay/         uid space time
+ *                                     bool: time extended, num1: time left
+ *    G /tariff/rules/     ver zone    bool: FALSE, the table is up to date
+ *    G /card/denylist/    ver         bool: FALSE, the denylist is empty
+ *    P /alert/park/       s t         bool: TRUE
+ *  A request that doesn't fit (unknown URL, wrong method, bad or unknown
+ *  card) gets a FALSE/0 response and is counted as an error.
+ *
+ *  Usage: backend [-p port] [-a accounts]
+ *  Runs till interrupted, then reports requests by endpoint and checks that
+ *  the ledger's money adds up.
+ *
+ * Table of Contents:
+ *   (local)
+ *   BackendParam     - find a parameter's value
+ *   BackendParamUint - get a numeric parameter
+ *   BackendAccount   - get the account or topup card a UID parameter names
+ *   CardValidate     - /card/validate/
+ *   PinValidate      - /pin/validate/
+ *   AcctBalance      - /account/balance/
+ *   AcctRecharge     - /account/recharge/
+ *   ParkDetails      - /park/details/
+ *   ParkPay          - /park/pay/
+ *   TariffRules      - /tariff/rules/
+ *   CardDenylist     - /card/denylist/
+ *   AlertPark        - /alert/park/
+ *   BackendRequest   - answer a request frame
+ *   BackendRead      - read from a terminal and answer whole frames
+ *   BackendStop      - signal handler: stop serving
+ *   BackendReport    - report requests and check the ledger
+ *   main             - serve terminals
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Server time in response frames
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "../general.h"
+#include "../sim5218.h"
+#include "../smartcard.h"
+#include "backend.h"
+
+typedef struct {                      /* an EasyCard account */
+  uint32_t balance;                   /* kobo */
+  uint32_t space;                     /* parking space paid for */
+  uint32_t park_end;                  /* epoch s the parking time runs out */
+} account;
+
+typedef struct {                      /* an endpoint */
+  const char *url;
+  char method;                        /* 'G' or 'P', as in request frames */
+  int (*handler)(const char *params, http_data *response);
+  uint32_t requests;
+  uint32_t errors;
+} endpoint;
+
+typedef struct {                      /* a connected terminal */
+  char buf[BACKEND_FRAME_SIZE];       /* bytes of frames not yet answered */
+  size_t len;
+} connection;
+
+
+/* functions local to this file */
+static const char *BackendParam(const char *params, const char *key);
+static int BackendParamUint(const char *params, const char *key,
+                            uint32_t *value);
+static int BackendAccount(const char *params, const char *key, uint8_t kind,
+                          uint32_t *n);
+static int CardValidate(const char *params, http_data *response);
+static int PinValidate(const char *params, http_data *response);
+static int AcctBalance(const char *params, http_data *response);
+static int AcctRecharge(const char *params, http_data *response);
+static int ParkDetails(const char *params, http_data *response);
+static int ParkPay(const char *params, http_data *response);
+static int TariffRules(const char *params, http_data *response);
+static int CardDenylist(const char *params, http_data *response);
+static int AlertPark(const char *params, http_data *response);
+static int BackendRequest(int fd, char *frame);
+static int BackendRead(int fd, connection *conn);
+static void BackendStop(int sig);
+static void BackendReport(void);
+
+
+/* shared variables have to be local to this file */
+static account *accounts;             /* EasyCard accounts */
+static uint8_t *topup_used;           /* (bool) EasyTopup card was redeemed */
+static uint32_t num_accounts = BACKEND_ACCOUNTS; /* cards of each kind */
+static uint64_t topped_up;            /* kobo added from EasyTopup cards */
+static uint64_t charged;              /* kobo paid for parking */
+static uint32_t frames;               /* request frames answered */
+static volatile sig_atomic_t stop;    /* (bool) interrupted */
+
+static struct pollfd fds[BACKEND_CONNS + 1]; /* listener, then terminals */
+static connection conns[BACKEND_CONNS + 1];  /* by index into fds */
+
+static endpoint endpoints[] = {
+  {"/card/validate/",    'P', CardValidate, 0, 0},
+  {"/pin/validate/",     'P', PinValidate,  0, 0},
+  {"/account/balance/",  'G', AcctBalance,  0, 0},
+  {"/account/recharge/", 'P', AcctRecharge, 0, 0},
+  {"/park/details/",     'G', ParkDetails,  0, 0},
+  {"/park/pay/",         'P', ParkPay,      0, 0},
+  {"/tariff/rules/",     'G', TariffRules,  0, 0},
+  {"/card/denylist/",    'G', CardDenylist, 0, 0},
+  {"/alert/park/",       'P', AlertPark,    0, 0}
+};
+#define NUM_ENDPOINTS  (sizeof(endpoints) / sizeof(endpoints[0]))
+static uint32_t bad_urls;             /* requests to no endpoint */
+
+
+/*
+ * BackendParam
+ * Description: Find a parameter's value in a parameter string such as
+ *              "uid=0445500000002A&pin=1234" (a leading '&' is fine too).
+ *
+ * Arguments:   params - parameter string
+ *              key - parameter name
+ * Return:      the value, which runs to the next '&' or the end, or NULL if
+ *              there's no such parameter
+ */
+static const char *BackendParam(const char *params, const char *key)
+{
+  size_t len = strlen(key);
+  const char *p = params;
+
+  while ((p = strstr(p, key)) != NULL) {
+    if (((p == params) || (p[-1] == '&')) && (p[len] == '='))
+      return &p[len + 1];
+    p += len;
+  }
+  return NULL;
+}
+
+
+static int BackendParamUint(const char *params, const char *key,
+                            uint32_t *value)
+{
+  const char *p = BackendParam(params, key);
+  char *end;
+
+  if ((p == NULL) || (*p < '0') || (*p > '9'))
+    return FAIL;
+  *value = (uint32_t) strtoul(p, &end, 10);
+  return ((*end == '\0') || (*end == '&')) ? SUCCESS : FAIL;
+}
+
+
+/*
+ * BackendAccount
+ * Description: Get the number of the card a UID parameter names.
+ *
+ * Arguments:   params - parameter string
+ *              key - parameter name, e.g. "uid"
+ *              kind - kind of card expected: BACKEND_UID_CARD/TOPUP
+ *              n - card's number [modified]
+ * Return:      SUCCESS, or FAIL if the value isn't 14 hex digits or isn't an
+ *              issued card of the kind
+ */
+static int BackendAccount(const char *params, const char *key, uint8_t kind,
+                          uint32_t *n)
+{
+  const char *p = BackendParam(params, key);
+  uint8_t uid[7];
+  unsigned int i, digit;
+
+  if (p == NULL)
+    return FAIL;
+  memset(uid, 0, sizeof(uid));
+  for (i = 0; i < 2*sizeof(uid); i++) {
+    if ((p[i] >= '0') && (p[i] <= '9'))      digit = p[i] - '0';
+    else if ((p[i] >= 'A') && (p[i] <= 'F')) digit = p[i] - 'A' + 10;
+    else if ((p[i] >= 'a') && (p[i] <= 'f')) digit = p[i] - 'a' + 10;
+    else return FAIL;
+    uid[i/2] = (uint8_t) ((uid[i/2] << 4) | digit);
+  }
+  if ((p[i] != '\0') && (p[i] != '&'))
+    return FAIL;
+
+  if ((uid[0] != kind) || (uid[1] != BACKEND_UID_TAG0) ||
+      (uid[2] != BACKEND_UID_TAG1) || (uid[3] != 0))
+    return FAIL;
+  *n = ((uint32_t) uid[4] << 16) | ((uint32_t) uid[5] << 8) | uid[6];
+  return (*n < num_accounts) ? SUCCESS : FAIL;
+}
+
+
+static int CardValidate(const char *params, http_data *response)
+{
+  uint32_t n;
+
+  if (BackendParam(params, "uid") == NULL)
+    return FAIL;
+  if (BackendAccount(params, "uid", BACKEND_UID_CARD, &n) == SUCCESS)
+    response->number = CARD_TAP;
+  else if (BackendAccount(params, "uid", BACKEND_UID_TOPUP, &n) == SUCCESS)
+    response->number = CARD_TOPUP;
+  else
+    response->number = CARD_INVALID;  /* a valid request about a bad card */
+  return SUCCESS;
+}
+
+
+static int PinValidate(const char *params, http_data *response)
+{
+  uint32_t n, pin;
+
+  if ((BackendAccount(params, "uid", BACKEND_UID_CARD, &n) < 0) ||
+      (BackendParamUint(params, "pin", &pin) < 0))
+    return FAIL;
+  response->boolean = (pin == BACKEND_PIN);
+  return SUCCESS;
+}
+
+
+static int AcctBalance(const char *params, http_data *response)
+{
+  uint32_t n;
+
+  if (BackendAccount(params, "uid", BACKEND_UID_CARD, &n) < 0)
+    return FAIL;
+  response->number = accounts[n].balance;
+  return SUCCESS;
+}
+
+
+/*
+ * AcctRecharge
+ * Description: Add an EasyTopup card's value to an account. Each card can
+ *              only be redeemed once.
+ */
+static int AcctRecharge(const char *params, http_data *response)
+{
+  uint32_t n, tid;
+
+  if ((BackendAccount(params, "uid", BACKEND_UID_CARD, &n) < 0) ||
+      (BackendAccount(params, "tid", BACKEND_UID_TOPUP, &tid) < 0))
+    return FAIL;
+
+  if (!topup_used[tid]) {
+    topup_used[tid] = TRUE;
+    accounts[n].balance += BACKEND_TOPUP;
+    topped_up += BACKEND_TOPUP;
+    response->boolean = TRUE;
+    response->number = BACKEND_TOPUP;
+  }
+  return SUCCESS;
+}
+
+
+static int ParkDetails(const char *params, http_data *response)
+{
+  uint32_t n;
+  uint32_t now = (uint32_t) time(NULL);
+
+  if (BackendAccount(params, "uid", BACKEND_UID_CARD, &n) < 0)
+    return FAIL;
+
+  if (accounts[n].park_end > now) {
+    response->boolean = TRUE;
+    response->number = accounts[n].space;
+    response->number2 = accounts[n].park_end - now;
+  }
+  return SUCCESS;
+}
+
+
+/*
+ * ParkPay
+ * Description: Pay for parking time at a space, at BACKEND_RATE for each
+ *              started minute. Time paid for at the space that's running
+ *              extends it; at any other space it starts afresh.
+ *
+ * Operation:   The response is TRUE with the time left when the time was
+ *              extended, and FALSE for a new payment, which leaves the
+ *              terminal's time as it is. There's no response for a balance
+ *              that's too low, so it's also FALSE, with nothing paid.
+ */
+static int ParkPay(const char *params, http_data *response)
+{
+  uint32_t n, space, secs, cost;
+  uint32_t now = (uint32_t) time(NULL);
+  account *a;
+
+  if ((BackendAccount(params, "uid", BACKEND_UID_CARD, &n) < 0) ||
+      (BackendParamUint(params, "space", &space) < 0) ||
+      (BackendParamUint(params, "time", &secs) < 0) || (secs == 0))
+    return FAIL;
+
+  a = &accounts[n];
+  cost = (secs + 59) / 60 * BACKEND_RATE;
+  if (cost > a->balance)
+    return SUCCESS;
+  a->balance -= cost;
+  charged += cost;
+
+  if ((a->park_end > now) && (a->space == space)) {
+    a->park_end += secs;
+    response->boolean = TRUE;
+    response->number = a->park_end - now;
+  } else {
+    a->space = space;
+    a->park_end = now + secs;
+  }
+  return SUCCESS;
+}
+
+
+static int TariffRules(const char *params, http_data *response)
+{
+  uint32_t ver, zone;
+
+  if ((BackendParamUint(params, "ver", &ver) < 0) ||
+      (BackendParamUint(params, "zone", &zone) < 0))
+    return FAIL;
+  response->number = ver;             /* up to date */
+  return SUCCESS;
+}
+
+
+static int CardDenylist(const char *params, http_data *response)
+{
+  uint32_t ver;
+
+  if (BackendParamUint(params, "ver", &ver) < 0)
+    return FAIL;
+  response->number = ver;             /* up to date */
+  return SUCCESS;
+}
+
+
+static int AlertPark(const char *params, http_data *response)
+{
+  uint32_t space, mins;
+
+  if ((BackendParamUint(params, "s", &space) < 0) ||
+      (BackendParamUint(params, "t", &mins) < 0))
+    return FAIL;
+  response->boolean = TRUE;           /* notification sent */
+  return SUCCESS;
+}
+
+
+/*
+ * BackendRequest
+ * Description: Answer a request frame.
+ *
+ * Arguments:   fd - terminal's socket
+ *              frame - "<id> <G|P> <url> <params>", NUL-terminated
+ *              [modified]
+ * Return:      SUCCESS, or FAIL if the frame can't be parsed or the response
+ *              can't be sent, which ends the connection
+ */
+static int BackendRequest(int fd, char *frame)
+{
+  char body[128];
+  char now[12];                       /* server time, epoch seconds */
+  char out[BACKEND_FRAME_SIZE];
+  http_data response;
+  const char *id, *url, *params;
+  char method;
+  char *p;
+  size_t i;
+  int len;
+
+  id = frame;                         /* split the frame up */
+  if ((p = strchr(frame, ' ')) == NULL)
+    return FAIL;
+  *p++ = '\0';
+  method = *p++;
+  if (*p++ != ' ')
+    return FAIL;
+  url = p;
+  if ((p = strchr(p, ' ')) != NULL) {
+    *p++ = '\0';
+    params = p;
+  } else {
+    params = "";
+  }
+
+  memset(&response, 0, sizeof(response));
+  for (i = 0; (i < NUM_ENDPOINTS) && (strcmp(endpoints[i].url, url) != 0); i++)
+    continue;
+  if (i == NUM_ENDPOINTS) {
+    bad_urls++;
+  } else {
+    endpoints[i].requests++;
+    if ((method != endpoints[i].method) ||
+        (endpoints[i].handler(params, &response) < 0)) {
+      endpoints[i].errors++;
+      memset(&response, 0, sizeof(response));
+    }
+  }
+  frames++;
+
+  sprintf(body, "{\"num1\":%lu,\"num2\":%lu,\"msg\":\"%s\",\"bool\":%s}",
+          (unsigned long) response.number, (unsigned long) response.number2,
+          (const char *) response.message,
+          response.boolean ? "true" : "false");
+  sprintf(now, "%lu", (unsigned long) time(NULL));
+  len = sprintf(out, "%lu\n%s %s %s",
+                (unsigned long) (strlen(id) + 1 + strlen(now) + 1 +
+                                 strlen(body)), id, now, body);
+  return (write(fd, out, len) == len) ? SUCCESS : FAIL;
+}
+
+
+/*
+ * BackendRead
+ * Description: Read what a terminal has sent, and answer each whole frame.
+ *
+ * Arguments:   fd - terminal's socket
+ *              conn - terminal's unanswered bytes [modified]
+ * Return:      SUCCESS, or FAIL if the terminal hung up or sent a frame that
+ *              can't be answered
+ */
+static int BackendRead(int fd, connection *conn)
+{
+  char frame[BACKEND_FRAME_SIZE];     /* a frame, NUL-terminated */
+  ssize_t got;
+  size_t len, header, i;
+
+  got = read(fd, &conn->buf[conn->len], sizeof(conn->buf) - conn->len);
+  if (got <= 0)
+    return ((got < 0) && (errno == EINTR)) ? SUCCESS : FAIL;
+  conn->len += got;
+
+  while (conn->len > 0) {
+    len = 0;                          /* get frame length */
+    for (i = 0; (i < conn->len) && (conn->buf[i] >= '0') &&
+           (conn->buf[i] <= '9'); i++)
+      len = 10*len + (conn->buf[i] - '0');
+    if (i == conn->len)               /* header not all here */
+      break;
+    if ((conn->buf[i] != '\n') || (len == 0) ||
+        (i + 1 + len >= sizeof(conn->buf)))
+      return FAIL;
+    header = i + 1;
+    if (conn->len < header + len)     /* frame not all here */
+      break;
+
+    memcpy(frame, &conn->buf[header], len);
+    frame[len] = '\0';
+    if (BackendRequest(fd, frame) < 0)
+      return FAIL;
+    conn->len -= header + len;        /* drop the frame */
+    memmove(conn->buf, &conn->buf[header + len], conn->len);
+  }
+  return SUCCESS;
+}
+
+
+static void BackendStop(int sig)
+{
+  (void) sig;
+  stop = TRUE;
+}
+
+
+static void BackendReport(void)
+{
+  uint64_t total = 0;
+  uint32_t n;
+  size_t i;
+
+  printf("\n%-20s %10s %8s\n", "endpoint", "requests", "errors");
+  for (i = 0; i < NUM_ENDPOINTS; i++)
+    printf("%-20s %10lu %8lu\n", endpoints[i].url,
+           (unsigned long) endpoints[i].requests,
+           (unsigned long) endpoints[i].errors);
+  printf("%-20s %10lu\n", "(unknown url)", (unsigned long) bad_urls);
+  printf("%lu frames\n", (unsigned long) frames);
+
+  for (n = 0; n < num_accounts; n++)
+    total += accounts[n].balance;
+  printf("ledger: %lu kobo topped up, %lu kobo charged; balances %s\n",
+         (unsigned long) topped_up, (unsigned long) charged,
+         (total == (uint64_t) num_accounts*BACKEND_BALANCE + topped_up -
+          charged) ? "add up" : "DON'T ADD UP");
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct sockaddr_in addr;
+  struct sigaction sa;
+  unsigned int port = BACKEND_PORT;
+  nfds_t nfds = 1;
+  nfds_t i;
+  int opt, fd;
+  int on = 1;
+  uint32_t n;
+
+  while ((opt = getopt(argc, argv, "p:a:")) != -1) {
+    if (opt == 'p') {
+      port = (unsigned int) strtoul(optarg, NULL, 10);
+    } else if (opt == 'a') {
+      num_accounts = (uint32_t) strtoul(optarg, NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-p port] [-a accounts]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if ((num_accounts == 0) || (num_accounts > BACKEND_ACCOUNTS_MAX)) {
+    fprintf(stderr, "%s: accounts must be 1 to %lu\n", argv[0],
+            (unsigned long) BACKEND_ACCOUNTS_MAX);
+    return EXIT_FAILURE;
+  }
+
+  accounts = calloc(num_accounts, sizeof(*accounts));
+  topup_used = calloc(num_accounts, sizeof(*topup_used));
+  if ((accounts == NULL) || (topup_used == NULL)) {
+    perror("calloc");
+    return EXIT_FAILURE;
+  }
+  for (n = 0; n < num_accounts; n++)
+    accounts[n].balance = BACKEND_BALANCE;
+
+  memset(&sa, 0, sizeof(sa));         /* stop cleanly, survive hang ups */
+  sa.sa_handler = BackendStop;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sa.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &sa, NULL);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  fds[0].fd = socket(AF_INET, SOCK_STREAM, 0);
+  if ((fds[0].fd < 0) ||
+      (setsockopt(fds[0].fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0) ||
+      (bind(fds[0].fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) ||
+      (listen(fds[0].fd, SOMAXCONN) < 0)) {
+    perror("listen");
+    return EXIT_FAILURE;
+  }
+  fds[0].events = POLLIN;
+  printf("backend: 127.0.0.1:%u, %lu accounts\n", port,
+         (unsigned long) num_accounts);
+  fflush(stdout);
+
+  while (!stop) {
+    if (poll(fds, nfds, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("poll");
+      break;
+    }
+
+    for (i = 1; i < nfds; i++) {      /* answer terminals */
+      if (fds[i].revents == 0)
+        continue;
+      if (BackendRead(fds[i].fd, &conns[i]) < 0) {
+        close(fds[i].fd);             /* hung up: fill its slot from the end */
+        nfds--;
+        fds[i] = fds[nfds];
+        conns[i] = conns[nfds];
+        i--;
+      }
+    }
+
+    if (fds[0].revents & POLLIN) {    /* take a new terminal */
+      fd = accept(fds[0].fd, NULL, NULL);
+      if ((fd >= 0) && (nfds > BACKEND_CONNS)) {
+        close(fd);                    /* full */
+      } else if (fd >= 0) {
+        fds[nfds].fd = fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        conns[nfds].len = 0;
+        nfds++;
+      }
+    }
+  }
+
+  BackendReport();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            BACKEND.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the header file for backend.c, the local reference server, and
+ *  what the load generator (loadgen.c) needs to know about it: where it
+ *  listens and which cards its in-memory ledger holds.
+ *
+ * Assumptions:
+ *  The ledger is made up at startup, so cards are numbered rather than
+ *  listed. Card n of a kind has the UID
+ *    <kind> 45 50 00 <n bits 23-16> <n bits 15-8> <n bits 7-0>
+ *  and UIDs of any other shape are unknown cards.
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * BACKEND CONSTANTS
+ * --------------------------------------
+ */
+#define BACKEND_PORT      8052        /* default TCP port on 127.0.0.1 */
+#define BACKEND_CONNS     1024        /* terminals connected at once */
+#define BACKEND_FRAME_SIZE 256        /* bytes kept of a request frame */
+
+/* ledger */
+#define BACKEND_ACCOUNTS  10000       /* default EasyCards (and EasyTopups) */
+#define BACKEND_ACCOUNTS_MAX 1000000  /* most cards of a kind */
+#define BACKEND_PIN       1234        /* every account's PIN */
+#define BACKEND_BALANCE   500000UL    /* opening balance (kobo) */
+#define BACKEND_TOPUP     100000UL    /* value of an EasyTopup card (kobo) */
+#define BACKEND_RATE      100         /* parking charge (kobo per minute) */
+
+/* card UIDs */
+#define BACKEND_UID_CARD  0x04        /* first byte: an EasyCard */
+#define BACKEND_UID_TOPUP 0x08        /* first byte: an EasyTopup card */
+#define BACKEND_UID_BAD   0x0F        /* first byte: a card nobody issued */
+#define BACKEND_UID_TAG0  0x45        /* 'E' */
+#define BACKEND_UID_TAG1  0x50        /* 'P' */
+
+
+#endif                                                           /* BACKEND_H */
@@ -0,0 +1,58 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            DIAG_HOST.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of diag.c for the host build. There is no PIC18 return stack to
+ *  look at, so none of it is ever used; the RAM figures are diag.c's, from
+ *  diag_ram.h.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../diag.h"
+#include "../diag_ram.h"
+#include "host.h"
+
+
+void DiagInit(void)
+{
+}
+
+
+uint8_t DiagStackPeak(void)
+{
+  return 0;
+}
+
+
+uint8_t DiagStackResets(void)
+{
+  return 0;
+}
+
+
+uint8_t DiagRamModules(void)
+{
+  return DIAG_RAM_MODULES;
+}
+
+
+uint16_t DiagRamModule(uint8_t index, const char **name)
+{
+  if (index > DIAG_RAM_MODULES)
+    index = DIAG_RAM_MODULES;
+
+  *name = diagRam[index].name;
+  return diagRam[index].bytes;
+}
+
+
+uint16_t DiagRamTotal(void)
+{
+  return DIAG_RAM_TOTAL;
+}
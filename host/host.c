@@ -0,0 +1,360 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              HOST.C                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the headless terminal simulator. It starts the terminal like
+ *  main.c does and hands over to the real StateDriver, on a virtual clock.
+ *  Every time the firmware clears the watchdog (each pass of the FSM loop and
+ *  of its long delays) the session script gets to run: it types keys, taps
+ *  cards, sets up the stub server and checks what the LCD shows.
+ *
+ *  Every FSM state change is reported with the input that led to it, the
+ *  virtual time from that input to the new state being shown, and the server
+ *  requests and bytes since the last state change, which includes any made
+ *  while the page waited on the input. A summary follows once the script is done.
+ *
+ *  Script commands, one per line ('#' starts a comment):
+ *    key <keys>        press keys in turn: 0-9, A-D, * and #
+ *    tap <uid>         put a card (14 hex digit UID) in the reader's field
+ *    leave             take the card out of the field
+ *    wait <ms>         let the terminal run for a while
+ *    expect <text>     wait till a row of the LCD shows text
+ *    show              print the LCD
+ *    server <url> <boolean> <number> <number2> [message]
+ *                      answer requests to url with this from now on
+ *    rtt <ms>          server round trip time
+ *    offline           server can't be reached
+ *    online            server can be reached again
+ *
+ * Table of Contents:
+ *   (local)
+ *   HostFail        - report a failed script line
+ *   HostFinish      - report the run and exit
+ *   HostLcdHas      - is some text on the LCD?
+ *   HostRun         - run a script line
+ *   HostStep        - run the script till it waits on the terminal
+ *
+ *   (public)
+ *   HostNow         - get the virtual time
+ *   HostDelay       - wait on the virtual clock
+ *   HostWatchdog    - clear the watchdog: run the script
+ *   HostInput       - note an input reaching the FSM
+ *   HostTraffic     - note a server request
+ *   HostTransition  - note a state change, and report it
+ *   main            - run a script on the terminal
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added the Diagnostics Page state
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Count traffic since the last state
+ *                                          change, not the last input
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../general.h"
+#include "../keypad.h"
+#include "../smartcard.h"
+#include "../lcd.h"
+#include "../rtcc.h"
+#include "../tariff.h"
+#include "../denylist.h"
+#include "../data.h"
+#include "../interface.h"
+#include "host.h"
+
+
+/* shared variables have to be local to this file */
+static char script[HOST_SCRIPT_LINES][HOST_LINE_SIZE]; /* session script */
+static unsigned int lines;            /* lines in script */
+static unsigned int next_line;        /* next line to run */
+static uint32_t now;                  /* virtual ms since startup */
+static uint32_t wait_until;           /* virtual ms the script waits till */
+static const char *expect_text;       /* text the script waits for, or NULL */
+static uint32_t expect_deadline;      /* virtual ms to stop waiting for it */
+static unsigned int fails;            /* failed script lines */
+
+static char input_name[24];           /* last input to reach the FSM */
+static uint32_t input_time;           /* virtual ms it did */
+static uint32_t state_requests;       /* server requests since last_state */
+static uint32_t state_tx, state_rx;   /* bytes to/from the server since */
+static uint8_t last_state;            /* FSM state shown */
+
+static uint32_t transitions;          /* FSM state changes */
+static uint32_t latency_sum;          /* virtual ms from inputs to them */
+static uint32_t latency_max;
+static uint32_t requests;             /* server requests */
+static uint32_t total_tx, total_rx;   /* bytes to/from the server */
+
+static const char *state_names[NUM_STATES] = {
+  "WELCOME", "PIN", "HOME", "ACCOUNT", "ACCOUNTRECHARGE", "PARKING",
+  "PARKINGSPACE", "PARKINGTIME", "MOBILE", "MOBILEMTN", "MOBILEGLO",
+  "MOBILEAIRTEL", "MOBILEETISALAT", "UTILITY", "UTILITYPOWER", "UTILITYWATER",
+  "DIAG"
+};
+
+
+/* functions local to this file */
+static void HostFail(const char *why);
+static void HostFinish(void);
+static uint8_t HostLcdHas(const char *text);
+static void HostRun(char *line);
+static void HostStep(void);
+
+
+static void HostFail(const char *why)
+{
+  uint8_t row;
+
+  fails++;
+  printf("%8lu ms  FAIL line %u: %s: %s\n", (unsigned long) now, next_line,
+         why, next_line ? script[next_line-1] : "");
+  for (row = 0; row < LCD_HEIGHT; row++)
+    printf("            |%s|\n", HostLcdRow(row));
+}
+
+
+static void HostFinish(void)
+{
+  printf("\n%lu transitions, latency avg %lu ms max %lu ms; "
+         "%lu requests, %lu/%lu bytes; key response max %lu ms; "
+         "%u failed\n",
+         (unsigned long) transitions,
+         (unsigned long) (transitions ? (latency_sum / transitions) : 0),
+         (unsigned long) latency_max, (unsigned long) requests,
+         (unsigned long) total_tx, (unsigned long) total_rx,
+         (unsigned long) KeyLatencyMax() * 1000 / TMR0_FREQ, fails);
+  exit(fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+static uint8_t HostLcdHas(const char *text)
+{
+  uint8_t row;
+
+  for (row = 0; row < LCD_HEIGHT; row++)
+    if (strstr(HostLcdRow(row), text) != NULL)
+      return TRUE;
+  return FALSE;
+}
+
+
+/*
+ * HostRun
+ * Description: Run a script line
+ *
+ * Arguments:   line - script line, without its newline
+ * Return:      None
+ *
+ * Error Handling: A line that can't be run is a failure.
+ */
+static void HostRun(char *line)
+{
+  char cmd[16];
+  char url[48];
+  char message[40];
+  unsigned long boolean, number, number2;
+  uint8_t uid[DENYLIST_UID_BYTES];
+  char *arg;
+  uint8_t row;
+
+  if ((line[0] == '#') || (sscanf(line, "%15s", cmd) != 1))
+    return;                              /* comment or blank line */
+  arg = line + strlen(cmd);
+  while (*arg == ' ')
+    arg++;
+
+  if (strcmp(cmd, "key") == 0) {
+    while (*arg != '\0')
+      if (HostKeyPress(*arg++) < 0)
+        HostFail("no such key");
+
+  } else if (strcmp(cmd, "tap") == 0) {
+    if (DenylistDecodeUid(arg, uid) < 0)
+      HostFail("bad UID");
+    else
+      HostCardEnter(uid);
+
+  } else if (strcmp(cmd, "leave") == 0) {
+    HostCardLeave();
+
+  } else if (strcmp(cmd, "wait") == 0) {
+    wait_until = now + strtoul(arg, NULL, 10);
+
+  } else if (strcmp(cmd, "expect") == 0) {
+    expect_text = arg;
+    expect_deadline = now + HOST_EXPECT_MS;
+
+  } else if (strcmp(cmd, "show") == 0) {
+    for (row = 0; row < LCD_HEIGHT; row++)
+      printf("            |%s|\n", HostLcdRow(row));
+
+  } else if (strcmp(cmd, "server") == 0) {
+    message[0] = '\0';
+    if ((sscanf(arg, "%47s %lu %lu %lu %39s", url, &boolean, &number,
+                &number2, message) < 4) ||
+        (HostServerAdd(url, (uint8_t) boolean, number, number2, message) < 0))
+      HostFail("bad server response");
+
+  } else if (strcmp(cmd, "rtt") == 0) {
+    HostServerRtt(strtoul(arg, NULL, 10));
+
+  } else if (strcmp(cmd, "offline") == 0) {
+    HostServerOnline(FALSE);
+
+  } else if (strcmp(cmd, "online") == 0) {
+    HostServerOnline(TRUE);
+
+  } else {
+    HostFail("unknown command");
+  }
+}
+
+
+/*
+ * HostStep
+ * Description: Run the script till it waits on the terminal, or is done.
+ *
+ * Arguments:   None
+ * Return:      None
+ */
+static void HostStep(void)
+{
+  while (TRUE) {
+    if ((int32_t) (now - wait_until) < 0)
+      return;                            /* still waiting */
+
+    if (expect_text != NULL) {
+      if (HostLcdHas(expect_text))
+        expect_text = NULL;
+      else if ((int32_t) (now - expect_deadline) >= 0) {
+        HostFail("not shown");
+        expect_text = NULL;
+      } else
+        return;                          /* not shown yet */
+    }
+
+    if (next_line >= lines)
+      HostFinish();
+    HostRun(script[next_line++]);
+  }
+}
+
+
+uint32_t HostNow(void)
+{
+  return now;
+}
+
+
+void HostDelay(uint32_t ms)
+{
+  now += ms;
+}
+
+
+void HostWatchdog(void)
+{
+  now += HOST_LOOP_MS;
+  if (now > HOST_RUN_MAX_MS) {
+    HostFail("script ran too long");
+    HostFinish();
+  }
+  HostStep();
+}
+
+
+void HostInput(const char *name)
+{
+  strncpy(input_name, name, sizeof(input_name) - 1);
+  input_time = now;
+}
+
+
+void HostTraffic(uint16_t tx, uint16_t rx)
+{
+  state_requests++;
+  state_tx += tx;
+  state_rx += rx;
+  requests++;
+  total_tx += tx;
+  total_rx += rx;
+}
+
+
+/*
+ * HostTransition
+ * Description: Note a state change, and report it with the input that led
+ *              to it and the server traffic since the last one. StateDriver records every state change (for a warm
+ *              restart) right after showing the new state, so this is
+ *              called from RestartSetState.
+ *
+ * Arguments:   state - new FSM state
+ * Return:      None
+ */
+void HostTransition(uint8_t state)
+{
+  uint32_t latency = now - input_time;
+
+  printf("%8lu ms  %-10s %-15s -> %-15s %6lu ms %3lu req %5lu/%-5lu B\n",
+         (unsigned long) input_time, input_name,
+         (last_state < NUM_STATES) ? state_names[last_state] : "?",
+         (state < NUM_STATES) ? state_names[state] : "?",
+         (unsigned long) latency, (unsigned long) state_requests,
+         (unsigned long) state_tx, (unsigned long) state_rx);
+
+  last_state = state;
+  state_requests = 0;
+  state_tx = 0;
+  state_rx = 0;
+  transitions++;
+  latency_sum += latency;
+  if (latency > latency_max)
+    latency_max = latency;
+}
+
+
+int main(int argc, char *argv[])
+{
+  FILE *fp;
+  size_t len;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <session script>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if ((fp = fopen(argv[1], "r")) == NULL) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  for (lines = 0; (lines < HOST_SCRIPT_LINES) &&
+         (fgets(script[lines], HOST_LINE_SIZE, fp) != NULL); lines++) {
+    len = strlen(script[lines]);
+    while ((len > 0) && ((script[lines][len-1] == '\n') ||
+                         (script[lines][len-1] == '\r')))
+      script[lines][--len] = '\0';
+  }
+  fclose(fp);
+
+  strcpy(input_name, "startup");
+  printf("%s\n", argv[1]);
+
+  /* start up like main() */
+  RtccInit();
+  KeypadInit();
+  CardInit();
+  LcdInit();
+  TariffInit();
+  DenylistInit();
+  DataInit();
+
+  StateDriver();               /* exits when the script is done */
+  return EXIT_FAILURE;
+}
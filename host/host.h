@@ -0,0 +1,79 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              HOST.H                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the header file for host.c, the headless terminal simulator. It
+ *  runs the real FSM (interface.c, eventproc.c, data.c, smartcard.c) on a
+ *  Unix host, on top of virtual drivers for the LCD, keypad, card reader and
+ *  3G module that are driven by a session script.
+ *
+ * Assumptions:
+ *  Time is virtual: it only moves when the firmware waits (__delay_ms), goes
+ *  round its loops (CLRWDT) or talks to the server. So runs are repeatable.
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * HOST CONSTANTS
+ * --------------------------------------
+ */
+#define HOST_LOOP_MS      1           /* virtual ms a wait loop pass takes */
+#define HOST_EXPECT_MS    60000UL     /* virtual ms to wait for expected text */
+#define HOST_RUN_MAX_MS   3600000UL   /* virtual ms a script may run for */
+#define HOST_EPOCH_START  1792220400UL/* server time at startup: 2026-10-17 */
+                                      /* 07:00:00 UTC */
+#define HOST_RTT_DEFAULT  800         /* virtual ms of a server round trip */
+
+#define HOST_LINE_SIZE    128         /* chars kept of a script line */
+#define HOST_SCRIPT_LINES 512         /* lines kept of a script */
+#define HOST_SERVER_SIZE  32          /* canned server responses */
+
+
+/* --------------------------------------
+ * HOST FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* virtual clock */
+extern uint32_t HostNow(void);
+extern void HostDelay(uint32_t ms);
+extern void HostWatchdog(void);
+
+/* measurements, reported by the drivers */
+extern void HostInput(const char *name);
+extern void HostTraffic(uint16_t tx, uint16_t rx);
+extern void HostTransition(uint8_t state);
+
+/* virtual keypad (keypad_host.c) */
+extern int HostKeyPress(char key);
+
+/* virtual card field (mifare_host.c) */
+extern void HostCardEnter(const uint8_t *uid);
+extern void HostCardLeave(void);
+
+/* virtual LCD (lcd_host.c) */
+extern const char *HostLcdRow(uint8_t row);
+
+/* stub server behind the virtual 3G module (sim5218_host.c) */
+extern int HostServerAdd(const char *url, uint8_t boolean, uint32_t number,
+                         uint32_t number2, const char *message);
+extern void HostServerOnline(uint8_t online);
+extern void HostServerRtt(uint32_t rtt);
+extern uint32_t HostServerTime(void);
+
+
+#endif                                                              /* HOST_H */
@@ -0,0 +1,26 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              HTC.H                                -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A stand-in for the HI-TECH C device header, for the host build. It only
+ *  has what the FSM code uses: waits move the virtual clock, and clearing the
+ *  watchdog is where the session script gets to run.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef HTC_H
+#define HTC_H
+
+#include "host.h"
+
+#define CLRWDT()         HostWatchdog()
+#define __delay_ms(x)    HostDelay((uint32_t) (x))
+#define __delay_us(x)    ((void) 0)
+
+
+#endif                                                               /* HTC_H */
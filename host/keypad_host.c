@@ -0,0 +1,142 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          KEYPAD_HOST.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of keypad.c for the host build. The session script presses
+ *  keys; each one is queued as an already debounced key press, stamped with
+ *  the virtual time, just like ScanAndDebounce queues them.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../keypad.h"
+#include "host.h"
+
+#define KEY_HOST_QUEUE  64            /* size of the queue array must be 2^n */
+
+/* shared variables have to be local to this file */
+static key_event keyQueue[KEY_HOST_QUEUE]; /* pressed keys */
+static uint8_t keyHead;                    /* next event to process */
+static uint8_t keyTail;                    /* next free slot */
+static uint16_t keyStamp;                  /* stamp of last key from GetKey */
+static uint8_t keyPending;                 /* (bool) keyStamp not yet shown */
+static uint16_t keyLatencyMax;             /* longest key press to response */
+
+/* keys, and their key codes */
+static const char keyNames[] = "123A456B789C*0#D";
+static const unsigned char keyCodes[] = {
+  KEY_1, KEY_2, KEY_3, KEY_A, KEY_4, KEY_5, KEY_6, KEY_B,
+  KEY_7, KEY_8, KEY_9, KEY_C, KEY_S, KEY_0, KEY_P, KEY_D
+};
+
+
+void KeypadInit(void)
+{
+  keyHead = 0;
+  keyTail = 0;
+  keyPending = FALSE;
+  keyLatencyMax = 0;
+}
+
+
+unsigned char IsAKey(void)
+{
+  while ((keyHead != keyTail) &&
+         (keyQueue[keyHead].type != KEY_EVENT_PRESS))
+    keyHead = (keyHead + 1) & (KEY_HOST_QUEUE - 1);
+
+  return (keyHead != keyTail);
+}
+
+
+unsigned char GetKey(void)
+{
+  char name[] = "key ?";
+  unsigned char code;
+  size_t i;
+
+  while (!IsAKey())
+    CLRWDT();                  /* the script may press one */
+
+  code = keyQueue[keyHead].code;
+  keyStamp = keyQueue[keyHead].stamp;
+  keyPending = TRUE;
+  keyHead = (keyHead + 1) & (KEY_HOST_QUEUE - 1);
+
+  for (i = 0; (i < sizeof(keyCodes)) && (keyCodes[i] != code); i++)
+    continue;
+  name[4] = keyNames[i];
+  HostInput(name);
+  return code;
+}
+
+
+unsigned char GetKeyEvent(key_event *ev)
+{
+  if (keyHead == keyTail)
+    return FALSE;
+
+  *ev = keyQueue[keyHead];
+  keyHead = (keyHead + 1) & (KEY_HOST_QUEUE - 1);
+  return TRUE;
+}
+
+
+uint16_t KeyTicks(void)
+{
+  return (uint16_t) (HostNow() * TMR0_FREQ / 1000);
+}
+
+
+void KeyShown(void)
+{
+  uint16_t latency;
+
+  if (!keyPending)
+    return;
+
+  keyPending = FALSE;
+  latency = KeyTicks() - keyStamp;
+  if (latency > keyLatencyMax)
+    keyLatencyMax = latency;
+}
+
+
+uint16_t KeyLatencyMax(void)
+{
+  return keyLatencyMax;
+}
+
+
+void ScanAndDebounce(void)
+{
+}
+
+
+/*
+ * HostKeyPress
+ * Description: Press a key, for the session script
+ *
+ * Arguments:   key - key name: 0-9, A-D, '*' or '#'
+ * Return:      SUCCESS, or FAIL if there's no such key or no room for it
+ */
+int HostKeyPress(char key)
+{
+  const char *name = strchr(keyNames, key);
+  uint8_t next = (keyTail + 1) & (KEY_HOST_QUEUE - 1);
+
+  if ((key == '\0') || (name == NULL) || (next == keyHead))
+    return FAIL;
+
+  keyQueue[keyTail].code = keyCodes[name - keyNames];
+  keyQueue[keyTail].type = KEY_EVENT_PRESS;
+  keyQueue[keyTail].stamp = KeyTicks();
+  keyTail = next;
+  return SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            LCD_HOST.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of lcd.c for the host build. Commands and data go to a model of
+ *  the 4x20 LCD's controller (its DDRAM and address counter) instead of the
+ *  LCD's bus, so the simulator can read back what is shown.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../lcd.h"
+#include "../format.h"
+#include "host.h"
+
+#define LCD_DDRAM_SIZE  0x80          /* DDRAM addresses */
+
+/* shared variables have to be local to this file */
+static char ddram[LCD_DDRAM_SIZE];    /* display data RAM */
+static uint8_t address;               /* address counter */
+static uint8_t cgram;                 /* (bool) address counter is in CGRAM */
+static char rowText[LCD_WIDTH+1];     /* last row read back */
+
+/* DDRAM address of the start of each row */
+static const uint8_t rowBase[LCD_HEIGHT] = {0x00, 0x40, 0x14, 0x54};
+
+
+void LcdCommand(unsigned char c)
+{
+  if (c & DDRAM_BASE) {               /* set DDRAM address */
+    address = c & (LCD_DDRAM_SIZE - 1);
+    cgram = FALSE;
+  } else if (c & CGRAM_BASE) {        /* set CGRAM address */
+    cgram = TRUE;
+  } else if (c == LCD_CLEAR) {
+    memset(ddram, ' ', sizeof(ddram));
+    address = 0;
+    cgram = FALSE;
+  } else if ((c & 0xFE) == LCD_RET_HOME) {
+    address = 0;
+    cgram = FALSE;
+  }                                   /* other commands don't change text */
+}
+
+
+void LcdWrite(unsigned char c)
+{
+  if (cgram)                          /* custom characters aren't modelled */
+    return;
+  ddram[address] = (char) c;
+  address = (address + 1) & (LCD_DDRAM_SIZE - 1);
+}
+
+
+void LcdWaitBF(void)
+{
+}
+
+
+void LcdTimerISR(void)
+{
+}
+
+
+void LcdInit(void)
+{
+  LcdCommand(LCD_CLEAR);
+}
+
+
+void LcdClear(void)
+{
+  LcdCommand(LCD_CLEAR);
+}
+
+
+void LcdWriteStr(const char *str)
+{
+  while (*str != '\0')
+    LcdWrite(*str++);
+}
+
+
+void LcdWriteInt(uint32_t num)
+{
+  char buffer[FORMAT_UINT_SIZE];
+  size_t i, len;
+
+  len = FormatUint(buffer, num);
+  for (i = 0; i < len; i++)
+    LcdWrite(buffer[i]);
+}
+
+
+void LcdWriteHex(uint8_t num)
+{
+  static const char hex[] = "0123456789ABCDEF";
+
+  LcdWrite(hex[num >> 4]);
+  LcdWrite(hex[num & 0x0F]);
+}
+
+
+void LcdWriteFill(const char (*displaytable)[LCD_WIDTH+1])
+{
+  uint8_t i;
+
+  LcdCommand(LCD_CLEAR);
+  LcdCommand(LCD_RET_HOME);
+  for (i = 0; i < LCD_HEIGHT; i++) {
+    LcdCursor(i, 0);
+    LcdWriteStr(displaytable[i]);
+  }
+}
+
+
+void LcdCursor(uint8_t row, uint8_t col)
+{
+  if (row >= LCD_HEIGHT) row = 0;
+  if (col >= LCD_WIDTH) col = 0;
+  LcdCommand(DDRAM_BASE + rowBase[row] + col);
+}
+
+
+/*
+ * HostLcdRow
+ * Description: Read back a row of the LCD. The Naira sign shows as 'N' and
+ *              other characters the simulator can't print as '?'.
+ *
+ * Arguments:   row - [0, LCD_HEIGHT-1]
+ * Return:      the row's LCD_WIDTH characters, valid till the next call
+ */
+const char *HostLcdRow(uint8_t row)
+{
+  uint8_t i;
+  char c;
+
+  for (i = 0; i < LCD_WIDTH; i++) {
+    c = ddram[rowBase[row % LCD_HEIGHT] + i];
+    if (c == NAIRA_CHAR)      c = 'N';
+    else if ((c < ' ') || (c > '~')) c = '?';
+    rowText[i] = c;
+  }
+  rowText[LCD_WIDTH] = '\0';
+  return rowText;
+}
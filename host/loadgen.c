@@ -0,0 +1,465 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            LOADGEN.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the multi-terminal load generator, for planning server capacity.
+ *  It runs hundreds of virtual terminals against a server (by default the
+ *  local backend.c), each replaying customer sessions through the real
+ *  data.c, so the server sees exactly the requests and parameter strings a
+ *  fleet of terminals would send it. It reports throughput and latency
+ *  percentiles by endpoint, and for whole sessions.
+ *
+ *  Each virtual terminal is a process of its own, as data.c keeps its state
+ *  in file-level variables, with its own socket to the server. It starts up
+ *  like a terminal (DataInit, then DataPoll till it's ready, which syncs the
+ *  tariff table), waits for the others, and then runs sessions back to back
+ *  for the measured time, with DataPoll's background checks in between.
+ *  A session goes the way eventproc.c takes a customer through one:
+ *    tap an EasyCard         DataCardValidate (LOADGEN_UNKNOWN% are unknown
+ *                            cards, which end the session)
+ *    type the PIN            DataPinValidate (LOADGEN_WRONG_PIN% are mistyped
+ *                            once first)
+ *    PIN page prefetch       DataAcctBalance, DataParkDetails
+ *    then one of
+ *      pay for parking       DataParkPay, DataAlertPark (LOADGEN_MIX_PARK%)
+ *      recharge              DataCardValidate of an EasyTopup card,
+ *                            DataAcctRecharge (LOADGEN_MIX_TOPUP%)
+ *      check the balance     nothing more (the rest)
+ *
+ *  Usage: loadgen [-n terminals] [-d seconds] [-w think ms] [-a accounts]
+ *                 [-h address] [-p port] [-s seed]
+ *  where think time is the mean pause between a terminal's sessions
+ *  (default 0, for the most load), and accounts must be no more than the
+ *  server has. The exit status is non-zero if a terminal couldn't start or
+ *  a request failed.
+ *
+ * Table of Contents:
+ *   (local)
+ *   LoadClock     - get the monotonic clock
+ *   LoadSleep     - sleep
+ *   LoadUid       - make the UID of a card in the backend's ledger
+ *   LoadSession   - run a customer session
+ *   LoadTerminal  - run a virtual terminal
+ *   LoadAdd       - add a record to the statistics
+ *   LoadPercentile- get a latency percentile
+ *   LoadReport    - report throughput and latency
+ *
+ *   (public)
+ *   LoadRecord    - note a request's outcome and latency
+ *   HostNow       - get the time since the terminal started
+ *   HostTransition- note a state change (none here)
+ *   main          - run the virtual terminals and report
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "../general.h"
+#include "../mifare.h"
+#include "../smartcard.h"
+#include "../tariff.h"
+#include "../denylist.h"
+#include "../data.h"
+#include "host.h"
+#include "backend.h"
+#include "loadgen.h"
+
+typedef struct {                      /* a request or session, sent through */
+  uint8_t kind;                       /* the pipe: index into kinds */
+  uint8_t ok;                         /* (bool) it succeeded */
+  uint32_t us;                        /* latency */
+} load_record;
+
+typedef struct {                      /* statistics of a kind of record */
+  uint32_t count;
+  uint32_t failed;
+  uint32_t max;                       /* us */
+} load_stats;
+
+
+/* functions local to this file */
+static uint64_t LoadClock(void);
+static void LoadSleep(uint32_t ms);
+static void LoadUid(uint8_t *uid, uint8_t kind, uint32_t n);
+static void LoadSession(void);
+static void LoadTerminal(unsigned int seed);
+static void LoadAdd(const load_record *r);
+static double LoadPercentile(uint8_t kind, unsigned int percent);
+static void LoadReport(unsigned int terminals, unsigned int seconds);
+
+
+/* kinds of records: the URLs data.c uses, then totals */
+static const char *kinds[] = {
+  "/card/validate/", "/pin/validate/", "/account/balance/",
+  "/account/recharge/", "/park/details/", "/park/pay/", "/tariff/rules/",
+  "/card/denylist/", "/alert/park/", "(all requests)", "(sessions)"
+};
+#define NUM_KINDS      (sizeof(kinds) / sizeof(kinds[0]))
+#define KIND_REQUESTS  (NUM_KINDS - 2)
+#define KIND_SESSIONS  (NUM_KINDS - 1)
+
+/* shared variables have to be local to this file */
+static uint64_t boot;                 /* us the terminal started */
+static uint64_t start;                /* us the measured time starts */
+static uint64_t deadline;             /* us it ends */
+static uint32_t accounts = BACKEND_ACCOUNTS; /* cards of each kind to use */
+static unsigned int think;            /* mean ms between sessions */
+static int pipe_out = -1;             /* terminal's end of the record pipe */
+static uint8_t measuring;             /* (bool) record requests */
+static uint8_t session_ok;            /* (bool) session's requests succeeded */
+
+static load_stats stats[NUM_KINDS];
+static uint32_t hist[NUM_KINDS][LOADGEN_BUCKETS]; /* latency histograms */
+
+
+static uint64_t LoadClock(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+static void LoadSleep(uint32_t ms)
+{
+  struct timespec ts;
+
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = (long) (ms % 1000) * 1000000L;
+  while ((nanosleep(&ts, &ts) < 0) && (errno == EINTR))
+    continue;
+}
+
+
+static void LoadUid(uint8_t *uid, uint8_t kind, uint32_t n)
+{
+  uid[0] = kind;
+  uid[1] = BACKEND_UID_TAG0;
+  uid[2] = BACKEND_UID_TAG1;
+  uid[3] = 0;
+  uid[4] = (uint8_t) (n >> 16);
+  uid[5] = (uint8_t) (n >> 8);
+  uid[6] = (uint8_t) n;
+}
+
+
+/*
+ * LoadSession
+ * Description: Run a customer session: the server requests the terminal
+ *              makes for it (see the file description), in turn, as fast as
+ *              the server answers them. Its latency is recorded too.
+ *
+ * Shared:      session_ok [modified]
+ */
+static void LoadSession(void)
+{
+  mifare_tag tag, topup;
+  uint64_t began = LoadClock();
+  uint32_t space = 0, value, balance;
+  int32_t time = 0;
+  unsigned int pick;
+
+  session_ok = TRUE;
+  memset(&tag, 0, sizeof(tag));
+  if ((unsigned int) (rand() % 100) < LOADGEN_UNKNOWN)
+    LoadUid(tag.uid, BACKEND_UID_BAD, (uint32_t) rand() % accounts);
+  else
+    LoadUid(tag.uid, BACKEND_UID_CARD, (uint32_t) rand() % accounts);
+
+  if (DataCardValidate(&tag) == CARD_TAP) {
+    if ((unsigned int) (rand() % 100) < LOADGEN_WRONG_PIN)
+      DataPinValidate(tag.uid, (BACKEND_PIN + 1) % 10000);
+    if (DataPinValidate(tag.uid, BACKEND_PIN)) {
+      DataAcctBalance(tag.uid, &balance);
+      DataParkDetails(tag.uid, &space, &time);
+
+      pick = (unsigned int) (rand() % 100);
+      if (pick < LOADGEN_MIX_PARK) {
+        if ((time <= 0) || (rand() % 2))  /* else extend the running space */
+          space = 1 + (uint32_t) rand() % 9999;
+        time = (1 + rand() % 8) * 15 * 60;
+        DataParkPay(tag.uid, space, &time);
+        DataAlertPark(space, time / 60);
+      } else if (pick < LOADGEN_MIX_PARK + LOADGEN_MIX_TOPUP) {
+        memset(&topup, 0, sizeof(topup));
+        LoadUid(topup.uid, BACKEND_UID_TOPUP, (uint32_t) rand() % accounts);
+        if (DataCardValidate(&topup) == CARD_TOPUP)
+          DataAcctRecharge(tag.uid, topup.uid, &value);
+      }
+    }
+  }
+
+  if (measuring) {
+    load_record r;
+    r.kind = KIND_SESSIONS;
+    r.ok = session_ok;
+    r.us = (uint32_t) (LoadClock() - began);
+    if (write(pipe_out, &r, sizeof(r)) != sizeof(r))
+      exit(EXIT_FAILURE);
+  }
+}
+
+
+/*
+ * LoadTerminal
+ * Description: Run a virtual terminal, in its own process, till the
+ *              measured time is over.
+ *
+ * Arguments:   seed - seed for its sessions
+ * Return:      None; exits with EXIT_FAILURE if it can't start up
+ */
+static void LoadTerminal(unsigned int seed)
+{
+  uint64_t now;
+
+  srand(seed);
+  boot = LoadClock();
+  TariffInit();                       /* start up like main.c */
+  DenylistInit();
+  DataInit();
+  while (!DataReady()) {
+    DataPoll();
+    if (LoadClock() >= start) {
+      fprintf(stderr, "loadgen: terminal couldn't reach the server\n");
+      exit(EXIT_FAILURE);
+    }
+    LoadSleep(10);
+  }
+  DataPoll();                         /* first background checks */
+
+  now = LoadClock();                  /* wait for the others */
+  if (now < start)
+    LoadSleep((uint32_t) ((start - now) / 1000));
+  measuring = TRUE;
+
+  while (LoadClock() < deadline) {
+    LoadSession();
+    DataPoll();
+    if (think != 0)                   /* 0 to 2x the mean */
+      LoadSleep((uint32_t) rand() % (2*think + 1));
+  }
+  exit(EXIT_SUCCESS);
+}
+
+
+static void LoadAdd(const load_record *r)
+{
+  uint8_t kinds_hit[2];
+  uint32_t bucket = r->us / LOADGEN_BUCKET_US;
+  unsigned int i;
+
+  if (r->kind >= NUM_KINDS)
+    return;
+  kinds_hit[0] = r->kind;
+  kinds_hit[1] = (r->kind == KIND_SESSIONS) ? KIND_SESSIONS : KIND_REQUESTS;
+  if (bucket >= LOADGEN_BUCKETS)
+    bucket = LOADGEN_BUCKETS - 1;
+
+  for (i = 0; i < ((kinds_hit[0] == kinds_hit[1]) ? 1u : 2u); i++) {
+    stats[kinds_hit[i]].count++;
+    if (!r->ok)
+      stats[kinds_hit[i]].failed++;
+    if (r->us > stats[kinds_hit[i]].max)
+      stats[kinds_hit[i]].max = r->us;
+    hist[kinds_hit[i]][bucket]++;
+  }
+}
+
+
+/*
+ * LoadPercentile
+ * Description: Get a latency percentile of a kind of record, in ms.
+ *
+ * Operation:   The latency is the top of the histogram bucket the percentile
+ *              falls in, so it's at most LOADGEN_BUCKET_US over.
+ */
+static double LoadPercentile(uint8_t kind, unsigned int percent)
+{
+  uint32_t target = (uint32_t) (((uint64_t) stats[kind].count * percent + 99)
+                                / 100);
+  uint32_t seen = 0;
+  uint32_t i;
+
+  for (i = 0; i < LOADGEN_BUCKETS - 1; i++) {
+    seen += hist[kind][i];
+    if (seen >= target)
+      break;
+  }
+  if (i == LOADGEN_BUCKETS - 1)       /* in the overflow bucket */
+    return stats[kind].max / 1000.0;
+  return (i + 1) * LOADGEN_BUCKET_US / 1000.0;
+}
+
+
+static void LoadReport(unsigned int terminals, unsigned int seconds)
+{
+  uint8_t k;
+
+  printf("%u terminals, %u s: %lu sessions (%.1f/s), %lu requests (%.1f/s), "
+         "%lu failed\n\n", terminals, seconds,
+         (unsigned long) stats[KIND_SESSIONS].count,
+         (double) stats[KIND_SESSIONS].count / seconds,
+         (unsigned long) stats[KIND_REQUESTS].count,
+         (double) stats[KIND_REQUESTS].count / seconds,
+         (unsigned long) stats[KIND_REQUESTS].failed);
+  printf("%-20s %9s %7s %9s %8s %8s %8s %8s\n", "", "count", "failed",
+         "per s", "p50 ms", "p90 ms", "p99 ms", "max ms");
+  for (k = 0; k < NUM_KINDS; k++) {
+    if (stats[k].count == 0)
+      continue;
+    printf("%-20s %9lu %7lu %9.1f %8.2f %8.2f %8.2f %8.2f\n", kinds[k],
+           (unsigned long) stats[k].count, (unsigned long) stats[k].failed,
+           (double) stats[k].count / seconds, LoadPercentile(k, 50),
+           LoadPercentile(k, 90), LoadPercentile(k, 99),
+           stats[k].max / 1000.0);
+  }
+}
+
+
+/*
+ * LoadRecord
+ * Description: Note a request's outcome and latency, once the measured time
+ *              has started, by sending it up the pipe to the report.
+ *
+ * Arguments:   url - path on the server
+ *              us - latency
+ *              ok - (bool) the request succeeded
+ * Return:      None
+ *
+ * Shared:      session_ok [modified]
+ */
+void LoadRecord(const char *url, uint32_t us, uint8_t ok)
+{
+  load_record r;
+
+  if (!ok)
+    session_ok = FALSE;
+  if (!measuring)
+    return;
+
+  for (r.kind = 0; (r.kind < KIND_REQUESTS) &&
+         (strcmp(kinds[r.kind], url) != 0); r.kind++)
+    continue;
+  if (r.kind == KIND_REQUESTS)        /* not one of data.c's URLs */
+    return;
+  r.ok = ok;
+  r.us = us;
+  if (write(pipe_out, &r, sizeof(r)) != sizeof(r))
+    exit(EXIT_FAILURE);               /* report is gone */
+}
+
+
+uint32_t HostNow(void)
+{
+  return (uint32_t) ((LoadClock() - boot) / 1000);
+}
+
+
+void HostTransition(uint8_t state)
+{
+  (void) state;
+}
+
+
+int main(int argc, char *argv[])
+{
+  load_record buf[512];
+  unsigned int terminals = LOADGEN_TERMINALS;
+  unsigned int seconds = LOADGEN_SECONDS;
+  unsigned int seed = 1;
+  unsigned int port = BACKEND_PORT;
+  const char *addr = "127.0.0.1";
+  unsigned int i, dead = 0;
+  int pipe_fds[2];
+  int opt, status;
+  size_t have = 0, n;
+  ssize_t got;
+  pid_t pid;
+
+  while ((opt = getopt(argc, argv, "n:d:w:a:h:p:s:")) != -1) {
+    switch (opt) {
+    case 'n': terminals = (unsigned int) strtoul(optarg, NULL, 10); break;
+    case 'd': seconds = (unsigned int) strtoul(optarg, NULL, 10);   break;
+    case 'w': think = (unsigned int) strtoul(optarg, NULL, 10);     break;
+    case 'a': accounts = (uint32_t) strtoul(optarg, NULL, 10);      break;
+    case 'h': addr = optarg;                                        break;
+    case 'p': port = (unsigned int) strtoul(optarg, NULL, 10);      break;
+    case 's': seed = (unsigned int) strtoul(optarg, NULL, 10);      break;
+    default:
+      fprintf(stderr, "usage: %s [-n terminals] [-d seconds] [-w think ms] "
+              "[-a accounts] [-h address] [-p port] [-s seed]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if ((terminals == 0) || (terminals > LOADGEN_TERMINALS_MAX) ||
+      (seconds == 0) || (accounts == 0) ||
+      (accounts > BACKEND_ACCOUNTS_MAX)) {
+    fprintf(stderr, "%s: need 1 to %u terminals, 1 to %lu accounts, and a "
+            "time\n", argv[0], LOADGEN_TERMINALS_MAX,
+            (unsigned long) BACKEND_ACCOUNTS_MAX);
+    return EXIT_FAILURE;
+  }
+
+  NetServer(addr, (uint16_t) port);
+  if (pipe(pipe_fds) < 0) {
+    perror("pipe");
+    return EXIT_FAILURE;
+  }
+  start = LoadClock() + LOADGEN_WARMUP_MS*1000UL;
+  deadline = start + seconds*1000000UL;
+
+  fflush(stdout);
+  for (i = 0; i < terminals; i++) {   /* start the terminals */
+    pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+      close(pipe_fds[0]);
+      pipe_out = pipe_fds[1];
+      LoadTerminal(seed*LOADGEN_TERMINALS_MAX + i);
+    }
+  }
+  close(pipe_fds[1]);
+
+  while ((got = read(pipe_fds[0], (char *) buf + have,
+                     sizeof(buf) - have)) != 0) {
+    if (got < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("read");
+      return EXIT_FAILURE;
+    }
+    have += got;                      /* add whole records, keep the rest */
+    for (n = 0; n < have / sizeof(buf[0]); n++)
+      LoadAdd(&buf[n]);
+    memmove(buf, &buf[n], have - n*sizeof(buf[0]));
+    have -= n*sizeof(buf[0]);
+  }
+
+  while (wait(&status) > 0)           /* all terminals are done */
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+      dead++;
+
+  LoadReport(terminals, seconds);
+  if (dead != 0)
+    printf("%u terminals failed\n", dead);
+  return ((dead == 0) && (stats[KIND_REQUESTS].failed == 0)) ?
+    EXIT_SUCCESS : EXIT_FAILURE;
+}
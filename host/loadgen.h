@@ -0,0 +1,60 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            LOADGEN.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the header file for loadgen.c, the multi-terminal load generator,
+ *  and for sim5218_net.c, the version of sim5218.c it runs data.c on, which
+ *  sends each request to a real server over a TCP socket.
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * LOADGEN CONSTANTS
+ * --------------------------------------
+ */
+#define LOADGEN_TERMINALS 200         /* default virtual terminals */
+#define LOADGEN_TERMINALS_MAX 1000    /* most virtual terminals */
+#define LOADGEN_SECONDS   10          /* default s to measure for */
+#define LOADGEN_WARMUP_MS 1000        /* ms for terminals to start up in */
+#define LOADGEN_TIMEOUT_MS 5000       /* ms to wait for a response */
+
+/* latency histograms */
+#define LOADGEN_BUCKET_US 10          /* us each bucket covers */
+#define LOADGEN_BUCKETS   100000      /* buckets: up to 1 s, the last holds */
+                                      /* anything longer */
+
+/* session mix, in percent of sessions by a known EasyCard */
+#define LOADGEN_MIX_PARK  50          /* pay for parking */
+#define LOADGEN_MIX_TOPUP 15          /* recharge with an EasyTopup card */
+                                      /* (the rest just check the balance) */
+#define LOADGEN_UNKNOWN   2           /* percent of taps by unknown cards */
+#define LOADGEN_WRONG_PIN 5           /* percent of PINs mistyped first */
+
+
+/* --------------------------------------
+ * LOADGEN FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* server the virtual 3G module connects to (sim5218_net.c) */
+extern void NetServer(const char *addr, uint16_t port);
+
+/* note a request's outcome and latency, from sim5218_net.c (loadgen.c) */
+extern void LoadRecord(const char *url, uint32_t us, uint8_t ok);
+
+
+#endif                                                           /* LOADGEN_H */
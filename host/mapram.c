@@ -0,0 +1,397 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             MAPRAM.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This makes diag_ram.h, the static RAM each firmware module uses, from the
+ *  map file the HI-TECH linker writes. diag.c reports it, so the figures are
+ *  what was linked, not what each module says it uses.
+ *
+ *  The map lists the psects of each object file as
+ *    <object>  <psect>  <link>  <load>  <length>  <selector>  <space>  [scale]
+ *  with the rest of an object's psects on lines of their own, less the
+ *  object, and all numbers in hex. That list ends at the TOTAL table. A
+ *  module's static RAM is the length of its psects in data space, less its
+ *  compiled stack (cstack*): the linker overlays that between modules by
+ *  the call graph, so it isn't any one module's.
+ *
+ *  Usage: mapram <map file> [header]
+ *  where the header defaults to ../diag_ram.h. It is the firmware build's
+ *  post-build step (see README.md). The header is only rewritten if its
+ *  figures changed, and then it says so: build again to link the new table
+ *  in. The table is in program memory, so that leaves the RAM it describes
+ *  as it was, and the second run finds nothing to change. The exit status
+ *  is non-zero if the map couldn't be read or had no psect list.
+ *
+ * Table of Contents:
+ *   (local)
+ *   IsHex         - is a string a hex number?
+ *   ModuleName    - get a module's name from its object file
+ *   ModuleAdd     - add a psect's length to a module
+ *   MapRead       - read the modules' data psects from a map file
+ *   HeaderWrite   - write diag_ram.h
+ *   SameFile      - do two files hold the same bytes?
+ *
+ *   (public)
+ *   main          - make diag_ram.h from a map file
+ *
+ * Limitations:
+ *   The per-module figures need an object file per module. If the whole
+ *   program is compiled into one object, it is listed as the one module and
+ *   only the total means much.
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Rewrite the header only if it
+ *                                          changed, as a post-build step
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+
+#define MAPRAM_MODULES     64      /* most modules in a map */
+#define MAPRAM_NAME_SIZE   16      /* chars in a module name, + NULL */
+#define MAPRAM_LINE_SIZE   256     /* chars in a map line, + NULL */
+#define MAPRAM_TOKENS      8       /* most fields on a psect line */
+#define MAPRAM_SPACE_DATA  1       /* space of PIC18 data memory */
+#define MAPRAM_CSTACK      "cstack" /* compiled stack psect prefix */
+#define MAPRAM_NEW         ".new"   /* suffix of the header being written */
+
+typedef struct {
+  char name[MAPRAM_NAME_SIZE];     /* object file, less directory and type */
+  unsigned long bytes;             /* length of its data space psects */
+} mapram_module;
+
+
+/* shared variables have to be local to this file */
+static mapram_module modules[MAPRAM_MODULES];
+static int numModules;
+
+
+/*
+ * IsHex
+ * Description: Is a string a hex number?
+ *
+ * Arguments:   s - string
+ * Return:      1 if it's all hex digits, else 0
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int IsHex(const char *s)
+{
+  if (*s == '\0')
+    return 0;
+  for (; *s != '\0'; s++) {
+    if (!isxdigit((unsigned char) *s))
+      return 0;
+  }
+  return 1;
+}
+
+
+/*
+ * ModuleName
+ * Description: Get a module's name from its object file's path
+ *
+ * Arguments:   name - module name [modified]
+ *              obj  - object file, e.g. build/data.obj or data.p1
+ * Return:      None
+ *
+ * Operation:   Drop everything up to the last / or \, and from the last '.'.
+ *              Long names are cut to fit.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void ModuleName(char *name, const char *obj)
+{
+  const char *start = obj;
+  const char *end;
+  size_t len;
+
+  for (; *obj != '\0'; obj++) {
+    if ((*obj == '/') || (*obj == '\\'))
+      start = obj + 1;
+  }
+  end = strrchr(start, '.');
+  len = (end != NULL) ? (size_t) (end - start) : strlen(start);
+  if (len >= MAPRAM_NAME_SIZE)
+    len = MAPRAM_NAME_SIZE - 1;
+  memcpy(name, start, len);
+  name[len] = '\0';
+}
+
+
+/*
+ * ModuleAdd
+ * Description: Add a psect's length to a module, adding the module if it's
+ *              new.
+ *
+ * Arguments:   name  - module name
+ *              bytes - psect length
+ * Return:      0 on success, -1 if there are too many modules
+ *
+ * Shared:      modules, numModules [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int ModuleAdd(const char *name, unsigned long bytes)
+{
+  int i;
+
+  for (i = 0; i < numModules; i++) {
+    if (strcmp(modules[i].name, name) == 0) {
+      modules[i].bytes += bytes;
+      return 0;
+    }
+  }
+  if (numModules == MAPRAM_MODULES)
+    return -1;
+  strcpy(modules[numModules].name, name);
+  modules[numModules].bytes = bytes;
+  numModules++;
+  return 0;
+}
+
+
+/*
+ * MapRead
+ * Description: Read the length of each module's data space psects from a
+ *              map file
+ *
+ * Arguments:   fp - map file
+ * Return:      0 on success, -1 if it had no psect list or too many modules
+ *
+ * Operation:   Skip to the psect list's heading (the first line with Link,
+ *              Load, Length and Space in it), then read psect lines till
+ *              the TOTAL table. A line is an object's first psect if its 2nd
+ *              field isn't a number; psect names always have a non-hex
+ *              letter in them. Lines of any other form are skipped.
+ *
+ * Shared:      modules, numModules [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int MapRead(FILE *fp)
+{
+  char line[MAPRAM_LINE_SIZE];
+  char name[MAPRAM_NAME_SIZE] = "";
+  char *tok[MAPRAM_TOKENS + 1];
+  int listed = 0;
+  int n, first;
+
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (!listed) {
+      listed = (strstr(line, "Link") != NULL) &&
+               (strstr(line, "Load") != NULL) &&
+               (strstr(line, "Length") != NULL) &&
+               (strstr(line, "Space") != NULL);
+      continue;
+    }
+
+    n = 0;
+    tok[n] = strtok(line, " \t\r\n");
+    while ((tok[n] != NULL) && (n < MAPRAM_TOKENS))
+      tok[++n] = strtok(NULL, " \t\r\n");
+    if (n == 0)
+      continue;
+    if (strcmp(tok[0], "TOTAL") == 0)
+      break;
+
+    first = (n >= 7) && !IsHex(tok[1]); /* <object> <psect> ... */
+    if (first)
+      ModuleName(name, tok[0]);
+    if ((n - first < 6) || (name[0] == '\0') ||
+        !IsHex(tok[first + 1]) || !IsHex(tok[first + 3]) ||
+        !IsHex(tok[first + 5]))
+      continue;                         /* not a psect line */
+
+    if ((strtoul(tok[first + 5], NULL, 16) == MAPRAM_SPACE_DATA) &&
+        (strncmp(tok[first], MAPRAM_CSTACK, strlen(MAPRAM_CSTACK)) != 0) &&
+        (ModuleAdd(name, strtoul(tok[first + 3], NULL, 16)) != 0))
+      return -1;
+  }
+
+  return listed ? 0 : -1;
+}
+
+
+/*
+ * HeaderWrite
+ * Description: Write diag_ram.h with the modules read, leaving out any
+ *              without static RAM.
+ *
+ * Arguments:   fp  - header file
+ *              map - map file's name, for the header's description
+ * Return:      None
+ *
+ * Shared:      modules, numModules [read only]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void HeaderWrite(FILE *fp, const char *map)
+{
+  unsigned long total = 0;
+  int count = 0;
+  int i;
+
+  for (i = 0; i < numModules; i++) {
+    if (modules[i].bytes > 0) {
+      total += modules[i].bytes;
+      count++;
+    }
+  }
+
+  fputs("/*\n"
+        " * ----------------------------------------------------------------"
+        "-------------\n"
+        " * -----                            DIAG_RAM.H                    "
+        "         -----\n"
+        " * -----                             EASYPAY                      "
+        "         -----\n"
+        " * ----------------------------------------------------------------"
+        "-------------\n"
+        " *\n", fp);
+  fprintf(fp,
+          " * File Description:\n"
+          " *   This is the static RAM of each module as linked, for diag.c"
+          " only.\n"
+          " *   It was made by host/mapram from %s; don't edit it.\n"
+          " */\n"
+          "\n"
+          "#ifndef DIAG_RAM_H\n"
+          "#define DIAG_RAM_H\n"
+          "\n", map);
+  fprintf(fp,
+          "#define DIAG_RAM_MODULES  %d\n"
+          "#define DIAG_RAM_TOTAL    %lu\n"
+          "\n"
+          "static const diag_ram diagRam[DIAG_RAM_MODULES + 1] = {\n",
+          count, total);
+  for (i = 0; i < numModules; i++) {
+    if (modules[i].bytes > 0)
+      fprintf(fp, "  {\"%s\", %lu},\n", modules[i].name, modules[i].bytes);
+  }
+  fprintf(fp,
+    "  {\"\", 0}                                       /* end */\n"
+    "};\n"
+    "\n"
+    "\n"
+    "#endif                                                      "
+    "    /* DIAG_RAM_H */\n");
+}
+
+
+/*
+ * SameFile
+ * Description: Do two files hold the same bytes?
+ *
+ * Arguments:   a, b - file names
+ * Return:      1 if both can be read and are the same, else 0
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int SameFile(const char *a, const char *b)
+{
+  FILE *fa, *fb;
+  int ca, cb;
+
+  if ((fa = fopen(a, "rb")) == NULL)
+    return 0;
+  if ((fb = fopen(b, "rb")) == NULL) {
+    fclose(fa);
+    return 0;
+  }
+  do {
+    ca = getc(fa);
+    cb = getc(fb);
+  } while ((ca == cb) && (ca != EOF));
+  fclose(fa);
+  fclose(fb);
+  return (ca == cb);
+}
+
+
+/*
+ * main
+ * Description: Make diag_ram.h from a map file
+ *
+ * Arguments:   argc, argv - map file, and optionally the header to write
+ * Return:      0 on success, else 1
+ *
+ * Operation:   Write the header next to the old one, then replace the old
+ *              one with it only if they differ, so an unchanged table doesn't
+ *              make the next build recompile diag.c.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Only replace a changed header
+ */
+int main(int argc, char *argv[])
+{
+  const char *header = "../diag_ram.h";
+  char temp[FILENAME_MAX];
+  FILE *fp;
+  int status;
+
+  if ((argc < 2) || (argc > 3)) {
+    fprintf(stderr, "usage: %s <map file> [header]\n", argv[0]);
+    return 1;
+  }
+  if (argc == 3)
+    header = argv[2];
+
+  if ((fp = fopen(argv[1], "r")) == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+  status = MapRead(fp);
+  fclose(fp);
+  if (status != 0) {
+    fprintf(stderr, "%s: no psect list, or too many modules\n", argv[1]);
+    return 1;
+  }
+
+  if (strlen(header) + strlen(MAPRAM_NEW) >= sizeof(temp)) {
+    fprintf(stderr, "%s: name too long\n", header);
+    return 1;
+  }
+  strcpy(temp, header);
+  strcat(temp, MAPRAM_NEW);
+  if ((fp = fopen(temp, "w")) == NULL) {
+    perror(temp);
+    return 1;
+  }
+  HeaderWrite(fp, argv[1]);
+  if (fclose(fp) != 0) {
+    perror(temp);
+    remove(temp);
+    return 1;
+  }
+
+  if (SameFile(temp, header)) {
+    remove(temp);
+    printf("%s is up to date\n", header);
+  } else if ((remove(header), rename(temp, header)) != 0) {
+    perror(header);
+    remove(temp);
+    return 1;
+  } else {
+    printf("%s changed: build again to link it in\n", header);
+  }
+
+  return 0;
+}
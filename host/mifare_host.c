@@ -0,0 +1,95 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          MIFARE_HOST.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of mifare.c (the SL032 reader) for the host build. The reader's
+ *  field holds whatever card the session script taps, till it leaves.
+ *  smartcard.c runs as is on top of it.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../mifare.h"
+#include "host.h"
+
+/* shared variables have to be local to this file */
+static uint8_t fieldUid[7];           /* UID of card in the field */
+static uint8_t inField;               /* (bool) a card is in the field */
+static uint8_t tapped;                /* (bool) reader hasn't seen it yet */
+
+
+void MifareStartTimer(unsigned int ms)
+{
+  (void) ms;
+}
+
+
+void MifareTimerISR(void)
+{
+}
+
+
+void MifareRttInit(void)
+{
+}
+
+
+void MifareTagInit(mifare_tag *tag)
+{
+  memset(tag, 0, sizeof(*tag));
+}
+
+
+int MifareDetect(mifare_tag *tag)
+{
+  if (!inField)
+    return FAIL;
+
+  memcpy(tag->uid, fieldUid, sizeof(fieldUid));
+  tag->active = TRUE;
+  if (tapped) {                       /* first select of a tapped card */
+    tapped = FALSE;
+    HostInput("tap");
+  }
+  return SUCCESS;
+}
+
+
+int MifareRats(mifare_tag *tag)
+{
+  return (inField && (memcmp(tag->uid, fieldUid, sizeof(fieldUid)) == 0)) ?
+    SUCCESS : FAIL;
+}
+
+
+int MifarePresent(mifare_tag *tag)
+{
+  return MifareRats(tag);
+}
+
+
+int MifareDisconnect(mifare_tag *tag)
+{
+  tag->active = FALSE;
+  return SUCCESS;
+}
+
+
+void HostCardEnter(const uint8_t *uid)
+{
+  memcpy(fieldUid, uid, sizeof(fieldUid));
+  inField = TRUE;
+  tapped = TRUE;
+}
+
+
+void HostCardLeave(void)
+{
+  inField = FALSE;
+}
@@ -0,0 +1,78 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          RESTART_HOST.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of restart.c for the host build. Every run is a cold start.
+ *  StateDriver records each state change here right after showing it, which
+ *  is where the simulator measures it.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added RestartSetDataInit and
+ *                                          RestartDataInit
+ */
+
+#include "../general.h"
+#include "../restart.h"
+#include "host.h"
+
+/* shared variables have to be local to this file */
+static uint8_t modemReady;         /* (bool) 3G module is up and idle */
+static uint8_t dataInit;           /* (bool) data module's state is set up */
+
+
+void RestartInit(void)
+{
+}
+
+
+uint8_t RestartIsWarm(void)
+{
+  return FALSE;
+}
+
+
+void RestartSetModem(uint8_t ready)
+{
+  modemReady = ready;
+}
+
+
+uint8_t RestartModemReady(void)
+{
+  return modemReady;
+}
+
+
+void RestartSetDataInit(uint8_t done)
+{
+  dataInit = done;
+}
+
+
+uint8_t RestartDataInit(void)
+{
+  return dataInit;
+}
+
+
+void RestartSetUid(const uint8_t *uid)
+{
+  (void) uid;
+}
+
+
+void RestartSetState(uint8_t state)
+{
+  HostTransition(state);
+}
+
+
+uint8_t RestartSession(uint8_t *uid)
+{
+  (void) uid;
+  return 0;                        /* STATE_WELCOME */
+}
@@ -0,0 +1,81 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                           RTCC_HOST.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of rtcc.c for the host build. Uptime is the virtual clock, and
+ *  the wall clock is set from the stub server's time like the RTCC is.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../datetime.h"
+#include "../rtcc.h"
+#include "host.h"
+
+/* shared variables have to be local to this file */
+static uint32_t offset;            /* wall clock minus uptime */
+static uint32_t syncStamp;         /* uptime when the clock was last set */
+static uint8_t synced;             /* (bool) wall clock has been set */
+
+
+void RtccInit(void)
+{
+  synced = FALSE;                  /* a power-on reset */
+}
+
+
+void RtccISR(void)
+{
+}
+
+
+uint32_t RtccUptime(void)
+{
+  return HostNow() / 1000;
+}
+
+
+uint32_t RtccNow(void)
+{
+  return synced ? (RtccUptime() + offset) : 0;
+}
+
+
+uint8_t RtccSynced(void)
+{
+  return synced;
+}
+
+
+void RtccSync(uint32_t epoch)
+{
+  if (epoch < DATETIME_EPOCH_MIN)
+    return;
+
+  offset = epoch - RtccUptime();
+  syncStamp = RtccUptime();
+  synced = TRUE;
+}
+
+
+uint32_t RtccSyncAge(void)
+{
+  return synced ? (RtccUptime() - syncStamp) : RTCC_NEVER;
+}
+
+
+uint16_t RtccMinuteOfDay(void)
+{
+  uint32_t local;
+
+  if (!synced)
+    return RTCC_DEFAULT_MINUTE;
+
+  local = RtccNow() + 60UL*RTCC_UTC_OFFSET;
+  return (uint16_t) ((local % DATETIME_DAY_SECS) / 60);
+}
@@ -0,0 +1,205 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          SIM5218_HOST.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of sim5218.c for the host build. The 3G module is up at once,
+ *  and HTTP requests go to a stub server: the session script gives it a
+ *  response for each URL, and it answers after a round trip time on the
+ *  virtual clock. Every request is counted with the bytes of its request
+ *  line and of the JSON body the real server would send back.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../general.h"
+#include "../sim5218.h"
+#include "host.h"
+
+typedef struct {                      /* a canned response */
+  char url[48];
+  http_data response;
+} host_response;
+
+/* shared variables have to be local to this file */
+static host_response server[HOST_SERVER_SIZE]; /* canned responses */
+static uint8_t responses;             /* canned responses in server */
+static uint8_t online = TRUE;         /* (bool) server can be reached */
+static uint32_t rtt = HOST_RTT_DEFAULT; /* virtual ms of a round trip */
+
+
+void SimStartTimer(unsigned int ms)
+{
+  (void) ms;
+}
+
+
+void SimTimerISR(void)
+{
+}
+
+
+void SimPowerOn(void)
+{
+}
+
+
+void SimResume(void)
+{
+}
+
+
+uint8_t SimPoll(void)
+{
+  return SIM_STATE_READY;
+}
+
+
+void SimDataInit(sim_data *module)
+{
+  memset(module->imei, '0', sizeof(module->imei));
+  memset(module->imsi, '0', sizeof(module->imsi));
+}
+
+
+int SimClock(uint32_t *epoch)
+{
+  *epoch = HostServerTime();
+  return SUCCESS;
+}
+
+
+/*
+ * SimHttp
+ * Description: Send a request to the stub server.
+ *
+ * Arguments:   method - SIM_HTTP_GET or SIM_HTTP_POST
+ *              url - path on the server
+ *              param_str - query string, or NULL
+ *              http_response - the response [modified]
+ * Return:      SUCCESS, or FAIL if the server is offline or doesn't have a
+ *              response for url
+ *
+ * Operation:   The latest response given for url is used. It comes back
+ *              with the server's time, as in a Date header.
+ */
+int SimHttp(uint8_t method, const char *url, const char *param_str,
+            http_data *http_response)
+{
+  char body[128];                     /* JSON body the server would send */
+  uint16_t tx;
+  int i;
+
+  if (!online)                        /* fails fast like an open breaker */
+    return FAIL;
+
+  tx = strlen((method == SIM_HTTP_POST) ? "POST " : "GET ") + strlen(url);
+  if (param_str)
+    tx += 1 + strlen(param_str);
+  HostDelay(rtt);
+
+  for (i = responses - 1; (i >= 0) && (strcmp(server[i].url, url) != 0); i--)
+    continue;
+  if (i < 0) {                        /* not found */
+    HostTraffic(tx, 0);
+    return FAIL;
+  }
+
+  *http_response = server[i].response;
+  http_response->date = HostServerTime();
+  sprintf(body, "{\"num1\":%lu,\"num2\":%lu,\"msg\":\"%s\",\"bool\":%s}",
+          (unsigned long) http_response->number,
+          (unsigned long) http_response->number2,
+          (const char *) http_response->message,
+          http_response->boolean ? "true" : "false");
+  HostTraffic(tx, (uint16_t) strlen(body));
+  return SUCCESS;
+}
+
+
+int SimHttpGet(const char *url, const char *param_str,
+               http_data *http_response)
+{
+  return SimHttp(SIM_HTTP_GET, url, param_str, http_response);
+}
+
+
+int SimHttpPost(const char *url, const char *param_str,
+                http_data *http_response)
+{
+  return SimHttp(SIM_HTTP_POST, url, param_str, http_response);
+}
+
+
+uint8_t SimOnline(void)
+{
+  return online;
+}
+
+
+void SimProbe(void)
+{
+}
+
+
+void SimHealthPoll(void)
+{
+}
+
+
+uint8_t SimHealth(void)
+{
+  return online ? SIM_HEALTH_GOOD : SIM_HEALTH_DOWN;
+}
+
+
+/*
+ * HostServerAdd
+ * Description: Give the stub server its response for a URL, for the session
+ *              script. It replaces any earlier one.
+ *
+ * Arguments:   url - path on the server
+ *              boolean, number, number2, message - the response
+ * Return:      SUCCESS, or FAIL if there's no room for it
+ */
+int HostServerAdd(const char *url, uint8_t boolean, uint32_t number,
+                  uint32_t number2, const char *message)
+{
+  host_response *r;
+
+  if ((responses >= HOST_SERVER_SIZE) ||
+      (strlen(url) >= sizeof(r->url)) ||
+      (strlen(message) >= sizeof(r->response.message)))
+    return FAIL;
+
+  r = &server[responses++];
+  strcpy(r->url, url);
+  r->response.boolean = boolean;
+  r->response.number = number;
+  r->response.number2 = number2;
+  strcpy((char *) r->response.message, message);
+  return SUCCESS;
+}
+
+
+void HostServerOnline(uint8_t reachable)
+{
+  online = reachable;
+}
+
+
+void HostServerRtt(uint32_t ms)
+{
+  rtt = ms;
+}
+
+
+uint32_t HostServerTime(void)
+{
+  return HOST_EPOCH_START + HostNow() / 1000;
+}
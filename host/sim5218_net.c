@@ -0,0 +1,280 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                           SIM5218_NET.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of sim5218.c for the load generator. The 3G module is a TCP
+ *  socket to a real server (e.g. backend.c), kept open like the module's
+ *  own socket transport, and requests go over it in the same frames that
+ *  SimTcpRequest sends and reads back. Each request's wall clock latency is
+ *  handed to LoadRecord.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Server time from response frames
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "../general.h"
+#include "../sim5218.h"
+#include "loadgen.h"
+
+#define NET_FRAME_SIZE  256           /* bytes kept of a response frame */
+
+/* shared variables have to be local to this file */
+static struct sockaddr_in server;     /* server's address */
+static int sock = -1;                 /* socket to server, or -1 if closed */
+static uint32_t requestId;            /* ID of the last request */
+
+
+/* functions local to this file */
+static int NetConnect(void);
+static int NetRequest(uint8_t method, const char *url, const char *param_str,
+                      http_data *http_response);
+static uint32_t NetJsonUint(const char *body, const char *key);
+
+
+static int NetConnect(void)
+{
+  int on = 1;
+
+  sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0)
+    return FAIL;
+  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  if (connect(sock, (struct sockaddr *) &server, sizeof(server)) < 0) {
+    close(sock);
+    sock = -1;
+    return FAIL;
+  }
+  return SUCCESS;
+}
+
+
+static uint32_t NetJsonUint(const char *body, const char *key)
+{
+  const char *p = strstr(body, key);
+
+  return p ? (uint32_t) strtoul(p + strlen(key), NULL, 10) : 0;
+}
+
+
+/*
+ * NetRequest
+ * Description: Send a request frame and read back the response frame with
+ *              its ID, as SimTcpRequest does.
+ *
+ * Arguments:   method - SIM_HTTP_GET or SIM_HTTP_POST
+ *              url - path on the server
+ *              param_str - parameter string, or NULL
+ *              http_response - the response [modified]
+ * Return:      SUCCESS, or FAIL if the server can't be reached, hangs up,
+ *              sends a bad frame or takes over LOADGEN_TIMEOUT_MS
+ */
+static int NetRequest(uint8_t method, const char *url, const char *param_str,
+                      http_data *http_response)
+{
+  char frame[NET_FRAME_SIZE];
+  char rx[NET_FRAME_SIZE];
+  char id_str[12];
+  struct pollfd pfd;
+  const char *body, *msg;
+  size_t rx_len = 0, len, header, i, id_len;
+  ssize_t got;
+  int n;
+
+  if ((sock < 0) && (NetConnect() < 0))
+    return FAIL;
+  if (!param_str) param_str = "";
+
+  requestId++;                        /* build and send frame */
+  id_len = sprintf(id_str, "%lu", (unsigned long) requestId);
+  if (id_len + 4 + strlen(url) + strlen(param_str) + 12 > sizeof(frame))
+    return FAIL;
+  n = sprintf(frame, "%lu\n%s %c %s %s",
+              (unsigned long) (id_len + 3 + strlen(url) + 1 +
+                               strlen(param_str)),
+              id_str, (method == SIM_HTTP_GET) ? 'G' : 'P', url, param_str);
+  if (write(sock, frame, n) != n)
+    return FAIL;
+
+  pfd.fd = sock;                      /* get the response frame with our ID */
+  pfd.events = POLLIN;
+  while (TRUE) {
+    if (poll(&pfd, 1, LOADGEN_TIMEOUT_MS) <= 0)
+      return FAIL;
+    got = read(sock, &rx[rx_len], sizeof(rx) - 1 - rx_len);
+    if (got <= 0)
+      return FAIL;
+    rx_len += got;
+
+    len = 0;                          /* get frame length */
+    for (i = 0; (i < rx_len) && (rx[i] >= '0') && (rx[i] <= '9'); i++)
+      len = 10*len + (rx[i] - '0');
+    if (i == rx_len)
+      continue;
+    if ((rx[i] != '\n') || (len == 0) || (i + 1 + len >= sizeof(rx)))
+      return FAIL;
+    header = i + 1;
+    if (rx_len < header + len)
+      continue;
+
+    rx[header + len] = '\0';
+    if ((len > id_len) && (memcmp(&rx[header], id_str, id_len) == 0) &&
+        (rx[header + id_len] == ' '))
+      break;                          /* it's our response */
+    rx_len -= header + len;           /* drop a stale one */
+    memmove(rx, &rx[header + len], rx_len);
+  }
+
+  /* parse json body */
+  body = strchr(&rx[header], '{');
+  if ((body == NULL) || (strchr(body, '}') == NULL))
+    return FAIL;
+  memset(http_response, 0, sizeof(*http_response));
+  for (i = header + id_len + 1; (rx[i] >= '0') && (rx[i] <= '9'); i++)
+    http_response->date = 10*http_response->date + (rx[i] - '0');
+  http_response->number = NetJsonUint(body, "\"num1\":");
+  http_response->number2 = NetJsonUint(body, "\"num2\":");
+  http_response->boolean = (strstr(body, "\"bool\":true") != NULL);
+  if ((msg = strstr(body, "\"msg\":\"")) != NULL) {
+    msg += strlen("\"msg\":\"");
+    for (i = 0; (msg[i] != '"') && (msg[i] != '\0') &&
+           (i < sizeof(http_response->message) - 1); i++)
+      http_response->message[i] = msg[i];
+  }
+  return SUCCESS;
+}
+
+
+void SimStartTimer(unsigned int ms)
+{
+  (void) ms;
+}
+
+
+void SimTimerISR(void)
+{
+}
+
+
+void SimPowerOn(void)
+{
+}
+
+
+void SimResume(void)
+{
+}
+
+
+uint8_t SimPoll(void)
+{
+  if ((sock < 0) && (NetConnect() < 0))
+    return SIM_STATE_BOOTING;
+  return SIM_STATE_READY;
+}
+
+
+void SimDataInit(sim_data *module)
+{
+  memset(module->imei, '0', sizeof(module->imei));
+  memset(module->imsi, '0', sizeof(module->imsi));
+}
+
+
+int SimClock(uint32_t *epoch)
+{
+  *epoch = (uint32_t) time(NULL);     /* the host's clock is network time */
+  return SUCCESS;
+}
+
+
+/*
+ * SimHttp
+ * Description: Send a request to the server, and time it.
+ *
+ * Arguments:   method - SIM_HTTP_GET or SIM_HTTP_POST
+ *              url - path on the server
+ *              param_str - parameter string, or NULL
+ *              http_response - the response [modified]
+ * Return:      SUCCESS/FAIL
+ *
+ * Operation:   After a failure the socket is closed, and the next request
+ *              opens a new one, as the module does.
+ */
+int SimHttp(uint8_t method, const char *url, const char *param_str,
+            http_data *http_response)
+{
+  struct timespec start, end;
+  int result;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  result = NetRequest(method, url, param_str, http_response);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  if ((result < 0) && (sock >= 0)) {
+    close(sock);
+    sock = -1;
+  }
+  LoadRecord(url, (uint32_t) ((end.tv_sec - start.tv_sec) * 1000000L +
+                              (end.tv_nsec - start.tv_nsec) / 1000),
+             result == SUCCESS);
+  return result;
+}
+
+
+int SimHttpGet(const char *url, const char *param_str,
+               http_data *http_response)
+{
+  return SimHttp(SIM_HTTP_GET, url, param_str, http_response);
+}
+
+
+int SimHttpPost(const char *url, const char *param_str,
+                http_data *http_response)
+{
+  return SimHttp(SIM_HTTP_POST, url, param_str, http_response);
+}
+
+
+uint8_t SimOnline(void)
+{
+  return TRUE;                        /* there's no breaker to open */
+}
+
+
+void SimProbe(void)
+{
+}
+
+
+void SimHealthPoll(void)
+{
+}
+
+
+uint8_t SimHealth(void)
+{
+  return SIM_HEALTH_GOOD;
+}
+
+
+void NetServer(const char *addr, uint16_t port)
+{
+  memset(&server, 0, sizeof(server));
+  server.sin_family = AF_INET;
+  server.sin_port = htons(port);
+  server.sin_addr.s_addr = inet_addr(addr);
+}
@@ -30,6 +30,7 @@
  *   UtilityTable        - Pay Utility Bill
  *   UtilityPowerTable   - Pay Power Bill
  *   UtilityWaterTable   - Pay Water Bill
+ *   DiagTable           - Stack and RAM Figures
  *
  *   DisplayTables       - Table of Screens [Above Tables]
  *   UpdateTable         - Table of Update functions for each state
@@ -46,6 +47,13 @@
  *
  * Revision History:
  *   Apr. 19, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Welcome tap gets user data, which
+ *                                           starts the account data prefetch
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Welcome page brings up data module
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Resume session after warm restart
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Time responses to queued keys
+ *   Oct. 17, 2026      Nnoduka Eruchalu     <#> on Welcome Page shows the
+ *                                           Diagnostics Page
  */
 
 #include <stdint.h>     /* for uint*_t */
@@ -57,6 +65,7 @@
 #include "interface.h"
 #include "eventproc.h"
 #include "lcd.h"
+#include "restart.h"
 
 /* variables local to this file */
 /* none */
@@ -336,6 +345,22 @@ static const char UtilityWaterTable[LCD_HEIGHT][LCD_WIDTH+1] = {
   "*Exit*           ~ D"  /* row 3 */
 };
 
+/*
+ * DiagTable
+ * Description: This table holds the message on the LCD on the Diagnostics
+ *              Page. Rows 1 and 2 are written in by UpdateDiag.
+ *              Note that each row has 1 extra slot for NULL-terminator.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static const char DiagTable[LCD_HEIGHT][LCD_WIDTH+1] = {
+  "-   Diagnostics    -", /* row 0 */
+  "                    ", /* row 1 */
+  "                    ", /* row 2 */
+  "*Next*~ A  *Exit*~ D"  /* row 3 */
+};
+
 
 /*
  * DisplayTables
@@ -353,6 +378,7 @@ static const char UtilityWaterTable[LCD_HEIGHT][LCD_WIDTH+1] = {
  *
  * Revision History:
  *   Apr. 21, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DiagTable
  */
 static const char (* DisplayTables[NUM_STATES])[LCD_WIDTH+1] =
 {
@@ -375,7 +401,9 @@ static const char (* DisplayTables[NUM_STATES])[LCD_WIDTH+1] =
   
   UtilityTable,          /* STATE_UTILITY         */
   UtilityPowerTable,     /* STATE_UTILITYPOWER    */
-  UtilityWaterTable      /* STATE_UTILITYWATER    */
+  UtilityWaterTable,     /* STATE_UTILITYWATER    */
+  
+  DiagTable              /* STATE_DIAG            */
 };
 
 
@@ -386,9 +414,11 @@ static const char (* DisplayTables[NUM_STATES])[LCD_WIDTH+1] =
  *
  * Revision History:
  *   Apr. 22, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added UpdateWelcome
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added UpdateDiag
  */
 static state (* const UpdateTable[NUM_STATES])(state curr_state) = {
-  NoUpdate,              /* STATE_WELCOME         */
+  UpdateWelcome,         /* STATE_WELCOME         */
   UpdatePin,             /* STATE_PIN             */
   NoUpdate,              /* STATE_HOME            */
   
@@ -407,7 +437,9 @@ static state (* const UpdateTable[NUM_STATES])(state curr_state) = {
   
   NoUpdate,              /* STATE_UTILITY         */
   NoUpdate,              /* STATE_UTILITYPOWER    */
-  NoUpdate               /* STATE_UTILITYWATER    */
+  NoUpdate,              /* STATE_UTILITYWATER    */
+  
+  UpdateDiag             /* STATE_DIAG            */
 };
 
 
@@ -420,6 +452,7 @@ static state (* const UpdateTable[NUM_STATES])(state curr_state) = {
  *
  * Revision History:
  *   Apr. 20, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added STATE_DIAG
  */
 static const state_transition StateTable[NUM_STATES][NUM_EVENTS] = {
   /* Current State = STATE_WELCOME */
@@ -438,9 +471,9 @@ static const state_transition StateTable[NUM_STATES][NUM_EVENTS] = {
     {STATE_WELCOME, NoAction},             /* <C> */
     {STATE_WELCOME, NoAction},             /* <D> */
     {STATE_WELCOME, NoAction},             /* <*> */
-    {STATE_WELCOME, NoAction},             /* <#> */
+    {STATE_DIAG, ShowDiag},                /* <#> */
     {STATE_WELCOME, NoAction},             /* other keypad keys  */
-    {STATE_PIN, ResetAction},              /* card tapped/synced */
+    {STATE_PIN, GetUserData},              /* card tapped/synced */
     {STATE_WELCOME, NoAction},             /* topup card tapped  */
     {STATE_WELCOME, NoAction}              /* other card tapped  */
   },
@@ -788,6 +821,29 @@ static const state_transition StateTable[NUM_STATES][NUM_EVENTS] = {
     {STATE_UTILITYWATER, NoAction},             /* card tapped/synced */
     {STATE_UTILITYWATER, NoAction},             /* topup card tapped  */
     {STATE_UTILITYWATER, NoAction}              /* other card tapped  */
+  },
+  
+  /* Current State = STATE_DIAG */
+  { {STATE_DIAG, NoAction},                /* <0> */
+    {STATE_DIAG, NoAction},                /* <1> */
+    {STATE_DIAG, NoAction},                /* <2> */
+    {STATE_DIAG, NoAction},                /* <3> */
+    {STATE_DIAG, NoAction},                /* <4> */
+    {STATE_DIAG, NoAction},                /* <5> */
+    {STATE_DIAG, NoAction},                /* <6> */
+    {STATE_DIAG, NoAction},                /* <7> */
+    {STATE_DIAG, NoAction},                /* <8> */
+    {STATE_DIAG, NoAction},                /* <9> */
+    {STATE_DIAG, NextDiagModule},          /* <A> */
+    {STATE_DIAG, NoAction},                /* <B> */
+    {STATE_DIAG, NoAction},                /* <C> */
+    {STATE_WELCOME, NoAction},             /* <D> */
+    {STATE_DIAG, NoAction},                /* <*> */
+    {STATE_DIAG, NoAction},                /* <#> */
+    {STATE_DIAG, NoAction},                /* other keypad keys  */
+    {STATE_DIAG, NoAction},                /* card tapped/synced */
+    {STATE_DIAG, NoAction},                /* topup card tapped  */
+    {STATE_DIAG, NoAction}                 /* other card tapped  */
   }
 };
   
@@ -957,6 +1013,12 @@ static eventcode CardLookup(void)
  * Operation:        To prevent system hanging, first check for a keypress
  *                   before trying to get a keycode. Use this keycode to index
  *                   the StateTable.
+ *                   Start where a session left off before a warm restart, and
+ *                   record every state change for the next one. Each loop
+ *                   iteration clears the watchdog.
+ *                   Keys are queued, so ones typed while an action runs are
+ *                   handled next. The time from a key press to its response
+ *                   being shown is measured.
  *
  * Error Handling:   Invalid input is ignored
  *
@@ -970,6 +1032,9 @@ static eventcode CardLookup(void)
  * Revision History:
  *   Apr. 19, 2013      Nnoduka Eruchalu     Initial Revision
  *   May  14, 2013      Nnoduka Eruchalu     Added cardtap detection
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Warm restart and watchdog support
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Time key responses
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Tell eventproc when a page is drawn
  */
 void StateDriver(void)
 {
@@ -979,12 +1044,15 @@ void StateDriver(void)
   state curr_state;            /* current sysem state        */
   state nextstate;             /* proposed next state in FSM */
   
-  curr_state = STATE_WELCOME;  /* start system on welcome page */
-  prev_state = STATE_WELCOME; 
+  curr_state = ResumeSession(); /* start on welcome page, or where a session */
+  prev_state = curr_state;      /* was before a warm restart */
   LcdWriteFill(DisplayTables[curr_state]); /* start by showing something */
+  PageShown();
 
   /* infinite loop processing input */
   while (TRUE) {
+    CLRWDT();                  /* still looping, so not hung */
+    
     /* handle updates */
     curr_state = UpdateTable[curr_state](curr_state);
     
@@ -1000,7 +1068,10 @@ void StateDriver(void)
     /* finally, if the state has changed - update display to reflect it */
     if (curr_state != prev_state) {
       LcdWriteFill(DisplayTables[curr_state]);
+      PageShown();                           /* update functions redo theirs */
+      RestartSetState(curr_state);           /* keep it for a warm restart */
     }
+    KeyShown();                /* time the response to the last key, if any */
     
     /* always remember the current status for the next loop iteration */
     prev_state = curr_state;
@@ -16,6 +16,7 @@
  *
  * Revision History:
  *   Apr. 19, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added STATE_DIAG
  */
 
 #ifndef INTERFACE_H
@@ -44,6 +45,8 @@ typedef enum {
   STATE_UTILITY,          /* select utility to pay   */
   STATE_UTILITYPOWER,     /* pay power: enter amount */
   STATE_UTILITYWATER,     /* pay water: enter amount */
+  
+  STATE_DIAG,             /* stack and RAM figures   */
     
   NUM_STATES              /* number of states        */
 } state;
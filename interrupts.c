@@ -9,7 +9,6 @@
  *
  * Table of Contents:
  *   Tmr0Init       - Initialize Timer0
- *   Tmr2Init       - Initialize Timer2
  * 
  * Assumptions:
  *   None
@@ -20,6 +19,8 @@
  * Revision History:
  *   Dec. 19, 2012      Nnoduka Eruchalu     Initial Revision
  *   Apr. 26, 2013      Nnoduka Eruchalu     Added Tmr2Init
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed Tmr2Init; the RTCC alarm
+ *                                           times events now
  */
 
 #include <htc.h>
@@ -64,48 +65,3 @@ void Tmr0Init(void)
   
   TMR0ON = 1;            /* now start the timer */
 }
-
-
-
-/*
- * Tmr2Init
- * Description: Initialize Tmr2 to generate 0.5ms periods
- *
- * Arguments:   None
- * Return:      None
- *
- * Operation:   Setup T2CON.
- *              Setup INTCON: T2IE, T2IF
- *
- * Revision History:
- *   Apr. 26, 2013      Nnoduka Eruchalu     Initial Revision
- */
-void Tmr2Init(void)
-{
-  /* configure Timer2 as follows:
-     
-     Period = 1 / [(Processor Frequency)/4] = 1 / (18.432MHz/4) = 217nS
-     PreScalar = 16
-     PR2 = 144
-     Time between Interrupts  = Period * PreScaler * PR2 = 0.5ms
-   */
-    
-  T2CKPS0 = 1;          /* prescale is divide by 16 */
-  T2CKPS1 = 1;
-  
-  T2OUTPS0 = 0;         /* postscale is 1:1 */
-  T2OUTPS1 = 0;
-  T2OUTPS2 = 0;
-  T2OUTPS3 = 0;
-  
-  PR2 = 144;
-  
-  TMR2 = 0;              /* Clear the TMR2 register */
-  
-  TMR2IF   = 0; 
-  TMR2IE   = 1;          /* enable TIMER2 overflow interrupts */
-  
-  TMR2ON = 1;            /* now start the timer */
-}
-
-
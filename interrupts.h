@@ -16,6 +16,8 @@
  * Revision History:
  *   Dec. 19, 2012      Nnoduka Eruchalu     Initial Revision
  *   Apr. 26, 2013      Nnoduka Eruchalu     Added Tmr2Init
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed Tmr2Init; the RTCC alarm
+ *                                           times events now
  */
 
 #ifndef INTERRUPTS_H
@@ -23,14 +25,10 @@
 
 /* TIMING CONSTANTS */
 #define TMR0_FREQ  1125    /* 0.8889 ms period == 1125Hz */
-#define TMR2_FREQ  2000    /* 0.5 ms period    == 2000Hz */
 
 /* FUNCTION PROTOTYPES */
 /* initialize Timer 0 */
 extern void Tmr0Init(void);
 
-/* initialize Timer 2 */
-extern void Tmr2Init(void);
-
 
 #endif                                                        /* INTERRUPTS_H */
@@ -8,34 +8,96 @@
  *   This is a library of functions for interfacing the PIC18F67K22 with a 4x4
  *   matrix keypad
  *
+ *   Debounced key presses and releases go into a queue, stamped with the
+ *   Timer0 tick they were debounced on. So keys typed while the main loop is
+ *   busy (in a HTTP request or a delay) are kept for it, in order.
+ *
+ *   Each key is debounced on its own, in about 25 ms. While no key is down the
+ *   scanner only reads the columns once a tick, with every row driven low.
+ *
  * Table of Contents:
+ *   (local)
+ *   KeyPost         - queue a key event
+ *
+ *   (public)
  *   KeypadInit      - initializes the keypad and ScanAndDebounce variables
  *   IsAKey          - checks if a fully debounced key is available
  *   GetKey          - gets a key from the keypad
+ *   GetKeyEvent     - gets the next key event, if any
+ *   KeyTicks        - gets the Timer0 ticks counted by the keypad scanner
+ *   KeyShown        - notes that the response to the last key has been shown
+ *   KeyLatencyMax   - gets the longest time from a key press to its response
  *   ScanAndDebounce - scan the keypad for keypresses and debounce the presses
  *
  * Assumptions:
  *   Hardware Hookup defined in include file.
  *
  * Limitations:
- *   - Simultaneous multiple key presses are invalid, but the program still
- *     handles them and returns key codes for them.
+ *   - Simultaneous multiple key presses each get their own key events.
  *   - Because of hardware limitations there will be ghosting and masking errors
- *   - If a key has been debounced and not processed, and another key is
- *     debounced, the first keypress will be lost.
+ *   - If KEY_QUEUE_SIZE-1 key events are waiting to be processed, further
+ *     key events are lost.
  *
  * Compiler:
  *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
  *
  * Revision History:
  *   Dec. 18, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Queue timestamped key events
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Per key debounce and idle mode
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added KeypadRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read ISR counters with READ_STABLE
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed KeypadRam; diag.c takes
+ *                                           RAM from the map file
  */
 #include "general.h"
 #include "keypad.h"
 
 /* shared variables have to be local to this file */
-static unsigned char keyDebounced;
-static volatile unsigned char keyValue;
+static key_event keyQueue[KEY_QUEUE_SIZE]; /* debounced key events */
+static volatile uint8_t keyHead;           /* next event to process */
+static volatile uint8_t keyTail;           /* next free slot */
+static volatile uint16_t keyTicks;         /* Timer0 ticks since startup */
+static uint16_t keyStamp;                  /* stamp of last key from GetKey */
+static uint8_t keyPending;                 /* (bool) keyStamp not yet shown */
+static uint16_t keyLatencyMax;             /* longest key press to response */
+static uint8_t keyScanning;                /* (bool) scanning rows, not idle */
+
+/* functions local to this file */
+static void KeyPost(unsigned char code, unsigned char type);
+
+
+/*
+ * KeyPost
+ * Description: This procedure queues a key event, stamped with the current
+ *              tick. If the queue is full, the event is dropped.
+ *
+ * Arguments:   code: key code
+ *              type: KEY_EVENT_PRESS or KEY_EVENT_RELEASE
+ * Return:      None
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Operation:   Fill in the event before moving the tail, so the main loop
+ *              never sees a half written slot. Only ScanAndDebounce calls
+ *              this, so it only runs in the ISR.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void KeyPost(unsigned char code, unsigned char type)
+{
+  uint8_t next = (keyTail + 1) & (KEY_QUEUE_SIZE - 1);
+  
+  if (next == keyHead)           /* no room: drop it */
+    return;
+  
+  keyQueue[keyTail].code = code;
+  keyQueue[keyTail].type = type;
+  keyQueue[keyTail].stamp = keyTicks;
+  keyTail = next;
+}
 
 /*
  * KeypadInit
@@ -47,21 +109,24 @@ static volatile unsigned char keyValue;
  * Input:       None
  * Output:      None
  *
- * Operation:   Put the keypad in a state of no debounced keys, by setting 
- *              keyDebounced to FALSE.
- *              Also the keyValue is set to an invalid key code.
- *              Setup keypad I/O.
- *              Start the ScanAndDebounce Timer
+ * Operation:   Put the keypad in a state of no debounced keys, by emptying
+ *              the key event queue.
+ *              Setup keypad I/O, with every row driven low for idle mode.
  *
  * Revision History:
  *   Dec. 18, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Empty the key event queue
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start in idle mode
  */
 void KeypadInit(void)
 {
-  keyDebounced = FALSE;          /* no debounced key press */
-  keyValue = NO_KEY_PRESSED;     /* start with an invalid key press */
+  keyHead = 0;                   /* no debounced key events */
+  keyTail = 0;
+  keyPending = FALSE;
+  keyLatencyMax = 0;
   KEY_TRIS = KEY_TRIS_VAL;       /* setup Rows as outputs; Cols as Inputs */
-  NO_ROW();                      /* row outputs start off inactive */
+  ALL_ROWS();                    /* idle: any key down pulls a column low */
+  keyScanning = FALSE;
 }
 
 
@@ -77,14 +142,20 @@ void KeypadInit(void)
  * Input:       None
  * Output:      None
  
- * Operation:   This function returns the value in keyDebounced
+ * Operation:   Drop key releases from the head of the queue, as GetKey only
+ *              returns presses. Then there is a key if the queue isn't empty.
  *
  * Revision History:
  *  Dec. 18, 2012      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Check the key event queue
  */
 unsigned char IsAKey(void)
 {
-  return keyDebounced;
+  while ((keyHead != keyTail) &&
+         (keyQueue[keyHead].type != KEY_EVENT_PRESS))
+    keyHead = (keyHead + 1) & (KEY_QUEUE_SIZE - 1);
+  
+  return (keyHead != keyTail);
 }
 
 
@@ -112,29 +183,142 @@ unsigned char IsAKey(void)
  * Output:      None
  *
  * Operation:   A while loop runs until IsAKey indicates that there is now a 
- *              fully debounced key. When there is a key, the keyDebounced 
- *              variable is reset and the key code is returned.
+ *              fully debounced key. When there is a key, it is taken off the
+ *              queue, its stamp is kept for KeyShown, and its code returned.
  *
  *
  * Revision History:
  *  Dec. 18, 2012      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Take key off the event queue
  */
 unsigned char GetKey(void)
 {
+  unsigned char code;
+  
   while(!IsAKey())             /* block until there is a key */
     continue;
   
-  keyDebounced = FALSE;        /* reset keypad to a state of no key */
-  return keyValue;             /* return key code */
+  code = keyQueue[keyHead].code;
+  keyStamp = keyQueue[keyHead].stamp;
+  keyPending = TRUE;           /* till its response is shown */
+  keyHead = (keyHead + 1) & (KEY_QUEUE_SIZE - 1);
+  return code;                 /* return key code */
+}
+
+
+/*
+ * GetKeyEvent
+ * Description: This gets the next key press or release event, if there is
+ *              one. It doesn't block.
+ *
+ * Arguments:   ev: key event [modified]
+ * Return:      TRUE:  ev holds the next key event
+ *              FALSE: no key event is waiting; ev is unchanged
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Operation:   Copy out the event at the head of the queue before moving the
+ *              head, so the ISR can't reuse its slot first.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+unsigned char GetKeyEvent(key_event *ev)
+{
+  if (keyHead == keyTail)      /* nothing queued */
+    return FALSE;
+  
+  *ev = keyQueue[keyHead];
+  keyHead = (keyHead + 1) & (KEY_QUEUE_SIZE - 1);
+  return TRUE;
+}
+
+
+/*
+ * KeyTicks
+ * Description: This gets the Timer0 ticks (0.889 ms) counted by the keypad
+ *              scanner, which key events are stamped with. It wraps around
+ *              after about 58 s, so only differences of it are meaningful.
+ *
+ * Arguments:   None
+ * Return:      tick count
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+uint16_t KeyTicks(void)
+{
+  uint16_t t;
+  
+  READ_STABLE(t, keyTicks);
+  
+  return t;
+}
+
+
+/*
+ * KeyShown
+ * Description: This notes that the response to the last key returned by
+ *              GetKey is now on its way to the display, and keeps the
+ *              longest key press to response time seen.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Operation:   Only the first call after a GetKey counts.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void KeyShown(void)
+{
+  uint16_t latency;
+  
+  if (!keyPending)
+    return;
+  
+  keyPending = FALSE;
+  latency = KeyTicks() - keyStamp;
+  if (latency > keyLatencyMax)
+    keyLatencyMax = latency;
+}
+
+
+/*
+ * KeyLatencyMax
+ * Description: This gets the longest time from a key press being debounced
+ *              to its response being shown, since startup.
+ *
+ * Arguments:   None
+ * Return:      latency in Timer0 ticks (0.889 ms)
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t KeyLatencyMax(void)
+{
+  return keyLatencyMax;
 }
 
 
 /*
  * ScanAndDebounce
- * Description: This scans the keypad and if a key is pressed, the key is 
- *              debounced for KEY_DEBOUNCE_TIME ms.
+ * Description: This scans the keypad and debounces every key on its own: a
+ *              key is pressed once it has read down for KEY_DEBOUNCE_TIME
+ *              ticks more than up, and released once it has read up as much.
  *              It also handles the keypad auto repeat with a repeat rate of
- *              KEY_REPEAT_TIME ms.
+ *              KEY_REPEAT_TIME ticks.
  *              This procedure is called by a timer ISR.
  *
  * Arguments:   None 
@@ -143,62 +327,90 @@ unsigned char GetKey(void)
  * Input:       Keypad (4x4 matrix keypad)
  * Output:      None
  *
- * Operation:   The function goes through each row of the keypad checking for 
- *               pressed keys.
- *              If no key has been pressed the debounce counter is reset to
- *               KEY_DEBOUNCE_TIME, the lastPortVal is set to curPortVal and the
- *               scanner goes on to the next keypad row. However if a key has 
- *               been pressed, the scanner stays on that row and does some 
- *               further checks.
- *              If the same key is being pressed, then the debouncer starts/
- *               continues debouncing the key.
- *               When a key is fully debounced, keyDebounced is set to TRUE and 
- *               the debounce counter is reloaded with KEY_REPEAT_TIME (to 
- *               enable auto repeat).
- *              The debounced key code is stored in keyValue.
- *              If a different key is being pressed when this function is called
- *               by the ISR, the debounce counter is reloaded with 
- *               (KEY_DEBOUNCE_TIME - 1). The -1 makes up for 1 lost count 
- *               during this check.
- *
- * Limitations:  - Simultaneous multiple key presses are invalid, but the 
- *                 procedure still handles them and returns key codes. 
+ * Operation:   While the keypad is idle, every row is driven low, so one read
+ *               of the columns shows if any key is down. Nothing else is done
+ *               until one is.
+ *              Then every row is scanned on each tick. Each key has an
+ *               integrator that counts up (to KEY_DEBOUNCE_TIME) on a down
+ *               read and down (to 0) on an up read. A key press event is
+ *               queued when a key's integrator reaches the top, and a key
+ *               release event when it gets back to 0.
+ *              The last key pressed repeats every KEY_REPEAT_TIME ticks while
+ *               it's held.
+ *              Once every integrator is back to 0, the keypad is idle again.
+ *              Every call counts a tick for the key event stamps.
+ *
+ * Limitations:  - Simultaneous multiple key presses each get their own key
+ *                 events.
  *               - Ghosting/Aliasing
- *               - If a key has been debounced and not processed, and another
- *                 key is debounced, the first keypress will be lost.
+ *               - If the key event queue is full, key events are lost.
  *
  * Revision History:
  *   Dec. 18, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Queue key press/release events
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Per key integrator debounce, and
+ *                                           one column read while idle
  */
 void ScanAndDebounce(void)
 {
   /* remember these are static variables: so only initialized once */
-  static unsigned char keyRow = 0; /* 0-indexed row number on the keypad */
-  static unsigned int debounceCntr = KEY_DEBOUNCE_TIME;
-  static volatile unsigned char lastPortVal;
-  static volatile unsigned char curPortVal;
+  static uint8_t integrator[KEY_NUM_ROWS*KEY_NUM_COLS]; /* per key count */
+  static uint16_t keysDown;              /* bit per debounced key held down */
+  static uint8_t repeatKey = KEY_NUM_ROWS*KEY_NUM_COLS; /* key to repeat */
+  static uint16_t repeatCntr;
+  uint8_t row;                           /* 0-indexed row number */
+  uint8_t col;                           /* 0-indexed column number */
+  uint8_t k;                             /* key index: row*KEY_NUM_COLS+col */
+  uint8_t cols;                          /* down column bits of a row */
+  uint8_t active = FALSE;                /* (bool) a key isn't settled up */
+  unsigned char code;
+  
+  keyTicks++;                            /* called on every Timer0 tick */
   
-  SET_ROW(keyRow);                    /* set the row to read from and */
-  curPortVal = KEY_PORT;              /* read in the keypad values*/
+  if (!keyScanning) {                    /* idle: every row is driven low */
+    if ((KEY_PORT & KEY_COLS_MASK) == NO_KEY_PRESSED)
+      return;                            /* still no key down */
+    keyScanning = TRUE;
+  }
   
-  /* check if a key is being pressed */
-  if ((curPortVal & KEY_COLS_MASK) == NO_KEY_PRESSED) { /* no key pressed */
-    lastPortVal = curPortVal;         /* save current port value */
-    debounceCntr = KEY_DEBOUNCE_TIME; /* reset debounce counter */
-    keyRow++; keyRow %= KEY_NUM_ROWS; /* move on to next row, don't overshoot */
+  for (row = 0, k = 0; row < KEY_NUM_ROWS; row++) {
+    SET_ROW(row);                        /* set the row to read from and */
+    cols = ~KEY_PORT & KEY_COLS_MASK;    /* read in the keys down on it */
     
-  } else {                            /* key pressed; do more checks */
-    if (lastPortVal == curPortVal) {  /* check 1: is this the same key press? */
-      if (--debounceCntr <= 0) {      /* done debouncing */
-        keyDebounced = TRUE;          /* a fully debounced key now available */
-        debounceCntr=KEY_REPEAT_TIME; /* enable key auto repeat */
-        keyValue = curPortVal;
+    for (col = 0; col < KEY_NUM_COLS; col++, k++) {
+      code = KEY_CODE(row, col);
+      
+      if (cols & (1 << (col + KEY_COLS_OFFSET))) {   /* key reads down */
+        if ((integrator[k] < KEY_DEBOUNCE_TIME) &&
+            (++integrator[k] == KEY_DEBOUNCE_TIME) &&
+            !(keysDown & (1U << k))) {
+          keysDown |= (1U << k);         /* done debouncing a press */
+          KeyPost(code, KEY_EVENT_PRESS);
+          repeatKey = k;                 /* enable key auto repeat */
+          repeatCntr = KEY_REPEAT_TIME;
+        }
+        
+      } else if ((integrator[k] > 0) &&  /* key reads up */
+                 (--integrator[k] == 0) &&
+                 (keysDown & (1U << k))) {
+        keysDown &= ~(1U << k);          /* done debouncing a release */
+        KeyPost(code, KEY_EVENT_RELEASE);
+        if (repeatKey == k)
+          repeatKey = KEY_NUM_ROWS*KEY_NUM_COLS;
       }
       
-    } else {                          /* check 2: or a different key press? */
-      lastPortVal = curPortVal;       /* save this port value, and reset cntr */
-      debounceCntr = KEY_DEBOUNCE_TIME - 1; /* accounting for a missed cnt */
-    }                                 /* end check for same key press */
-    
-  }                                   /* end check for key press */
+      if (integrator[k] > 0)
+        active = TRUE;
+      
+      if ((k == repeatKey) && (--repeatCntr == 0)) {
+        KeyPost(code, KEY_EVENT_PRESS);  /* auto repeat */
+        repeatCntr = KEY_REPEAT_TIME;
+      }
+    }
+  }
+  
+  if (!active) {                         /* every key settled up: go idle */
+    ALL_ROWS();
+    keyScanning = FALSE;
+  }
 }
@@ -20,6 +20,12 @@
  *
  * Revision History:
  *  Dec. 17, 2012      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added key event queue
+ *  Oct. 17, 2026      Nnoduka Eruchalu     25 ms per key debounce; idle mode
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added KeypadRam
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Removed KeypadRam; diag.c takes
+ *                                          RAM from the map file
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Key queue of 32 events
  */
 
 #ifndef KEYPAD_H
@@ -27,6 +33,7 @@
 
 /* library include files */
 #include <htc.h>
+#include <stdint.h>     /* for uint*_t */
 
 /* local include files*/
 #include "interrupts.h"
@@ -48,6 +55,8 @@
 #define KEY_ROWS_OFFSET    0    /* offset of row bits on PORT E:   0  or    4 */
 #define KEY_COLS_MASK      0xF0 /* mask for extracting Col bits: 0xF0 or 0x0F */
 #define KEY_NUM_ROWS       4
+#define KEY_COLS_OFFSET    4    /* offset of col bits on PORT E:   4  or    0 */
+#define KEY_NUM_COLS       4
 
 #define KEY_TRIS_VAL       0xF0 /* Row=0 --> output; Col=1 --> input */
 
@@ -55,12 +64,30 @@
 /* KEYPAD TIMING PARAMETERS 
    -- assuming Timer0
    Counting up to 1s requires counting 1/TMR0_PERIOD == TMR0_FREQ
-   so 200ms = 0.2s = 0.2 * TMR0_FREQ = TMR0_FREQ/5
+   so 25ms = 0.025s = 0.025 * TMR0_FREQ = TMR0_FREQ/40
 */
-#define KEY_DEBOUNCE_TIME  TMR0_FREQ/5  /* debounce time of 200 ms */
+#define KEY_DEBOUNCE_TIME  (TMR0_FREQ/40) /* debounce time of 25 ms */
 #define KEY_REPEAT_TIME    TMR0_FREQ    /* repeat rate of 1Hz */  
 
 
+/* KEY EVENT QUEUE */
+#define KEY_QUEUE_SIZE     32   /* size of the queue array must be 2^n; */
+                                /* a key is a press and a release, and a */
+                                /* slot stays empty: 15 keys of type-ahead */
+#if (KEY_QUEUE_SIZE & (KEY_QUEUE_SIZE - 1)) != 0
+#error KEY_QUEUE_SIZE must be a power of 2
+#endif
+
+#define KEY_EVENT_RELEASE  0    /* key event types */
+#define KEY_EVENT_PRESS    1    /* (an auto repeat is another press) */
+
+typedef struct {                /* a debounced key event */
+  unsigned char code;           /* key code (KEY_*) */
+  unsigned char type;           /* KEY_EVENT_PRESS or KEY_EVENT_RELEASE */
+  uint16_t stamp;               /* KeyTicks() when it was debounced */
+} key_event;
+
+
 /* KEYPAD CODES */
 /* The codes are designed such that the row number is in the lower bits of
    of the keypad port. The column number is contained in the higher bits.
@@ -100,10 +127,19 @@
 /* set all row bits to 1 */
 #define NO_ROW() (KEY_ROWS |= ~(KEY_COLS_MASK))  
 
+/* select every row by setting all row bits to 0 (idle mode) */
+#define ALL_ROWS() (KEY_ROWS &= KEY_COLS_MASK)
+
 /* select a row by setting its bit to 0, and all others to 1.
    - no error checking. i has to be from 0 to 3 */
 #define SET_ROW(i)  NO_ROW(); (KEY_ROWS &= (~(1<<i+KEY_ROWS_OFFSET))) 
 
+/* key code of the key on a row and column: the port value read with that row
+   selected and only that key down */
+#define KEY_CODE(row, col) \
+  ((unsigned char) ((~(1 << ((col) + KEY_COLS_OFFSET)) & KEY_COLS_MASK) | \
+                    (~(1 << ((row) + KEY_ROWS_OFFSET)) & ~KEY_COLS_MASK)))
+
 
 /* FUNCTION PROTOTYPES */
 /* initializes the keypad and ScanAndDebounce variables */
@@ -115,6 +151,18 @@ extern unsigned char IsAKey(void);
 /* Gets a key from the keypad */
 extern unsigned char GetKey(void);
 
+/* gets the next key event, if any */
+extern unsigned char GetKeyEvent(key_event *ev);
+
+/* gets the Timer0 ticks counted by the keypad scanner */
+extern uint16_t KeyTicks(void);
+
+/* notes that the response to the last key from GetKey has been shown */
+extern void KeyShown(void);
+
+/* gets the longest time (in Timer0 ticks) from a key press to its response */
+extern uint16_t KeyLatencyMax(void);
+
 /* scans the keypad for keypresses and debounces the presses */
 extern void ScanAndDebounce(void);
 
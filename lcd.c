@@ -8,14 +8,23 @@
  *   This is a library of functions for interfacing the PIC18F67K22 with a 20x4
  *   LCD (ST7066U driver) in its 8-bit databus mode
  *
+ *   Once initialized, the LCD is written through an output queue: callers
+ *   queue command and data bytes and return right away, and the Timer0 tick
+ *   sends one byte per tick. A tick (0.889ms) is longer than the 37us most
+ *   instructions take, so the busy flag isn't polled; the slow clear and home
+ *   instructions (1.52ms) hold off the queue for a few extra ticks.
+ *
  * Table of Contents:
  *   (private)
  *   GenSpecChars  - load special characters into LCD's CGRAM
+ *   LcdSend       - put a byte on the LCD's bus
+ *   LcdPut        - queue a byte for the LCD
  *
  *   (public)
  *   LcdCommand    - write a command byte to the LCD.
  *   LcdWrite      - write a data byte to the LCD.
  *   LcdWaitBF     - wait for LCD BF (Busy Flag) to be clear
+ *   LcdTimerISR   - send the next queued byte to the LCD
  *   LcdInit       - initialize the LCD
  *   LcdClear      - clear the LCD and home the cursor
  *   LcdWriteStr   - write a string of chars to the LCD
@@ -36,11 +45,18 @@
  *   May  02, 2013      Nnoduka Eruchalu     Added LcdWriteHex
  *   May  15, 2013      Nnoduka Eruchalu     LcdWriteInt argument changed:
  *                                           unsigned int32_t -> uint32_t
+ *   Oct. 17, 2026      Nnoduka Eruchalu     LcdWriteInt uses FormatUint
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Timer drained output queue
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Drain queue on the Timer0 tick
+ *   Oct. 17, 2026      Nnoduka Eruchalu     LcdWriteHex takes a uint8_t
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added LcdRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed LcdRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #include <htc.h>
-#include <stdio.h>
 #include "lcd.h"
+#include "format.h"
 
 /* tables local to this file 
  ---------------------------- */
@@ -66,15 +82,88 @@ static char NairaTable[LCD_CHAR_HEIGHT] = {
 };
 
 
+/* shared variables have to be local to this file 
+ ------------------------------------------------ */
+static uint8_t lcdQueue[LCD_QUEUE_SIZE];     /* queued bytes */
+static uint8_t lcdQueueRS[LCD_QUEUE_SIZE/8]; /* RS bit of each queued byte */
+static volatile uint8_t lcdHead;             /* next byte to send */
+static volatile uint8_t lcdTail;             /* next free slot */
+static uint8_t lcdHold;                      /* ticks left on slow command */
+static uint8_t lcdQueued;                    /* (bool) writes are queued */
+
+
 /* functions local to this file 
  ------------------------------- */
 static void GenSpecChars(void);
+static void LcdSend(unsigned char c, uint8_t rs);
+static void LcdPut(unsigned char c, uint8_t rs);
+
+
+/*
+ * LcdSend
+ * Description: This procedure puts a byte on the LCD's bus and strobes it in.
+ *              It doesn't wait for the LCD to be done with it.
+ *
+ * Argument:    c:  command or data byte
+ *              rs: LCD_RS_CMD or LCD_RS_DATA
+ * Return:      None
+ *
+ * Input:       None
+ * Output:      LCD
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void LcdSend(unsigned char c, uint8_t rs)
+{
+  LCD_DATA_LAT = c;           /* put data on output port */
+  if (rs) SET_RS();           /* RS = 1: Data */
+  else    CLEAR_RS();         /* RS = 0: Command */
+  CLEAR_RW();                 /* R/W = 0: Write */
+  LCD_STROBE();
+}
+
+
+/*
+ * LcdPut
+ * Description: This procedure queues a byte for the LCD. If the queue is
+ *              full it waits for LcdTimerISR to make room.
+ *
+ * Argument:    c:  command or data byte
+ *              rs: LCD_RS_CMD or LCD_RS_DATA
+ * Return:      None
+ *
+ * Input:       None
+ * Output:      None
+ *
+ * Operation:   Fill in the byte and its RS bit before moving the tail, so the
+ *              ISR never sees a half written slot.
+ *
+ * Assumptions: Interrupts are enabled, if more than LCD_QUEUE_SIZE-1 bytes
+ *              are queued at once.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void LcdPut(unsigned char c, uint8_t rs)
+{
+  uint8_t next = (lcdTail + 1) & (LCD_QUEUE_SIZE - 1);
+  
+  while (next == lcdHead)     /* wait for room */
+    continue;
+  
+  lcdQueue[lcdTail] = c;
+  if (rs) lcdQueueRS[lcdTail >> 3] |= (1 << (lcdTail & 7));
+  else    lcdQueueRS[lcdTail >> 3] &= ~(1 << (lcdTail & 7));
+  lcdTail = next;
+}
 
 
 /*
  * LcdCommand
  * Description: This procedure simply writes a command byte to the LCD.
- *              It does not return until the LCD's busy flag is cleared.
+ *              During LcdInit it does not return until the LCD's busy flag is
+ *              cleared. After that it queues the byte and returns.
  *
  * Argument:    c: command byte
  * Return:      None
@@ -82,25 +171,28 @@ static void GenSpecChars(void);
  * Input:       None
  * Output:      LCD
  * 
- * Operation:   Send the byte, then wait for the BF to be cleared.
+ * Operation:   Queue the byte, or send it then wait for the BF to be cleared.
  *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Queue once initialized
  */
 void LcdCommand(unsigned char c)
 {
-  LCD_DATA_LAT = c;           /* put data on output port */
-  CLEAR_RS();                 /* RS = 0: Command */
-  CLEAR_RW();                 /* R/W = 0: Write */
-  LCD_STROBE();
-  LcdWaitBF();               /* dont exit until the LCD is no longer busy */
+  if (lcdQueued) {
+    LcdPut(c, LCD_RS_CMD);
+  } else {
+    LcdSend(c, LCD_RS_CMD);
+    LcdWaitBF();              /* dont exit until the LCD is no longer busy */
+  }
 }
 
 
 /*
  * LcdWrite
  * Description: This procedure simply writes a data byte to the LCD.
- *              It does not return until the LCD's busy flag is cleared.
+ *              During LcdInit it does not return until the LCD's busy flag is
+ *              cleared. After that it queues the byte and returns.
  *
  * Argument:    c: data byte
  * Return:      None
@@ -108,18 +200,20 @@ void LcdCommand(unsigned char c)
  * Input:       None
  * Output:      LCD
  * 
- * Operation:   Send the byte, then wait for the BF to be cleared.
+ * Operation:   Queue the byte, or send it then wait for the BF to be cleared.
  *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Queue once initialized
  */
 void LcdWrite(unsigned char c)
 {
-  LCD_DATA_LAT = c;           /* put data on output port */
-  SET_RS();                   /* RS = 1: Data */
-  CLEAR_RW();                 /* R/W = 0: Write */
-  LCD_STROBE();
-  LcdWaitBF();               /* dont exit until the LCD is no longer busy */
+  if (lcdQueued) {
+    LcdPut(c, LCD_RS_DATA);
+  } else {
+    LcdSend(c, LCD_RS_DATA);
+    LcdWaitBF();              /* dont exit until the LCD is no longer busy */
+  }
 }
 
 /*
@@ -165,6 +259,51 @@ void LcdWaitBF(void)
   LCD_DATA_TRIS = 0x00;        /* and the I/O pins are set as outputs */
 }
 
+
+/*
+ * LcdTimerISR
+ * Description: This procedure sends the next queued byte to the LCD. It is
+ *              called on every Timer0 tick.
+ *
+ * Argument:    None
+ * Return:      None
+ *
+ * Input:       None
+ * Output:      LCD
+ *
+ * Operation:   If a clear or return home command is still running, count
+ *              down its hold. Else send the byte at the head of the queue, if
+ *              any. Clear and return home take 1.52ms, so they hold the queue
+ *              for LCD_SLOW_TICKS more ticks; everything else is done within
+ *              the tick.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Moved to the Timer0 tick
+ */
+void LcdTimerISR(void)
+{
+  unsigned char c;
+  uint8_t rs;
+  
+  if (lcdHold) {                     /* slow command still running */
+    lcdHold--;
+    return;
+  }
+  
+  if (lcdHead == lcdTail)            /* nothing queued */
+    return;
+  
+  c = lcdQueue[lcdHead];
+  rs = lcdQueueRS[lcdHead >> 3] & (1 << (lcdHead & 7));
+  LcdSend(c, rs);
+  
+  if (!rs && ((c == LCD_CLEAR) || ((c & 0xFE) == LCD_RET_HOME)))
+    lcdHold = LCD_SLOW_TICKS;
+  
+  lcdHead = (lcdHead + 1) & (LCD_QUEUE_SIZE - 1);
+}
+
 /*
  * LcdInit
  * Description: This initializes the LCD. This must be called before the LCD can
@@ -211,11 +350,18 @@ void LcdWaitBF(void)
  *      \|/
  *   Initialization End
  *
+ *   All this is done waiting on the LCD, then the output queue takes over.
+ *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start output queue when done
  */
 void LcdInit(void)
 {
+  lcdQueued = FALSE;           /* write directly till initialized */
+  lcdHead = lcdTail = 0;
+  lcdHold = 0;
+  
   LCD_DATA_TRIS = 0x00;        /* setup LCD IO ports as outputs */
   LCD_E_TRIS = 0;
   LCD_RW_TRIS = 0;
@@ -243,6 +389,8 @@ void LcdInit(void)
   LcdCommand(LCD_ENTRY_MD);     /* ENTRY mode set */
   
   GenSpecChars();               /* Now create some special characters */
+  
+  lcdQueued = TRUE;             /* from now on, queue writes */
 }
 
 
@@ -250,7 +398,7 @@ void LcdInit(void)
  * LcdClear
  * Description: This function clears the LCD and return the cursor to the 
  *              starting position
- *              This function doesnt return until the LCD's BF is cleared.
+ *              The output is queued, so this function returns right away.
  *
  * Arguments:   None
  * Return:      None
@@ -262,6 +410,7 @@ void LcdInit(void)
  *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Output is queued
  */
 void LcdClear(void)
 {
@@ -272,7 +421,7 @@ void LcdClear(void)
 /*
  * LcdWriteStr
  * Description: This function writes a string of characters to the LCD
- *              This function doesnt return until the LCD's BF is cleared.
+ *              The output is queued, so this function returns right away.
  *
  * Arguments:   str: string to write to LCD
  * Return:      None
@@ -285,6 +434,7 @@ void LcdClear(void)
  *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Output is queued
  */
 void LcdWriteStr(const char *str)
 {
@@ -297,7 +447,7 @@ void LcdWriteStr(const char *str)
 /*
  * LcdWriteInt
  * Description: This function writes an integer to the lcd
- *              This function doesnt return until the LCD's BF is cleared.
+ *              The output is queued, so this function returns right away.
  *
  * Arguments:   num: integer to write.
  * Return:      None
@@ -307,18 +457,18 @@ void LcdWriteStr(const char *str)
  * 
  * Operation:   Convert the integer to a string then write it to the LCD.
  *
- * Issues:      Buffer Overflow/Truncation Issues
- *
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use FormatUint, not sprintf
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Output is queued
  */
 void LcdWriteInt(uint32_t num)
 {
-  char buffer[LCD_WIDTH];   /* buffer to hold int string */
-  size_t i;
-  sprintf(buffer, "%lu", num);
+  char buffer[FORMAT_UINT_SIZE];   /* buffer to hold int string */
+  size_t i, len;
+  len = FormatUint(buffer, num);
   
-  for(i=0; ((buffer[i]!='\0') && (i<LCD_WIDTH)); i++) {
+  for(i=0; i<len; i++) {
     LcdWrite(buffer[i]);
   }  
 }
@@ -327,7 +477,7 @@ void LcdWriteInt(uint32_t num)
 /*
  * LcdWriteHex
  * Description: This function writes a hex byte to the LCD.
- *              This function doesnt return until the LCD's BF is cleared.
+ *              The output is queued, so this function returns right away.
  *
  * Arguments:   num = hex number in range [0, 255]
  * Return:      None
@@ -346,8 +496,10 @@ void LcdWriteInt(uint32_t num)
  *
  * Revision History:
  *  May  02, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Output is queued
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Argument is a uint8_t
  */
-void LcdWriteHex(unsigned int8_t num)
+void LcdWriteHex(uint8_t num)
 {
   char nibble;
   /* extract high nibble and write out numeric or alpha */
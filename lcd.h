@@ -20,6 +20,12 @@
  *   May  02, 2013      Nnoduka Eruchalu     Added LcdWriteHex
  *   May  15, 2013      Nnoduka Eruchalu     LcdWriteInt argument changed:
  *                                          unsigned int32_t -> uint32_t
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added output queue
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Drain queue on the Timer0 tick
+ *   Oct. 17, 2026      Nnoduka Eruchalu     LcdWriteHex takes a uint8_t
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added LcdRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed LcdRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #ifndef LCD_H
@@ -96,6 +102,14 @@
 #define LCD_RET_HOME  0x02     /* Return Cursor Home      */
 
 
+/* LCD Output Queue */
+#define LCD_QUEUE_SIZE  128    /* bytes queued; must be a power of 2 <= 256 */
+#define LCD_SLOW_TICKS  2      /* Timer0 ticks (0.889ms) to hold queue after */
+                               /* a clear or return home (1.52ms) */
+#define LCD_RS_CMD      0      /* queued byte is a command */
+#define LCD_RS_DATA     1      /* queued byte is data */
+
+
 /* ASCII codes for special characters in CGRAM */
 #define NAIRA_CHAR  '\x01'
 
@@ -121,6 +135,9 @@ extern void LcdWrite(unsigned char c);
 /* wait on the LCD busy flag */
 extern void LcdWaitBF(void);
 
+/* send the next queued byte to the LCD (call on every Timer0 tick) */
+extern void LcdTimerISR(void);
+
 /* initialize the LCD to some documented specs */
 extern void LcdInit(void);
 
@@ -134,7 +151,7 @@ extern void LcdWriteStr(const char *str);
 extern void LcdWriteInt(uint32_t num);
 
 /* write a hex byte to the LCD */
-extern void LcdWriteHex(unsigned uint8_t num);
+extern void LcdWriteHex(uint8_t num);
 
 /* write characters to fill all rows and columns of display */
 extern void LcdWriteFill(const char (*displaytable)[LCD_WIDTH+1]);
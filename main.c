@@ -16,6 +16,15 @@
  * Revision History:
  *   Dec. 16, 2012      Nnoduka Eruchalu     Initial Revision
  *   May  14, 2013      Nnoduka Eruchalu     Updated for demo
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Load and sync tariff table
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Drain LCD queue on Timer2
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Staged boot; modem starts in the
+ *                                           background
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Warm restart after watchdog resets
+ *   Oct. 17, 2026      Nnoduka Eruchalu     RTCC alarm replaces Timer2; LCD
+ *                                           queue drains on Timer0
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Load card denylist
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Paint the hardware stack
  */
 
 #include "general.h"
@@ -31,11 +40,14 @@
 #include "interface.h"
 #include "sim5218.h"
 #include "eventproc.h"
+#include "tariff.h"
+#include "restart.h"
+#include "rtcc.h"
+#include "denylist.h"
+#include "diag.h"
 
 
 /* POWER PIN DEFINITIONS */
-#define DATAPOWER_MCU_TRIS TRISG0
-#define DATAPOWER_MCU      LATG0
 
 #define LCDPOWER_MCU_TRIS TRISB4
 #define LCDPOWER_MCU      LATB4
@@ -86,9 +98,25 @@
  *
  * Revision History:
  *   Apr. 20, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't wait on the 3G module
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Check for a warm restart first
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the RTCC instead of Timer2
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Load the card denylist
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Paint the hardware stack for
+ *                                           DiagStackPeak
  */
 void main(void)
 {
+  /* find out if this is a warm restart (e.g. watchdog reset out of a hang),
+   * before anything is written to persistent RAM
+   */
+  RestartInit();
+  
+  /* note a stack overflow reset, and paint the unused hardware stack levels
+   * while main is still at the bottom of it and interrupts are off
+   */
+  DiagInit();
+  
   /* POWER ON THE MODULES 
    * ----------------------------
    */
@@ -98,18 +126,10 @@ void main(void)
   LCDPOWER_MCU_TRIS = 0;  /* power line is an output */
   LCDPOWER_MCU = 1;
   
-  /* 3G module (SIM5218A) power on sequence is:
-   * - DATAPOWER high
-   * - DATAPOWER low for at least 64ms
-   * - DATAPOWER high
-   * but that comes out of an inverting switch so DATAPOWER_MCU (from MCU)
-   * does exact opposite
+  /* 3G module (SIM5218A) is powered on by DataInit, once interrupts are up.
+   * It takes over 10s to start, so it's brought up in the background while the
+   * welcome page is already showing.
    */
-  DATAPOWER_MCU_TRIS = 0; /* power control is an output */
-  DATAPOWER_MCU = 0;
-  DATAPOWER_MCU = 1; __delay_s(2);
-  DATAPOWER_MCU = 0;
-  __delay_s(SIM_STARTUP_TIME);    /* wait for SIM5218A to be ready for input */
   
     
   /* INITIALIZE THE MODULES 
@@ -117,7 +137,7 @@ void main(void)
    */
   /* timer modules */
   Tmr0Init();              /* Setup Timer Event for ScanAndDebounce */
-  Tmr2Init();              /* Setup Timer Event for EventProcessors */
+  RtccInit();              /* Setup wall clock and its 1Hz alarm */
   
   /* communication modules */
   SerialInit();            /* setup serial channel 1 */
@@ -128,12 +148,17 @@ void main(void)
   CardInit();              /* setup smartcard */
   LcdInit();               /* setup lcd */
   
+  /* local tables */
+  TariffInit();            /* load parking tariffs saved in EEPROM */
+  DenylistInit();          /* load blocked cards saved in EEPROM */
+  
   /* interrupts */
   GIE = 1;    /* Enable Global and Peripheral interrupts.*/
   PEIE = 1;
   
   /* initialization routines that need interrupts */
   DataInit();  /* must be called after SerialInit2() and enabling interrupts */
+               /* returns right away; DataPoll finishes it when module's up */
   
   /* FSM loop */
   StateDriver();   /* this should never return */
@@ -170,12 +195,12 @@ void interrupt isr(void)
     ScanAndDebounce();   /* Call keypad event handler */
     MifareTimerISR();    /* Call Mifare time based event handler */
     SimTimerISR();       /* Call Sim5218's time based event handler */
+    LcdTimerISR();       /* send next queued byte to the LCD */
     TMR0IF = 0;          /* clear the flag so next overflow can be detected */
   }
 
-  /* make this light weight (i.e. only call 1 func) because it's a clock timer*/
-  if(TMR2IE && TMR2IF) { /* interrupt from Timer2 has occured */
-    EventTimer();        /* call timer for interface events */
-    TMR2IF = 0;          /* clear the flag so next overflow can be detected */
+  if(RTCCIE && RTCCIF) { /* 1Hz RTCC alarm has occured */
+    RtccISR();           /* count the second for the wall clock */
+    RTCCIF = 0;          /* clear the flag so next alarm can be detected */
   }
 }
@@ -11,10 +11,15 @@
  * Table of Contents:
  *   MifareStartTimer        - start a countdown timer with a Timer
  *   MifareTimerISR          - Timer interrupt service routine.
+ *   MifareRttInit           - start the round trip time estimates
+ *   MifareRttDone           - update an estimate after a wait
+ *   MifareRtt               - get an estimate, for telemetry
  *   MifarePutBuf            - output a buffer of bytes to the serial channel
  *   MifareGetBuf            - get a buffer of bytes from the serial channel
  *   MifareTagInit           - initialize a MIFARE DESFire tag 
  *   MifareDetect            - detect a card within range
+ *   MifareRats              - open an ISO14443-4 session with a selected card
+ *   MifarePresent           - check a card with an open session is in range
  *   MifareConnect           - establish connection to the provided tag.
  *   MifareDisconnect        - terminate connection with the provided tag
  *  
@@ -60,9 +65,18 @@
  *   May  06, 2013      Nnoduka Eruchalu     Added mifare_tag_simple struct and
  *                                           used for MifareDetect functions.
  *   May  07, 2013      Nnoduka Eruchalu     Simplified this for demo project
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added MifareRats and MifarePresent
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Starting a timer clears the
+ *                                           watchdog
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Adaptive timeouts
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added MifareRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read ISR counters with READ_STABLE
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed MifareRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #include "general.h"
+#include <htc.h>      /* for CLRWDT */
 #include <string.h>   /* for mem* operations */
 #include <stdlib.h>
 #include "mifare.h"
@@ -72,12 +86,17 @@
 /* shared variables have to be local to this file */
 static unsigned int timer;                    /* serial comm. ms time counter */
 static unsigned char timerOvertime;           /* serial comm. timeout flag */
+static rtt_est mifareRtt[MIFARE_RTT_CLASSES]; /* estimates per MIFARE_RTT_* */
 static unsigned char uartStatus;              /* SL032 uart channel status */
 static unsigned char rxBuf[MAX_FRAME_SIZE+5]; /* serial channel Rx buffer */
                                               /* +5 for SL032 comm. bytes */
 
 static uint8_t SelectCard[3] = {0xBA, 0x02, SL_SELECT_CARD};/* SL032 commands */
 static uint8_t RATSDesfire[3]= {0xBA, 0x02, SL_RATS};
+static uint8_t PresenceDesfire[4] = {0xBA, 0x03, SL_TCL, MF_GET_KEY_SETTINGS};
+
+/* local functions */
+static void MifareRttDone(uint8_t cls, uint16_t wait);
 
 
 /* SL032 specific defines */
@@ -101,14 +120,18 @@ static uint8_t RATSDesfire[3]= {0xBA, 0x02, SL_RATS};
  *
  * Operation:   Start timer countdown to passed in argument, and clear out 
  *              overtime flag, as timer hasn't timed out yet.
+ *              Waits started with a timer are bounded, so also clear the
+ *              watchdog; only a wait without one can hang long enough for it.
  *
  * Limitations: Critical code on timerOvertime
  *
  * Revision History:
  *   Dec. 30, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Clear the watchdog
  */
 void MifareStartTimer(unsigned int ms)
 {
+  CLRWDT();               /* a bounded wait is starting */
   timer = ms;             /* Start timer */
   timerOvertime = FALSE;  /* timer hasn't timed out yet */
 }
@@ -139,6 +162,76 @@ void MifareTimerISR(void)
 }
 
 
+/*
+ * MifareRttInit
+ * Description: Start the round trip time estimates of each class of wait,
+ *              with the fixed timeout they used to have.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      mifareRtt [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifareRttInit(void)
+{
+  RttInit(&mifareRtt[MIFARE_RTT_REPLY], MIFARE_TIMERCOUNT,
+          MIFARE_RTT_REPLY_MIN, 2*MIFARE_TIMERCOUNT);
+  RttInit(&mifareRtt[MIFARE_RTT_GAP], MIFARE_TIMERCOUNT,
+          MIFARE_RTT_GAP_MIN, MIFARE_TIMERCOUNT);
+}
+
+
+/*
+ * MifareRttDone
+ * Description: Update a class's round trip time estimate after a wait on the
+ *              timer.
+ *
+ * Arguments:   cls  - MIFARE_RTT_* class of the wait
+ *              wait - ms the timer was started with
+ * Return:      None
+ *
+ * Operation:   If the timer ran out, back off the class's timeout. Else the
+ *              time it took is the time used up on the timer.
+ *
+ * Shared:      mifareRtt [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+static void MifareRttDone(uint8_t cls, uint16_t wait)
+{
+  uint16_t left;
+  
+  READ_STABLE(left, timer);
+  
+  if(left == 0)
+    RttBackoff(&mifareRtt[cls]);
+  else
+    RttSample(&mifareRtt[cls], wait - left);
+}
+
+
+/*
+ * MifareRtt
+ * Description: Get the round trip time estimate of a class of wait, for
+ *              telemetry.
+ *
+ * Arguments:   cls - MIFARE_RTT_* class
+ * Return:      estimate
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+const rtt_est *MifareRtt(uint8_t cls)
+{
+  return &mifareRtt[cls];
+}
+
+
 /*
  * MifarePutBuf (through the SL032)
  * Description:
@@ -229,6 +322,9 @@ void MifarePutBuf(unsigned char *buffer, unsigned char size)
  *   number of bytes (Len + 2), where "Len" is as described above.
  *   In each iteration, set timer and wait for a timeout or a serial byte. If
  *   there is a timeout record an rx error and break from the loop.
+ *   The first wait is for the reply to start and the rest are for the gaps
+ *   between its bytes, so each uses its class's adaptive timeout instead of
+ *   a fixed MIFARE_TIMERCOUNT.
  *   If there isnt a timeout, grab a byte and compute cummulative checksum.
  *
  *   When evaluating the checksum, instead of XORing only from Preamble
@@ -250,11 +346,14 @@ void MifarePutBuf(unsigned char *buffer, unsigned char size)
  *
  * Revision History:
  *   Dec. 30, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Adaptive timeouts
  */
 void MifareGetBuf(void)
 {
   unsigned int rxCount = 0;   /* 0-index'd number of bytes received */
   unsigned char checkSum = 0; /* cummulative checksum */
+  uint8_t cls = MIFARE_RTT_REPLY; /* first wait is for the reply to start */
+  uint16_t wait;
   
   uartStatus = MF_UARTSTATUS_RXSUCC;  /* assume success for rx status */
   
@@ -264,8 +363,11 @@ void MifareGetBuf(void)
    */
   while((rxCount < 2) || ((rxCount >= 2) && (rxCount < rxBuf[1]+2))) {
     
-    MifareStartTimer(MIFARE_TIMERCOUNT); /*set timer; wait for timeout or byte*/
+    wait = RttTimeout(&mifareRtt[cls]);
+    MifareStartTimer(wait);            /* set timer; wait for timeout or byte */
     while(!SerialInRdy() && !(timerOvertime && timer == 0)); /* if a timeout  */
+    MifareRttDone(cls, wait);
+    cls = MIFARE_RTT_GAP;
     if(!SerialInRdy()) uartStatus = MF_UARTSTATUS_RXERR;     /* record error  */
         
     if(uartStatus != MF_UARTSTATUS_RXERR) {     /* if no errors grab bytes */
@@ -353,6 +455,83 @@ int MifareDetect(mifare_tag *tag)
 }
 
 
+/*
+ * MifareRats
+ * Description: Open an ISO14443-4 (T=CL) session with a card that has just
+ *              been selected by MifareDetect, by sending a Request for Answer
+ *              To Select.
+ *
+ * Arguments:   tag: PICC, as filled in by MifareDetect
+ * Return:      SUCCESS - session open; tag is now active
+ *              FAIL    - not a DESFire card or no answer to RATS
+ *
+ * Operation:   Only DESFire cards speak T=CL. Send RATS and activate the tag
+ *              if the SL032 reports success.
+ *              This is the second half of MifareConnect without repeating the
+ *              select that MifareDetect already did.
+ *
+ * Error Checking: - uart rx is successful
+ *                 - rx'd sl032 command is "Request for Answer To Select"
+ *                 - rx'd sl032 status is "operation success"
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareRats(mifare_tag *tag)
+{
+  tag->active = FALSE;                          /* no session until RATS ok */
+  if(tag->type != MIFARE_CARD_DES)
+    return FAIL;
+  
+  MifarePutBuf(RATSDesfire, sizeof(RATSDesfire)); /* send "RATS" command */
+  MifareGetBuf();                                 /* hopefully get feedback */
+  if((uartStatus == MF_UARTSTATUS_RXSUCC) && (SL032_RXCMD == SL_RATS) &&
+     (SL032_RXSTA == SL_OPERATION_SUCC)) {
+    tag->active = TRUE;
+    return SUCCESS;
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * MifarePresent
+ * Description: Check that a card with an open ISO14443-4 session is still in
+ *              the read-range of SL032.
+ *
+ * Arguments:   tag: active PICC
+ * Return:      SUCCESS - card answered; session is still open
+ *              FAIL    - card is gone (or tag has no session); tag is
+ *                        deactivated
+ *
+ * Operation:   Exchange a one byte GetKeySettings command over T=CL. Any
+ *              DESFire answer, even an error status, proves the card is there;
+ *              only a failed T=CL exchange means it left. This is a single
+ *              short exchange, compared to select + RATS for a new session.
+ *              DESFire drops authentication on error statuses, so don't use
+ *              this in the middle of an authenticated exchange.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifarePresent(mifare_tag *tag)
+{
+  if(!tag->active)
+    return FAIL;
+  
+  MifarePutBuf(PresenceDesfire, sizeof(PresenceDesfire)); /* T=CL exchange */
+  MifareGetBuf();
+  if((uartStatus == MF_UARTSTATUS_RXSUCC) && (SL032_RXCMD == SL_TCL) &&
+     (SL032_RXSTA == SL_OPERATION_SUCC)) {
+    return SUCCESS;
+  }
+  
+  tag->active = FALSE;                           /* session is lost */
+  return FAIL;
+}
+
+
 /*
  * MifareConnect
  * Description: Establish a connection to the provided PICC, by selecting the 
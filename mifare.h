@@ -26,6 +26,11 @@
  *   May  06, 2013      Nnoduka Eruchalu     Added mifare_tag_simple struct and
  *                                           used for MifareDetect functions.
  *   May  07, 2013      Nnoduka Eruchalu     Simplified this for demo project
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added MifareRats and MifarePresent
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added adaptive timeout classes
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added MifareRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed MifareRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #ifndef MIFARE_H
@@ -34,6 +39,7 @@
 /* library include files */
 #include <stdint.h>     /* for uint*_t */
 #include <stdlib.h>     /* for size_t */
+#include "rtt.h"        /* for rtt_est */
 
 
 /* --------------------------------------
@@ -42,6 +48,14 @@
  */
 #define MIFARE_TIMERCOUNT  200     /* ms to wait before communication timeout */
 
+/* adaptive timeout classes, each with its own round trip time estimate */
+#define MIFARE_RTT_REPLY      0    /* command to first byte of its reply */
+#define MIFARE_RTT_GAP        1    /* gap between bytes of a reply */
+#define MIFARE_RTT_CLASSES    2
+
+#define MIFARE_RTT_REPLY_MIN  50   /* shortest wait for a reply in ms */
+#define MIFARE_RTT_GAP_MIN    10   /* shortest wait between reply bytes */
+
 
 /* --------------------------------------
  * UART Status Words Define
@@ -78,6 +92,13 @@
 #define SL_TCL              0x21   /* Exchange Transparent Data with T=CL */
 
 
+/* --------------------------------------
+ * DESFire Commands
+ * --------------------------------------
+ */
+#define MF_GET_KEY_SETTINGS 0x45   /* get master key settings */
+
+
 /* --------------------------------------
  * SL032 Status and Error Codes 
  * --------------------------------------
@@ -171,6 +192,12 @@ extern void MifareStartTimer(unsigned int ms);
 /* interrupt service routine for a Timer */
 extern void MifareTimerISR(void);
 
+/* start the round trip time estimates */
+extern void MifareRttInit(void);
+
+/* get the round trip time estimate of a class of wait, for telemetry */
+extern const rtt_est *MifareRtt(uint8_t cls);
+
 
 /* --------------------------------------
  * SL032 specific functions
@@ -198,6 +225,12 @@ extern void MifareTagInit(mifare_tag *tag);
 /* Detect a card in the read-range of SL032 */
 extern int MifareDetect(mifare_tag *tag);
 
+/* open an ISO14443-4 session with a card selected by MifareDetect */
+extern int MifareRats(mifare_tag *tag);
+
+/* check a card with an open session is still in range */
+extern int MifarePresent(mifare_tag *tag);
+
 
 /* establish connection to the provided tag */
 extern int MifareConnect(mifare_tag *tag);
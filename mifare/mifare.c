@@ -11,7 +11,8 @@
  * Table of Contents:
  *   le16toh                 - save 16-bit little-endian data block to host
  *   le24toh                 - save 24-bit little-endian data block to host
- *   le32toh                 - save 32-bit little-endian data block to host
+ *   MifareGetLe32           - get a 32-bit little-endian value
+ *   MifarePutLe32           - put a 32-bit little-endian value
  *   MifareStartTimer        - start a countdown timer with a Timer
  *   MifareTimerISR          - Timer interrupt service routine.
  *   MifarePutBuf            - output a buffer of bytes to the serial channel
@@ -64,13 +65,20 @@
  *   MifareCreateCyclicRecordFile - create cyclic record file
  *   MifareCreateCyclicRecordFileIso
  *   MifareDeleteFile        - deactivate a file within directory of current app
+ *   MifarePrefetchFileSettings - cache settings of files ahead of their use
  *
+ *   FileSettingsCacheFlush  - drop all cached file settings of a tag
+ *   FileSettingsCacheDrop   - drop the cached settings of one file
+ *   FileSettingsCacheStore  - save a file's settings in the tag's cache
+ *   GetCachedFileSettings   - get file settings, from the cache if possible
  *   GetReadCommunicationSettings- get communication mode of a file in an app 
  *   GetWriteCommunicationSettings- get communication mode of a file in an app 
  *   ReadData                - helper function to read data and record files
  *   MifareReadData          - read data (communication mode to be derived)
  *   MifareReadDataEx        - read data files with explicit communication mode
  *   WriteData               - helper function to write data and record files
+ *   StreamFrameBytes        - add bytes to a streamed write's frame
+ *   WriteDataStreamed       - helper function for writes too big to buffer
  *   MifareWriteData         - write data (communication mode to be derived)
  *   MifareWriteDataEx       - write data files with explicit communication mode
  *   MifareGetValue          -read value file (with implicit communication mode)
@@ -130,6 +138,12 @@
  *                                           AuthenticateAes
  *  May  06, 2013      Nnoduka Eruchalu     Added mifare_tag_simple struct and
  *                                          used for MifareDetect functions.
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Cache file settings on the tag so
+ *                                          data/value commands skip the
+ *                                          GetFileSettings round trip.
+ *  Oct. 17, 2026      Nnoduka Eruchalu     MifareCommTCL sends a command once
+ *  Oct. 17, 2026      Nnoduka Eruchalu     le32toh is now the public
+ *                                          MifareGetLe32; added MifarePutLe32
  */
 
 #include <string.h>   /* for mem* operations */
@@ -144,7 +158,6 @@
 /* functions local to this file */
 static uint16_t le16toh(uint8_t data[/*2*/]);
 static uint32_t le24toh(uint8_t data[/*3*/]);
-static uint32_t le32toh(uint8_t data[/*4*/]);
 
 static int Authenticate(mifare_tag *tag, uint8_t cmd, uint8_t key_no,
                         mifare_desfire_key *key);
@@ -166,6 +179,12 @@ static int CreateFileRecord(mifare_tag *tag, uint8_t command, uint8_t file_no,
                             uint16_t access_rights, uint32_t record_size, 
                             uint32_t max_number_of_records);
 
+static void FileSettingsCacheFlush(mifare_tag *tag);
+static void FileSettingsCacheDrop(mifare_tag *tag, uint8_t file_no);
+static void FileSettingsCacheStore(mifare_tag *tag, uint8_t file_no,
+                                   mifare_desfire_file_settings *settings);
+static int GetCachedFileSettings(mifare_tag *tag, uint8_t file_no,
+                                 mifare_desfire_file_settings *settings);
 static uint8_t GetReadCommunicationSettings(mifare_tag *tag, uint8_t file_no);
 static uint8_t GetWriteCommunicationSettings(mifare_tag *tag, uint8_t file_no);
 
@@ -176,6 +195,12 @@ static int ReadData(mifare_tag *tag,  uint8_t command, uint8_t file_no,
 static int WriteData(mifare_tag *tag,  uint8_t command, uint8_t file_no, 
                      uint32_t offset, uint32_t length, uint8_t *data, 
                      size_t *data_sent, uint8_t communication_mode);
+static int StreamFrameBytes(uint8_t frame[], size_t *frame_n, 
+                            size_t *frame_cap, uint8_t bytes[], size_t n);
+static int WriteDataStreamed(mifare_tag *tag,  uint8_t command, 
+                             uint8_t file_no, uint32_t offset, 
+                             uint32_t length, uint8_t *data, 
+                             size_t *data_sent, uint8_t communication_mode);
 
 
 /* shared variables have to be local to this file */
@@ -217,16 +242,44 @@ static uint32_t le24toh(uint8_t data[/*3*/])
           ((uint32_t) data[2] << 16));
 }
 
-/* save 32-bit little endian data to host memory
- * argument is pointer to memory block
+/*
+ * MifareGetLe32
+ * Description: Get a 32-bit little endian value, as DESFire and the EasyCard
+ *              records keep them
+ *
+ * Arguments:   data - 4 bytes, LSB first
+ * Return:      value
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision, from le32toh
  */
-static uint32_t le32toh(uint8_t data[/*4*/])
+uint32_t MifareGetLe32(uint8_t data[/*4*/])
 {
   return ((uint32_t) data[0] | ((uint32_t) data[1] << 8) | 
           ((uint32_t) data[2] << 16)  | ((uint32_t) data[3] << 24));
 }
 
 
+/*
+ * MifarePutLe32
+ * Description: Put a 32-bit little endian value
+ *
+ * Arguments:   data  - 4 bytes to save value in, LSB first [modified]
+ *              value - value
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifarePutLe32(uint8_t data[/*4*/], uint32_t value)
+{
+  data[0] = (uint8_t) value;
+  data[1] = (uint8_t) (value >> 8);
+  data[2] = (uint8_t) (value >> 16);
+  data[3] = (uint8_t) (value >> 24);
+}
+
+
 /*
  * MifareStartTimer
  * Description:
@@ -464,6 +517,8 @@ void MifareGetBuf(void)
  *
  * Revision History:
  *  Jan. 2, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Send the command once, not once
+ *                                          per byte copied
  */
 int MifareCommTCL(unsigned char *buffer, unsigned char size)
 {
@@ -478,17 +533,16 @@ int MifareCommTCL(unsigned char *buffer, unsigned char size)
   
   for (i = 0; i < size; i++) {              /* copy data into command buffer*/
     comm[i+3] = buffer[i];                  /* remembering command buffer */
-                                            /* has 3 pre-appended bytes */
-    
-    MifarePutBuf(comm, size+3);             /* send T = CL command */
-    MifareGetBuf();                         /* hopefully get feedback */
-    
-    /* error checking */
-    if((uartStatus == MF_UARTSTATUS_RXSUCC) && (SL032_RXCMD == SL_TCL) &&
-       (SL032_RXSTA == SL_OPERATION_SUCC)  && 
-       ((MF_RXSTA == MF_OPERATION_OK) || (MF_RXSTA == MF_ADDITIONAL_FRAME))) {
-      success = SUCCESS;                    /* no communication error */
-    }
+  }                                         /* has 3 pre-appended bytes */
+  
+  MifarePutBuf(comm, size+3);               /* send T = CL command */
+  MifareGetBuf();                           /* hopefully get feedback */
+  
+  /* error checking */
+  if((uartStatus == MF_UARTSTATUS_RXSUCC) && (SL032_RXCMD == SL_TCL) &&
+     (SL032_RXSTA == SL_OPERATION_SUCC)  && 
+     ((MF_RXSTA == MF_OPERATION_OK) || (MF_RXSTA == MF_ADDITIONAL_FRAME))) {
+    success = SUCCESS;                      /* no communication error */
   }
   
   MF_RXDATA[MF_RXLEN-1] = MF_RXSTA;  /* place DESFire Rx Status after Rx data */
@@ -505,6 +559,7 @@ int MifareCommTCL(unsigned char *buffer, unsigned char size)
  *
  * Operation:
  *  reset last picc/pcd errors to a no error state (OPERATION_OK)
+ *  drop any file settings cached from a previous card
  *
  * Arguments: PICC
  * Return:    None
@@ -512,6 +567,7 @@ int MifareCommTCL(unsigned char *buffer, unsigned char size)
  * Revision History:
  *  Dec. 28, 2012      Nnoduka Eruchalu     Initial Revision
  *  May  04, 2013      Nnoduka Eruchalu     Changed: MifareTagNew->MifareTagInit
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Flush file settings cache
  */
 void MifareTagInit(mifare_tag *tag)
 {
@@ -520,6 +576,7 @@ void MifareTagInit(mifare_tag *tag)
   tag->last_pcd_error  = MF_OPERATION_OK;  /* error states: OPERATION_OK */
   tag->authenticated_key_no = NOT_YET_AUTHENTICATED;
   tag->selected_application = 0;
+  FileSettingsCacheFlush(tag);
   return;
 }
 
@@ -1645,6 +1702,7 @@ int MifareDeleteApplication(mifare_tag *tag, uint32_t aid)
   if(tag->selected_application == aid) {
     tag->selected_application = 0x000000; 
   }
+  FileSettingsCacheFlush(tag);      /* files of aid are gone */
   
   return SUCCESS;
 }
@@ -1949,6 +2007,7 @@ int MifareSelectApplication(mifare_tag *tag, uint32_t aid) {
   
   /* SelectApplication invalidates the current authentication status */
   tag->selected_application = aid;
+  FileSettingsCacheFlush(tag);      /* and cached settings of previous app */
   
   return SUCCESS;
 }
@@ -2011,6 +2070,7 @@ int MifareFormatPicc(mifare_tag *tag)
   
   /* SelectApplication invalidates the current authentication status */
   tag->selected_application = 0x000000;
+  FileSettingsCacheFlush(tag);      /* all files are gone */
   
   return SUCCESS;
 }
@@ -2336,6 +2396,9 @@ int MifareGetIsoFileIds(mifare_tag *tag, uint16_t files[],
  *
  * Revision History:
  *  Mar. 22, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Save settings in file settings cache
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Fail on a PICC error, so it isn't
+ *                                          cached as settings
  */
 int MifareGetFileSettings(mifare_tag *tag, uint8_t file_no,
                           mifare_desfire_file_settings *settings)
@@ -2353,7 +2416,10 @@ int MifareGetFileSettings(mifare_tag *tag, uint8_t file_no,
   p = MifareCryptoPreprocessData(tag, BUFFER_ARRAY(cmd), &BUFFER_SIZE(cmd), 0,
                                  MDCM_PLAIN | CMAC_COMMAND);
   
-  MifareCommTCL(p, BUFFER_SIZE(cmd));
+  if (MifareCommTCL(p, BUFFER_SIZE(cmd)) != SUCCESS) {
+    tag->last_picc_error = MF_RXSTA; /* e.g. no such file; nothing to cache */
+    return FAIL;
+  }
   
   nbytes = MF_RXLEN;                /* number of Rx'd bytes */
   p = MifareCryptoPostprocessData(tag, MF_RXDATA, &nbytes, 
@@ -2377,11 +2443,11 @@ int MifareGetFileSettings(mifare_tag *tag, uint8_t file_no,
     
   case MDFT_VALUE_FILE_WITH_BACKUP:
     settings->settings.value_file.lower_limit = 
-      le32toh((uint8_t *) raw_settings.settings.value_file.lower_limit);
+      MifareGetLe32((uint8_t *) raw_settings.settings.value_file.lower_limit);
     settings->settings.value_file.upper_limit = 
-      le32toh((uint8_t *) raw_settings.settings.value_file.upper_limit);
+      MifareGetLe32((uint8_t *) raw_settings.settings.value_file.upper_limit);
     settings->settings.value_file.limited_credit_value = 
-      le32toh((uint8_t *)raw_settings.settings.value_file.limited_credit_value);
+      MifareGetLe32((uint8_t *)raw_settings.settings.value_file.limited_credit_value);
     settings->settings.value_file.limited_credit_enabled = 
       raw_settings.settings.value_file.limited_credit_enabled;
     break;
@@ -2401,6 +2467,7 @@ int MifareGetFileSettings(mifare_tag *tag, uint8_t file_no,
     /* break; */
   } /* end switch(settings->file_type) */
   
+  FileSettingsCacheStore(tag, file_no, settings); /* keep freshest copy */
   
   return SUCCESS;
 }
@@ -2452,6 +2519,7 @@ int MifareGetFileSettings(mifare_tag *tag, uint8_t file_no,
  *
  * Revision History:
  *  Mar. 22, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Drop file's cached settings
  */
 int MifareChangeFileSettings(mifare_tag *tag, uint8_t file_no,
                              uint8_t communication_settings,
@@ -2490,6 +2558,7 @@ int MifareChangeFileSettings(mifare_tag *tag, uint8_t file_no,
   nbytes = MF_RXLEN;                /* number of Rx'd bytes */
   p = MifareCryptoPostprocessData(tag, MF_RXDATA, &nbytes, 
                                   MDCM_PLAIN | CMAC_COMMAND | CMAC_VERIFY);
+  FileSettingsCacheDrop(tag, file_no); /* cached settings are now stale */
   if (!p)
     return FAIL;
   
@@ -2873,6 +2942,7 @@ int MifareDeleteFile(mifare_tag *tag, uint8_t file_no)
   nbytes = MF_RXLEN;                /* number of Rx'd bytes */
   p = MifareCryptoPostprocessData(tag, MF_RXDATA, &nbytes, 
                                   MDCM_PLAIN | CMAC_COMMAND | CMAC_VERIFY);
+  FileSettingsCacheDrop(tag, file_no); /* file number may be reused */
   
   if(!p)
     return FAIL;
@@ -2881,6 +2951,193 @@ int MifareDeleteFile(mifare_tag *tag, uint8_t file_no)
 }
 
 
+/*
+ * MifarePrefetchFileSettings
+ * Description:
+ *  Get the settings of a set of files in the currently selected application
+ *  ahead of their use, so later data and value commands on those files don't
+ *  need a GetFileSettings exchange of their own.
+ *  
+ * Arguments
+ *  tag:   DESFire tag
+ *  files: File IDentifiers of files to prefetch
+ *  count: number of File IDentifiers in files
+ *
+ * Operation:
+ *  Call MifareGetFileSettings() on each file, which saves the settings in the
+ *  tag's file settings cache. Only the last MIFARE_FILE_SETTINGS_CACHE files
+ *  stay cached.
+ *
+ * Return:  
+ *  SUCCESS: settings of all files retrieved
+ *  FAIL:    failed to get settings of at least one file
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifarePrefetchFileSettings(mifare_tag *tag, uint8_t files[], size_t count)
+{
+  mifare_desfire_file_settings settings;
+  size_t i;
+  int res = SUCCESS;
+  
+  ASSERT_ACTIVE(tag);
+  
+  for(i=0; i<count; i++) {
+    if(MifareGetFileSettings(tag, files[i], &settings) != SUCCESS)
+      res = FAIL;
+  }
+  
+  return res;
+}
+
+
+/*
+ * FileSettingsCacheFlush
+ * Description:
+ *  Drop all file settings cached on a tag.
+ *
+ * Arguments
+ *  tag: DESFire tag
+ *
+ * Operation:
+ *  Mark every cache slot as unused and restart slot replacement at 0.
+ *
+ * Return:  None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void FileSettingsCacheFlush(mifare_tag *tag)
+{
+  uint8_t i;
+  
+  for(i=0; i<MIFARE_FILE_SETTINGS_CACHE; i++) {
+    tag->file_settings[i].valid = FALSE;
+  }
+  tag->file_settings_next = 0;
+}
+
+
+/*
+ * FileSettingsCacheDrop
+ * Description:
+ *  Drop the cached settings of a file in the currently selected application.
+ *
+ * Arguments
+ *  tag:     DESFire tag
+ *  file_no: DESFire File IDentifier
+ *
+ * Operation:
+ *  Mark the cache slot holding (selected_application, file_no) as unused.
+ *
+ * Return:  None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void FileSettingsCacheDrop(mifare_tag *tag, uint8_t file_no)
+{
+  uint8_t i;
+  
+  for(i=0; i<MIFARE_FILE_SETTINGS_CACHE; i++) {
+    if((tag->file_settings[i].file_no == file_no) &&
+       (tag->file_settings[i].aid == tag->selected_application)) {
+      tag->file_settings[i].valid = FALSE;
+    }
+  }
+}
+
+
+/*
+ * FileSettingsCacheStore
+ * Description:
+ *  Save the settings of a file in the currently selected application in the
+ *  tag's file settings cache.
+ *
+ * Arguments
+ *  tag:      DESFire tag
+ *  file_no:  DESFire File IDentifier
+ *  settings: file settings to be cached
+ *
+ * Operation:
+ *  Reuse the slot already holding this file if there is one, else replace
+ *  slots in round-robin order.
+ *
+ * Return:  None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void FileSettingsCacheStore(mifare_tag *tag, uint8_t file_no,
+                                   mifare_desfire_file_settings *settings)
+{
+  uint8_t i;
+  mifare_file_settings_cache *entry = NULL;
+  
+  for(i=0; i<MIFARE_FILE_SETTINGS_CACHE; i++) {  /* already cached? */
+    if(tag->file_settings[i].valid && 
+       (tag->file_settings[i].file_no == file_no) &&
+       (tag->file_settings[i].aid == tag->selected_application)) {
+      entry = &tag->file_settings[i];
+      break;
+    }
+  }
+  
+  if(!entry) {                                   /* else replace next slot */
+    entry = &tag->file_settings[tag->file_settings_next];
+    tag->file_settings_next = 
+      (tag->file_settings_next + 1) % MIFARE_FILE_SETTINGS_CACHE;
+  }
+  
+  entry->valid = TRUE;
+  entry->file_no = file_no;
+  entry->aid = tag->selected_application;
+  memcpy(&entry->settings, settings, sizeof(mifare_desfire_file_settings));
+}
+
+
+/*
+ * GetCachedFileSettings
+ * Description:
+ *  Get the settings of a file in the currently selected application, from the
+ *  tag's file settings cache if possible.
+ *
+ * Arguments
+ *  tag:      DESFire tag
+ *  file_no:  DESFire File IDentifier
+ *  settings: pointer to mifare_desfire_file_settings struct [modified]
+ *
+ * Operation:
+ *  Look for (selected_application, file_no) in the cache. On a miss call
+ *  MifareGetFileSettings() which also populates the cache.
+ *
+ * Return:  
+ *  SUCCESS: settings retrieved
+ *  FAIL:    failed to get settings
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int GetCachedFileSettings(mifare_tag *tag, uint8_t file_no,
+                                 mifare_desfire_file_settings *settings)
+{
+  uint8_t i;
+  
+  for(i=0; i<MIFARE_FILE_SETTINGS_CACHE; i++) {
+    if(tag->file_settings[i].valid && 
+       (tag->file_settings[i].file_no == file_no) &&
+       (tag->file_settings[i].aid == tag->selected_application)) {
+      memcpy(settings, &tag->file_settings[i].settings,
+             sizeof(mifare_desfire_file_settings));
+      return SUCCESS;
+    }
+  }
+  
+  return MifareGetFileSettings(tag, file_no, settings);
+}
+
+
 /*
  * GetReadCommunicationSettings
  * Description:
@@ -2891,7 +3148,7 @@ int MifareDeleteFile(mifare_tag *tag, uint8_t file_no)
  *  file_no: DESFire File IDentifier  
  *
  * Operation:
- *  First get file settings using MifareGetFileSettings()
+ *  First get file settings using GetCachedFileSettings()
  *  If that is successful, depending on the AccessRights field (settings r and 
  *  r/w) we have to decide whether we are able to communicate in the mode
  *  indicated by the settings' communication_settings.  
@@ -2905,13 +3162,14 @@ int MifareDeleteFile(mifare_tag *tag, uint8_t file_no)
  *
  * Revision History:
  *  Mar. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Use file settings cache
  */
 static uint8_t GetReadCommunicationSettings(mifare_tag *tag, uint8_t file_no)
 {
   mifare_desfire_file_settings settings;
   uint8_t read_only_access, read_write_access;
   
-  if (MifareGetFileSettings(tag, file_no, &settings) != SUCCESS) {
+  if (GetCachedFileSettings(tag, file_no, &settings) != SUCCESS) {
     return -1; /* return an invalid communication mode */
   }
   
@@ -2939,7 +3197,7 @@ static uint8_t GetReadCommunicationSettings(mifare_tag *tag, uint8_t file_no)
  *  file_no: DESFire File IDentifier  
  *
  * Operation:
- *  First get file settings using MifareGetFileSettings()
+ *  First get file settings using GetCachedFileSettings()
  *  If that is successful, depending on the AccessRights field (settings w and 
  *  r/w) we have to decide whether we are able to communicate in the mode
  *  indicated by the settings' communication_settings.  
@@ -2953,13 +3211,14 @@ static uint8_t GetReadCommunicationSettings(mifare_tag *tag, uint8_t file_no)
  *
  * Revision History:
  *  Mar. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Use file settings cache
  */
 static uint8_t GetWriteCommunicationSettings(mifare_tag *tag, uint8_t file_no)
 {
   mifare_desfire_file_settings settings;
   uint8_t write_only_access, read_write_access;
   
-  if (MifareGetFileSettings(tag, file_no, &settings) != SUCCESS) {
+  if (GetCachedFileSettings(tag, file_no, &settings) != SUCCESS) {
     return -1; /* return an invalid communication mode */
   }
   
@@ -3028,12 +3287,18 @@ static uint8_t GetWriteCommunicationSettings(mifare_tag *tag, uint8_t file_no)
  * |                                 |       | status                          |
  * +---------------------------------+       +---------------------------------+
  *
+ *  A frame that doesn't fit in what is left of data ends the read with a
+ *  BUFFER_ERROR, rather than being dropped while later frames are kept.
+ *
  * Return:  
  *  SUCCESS: command executed successfully
  *  FAIL:    failed command execution
  *
  * Revision History:
  *  Mar. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Fail on PICC errors and on frames
+ *                                          that don't fit; send additional
+ *                                          frame requests on their own
  */
 static int ReadData(mifare_tag *tag,  uint8_t command, uint8_t file_no, 
                     uint32_t offset, uint32_t length, uint8_t data[], 
@@ -3058,16 +3323,22 @@ static int ReadData(mifare_tag *tag,  uint8_t command, uint8_t file_no,
                                  MDCM_PLAIN | CMAC_COMMAND);
   
   do {
-    MifareCommTCL(p, BUFFER_SIZE(cmd));
+    if (MifareCommTCL(p, BUFFER_SIZE(cmd)) != SUCCESS) {
+      tag->last_picc_error = MF_RXSTA; /* e.g. boundary error */
+      return FAIL;
+    }
     
     frame_bytes = MF_RXLEN - 1;
-    if ((*data_size+frame_bytes) <= max_count-1) { /* -1 for status byte */
-      memcpy(data+*data_size, MF_RXDATA, frame_bytes);
-      *data_size += frame_bytes;
+    if ((*data_size+frame_bytes) > max_count-1) { /* -1 for status byte */
+      tag->last_pcd_error = BUFFER_ERROR; /* stop; don't skip the frame */
+      return FAIL;
     }
+    memcpy(data+*data_size, MF_RXDATA, frame_bytes);
+    *data_size += frame_bytes;
     
     p[0] = 0xAF; /* get additional frames */
-  } while((MF_RXSTA == 0xAF) && (*data_size < max_count-1));
+    BUFFER_SIZE(cmd) = 1;
+  } while(MF_RXSTA == 0xAF);
   
   /* append status byte */
   data[*data_size] = 0x00;
@@ -3170,7 +3441,8 @@ int MifareReadDataEx(mifare_tag *tag, uint8_t file_no, uint32_t offset,
  *  file_no:            DESFire File IDentifier
  *  offset:             starting position for write within the file
  *  length:             number of bytes to be written.
- *                      range is [1, MF_MAX_WRITE_LENGTH]
+ *                      lengths above MF_MAX_WRITE_LENGTH are streamed by
+ *                      WriteDataStreamed
  *  data:               buffer of data bytes to be written
  *  data_sent:          actual number of data bytes written
  *  communication_mode: file's communication mode
@@ -3214,6 +3486,7 @@ int MifareReadDataEx(mifare_tag *tag, uint8_t file_no, uint32_t offset,
  *
  * Revision History:
  *  Mar. 23, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Stream writes too big for cmd buffer
  */
 static int WriteData(mifare_tag *tag,  uint8_t command, uint8_t file_no, 
                      uint32_t offset, uint32_t length, uint8_t *data, 
@@ -3230,6 +3503,10 @@ static int WriteData(mifare_tag *tag,  uint8_t command, uint8_t file_no,
   ASSERT_ACTIVE(tag);
   ASSERT_CS(communication_mode);
   
+  if (length > MF_MAX_WRITE_LENGTH) /* too big for cmd buffer */
+    return WriteDataStreamed(tag, command, file_no, offset, length, data,
+                             data_sent, communication_mode);
+  
   BUFFER_APPEND(cmd, command);
   BUFFER_APPEND(cmd, file_no);
   BUFFER_APPEND_LE(cmd, offset, 3);
@@ -3284,6 +3561,141 @@ static int WriteData(mifare_tag *tag,  uint8_t command, uint8_t file_no,
 }
 
 
+/*
+ * StreamFrameBytes
+ * Description:
+ *  Add bytes of a streamed write to the frame being built, sending the frame
+ *  off whenever it is full and more bytes are to follow.
+ *
+ * Arguments
+ *  frame:     frame being built [modified]
+ *  frame_n:   # of bytes in frame [modified]
+ *  frame_cap: max # of bytes in frame [modified]
+ *  bytes:     bytes to add
+ *  n:         # of bytes to add
+ *
+ * Operation:
+ *  A full frame is only sent when there is another byte to add, so the last
+ *  frame of the command is always left for the caller to send. After a full
+ *  frame is sent the PICC must ask for more (0xAF), and the next frame starts
+ *  with 0xAF.
+ *
+ * Return:  
+ *  SUCCESS: bytes added to frame
+ *  FAIL:    PICC didn't ask for more data; MF_RXSTA holds its status
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int StreamFrameBytes(uint8_t frame[], size_t *frame_n, 
+                            size_t *frame_cap, uint8_t bytes[], size_t n)
+{
+  while(n--) {
+    if (*frame_n == *frame_cap) {
+      MifareCommTCL(frame, *frame_n);
+      if (0xAF != MF_RXSTA)
+        return FAIL;
+      
+      frame[0] = 0xAF;       /* PICC expects more data */
+      *frame_n = 1;
+      *frame_cap = FRAME_PAYLOAD_SIZE;
+    }
+    frame[(*frame_n)++] = *bytes++;
+  }
+  
+  return SUCCESS;
+}
+
+
+/*
+ * WriteDataStreamed
+ * Description:
+ *  Helper function to write data to Data and Record Files when the data is
+ *  too big to be preprocessed in one buffer.
+ *
+ * Arguments
+ *  tag:                DESFire tag
+ *  command:            to write data files (0x3D) or records (0x3B)
+ *  file_no:            DESFire File IDentifier
+ *  offset:             starting position for write within the file
+ *  length:             number of bytes to be written; up to the file size
+ *  data:               buffer of data bytes to be written
+ *  data_sent:          actual number of data bytes written
+ *  communication_mode: file's communication mode
+ *
+ * Operation:
+ *  Same exchange as WriteData, but the 8 byte command header and data are
+ *  fed a byte at a time through a crypto stream which MACs/enciphers them on
+ *  the fly. Its output fills frames that are sent as they fill up, so the
+ *  whole write is a single command with a single MAC/CRC regardless of
+ *  length, and only a frame's worth of bytes is buffered.
+ *  The first frame holds at most FRAME_PAYLOAD_SIZE-8 bytes like WriteData.
+ * 
+ * Return:  
+ *  SUCCESS: command executed successfully
+ *  FAIL:    failed command execution
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int WriteDataStreamed(mifare_tag *tag,  uint8_t command, 
+                             uint8_t file_no, uint32_t offset, 
+                             uint32_t length, uint8_t *data, 
+                             size_t *data_sent, uint8_t communication_mode)
+{
+  uint8_t *p;
+  ssize_t nbytes;
+  uint32_t i;
+  size_t n, frame_n, frame_cap;
+  uint8_t frame[FRAME_PAYLOAD_SIZE];
+  uint8_t out[MIFARE_CRYPTO_STREAM_OUT_SIZE];
+  mifare_crypto_stream stream;
+  BUFFER_INIT(hdr, 8);
+  
+  BUFFER_APPEND(hdr, command);
+  BUFFER_APPEND(hdr, file_no);
+  BUFFER_APPEND_LE(hdr, offset, 3);
+  BUFFER_APPEND_LE(hdr, length, 3);
+  
+  if (MifareCryptoStreamInit(&stream, tag, 8, communication_mode |
+                             MAC_COMMAND | CMAC_COMMAND | ENC_COMMAND) < 0)
+    return FAIL;
+  
+  frame_n = 0;
+  frame_cap = FRAME_PAYLOAD_SIZE - 8;
+  
+  for (i = 0; i < 8 + length; i++) {
+    n = MifareCryptoStreamPut(&stream, (i < 8) ? BUFFER_ARRAY(hdr)[i] :
+                              data[i - 8], out);
+    if (StreamFrameBytes(frame, &frame_n, &frame_cap, out, n) < 0)
+      break;
+  }
+  
+  if (i == 8 + length) {          /* all data framed; finish and send */
+    n = MifareCryptoStreamFinal(&stream, out);
+    if (StreamFrameBytes(frame, &frame_n, &frame_cap, out, n) == SUCCESS)
+      MifareCommTCL(frame, frame_n);
+  }
+  
+  nbytes = MF_RXLEN;                /* number of Rx'd bytes */
+  p = MifareCryptoPostprocessData(tag, MF_RXDATA, &nbytes, 
+                                  MDCM_PLAIN | CMAC_COMMAND | CMAC_VERIFY);
+  
+  if(!p)
+    return FAIL;
+  
+  if (0x00 == MF_RXSTA) {
+    *data_sent = length;
+  } else {
+    /* PICC aborted the write mid-stream or rejected it at the end */
+    tag->last_picc_error = MF_RXSTA;
+    *data_sent = -1;
+  }
+  
+  return SUCCESS;
+}
+
+
 /*
  * MifareWriteData
  * Description:
@@ -3442,7 +3854,7 @@ int MifareGetValueEx(mifare_tag *tag, uint8_t file_no, int32_t *value,
   if(!p)
     return FAIL;
   
-  *value = le32toh(p);
+  *value = MifareGetLe32(p);
   
   return SUCCESS; 
 }
@@ -25,6 +25,9 @@
  *   May  05, 2013      Nnoduka Eruchalu     Added MifareDetect
  *   May  06, 2013      Nnoduka Eruchalu     Added mifare_tag_simple struct and
  *                                           used for MifareDetect functions.
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added file settings cache to
+ *                                           mifare_tag
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added MifareGetLe32, MifarePutLe32
  */
 
 #ifndef MIFARE_H
@@ -187,6 +190,7 @@
 #define MIFARE_MAX_FILE_COUNT        16 /* max # of files in each application */
 #define MIFARE_UID_BYTES             7  /* number of UID bytes */
 #define MIFARE_AID_SIZE              3  /* number of AID bytes */
+#define MIFARE_FILE_SETTINGS_CACHE   4  /* # of file settings cached per tag */
 
 
 /* --------------------------------------
@@ -340,6 +344,7 @@ enum mifare_desfire_file_types {
 
 /* Error Code Managed by this Library */
 #define CRYPTO_ERROR              0x01  /* crypto verification error */
+#define BUFFER_ERROR              0x02  /* rx'd data doesn't fit in buffer */
 
 
 
@@ -391,6 +396,38 @@ typedef struct {
 } mifare_tag_simple;
 
 
+typedef struct {
+  uint8_t file_type;
+  uint8_t communication_settings;
+  uint16_t access_rights;
+  
+  union {
+    struct {
+      uint32_t file_size;
+    } standard_file;
+    struct {
+      int32_t lower_limit;
+      int32_t upper_limit;
+      int32_t limited_credit_value;
+      uint8_t limited_credit_enabled;
+    } value_file;
+    struct {
+      uint32_t record_size;
+      uint32_t max_number_of_records;
+      uint32_t current_number_of_records;
+    } record_file;                        /* linear and cyclic record files */
+  } settings;
+} mifare_desfire_file_settings;
+
+
+typedef struct {             /* cached copy of a file's settings */
+  uint8_t valid;             /* TRUE if this cache slot is in use */
+  uint8_t file_no;           /* file these settings belong to */
+  uint32_t aid;              /* application the file lives in */
+  mifare_desfire_file_settings settings;
+} mifare_file_settings_cache;
+
+
 typedef struct {
   uint8_t active;
   uint8_t uid[7];
@@ -406,6 +443,10 @@ typedef struct {
   uint8_t cmac[16];
   uint8_t crypto_buffer[MAX_CRYPTO_BUFFER_SIZE];
   uint32_t selected_application;
+  
+  /* file settings of recently accessed files in the selected application */
+  mifare_file_settings_cache file_settings[MIFARE_FILE_SETTINGS_CACHE];
+  uint8_t file_settings_next;           /* next cache slot to be replaced */
 } mifare_tag;
 
 typedef struct {             /* structure for the GetDfNames command */
@@ -469,28 +510,6 @@ typedef struct {
 } mifare_desfire_raw_file_settings;
 
 
-typedef struct {
-  uint8_t file_type;
-  uint8_t communication_settings;
-  uint16_t access_rights;
-  
-  union {
-    struct {
-      uint32_t file_size;
-    } standard_file;
-    struct {
-      int32_t lower_limit;
-      int32_t upper_limit;
-      int32_t limited_credit_value;
-      uint8_t limited_credit_enabled;
-    } value_file;
-    struct {
-      uint32_t record_size;
-      uint32_t max_number_of_records;
-      uint32_t current_number_of_records;
-    } record_file;                        /* linear and cyclic record files */
-  } settings;
-} mifare_desfire_file_settings;
 
 
 /* --------------------------------------
@@ -508,6 +527,17 @@ extern void MifareStartTimer(unsigned int ms);
 extern void MifareTimerISR(void);
 
 
+/* --------------------------------------
+ * Byte order helpers
+ * --------------------------------------
+ */
+/* get a 32-bit little endian value */
+extern uint32_t MifareGetLe32(uint8_t data[/*4*/]);
+
+/* put a 32-bit little endian value */
+extern void MifarePutLe32(uint8_t data[/*4*/], uint32_t value);
+
+
 /* --------------------------------------
  * SL032 specific functions
  * --------------------------------------
@@ -666,6 +696,8 @@ extern int MifareCreateCyclicRecordFileIso(mifare_tag *tag, uint8_t file_no,
                                            uint32_t max_number_of_records, 
                                            uint16_t iso_file_id);
 extern int MifareDeleteFile(mifare_tag *tag, uint8_t file_no);
+extern int MifarePrefetchFileSettings(mifare_tag *tag, uint8_t files[],
+                                      size_t count);
 
 
 /* Data Manipulation Commands */
@@ -16,8 +16,10 @@
  *   Crc32               - get a CRC32 checksum
  *   Crc32Append         - get a CRC32 checksum and append to data
  *   MifareCrc32         - get a Desfire CRC32 checksum
+ *   MifareCrc32Update   - update a running Desfire CRC32 register with data
  *   MifareCrc32Append   - get a Desfire CRC32 checksum and append to data
  *   MifareCrc16         - get a Desfire ISO1444-3 Type A CRC16 checksum
+ *   MifareCrc16Update   - update a running Desfire CRC16 register with data
  *   MifareCrc16Append   - get a Desfire CRC16 checksum and append to data
  *
  *   KeyBlockSize        - get key block size
@@ -31,6 +33,10 @@
  *   MifareCipherSingleBlock
  *   MifareCipherBlocksChained   - performs all CBC ciphering/deciphering
  *
+ *   MifareCryptoStreamInit  - start preprocessing data a byte at a time
+ *   MifareCryptoStreamPut   - preprocess the next byte of data
+ *   MifareCryptoStreamFinal - finish preprocessing data (CRC, padding, MAC)
+ *
  * Documentation Sources:
  *   - libfreefare
  *
@@ -59,6 +65,8 @@
  *   May  03, 2013      Nnoduka Eruchalu     Removed dynamic memory allocation
  *                                           So changed functions to accept
  *                                           pointers to pre-allocated data
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added incremental CRCs and crypto
+ *                                           stream for streamed writes
  */
 
 #include <string.h>   /* for mem* operations */
@@ -77,6 +85,9 @@
 static void Xor(uint8_t *ivect, uint8_t *data, size_t len);
 /* size of MACing produced with the key */
 static size_t KeyMacingLength(mifare_desfire_key *key);
+/* run a byte through the crypto stream's block cipher */
+static size_t StreamCipherByte(mifare_crypto_stream *stream, uint8_t byte,
+                               uint8_t *out);
 
 
 /*
@@ -421,13 +432,42 @@ void Crc32Append(uint8_t *data, size_t len)
  *
  * Revision History:
  *   Jan. 05, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Moved shifting to MifareCrc32Update
  */
 void MifareCrc32 (uint8_t *data, size_t len, uint8_t *crc)
 {
-  uint32_t reg = 0xFFFFFFFF; /* load register with 1 bits */
+  uint32_t reg = MIFARE_CRC32_INIT; /* load register with 1 bits */
+  size_t byte;               /* index into CRC array bytes */
+  
+  reg = MifareCrc32Update(reg, data, len);
+  
+  for(byte=0; byte < CRC32_NUMBYTES; byte++) { /* save the reg in crc array */
+    crc[byte] = (reg >> (8*byte)) & 0xFF;      /* in little endian format */
+  }
+}
+
+
+/*
+ * MifareCrc32Update
+ * Description: Shift data into a running MIFARE DESFire CRC32 register. This
+ *              lets a CRC be computed over data that isn't all in memory at
+ *              once.
+ *
+ * Arguments:   reg  = CRC register; start with MIFARE_CRC32_INIT
+ *              data = pointer to data block
+ *              len  = length of data block
+ * Return:      updated CRC register. Its bytes, LSB first, are the checksum
+ *              as it's to be transmitted.
+ *
+ * Operation:   See MifareCrc32
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t MifareCrc32Update(uint32_t reg, uint8_t *data, size_t len)
+{
   int current_bit;           /* need current bit and byte values to keep */
   uint8_t current_byte;      /* track of shifts into register */
-  size_t byte;               /* index into CRC array bytes */
   uint8_t popped_bit;        /* bit popped out of register after shift */
   
   while(len--) {             /* shift in bytes of data message keeping track */
@@ -440,9 +480,7 @@ void MifareCrc32 (uint8_t *data, size_t len, uint8_t *crc)
     }
   }
   
-  for(byte=0; byte < CRC32_NUMBYTES; byte++) { /* save the reg in crc array */
-    crc[byte] = (reg >> (8*byte)) & 0xFF;      /* in little endian format */
-  }
+  return reg;
 }
 
 
@@ -511,22 +549,49 @@ void MifareCrc32Append(uint8_t *data, size_t len)
  *
  * Revision History:
  *   Jan. 05, 2012      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Moved shifting to MifareCrc16Update
  */
 void MifareCrc16 (uint8_t *data, size_t len, uint8_t *crc)
+{
+  uint16_t reg = MIFARE_CRC16_INIT;          /* ITU-V.41 */
+  
+  reg = MifareCrc16Update(reg, data, len);
+  
+  *crc++ = (uint8_t) (reg & 0xFF);           /* transmit LSB first */
+  *crc = (uint8_t) ((reg >> 8) & 0xFF);      /* transmit MSB second */
+}
+
+
+/*
+ * MifareCrc16Update
+ * Description: Shift data into a running MIFARE DESFire CRC16 register. This
+ *              lets a CRC be computed over data that isn't all in memory at
+ *              once.
+ *
+ * Arguments:   reg  = CRC register; start with MIFARE_CRC16_INIT
+ *              data = pointer to data block
+ *              len  = length of data block
+ * Return:      updated CRC register. Its bytes, LSB first, are the checksum
+ *              as it's to be transmitted.
+ *
+ * Operation:   See MifareCrc16
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t MifareCrc16Update(uint16_t reg, uint8_t *data, size_t len)
 {
   uint8_t  bt;                               /* get current data byte */
-  uint16_t reg = 0x6363;                     /* ITU-V.41 */
   
-  do {
+  while (len--) {                            /* stay within data array limits */
     bt = *data++;                            /* loop through data bytes */
     bt = (bt ^ (uint8_t) (reg & 0x00FF));    
     bt = (bt ^ (bt << 4));
     reg = (reg >> 8) ^ ((uint16_t) bt << 8) ^ ((uint16_t) bt << 3) ^ 
       ((uint16_t) bt >> 4);
-  } while (--len);                           /* stay within data array limits */
+  }
   
-  *crc++ = (uint8_t) (reg & 0xFF);           /* transmit LSB first */
-  *crc = (uint8_t) ((reg >> 8) & 0xFF);      /* transmit MSB second */
+  return reg;
 }
 
 
@@ -1445,3 +1510,257 @@ void MifareCipherBlocksChained(mifare_tag *tag, mifare_desfire_key *key,
     offset += block_size;
   }
 }
+
+
+/*
+ * MifareCryptoStreamInit
+ * Description: Start preprocessing data for transmission a byte at a time.
+ *              This produces the same bytes as MifareCryptoPreprocessData but
+ *              doesn't need the whole command in a buffer, so commands longer
+ *              than the crypto buffer can be sent as they are processed.
+ *
+ * Arguments:   stream = stream state [modified]
+ *              tag    = PICC
+ *              offset = # of command + header bytes at the start of the data
+ *              communication_settings
+ * Return:      SUCCESS/FAIL (unknown communication mode)
+ *
+ * Operation:   Decide what processing is needed the same way
+ *              MifareCryptoPreprocessData does:
+ *              - MDCM_PLAIN: nothing for legacy auth; for new auth a CMAC that
+ *                isn't appended.
+ *              - MDCM_MACED: a MAC of data after offset for legacy auth; a
+ *                CMAC of the whole command for new auth.
+ *              - MDCM_ENCIPHERED: encipher data after offset with CRC.
+ *              Legacy auth CBC starts from an all 0s ivect, new auth continues
+ *              from the tag's ivect.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareCryptoStreamInit(mifare_crypto_stream *stream, mifare_tag *tag,
+                           off_t offset, int communication_settings)
+{
+  stream->tag = tag;
+  stream->communication_settings = communication_settings;
+  stream->offset = offset;
+  stream->position = 0;
+  stream->operation = MCS_NONE;
+  stream->append_mac = TRUE;
+  stream->block_n = 0;
+  stream->block_size = KeyBlockSize(&tag->session_key);
+  stream->crc32 = MIFARE_CRC32_INIT;
+  stream->crc16 = MIFARE_CRC16_INIT;
+  
+  switch(communication_settings & MDCM_MASK) {
+  case MDCM_PLAIN:             /* plain data transfer */
+    if (AS_LEGACY == tag->authentication_scheme)
+      break;                   /* do nothing if legacy authentication scheme */
+    stream->append_mac = FALSE;/* new auth. CMACs without appending */
+    
+  case MDCM_MACED:             /* plain data transfer with MAC */
+    switch (tag->authentication_scheme) {
+    case AS_LEGACY:
+      if (communication_settings & MAC_COMMAND)
+        stream->operation = MCS_MAC;
+      break;
+    case AS_NEW:
+      if (communication_settings & CMAC_COMMAND)
+        stream->operation = MCS_CMAC;
+      break;
+    }
+    break;
+    
+  case MDCM_ENCIPHERED:        /* DES/3DES ecnrypted data transfer */
+    if (communication_settings & ENC_COMMAND)
+      stream->operation = MCS_ENCIPHER;
+    break;
+    
+  default:                     /* unknown communication settings */
+    return FAIL;
+  }
+  
+  if ((stream->operation != MCS_NONE) && (stream->operation != MCS_CMAC) &&
+      (AS_LEGACY == tag->authentication_scheme)) {
+    memset(tag->ivect, 0, MAX_CRYPTO_BLOCK_SIZE); /* legacy ivect is all 0s */
+  }
+  
+  return SUCCESS;
+}
+
+
+/*
+ * StreamCipherByte
+ * Description: Add a byte to the crypto stream's block, and cipher the block
+ *              for sending once it is full.
+ *
+ * Arguments:   stream = stream state [modified]
+ *              byte   = byte to add
+ *              out    = buffer for ciphered block [modified]
+ * Return:      # of bytes saved in out: 0 or a block size
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static size_t StreamCipherByte(mifare_crypto_stream *stream, uint8_t byte,
+                               uint8_t *out)
+{
+  mifare_tag *tag = stream->tag;
+  
+  stream->block[stream->block_n++] = byte;
+  if (stream->block_n < stream->block_size)
+    return 0;
+  
+  MifareCipherSingleBlock(&tag->session_key, stream->block, tag->ivect,
+                          MCD_SEND, (AS_NEW == tag->authentication_scheme) ?
+                          MCO_ENCIPHER : MCO_DECIPHER, stream->block_size);
+  memcpy(out, stream->block, stream->block_size);
+  stream->block_n = 0;
+  return stream->block_size;
+}
+
+
+/*
+ * MifareCryptoStreamPut
+ * Description: Preprocess the next byte of data for transmission.
+ *
+ * Arguments:   stream = stream state [modified]
+ *              byte   = next byte of command
+ *              out    = buffer of at least MIFARE_CRYPTO_STREAM_OUT_SIZE bytes
+ *                       for bytes ready to transmit [modified]
+ * Return:      # of bytes saved in out
+ *
+ * Operation:   Headers pass through untouched except for updating the CRC32
+ *              and CMAC which cover the whole command.
+ *              MACed data passes through while the MAC/CMAC is computed
+ *              one block at a time. The last CMAC block is held back since
+ *              it gets xor'd with a subkey.
+ *              Enciphered data is output a block at a time as each block is
+ *              filled and ciphered.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t MifareCryptoStreamPut(mifare_crypto_stream *stream, uint8_t byte,
+                             uint8_t *out)
+{
+  mifare_tag *tag = stream->tag;
+  uint8_t is_header = (stream->position < (size_t) stream->offset);
+  stream->position++;
+  
+  switch(stream->operation) {
+  case MCS_MAC:                /* legacy MAC covers data after offset */
+    if (!is_header) {
+      stream->block[stream->block_n++] = byte;
+      if (stream->block_n == stream->block_size) {
+        MifareCipherSingleBlock(&tag->session_key, stream->block, tag->ivect,
+                                MCD_SEND, MCO_ENCIPHER, stream->block_size);
+        stream->block_n = 0;
+      }
+    }
+    break;
+    
+  case MCS_CMAC:               /* CMAC covers all; hold back last block */
+    if (stream->block_n == stream->block_size) {
+      MifareCipherSingleBlock(&tag->session_key, stream->block, tag->ivect,
+                              MCD_SEND, MCO_ENCIPHER, stream->block_size);
+      stream->block_n = 0;
+    }
+    stream->block[stream->block_n++] = byte;
+    break;
+    
+  case MCS_ENCIPHER:
+    if (AS_NEW == tag->authentication_scheme)   /* CRC32 covers all */
+      stream->crc32 = MifareCrc32Update(stream->crc32, &byte, 1);
+    if (is_header)
+      break;
+    if (AS_LEGACY == tag->authentication_scheme)/* CRC16 covers just data */
+      stream->crc16 = MifareCrc16Update(stream->crc16, &byte, 1);
+    return StreamCipherByte(stream, byte, out);
+    
+  case MCS_NONE:
+    break;
+  }
+  
+  out[0] = byte;               /* byte is transmitted as is */
+  return 1;
+}
+
+
+/*
+ * MifareCryptoStreamFinal
+ * Description: Finish preprocessing data for transmission.
+ *
+ * Arguments:   stream = stream state [modified]
+ *              out    = buffer of at least MIFARE_CRYPTO_STREAM_OUT_SIZE bytes
+ *                       for bytes ready to transmit [modified]
+ * Return:      # of bytes saved in out
+ *
+ * Operation:   - MCS_MAC: 0 pad and cipher the last block, output the MAC.
+ *              - MCS_CMAC: xor last block with subkey 1 if complete, else
+ *                pad with 0x80 0x00... and xor with subkey 2. Cipher it and
+ *                save the CMAC in the tag. Output the CMAC if it is to be
+ *                appended.
+ *              - MCS_ENCIPHER: cipher the CRC (unless NO_CRC), 0 pad and
+ *                cipher the last block, and output the ciphered blocks.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+size_t MifareCryptoStreamFinal(mifare_crypto_stream *stream, uint8_t *out)
+{
+  mifare_tag *tag = stream->tag;
+  size_t bs = stream->block_size;
+  size_t n = 0;                /* # of bytes in out */
+  uint8_t i;
+  
+  switch(stream->operation) {
+  case MCS_MAC:
+    if (stream->block_n) {
+      memset(stream->block + stream->block_n, 0, bs - stream->block_n);
+      MifareCipherSingleBlock(&tag->session_key, stream->block, tag->ivect,
+                              MCD_SEND, MCO_ENCIPHER, bs);
+    }
+    memcpy(out, tag->ivect, MAC_LENGTH);
+    n = MAC_LENGTH;
+    break;
+    
+  case MCS_CMAC:
+    if (stream->block_n == bs) {
+      Xor(tag->session_key.cmac_sk1, stream->block, bs);
+    } else {
+      stream->block[stream->block_n++] = 0x80;
+      memset(stream->block + stream->block_n, 0, bs - stream->block_n);
+      Xor(tag->session_key.cmac_sk2, stream->block, bs);
+    }
+    MifareCipherSingleBlock(&tag->session_key, stream->block, tag->ivect,
+                            MCD_SEND, MCO_ENCIPHER, bs);
+    memcpy(tag->cmac, tag->ivect, bs);
+    if (stream->append_mac) {
+      memcpy(out, tag->cmac, CMAC_LENGTH);
+      n = CMAC_LENGTH;
+    }
+    break;
+    
+  case MCS_ENCIPHER:
+    if (!(stream->communication_settings & NO_CRC)) {
+      if (AS_NEW == tag->authentication_scheme) {
+        for (i=0; i<CRC32_NUMBYTES; i++)       /* CRC is little endian */
+          n += StreamCipherByte(stream, (stream->crc32 >> (8*i)) & 0xFF,
+                                out + n);
+      } else {
+        for (i=0; i<2; i++)
+          n += StreamCipherByte(stream, (stream->crc16 >> (8*i)) & 0xFF,
+                                out + n);
+      }
+    }
+    while (stream->block_n)                    /* pad last block with 0s */
+      n += StreamCipherByte(stream, 0x00, out + n);
+    break;
+    
+  case MCS_NONE:
+    break;
+  }
+  
+  return n;
+}
@@ -19,6 +19,8 @@
  *   May  03, 2013      Nnoduka Eruchalu     Removed dynamic memory allocation
  *                                           So changed functions to accept
  *                                           pointers to pre-allocated data
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added incremental CRCs and crypto
+ *                                           stream
  */
 
 #ifndef MIFARE_CRYPTO_H
@@ -41,6 +43,12 @@
 #define CRC32_NUMBYTES 4
 #define CRC32_NUMBITS  8*CRC32_NUMBYTES
 
+#define MIFARE_CRC32_INIT 0xFFFFFFFF /* DESFire CRC32 register initial value */
+#define MIFARE_CRC16_INIT 0x6363     /* DESFire CRC16 register initial value */
+
+/* buffer size needed for output of MifareCryptoStreamPut/Final */
+#define MIFARE_CRYPTO_STREAM_OUT_SIZE  (2*MAX_CRYPTO_BLOCK_SIZE)
+
 
 /* --------------------------------------
  * MIFARE Crypto Data Types
@@ -56,6 +64,25 @@ typedef enum {
   MCO_DECIPHER
 } mifare_crypto_operation;
 
+typedef struct {             /* state of data being preprocessed bytewise */
+  mifare_tag *tag;
+  int communication_settings;
+  off_t offset;              /* # of leading command + header bytes */
+  size_t position;           /* # of bytes put so far */
+  enum {
+    MCS_NONE,                /* no processing; bytes pass through */
+    MCS_MAC,                 /* legacy MAC of data after offset */
+    MCS_CMAC,                /* CMAC of all bytes */
+    MCS_ENCIPHER             /* encipher data after offset, with CRC */
+  } operation;
+  uint8_t append_mac;        /* append MAC/CMAC at the end? */
+  uint8_t block[MAX_CRYPTO_BLOCK_SIZE]; /* block being filled */
+  size_t block_n;            /* # of bytes in block */
+  size_t block_size;         /* key block size */
+  uint32_t crc32;            /* running CRC registers */
+  uint16_t crc16;
+} mifare_crypto_stream;
+
 
 /* --------------------------------------
  * FUNCTION PROTOTYPES
@@ -83,12 +110,18 @@ extern void Crc32Append(uint8_t *data, size_t len);
 /* get a Desfire CRC32 checksum for data of len bytes */
 extern void MifareCrc32(uint8_t *data, size_t len, uint8_t *crc);
 
+/* update a running Desfire CRC32 register with len bytes of data */
+extern uint32_t MifareCrc32Update(uint32_t reg, uint8_t *data, size_t len);
+
 /* get a Desfire CRC32 checksum for data of len bytes, and append to data */
 extern void MifareCrc32Append(uint8_t *data, size_t len);
 
 /* get a Desfire ISO1444-3 Type A CRC16 checksum for data of len bytes */
 extern void MifareCrc16(uint8_t *data, size_t len, uint8_t *crc);
 
+/* update a running Desfire CRC16 register with len bytes of data */
+extern uint16_t MifareCrc16Update(uint16_t reg, uint8_t *data, size_t len);
+
 /* get a Desfire CRC16 checksum for data of len bytes, and append to data */
 extern void MifareCrc16Append(uint8_t *data, size_t len);
 
@@ -129,5 +162,14 @@ extern void MifareCipherBlocksChained(mifare_tag *tag, mifare_desfire_key *key,
                                       mifare_crypto_direction direction,
                                       mifare_crypto_operation operation);
 
+/* Data Encipher before transmission, a byte at a time */
+extern int MifareCryptoStreamInit(mifare_crypto_stream *stream,
+                                  mifare_tag *tag, off_t offset,
+                                  int communication_settings);
+extern size_t MifareCryptoStreamPut(mifare_crypto_stream *stream,
+                                    uint8_t byte, uint8_t *out);
+extern size_t MifareCryptoStreamFinal(mifare_crypto_stream *stream,
+                                      uint8_t *out);
+
 
 #endif                                                     /* MIFARE_CRYPTO_H */
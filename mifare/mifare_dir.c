@@ -0,0 +1,465 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          MIFARE_DIR.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for caching the directory (applications,
+ *   files and DF names) of MIFARE DESFire cards in data EEPROM.
+ *   Card layouts almost never change after issuance, so a repeat card can skip
+ *   the GetApplicationIds, GetDfNames and per-application GetFileIds exchanges
+ *   and use its cached directory instead.
+ *
+ *   Records are keyed by UID plus a few GetVersion bytes, so a UID reused by a
+ *   different kind of card doesn't pick up a stale directory. When all records
+ *   are in use, the least recently used record is replaced.
+ *
+ * Table of Contents:
+ *   (local)
+ *   RecordAddr          - get EEPROM address of a record
+ *   VersionKey          - extract the version bytes a record is keyed by
+ *   FindRecord          - find a card's record
+ *   MaxStamp            - get the largest use stamp in use
+ *   NextStamp           - get the use stamp for the most recently used record
+ *
+ *   (public)
+ *   MifareDirLookup     - find a card's directory in the cache
+ *   MifareDirStore      - save a card's directory in the cache
+ *   MifareDirForget     - remove a card's directory from the cache
+ *   MifareDirDiscover   - enumerate a card's directory
+ *   MifareDirGet        - get a card's directory; from the cache if possible
+ *   MifareDirFindApp    - find an application in a directory
+ *
+ * Limitations:
+ *   Cards with more than MIFARE_DIR_MAX_APPS applications are not cached.
+ *   The firmware doesn't link in the mifare/ library yet (see its README), so
+ *   for now this is only built and tested on the host.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Noted it isn't in the firmware
+ *   Oct. 17, 2026      Nnoduka Eruchalu     No EEPROM write on a hit of the
+ *                                           most recently used record
+ */
+
+#include <string.h>   /* for mem* operations */
+#include <stddef.h>   /* for offsetof */
+#include "mifare_dir.h"
+#include "../eeprom.h"
+
+
+/* all records must fit in the EEPROM region set aside for them */
+typedef char mifare_dir_fits_eeprom[(MIFARE_DIR_RECORDS *
+                                     sizeof(mifare_dir_record) <=
+                                     EEPROM_MIFARE_DIR_SIZE) ? 1 : -1];
+
+
+/* shared variables have to be local to this file */
+static mifare_dir_record record;   /* working copy of an EEPROM record */
+
+
+/* local functions */
+static uint16_t RecordAddr(uint8_t i);
+static void VersionKey(mifare_desfire_version_info *version_info,
+                       uint8_t key[/*MIFARE_DIR_VERSION_SIZE*/]);
+static int FindRecord(uint8_t uid[/*7*/]);
+static uint16_t MaxStamp(void);
+static uint16_t NextStamp(void);
+
+
+/*
+ * RecordAddr
+ * Description: Get the EEPROM address of a record
+ *
+ * Arguments:   i - record index
+ * Return:      EEPROM address
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint16_t RecordAddr(uint8_t i)
+{
+  return EEPROM_MIFARE_DIR_ADDR + i*sizeof(mifare_dir_record);
+}
+
+
+/*
+ * VersionKey
+ * Description: Extract the GetVersion bytes a record is keyed by
+ *
+ * Arguments:   version_info - card's GetVersion info
+ *              key          - buffer to save key bytes in [modified]
+ * Return:      None
+ *
+ * Operation:   Keep hardware type and storage size, and software version.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void VersionKey(mifare_desfire_version_info *version_info,
+                       uint8_t key[/*MIFARE_DIR_VERSION_SIZE*/])
+{
+  key[0] = version_info->hardware.type;
+  key[1] = version_info->hardware.storage_size;
+  key[2] = version_info->software.version_major;
+  key[3] = version_info->software.version_minor;
+}
+
+
+/*
+ * FindRecord
+ * Description: Find the record of a card
+ *
+ * Arguments:   uid - card UID
+ * Return:      index of record, or FAIL if none
+ *
+ * Operation:   Read each record and compare its UID. On success the record is
+ *              left in the shared record.
+ *
+ * Shared:      record [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int FindRecord(uint8_t uid[/*7*/])
+{
+  uint8_t i;
+
+  for(i=0; i<MIFARE_DIR_RECORDS; i++) {
+    EepromRead(RecordAddr(i), &record, sizeof(record));
+    if((record.valid == MIFARE_DIR_VALID) &&
+       (memcmp(record.uid, uid, MIFARE_UID_BYTES) == 0)) {
+      return i;
+    }
+  }
+
+  return FAIL;
+}
+
+
+/*
+ * MaxStamp
+ * Description: Get the largest use stamp of the records in use, i.e. that of
+ *              the most recently used record.
+ *
+ * Arguments:   None
+ * Return:      largest use stamp, or 0 if no record is in use
+ *
+ * Shared:      record [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint16_t MaxStamp(void)
+{
+  uint16_t max = 0;
+  uint8_t i;
+
+  for(i=0; i<MIFARE_DIR_RECORDS; i++) {
+    EepromRead(RecordAddr(i), &record, sizeof(record));
+    if((record.valid == MIFARE_DIR_VALID) && (record.stamp > max))
+      max = record.stamp;
+  }
+
+  return max;
+}
+
+
+/*
+ * NextStamp
+ * Description: Get the use stamp to give the most recently used record.
+ *
+ * Arguments:   None
+ * Return:      use stamp
+ *
+ * Operation:   Return 1 more than the largest stamp in use.
+ *              If the stamps have run up to the max value, first renumber the
+ *              records 0, 1, 2, ... in their order of use.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint16_t NextStamp(void)
+{
+  uint16_t stamps[MIFARE_DIR_RECORDS];
+  uint8_t valid[MIFARE_DIR_RECORDS];
+  uint16_t max = 0;
+  uint16_t rank;
+  uint8_t i, j;
+
+  for(i=0; i<MIFARE_DIR_RECORDS; i++) {   /* get stamps of records in use */
+    EepromRead(RecordAddr(i), &record, sizeof(record));
+    valid[i] = (record.valid == MIFARE_DIR_VALID);
+    stamps[i] = record.stamp;
+    if(valid[i] && (stamps[i] > max)) max = stamps[i];
+  }
+
+  if(max < 0xFFFF)
+    return max + 1;
+
+  max = 0;                                /* renumber in order of use */
+  for(i=0; i<MIFARE_DIR_RECORDS; i++) {
+    if(!valid[i]) continue;
+    rank = 0;
+    for(j=0; j<MIFARE_DIR_RECORDS; j++) {
+      if(valid[j] && (stamps[j] < stamps[i])) rank++;
+    }
+    EepromWrite(RecordAddr(i) + offsetof(mifare_dir_record, stamp),
+                &rank, sizeof(rank));
+    if(rank > max) max = rank;
+  }
+
+  return max + 1;
+}
+
+
+/*
+ * MifareDirLookup
+ * Description: Find a card's directory in the cache.
+ *
+ * Arguments:   uid          - card UID
+ *              version_info - card's GetVersion info
+ *              dir          - buffer to save directory in [modified]
+ * Return:      SUCCESS: directory found
+ *              FAIL:    card not cached
+ *
+ * Operation:   Find the card's record. If its version bytes don't match this
+ *              is a different card with the same UID so drop the record.
+ *              Else copy out the directory and mark the record most recently
+ *              used, unless it already is: a card tapped again and again
+ *              then costs no EEPROM writes.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Skip the stamp write if the record
+ *                                           is already most recently used
+ */
+int MifareDirLookup(uint8_t uid[/*7*/],
+                    mifare_desfire_version_info *version_info, mifare_dir *dir)
+{
+  uint8_t key[MIFARE_DIR_VERSION_SIZE];
+  uint16_t stamp;
+  int i = FindRecord(uid);
+
+  if(i == FAIL)
+    return FAIL;
+
+  VersionKey(version_info, key);
+  if(memcmp(record.version, key, MIFARE_DIR_VERSION_SIZE) != 0) {
+    MifareDirForget(uid);
+    return FAIL;
+  }
+
+  memcpy(dir, &record.dir, sizeof(mifare_dir));
+
+  stamp = record.stamp;               /* MaxStamp reads over record */
+  if(stamp < MaxStamp()) {            /* not most recently used yet */
+    stamp = NextStamp();
+    EepromWrite(RecordAddr(i) + offsetof(mifare_dir_record, stamp),
+                &stamp, sizeof(stamp));
+  }
+
+  return SUCCESS;
+}
+
+
+/*
+ * MifareDirStore
+ * Description: Save a card's directory in the cache.
+ *
+ * Arguments:   uid          - card UID
+ *              version_info - card's GetVersion info
+ *              dir          - directory to save
+ * Return:      None
+ *
+ * Operation:   Overwrite the card's record if it has one. Else use a free
+ *              record, and if there is none replace the least recently used
+ *              record.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifareDirStore(uint8_t uid[/*7*/],
+                    mifare_desfire_version_info *version_info, mifare_dir *dir)
+{
+  uint16_t lru_stamp = 0xFFFF;
+  uint8_t lru = 0;
+  uint8_t i;
+  int slot = FindRecord(uid);
+
+  if(slot == FAIL) {                     /* pick a free or the LRU record */
+    for(i=0; i<MIFARE_DIR_RECORDS; i++) {
+      EepromRead(RecordAddr(i), &record, sizeof(record));
+      if(record.valid != MIFARE_DIR_VALID) {
+        lru = i;
+        break;
+      }
+      if(record.stamp <= lru_stamp) {
+        lru_stamp = record.stamp;
+        lru = i;
+      }
+    }
+    slot = lru;
+  }
+
+  record.stamp = NextStamp();
+  record.valid = MIFARE_DIR_VALID;
+  memcpy(record.uid, uid, MIFARE_UID_BYTES);
+  VersionKey(version_info, record.version);
+  memcpy(&record.dir, dir, sizeof(mifare_dir));
+
+  EepromWrite(RecordAddr(slot), &record, sizeof(record));
+}
+
+
+/*
+ * MifareDirForget
+ * Description: Remove a card's directory from the cache. Use this when a
+ *              cached directory proves wrong, e.g. an application in it is not
+ *              found on the card.
+ *
+ * Arguments:   uid - card UID
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifareDirForget(uint8_t uid[/*7*/])
+{
+  uint8_t invalid = EEPROM_ERASED;
+  int i = FindRecord(uid);
+
+  if(i != FAIL) {
+    EepromWrite(RecordAddr(i) + offsetof(mifare_dir_record, valid),
+                &invalid, sizeof(invalid));
+  }
+}
+
+
+/*
+ * MifareDirDiscover
+ * Description: Enumerate a card's directory.
+ *
+ * Arguments:   tag - DESFire tag
+ *              dir - buffer to save directory in [modified]
+ * Return:      SUCCESS: directory enumerated
+ *              FAIL:    failed, or card has too many applications to cache
+ *
+ * Operation:   At PICC level get the AIDs, and the DF names (EV1 only, so a
+ *              failure here just means no DF names). Then select each
+ *              application and get its file IDs. Finally go back to PICC
+ *              level.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareDirDiscover(mifare_tag *tag, mifare_dir *dir)
+{
+  uint32_t aids[MIFARE_DIR_MAX_APPS];
+  mifare_desfire_df dfs[MIFARE_DIR_MAX_APPS];
+  uint8_t files[MIFARE_MAX_FILE_COUNT];
+  size_t count, nfiles;
+  uint8_t i, j;
+
+  ASSERT_ACTIVE(tag);
+
+  memset(dir, 0, sizeof(mifare_dir));
+  memset(dfs, 0, sizeof(dfs));
+
+  if(MifareSelectApplication(tag, 0x000000) != SUCCESS)
+    return FAIL;
+  if(MifareGetApplicationIds(tag, aids, MIFARE_DIR_MAX_APPS, &count)!=SUCCESS)
+    return FAIL;
+  if(count > MIFARE_DIR_MAX_APPS)
+    return FAIL;
+  MifareGetDfNames(tag, dfs, MIFARE_DIR_MAX_APPS, &nfiles);
+
+  dir->count = count;
+  for(i=0; i<count; i++) {
+    dir->apps[i].aid = aids[i];
+
+    for(j=0; j<MIFARE_DIR_MAX_APPS; j++) {  /* match up DF names */
+      if((dfs[j].df_name_len > 0) && (dfs[j].aid == aids[i])) {
+        dir->apps[i].iso_fid = dfs[j].fid;
+        dir->apps[i].df_name_len = MIN(dfs[j].df_name_len,
+                                       MIFARE_DIR_DF_NAME_SIZE);
+        memcpy(dir->apps[i].df_name, dfs[j].df_name,
+               dir->apps[i].df_name_len);
+      }
+    }
+
+    if((MifareSelectApplication(tag, aids[i]) != SUCCESS) ||
+       (MifareGetFileIds(tag, files, MIFARE_MAX_FILE_COUNT, &nfiles) !=
+        SUCCESS)) {
+      return FAIL;
+    }
+    for(j=0; (j<nfiles) && (j<MIFARE_MAX_FILE_COUNT); j++) {
+      if(files[j] < MIFARE_MAX_FILE_COUNT)
+        dir->apps[i].files |= (uint16_t)1 << files[j];
+    }
+  }
+
+  return MifareSelectApplication(tag, 0x000000);
+}
+
+
+/*
+ * MifareDirGet
+ * Description: Get a card's directory; from the cache if possible.
+ *
+ * Arguments:   tag - DESFire tag
+ *              dir - buffer to save directory in [modified]
+ * Return:      SUCCESS/FAIL
+ *
+ * Operation:   Get the card's version info, and look up the card in the
+ *              cache. On a miss enumerate the card, and cache the result.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareDirGet(mifare_tag *tag, mifare_dir *dir)
+{
+  mifare_desfire_version_info version_info;
+
+  ASSERT_ACTIVE(tag);
+
+  if(MifareGetVersion(tag, &version_info) != SUCCESS)
+    return FAIL;
+
+  if(MifareDirLookup(tag->uid, &version_info, dir) == SUCCESS)
+    return SUCCESS;
+
+  if(MifareDirDiscover(tag, dir) != SUCCESS)
+    return FAIL;
+
+  MifareDirStore(tag->uid, &version_info, dir);
+  return SUCCESS;
+}
+
+
+/*
+ * MifareDirFindApp
+ * Description: Find an application in a directory
+ *
+ * Arguments:   dir - card directory
+ *              aid - application ID
+ * Return:      pointer to application entry, or NULL if not found
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+mifare_dir_app *MifareDirFindApp(mifare_dir *dir, uint32_t aid)
+{
+  uint8_t i;
+
+  for(i=0; (i<dir->count) && (i<MIFARE_DIR_MAX_APPS); i++) {
+    if(dir->apps[i].aid == aid)
+      return &dir->apps[i];
+  }
+
+  return NULL;
+}
@@ -0,0 +1,99 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          MIFARE_DIR.H                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for mifare_dir.c, the library of functions for
+ *   caching the directory (applications, files and DF names) of MIFARE
+ *   DESFire cards in data EEPROM.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef MIFARE_DIR_H
+#define MIFARE_DIR_H
+
+/* library include files */
+#include <stdint.h>    /* for uint*_t */
+
+/* local include files */
+#include "mifare.h"
+
+
+/* --------------------------------------
+ * Directory Cache Constants
+ * --------------------------------------
+ */
+#define MIFARE_DIR_MAX_APPS     2    /* max # of applications per card */
+#define MIFARE_DIR_RECORDS      4    /* # of cards cached */
+#define MIFARE_DIR_VERSION_SIZE 4    /* bytes of GetVersion info kept */
+#define MIFARE_DIR_DF_NAME_SIZE 16   /* max DF name length */
+
+#define MIFARE_DIR_VALID        0xA5 /* marks a record in use */
+
+
+/* --------------------------------------
+ * Directory Cache Data Objects
+ * --------------------------------------
+ */
+typedef struct {
+  uint32_t aid;                          /* application ID */
+  uint16_t iso_fid;                      /* ISO file ID (0 if none) */
+  uint16_t files;                        /* bit n set if file n exists */
+  uint8_t df_name_len;                   /* 0 if no DF name */
+  uint8_t df_name[MIFARE_DIR_DF_NAME_SIZE];
+} mifare_dir_app;
+
+
+typedef struct {
+  uint8_t count;                         /* # of applications on card */
+  mifare_dir_app apps[MIFARE_DIR_MAX_APPS];
+} mifare_dir;
+
+
+typedef struct {                         /* a record as saved in EEPROM */
+  uint8_t valid;                         /* MIFARE_DIR_VALID if in use */
+  uint8_t uid[MIFARE_UID_BYTES];
+  uint8_t version[MIFARE_DIR_VERSION_SIZE];
+  uint16_t stamp;                        /* last use; larger is more recent */
+  mifare_dir dir;
+} mifare_dir_record;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* find a card's directory in the cache */
+extern int MifareDirLookup(uint8_t uid[/*7*/],
+                           mifare_desfire_version_info *version_info,
+                           mifare_dir *dir);
+
+/* save a card's directory in the cache */
+extern void MifareDirStore(uint8_t uid[/*7*/],
+                           mifare_desfire_version_info *version_info,
+                           mifare_dir *dir);
+
+/* remove a card's directory from the cache */
+extern void MifareDirForget(uint8_t uid[/*7*/]);
+
+/* enumerate a card's directory */
+extern int MifareDirDiscover(mifare_tag *tag, mifare_dir *dir);
+
+/* get a card's directory; from the cache if possible */
+extern int MifareDirGet(mifare_tag *tag, mifare_dir *dir);
+
+/* find an application in a directory */
+extern mifare_dir_app *MifareDirFindApp(mifare_dir *dir, uint32_t aid);
+
+
+#endif                                                        /* MIFARE_DIR_H */
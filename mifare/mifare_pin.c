@@ -0,0 +1,277 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          MIFARE_PIN.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for verifying an EasyCard PIN offline. The
+ *   card holds a salted PIN verifier: the CMAC of the salt and PIN, computed
+ *   with a key diversified from a terminal-held master key and the card's UID.
+ *   Checking a PIN then takes a card read instead of a server round trip, and
+ *   a verifier copied to another card (or leaked) is useless elsewhere.
+ *
+ *   Wrong PINs are counted on the card itself, so pulling the card and trying
+ *   again at another terminal doesn't reset the count. A try is used up before
+ *   the PIN is checked, and given back only when it turns out correct.
+ *
+ * Table of Contents:
+ *   (local)
+ *   PinVerifier           - get the verifier of a salted PIN
+ *
+ *   (public)
+ *   MifarePinDiversifyKey - get a card's PIN key from the master key
+ *   MifarePinEncode       - encode a PIN into its on-card verifier record
+ *   MifarePinDecode       - decode the counters of an on-card verifier record
+ *   MifarePinMatch        - check a PIN against an on-card verifier record
+ *   MifarePinVerify       - verify a PIN against the card
+ *
+ * Limitations:
+ *   The master key has to be an AES key.
+ *   Only MIFARE_PIN_VERSION records are understood.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Sized the verify read buffer
+ */
+
+#include <string.h>   /* for mem* operations */
+#include "mifare_pin.h"
+#include "mifare_key.h"
+#include "mifare_crypto.h"
+
+
+/* local functions */
+static void PinVerifier(mifare_desfire_key *key, uint8_t salt[], uint32_t pin,
+                        uint8_t verifier[/*MIFARE_PIN_VERIFIER_LENGTH*/]);
+
+
+/*
+ * PinVerifier
+ * Description: Get the verifier of a salted PIN
+ *
+ * Arguments:   key      - card's PIN key [subkeys modified]
+ *              salt     - MIFARE_PIN_SALT_LENGTH bytes of salt
+ *              pin      - PIN
+ *              verifier - MIFARE_PIN_VERIFIER_LENGTH bytes of verifier
+ *                         [modified]
+ * Return:      None
+ *
+ * Operation:   CMAC the salt followed by the 4-byte little endian PIN, starting
+ *              with an all 0s ivect, and keep the first bytes.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void PinVerifier(mifare_desfire_key *key, uint8_t salt[], uint32_t pin,
+                        uint8_t verifier[/*MIFARE_PIN_VERIFIER_LENGTH*/])
+{
+  uint8_t data[MIFARE_PIN_SALT_LENGTH + 4];
+  uint8_t ivect[MAX_CRYPTO_BLOCK_SIZE];
+  uint8_t cmac[MAX_CRYPTO_BLOCK_SIZE];
+
+  memcpy(data, salt, MIFARE_PIN_SALT_LENGTH);
+  data[MIFARE_PIN_SALT_LENGTH] = (uint8_t) pin;
+  data[MIFARE_PIN_SALT_LENGTH+1] = (uint8_t) (pin >> 8);
+  data[MIFARE_PIN_SALT_LENGTH+2] = (uint8_t) (pin >> 16);
+  data[MIFARE_PIN_SALT_LENGTH+3] = (uint8_t) (pin >> 24);
+  memset(ivect, 0, MAX_CRYPTO_BLOCK_SIZE);
+
+  CmacGenerateSubkeys(key);
+  Cmac(key, ivect, data, sizeof(data), cmac);
+  memcpy(verifier, cmac, MIFARE_PIN_VERIFIER_LENGTH);
+}
+
+
+/*
+ * MifarePinDiversifyKey
+ * Description: Get a card's PIN key by diversifying an AES master key with
+ *              the card's UID
+ *
+ * Arguments:   master - AES master key [subkeys modified]
+ *              uid    - UID of card
+ *              key    - card's AES PIN key [modified]
+ * Return:      None
+ *
+ * Operation:   The card's key is the CMAC of 0x01 followed by the UID, with the
+ *              master key and an all 0s ivect.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifarePinDiversifyKey(mifare_desfire_key *master, uint8_t uid[/*7*/],
+                           mifare_desfire_key *key)
+{
+  uint8_t data[1 + MIFARE_UID_BYTES];
+  uint8_t ivect[MAX_CRYPTO_BLOCK_SIZE];
+  uint8_t value[MAX_CRYPTO_BLOCK_SIZE];
+
+  data[0] = 0x01;                     /* diversification constant for AES-128 */
+  memcpy(data + 1, uid, MIFARE_UID_BYTES);
+  memset(ivect, 0, MAX_CRYPTO_BLOCK_SIZE);
+
+  CmacGenerateSubkeys(master);
+  Cmac(master, ivect, data, sizeof(data), value);
+  MifareAesKeyNew(key, value);
+}
+
+
+/*
+ * MifarePinEncode
+ * Description: Encode a PIN into its on-card verifier record
+ *
+ * Arguments:   pin_info - try counters and salt to encode
+ *              pin      - PIN
+ *              uid      - UID of card the record is for
+ *              master   - AES master key
+ *              blob     - MIFARE_PIN_SIZE bytes of record [modified]
+ * Return:      None
+ *
+ * Operation:   Lay out the fields as described in mifare_pin.h, zero the
+ *              reserved byte and append the verifier.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifarePinEncode(mifare_pin *pin_info, uint32_t pin, uint8_t uid[/*7*/],
+                     mifare_desfire_key *master,
+                     uint8_t blob[/*MIFARE_PIN_SIZE*/])
+{
+  mifare_desfire_key key;
+
+  memset(blob, 0, MIFARE_PIN_SIZE);
+
+  blob[MIFARE_PIN_VERSION_OFS] = MIFARE_PIN_VERSION;
+  blob[MIFARE_PIN_TRIES_OFS] = pin_info->tries;
+  blob[MIFARE_PIN_MAX_TRIES_OFS] = pin_info->max_tries;
+  memcpy(blob + MIFARE_PIN_SALT_OFS, pin_info->salt, MIFARE_PIN_SALT_LENGTH);
+
+  MifarePinDiversifyKey(master, uid, &key);
+  PinVerifier(&key, pin_info->salt, pin, blob + MIFARE_PIN_VERIFIER_OFS);
+}
+
+
+/*
+ * MifarePinDecode
+ * Description: Decode the try counters and salt of an on-card verifier record
+ *
+ * Arguments:   blob     - MIFARE_PIN_SIZE bytes of record
+ *              pin_info - decoded counters and salt [modified]
+ * Return:      SUCCESS: record decoded
+ *              FAIL:    unknown version
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifarePinDecode(uint8_t blob[/*MIFARE_PIN_SIZE*/], mifare_pin *pin_info)
+{
+  if (blob[MIFARE_PIN_VERSION_OFS] != MIFARE_PIN_VERSION)
+    return FAIL;
+
+  pin_info->tries = blob[MIFARE_PIN_TRIES_OFS];
+  pin_info->max_tries = blob[MIFARE_PIN_MAX_TRIES_OFS];
+  memcpy(pin_info->salt, blob + MIFARE_PIN_SALT_OFS, MIFARE_PIN_SALT_LENGTH);
+
+  return SUCCESS;
+}
+
+
+/*
+ * MifarePinMatch
+ * Description: Check a PIN against an on-card verifier record
+ *
+ * Arguments:   blob   - MIFARE_PIN_SIZE bytes of record
+ *              uid    - UID of card the record was read from
+ *              master - AES master key
+ *              pin    - PIN to check
+ * Return:      TRUE:  PIN matches the verifier
+ *              FALSE: PIN doesn't match, or unknown record version
+ *
+ * Operation:   Recompute the verifier and compare all its bytes, without
+ *              stopping at the first difference.
+ *              Try counters are left to the caller.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t MifarePinMatch(uint8_t blob[/*MIFARE_PIN_SIZE*/], uint8_t uid[/*7*/],
+                       mifare_desfire_key *master, uint32_t pin)
+{
+  mifare_desfire_key key;
+  uint8_t verifier[MIFARE_PIN_VERIFIER_LENGTH];
+  uint8_t diff = 0;
+  size_t i;
+
+  if (blob[MIFARE_PIN_VERSION_OFS] != MIFARE_PIN_VERSION)
+    return FALSE;
+
+  MifarePinDiversifyKey(master, uid, &key);
+  PinVerifier(&key, blob + MIFARE_PIN_SALT_OFS, pin, verifier);
+
+  for (i = 0; i < MIFARE_PIN_VERIFIER_LENGTH; i++)
+    diff |= verifier[i] ^ blob[MIFARE_PIN_VERIFIER_OFS + i];
+
+  return (diff == 0);
+}
+
+
+/*
+ * MifarePinVerify
+ * Description: Verify a PIN against the card, keeping count of wrong tries
+ *              on-card
+ *
+ * Arguments:   tag    - DESFire tag, with the EasyCard application selected
+ *                       and authenticated with a key allowing reads and writes
+ *              master - AES master key
+ *              pin    - PIN to verify
+ * Return:      MIFARE_PIN_OK:      PIN is correct
+ *              MIFARE_PIN_WRONG:   PIN is wrong
+ *              MIFARE_PIN_BLOCKED: no tries left
+ *              FAIL:               card error or unknown record, so the
+ *                                  caller should fall back to the server
+ *
+ * Operation:   Read the record in one command. If tries are left, use one up
+ *              on the card before checking the PIN, so an interrupted check
+ *              still counts. A correct PIN restores the tries.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Room for CRC/MAC and status in read
+ */
+int MifarePinVerify(mifare_tag *tag, mifare_desfire_key *master, uint32_t pin)
+{
+  /* room for the record, then CRC/MAC and padding, and status byte */
+  uint8_t blob[MIFARE_PIN_SIZE + 2*MAX_CRYPTO_BLOCK_SIZE + 1];
+  mifare_pin pin_info;
+  ssize_t size;
+  size_t sent;
+
+  if ((MifareReadData(tag, MIFARE_PIN_FILE_NO, 0, MIFARE_PIN_SIZE,
+                      blob, sizeof(blob), &size) < 0) ||
+      (size != MIFARE_PIN_SIZE) ||
+      (MifarePinDecode(blob, &pin_info) < 0))
+    return FAIL;
+
+  if (pin_info.tries == 0)
+    return MIFARE_PIN_BLOCKED;
+
+  pin_info.tries--;                   /* use up a try before checking */
+  if ((MifareWriteData(tag, MIFARE_PIN_FILE_NO, MIFARE_PIN_TRIES_OFS, 1,
+                       &pin_info.tries, &sent) < 0) || (sent != 1))
+    return FAIL;
+
+  if (!MifarePinMatch(blob, tag->uid, master, pin))
+    return MIFARE_PIN_WRONG;
+
+  if (pin_info.tries != pin_info.max_tries) { /* give back the try (and any */
+    pin_info.tries = pin_info.max_tries;      /* previously used up)        */
+    if ((MifareWriteData(tag, MIFARE_PIN_FILE_NO, MIFARE_PIN_TRIES_OFS, 1,
+                         &pin_info.tries, &sent) < 0) || (sent != 1))
+      return FAIL;
+  }
+
+  return MIFARE_PIN_OK;
+}
@@ -0,0 +1,100 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          MIFARE_PIN.H                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for mifare_pin.c, the library of functions for
+ *   verifying an EasyCard PIN offline, against a verifier stored on the card.
+ *
+ * Assumptions:
+ *   The PIN file's write access requires a key only terminals hold, since the
+ *   try counter itself isn't MAC'd.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef MIFARE_PIN_H
+#define MIFARE_PIN_H
+
+/* library include files */
+#include <stdint.h>    /* for uint*_t */
+
+/* local include files */
+#include "mifare.h"
+
+
+/* --------------------------------------
+ * PIN Verifier Constants
+ * --------------------------------------
+ */
+#define MIFARE_PIN_VERSION      1    /* layout version written by this code */
+#define MIFARE_PIN_FILE_NO      0x03 /* standard data file holding verifier */
+#define MIFARE_PIN_MAX_TRIES    3    /* wrong PINs allowed before blocking */
+#define MIFARE_PIN_SALT_LENGTH  4    /* bytes of per-card salt */
+#define MIFARE_PIN_VERIFIER_LENGTH 8 /* bytes of verifier kept */
+
+/*
+ * PIN record layout. The PIN is hashed little endian, like DESFire.
+ * +---------+-------+-----------+------+------+----------+
+ * | version | tries | max tries | rsvd | salt | verifier |
+ * +---------+-------+-----------+------+------+----------+
+ *      1        1         1        1      4        8
+ */
+#define MIFARE_PIN_VERSION_OFS   0
+#define MIFARE_PIN_TRIES_OFS     1
+#define MIFARE_PIN_MAX_TRIES_OFS 2
+#define MIFARE_PIN_SALT_OFS      4
+#define MIFARE_PIN_VERIFIER_OFS  8
+#define MIFARE_PIN_SIZE          16  /* bytes of PIN file used */
+
+/* MifarePinVerify results, besides FAIL (card error, so ask the server) */
+#define MIFARE_PIN_OK           0    /* PIN is correct */
+#define MIFARE_PIN_WRONG        1    /* PIN is wrong, a try has been used up */
+#define MIFARE_PIN_BLOCKED      2    /* no tries left, PIN wasn't checked */
+
+
+/* --------------------------------------
+ * PIN Verifier Data Objects
+ * --------------------------------------
+ */
+typedef struct {
+  uint8_t tries;                         /* wrong PINs left before blocking */
+  uint8_t max_tries;                     /* tries restored by a correct PIN */
+  uint8_t salt[MIFARE_PIN_SALT_LENGTH];  /* per-card verifier salt */
+} mifare_pin;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* get a card's PIN key by diversifying an AES master key with its UID */
+extern void MifarePinDiversifyKey(mifare_desfire_key *master,
+                                  uint8_t uid[/*7*/], mifare_desfire_key *key);
+
+/* encode a PIN into its on-card verifier record */
+extern void MifarePinEncode(mifare_pin *pin_info, uint32_t pin,
+                            uint8_t uid[/*7*/], mifare_desfire_key *master,
+                            uint8_t blob[/*MIFARE_PIN_SIZE*/]);
+
+/* decode the try counters and salt of an on-card verifier record */
+extern int MifarePinDecode(uint8_t blob[/*MIFARE_PIN_SIZE*/],
+                           mifare_pin *pin_info);
+
+/* check a PIN against an on-card verifier record */
+extern uint8_t MifarePinMatch(uint8_t blob[/*MIFARE_PIN_SIZE*/],
+                              uint8_t uid[/*7*/], mifare_desfire_key *master,
+                              uint32_t pin);
+
+/* verify a PIN against the card, keeping count of wrong tries on-card */
+extern int MifarePinVerify(mifare_tag *tag, mifare_desfire_key *master,
+                           uint32_t pin);
+
+
+#endif                                                        /* MIFARE_PIN_H */
@@ -0,0 +1,250 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         MIFARE_TXLOG.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for the EasyCard's on-card transaction log:
+ *   a cyclic record file with a compact fixed-size record per payment. The
+ *   record is written in the same DESFire transaction as the value debit, so
+ *   either both land on the card or neither does. A terminal can read back the
+ *   last few payments in one command, which settles disputes offline.
+ *
+ *   Each record carries a MAC over the card's UID and the record's fields,
+ *   computed with a key the terminal holds, so records can't be forged or
+ *   copied over from another card.
+ *
+ * Table of Contents:
+ *   (local)
+ *   RecordMac          - get the MAC of a log record
+ *
+ *   (public)
+ *   MifareTxlogEncode  - encode a log entry into its on-card record
+ *   MifareTxlogDecode  - decode and verify an on-card log record
+ *   MifareTxlogDebit   - debit a value file and log it in one transaction
+ *   MifareTxlogReadLast - read the last n log entries in one command
+ *
+ * Limitations:
+ *   The firmware doesn't link in the mifare/ library yet (see its README), so
+ *   for now this is only built and tested on the host.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read the log without GetFileSettings
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Noted it isn't in the firmware
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Little endian helpers in mifare.c
+ */
+
+#include <string.h>   /* for mem* operations */
+#include "mifare_txlog.h"
+#include "mifare_crypto.h"
+
+
+/* local functions */
+static void RecordMac(uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/],
+                      uint8_t uid[/*7*/], mifare_desfire_key *key,
+                      uint8_t mac[/*MAC_LENGTH*/]);
+
+
+/*
+ * RecordMac
+ * Description: Get the MAC of a log record
+ *
+ * Arguments:   record - log record; only fields before the MAC are used
+ *              uid    - UID of card the record belongs to
+ *              key    - log key [subkeys modified]
+ *              mac    - MAC_LENGTH bytes of MAC [modified]
+ * Return:      None
+ *
+ * Operation:   CMAC the UID followed by the record fields, starting with an
+ *              all 0s ivect, and keep the first MAC_LENGTH bytes; a record is
+ *              small and there are many of them.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void RecordMac(uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/],
+                      uint8_t uid[/*7*/], mifare_desfire_key *key,
+                      uint8_t mac[/*MAC_LENGTH*/])
+{
+  uint8_t data[MIFARE_UID_BYTES + MIFARE_TXLOG_MAC_OFS];
+  uint8_t ivect[MAX_CRYPTO_BLOCK_SIZE];
+  uint8_t cmac[MAX_CRYPTO_BLOCK_SIZE];
+
+  memcpy(data, uid, MIFARE_UID_BYTES);
+  memcpy(data + MIFARE_UID_BYTES, record, MIFARE_TXLOG_MAC_OFS);
+  memset(ivect, 0, MAX_CRYPTO_BLOCK_SIZE);
+
+  CmacGenerateSubkeys(key);
+  Cmac(key, ivect, data, sizeof(data), cmac);
+  memcpy(mac, cmac, MAC_LENGTH);
+}
+
+
+/*
+ * MifareTxlogEncode
+ * Description: Encode a log entry into its on-card record
+ *
+ * Arguments:   entry  - log entry to encode
+ *              uid    - UID of card the record is for
+ *              key    - log key
+ *              record - MIFARE_TXLOG_RECORD_SIZE bytes of record [modified]
+ * Return:      None
+ *
+ * Operation:   Lay out the fields as described in mifare_txlog.h and append
+ *              the MAC.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifareTxlogEncode(mifare_txlog_entry *entry, uint8_t uid[/*7*/],
+                       mifare_desfire_key *key,
+                       uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/])
+{
+  MifarePutLe32(record + MIFARE_TXLOG_AMOUNT_OFS, entry->amount);
+  MifarePutLe32(record + MIFARE_TXLOG_TERMINAL_OFS, entry->terminal);
+  MifarePutLe32(record + MIFARE_TXLOG_TIME_OFS, entry->time);
+  record[MIFARE_TXLOG_SEQ_OFS] = (uint8_t) entry->seq;
+  record[MIFARE_TXLOG_SEQ_OFS+1] = (uint8_t) (entry->seq >> 8);
+
+  RecordMac(record, uid, key, record + MIFARE_TXLOG_MAC_OFS);
+}
+
+
+/*
+ * MifareTxlogDecode
+ * Description: Decode and verify an on-card log record
+ *
+ * Arguments:   record - MIFARE_TXLOG_RECORD_SIZE bytes of record
+ *              uid    - UID of card the record was read from
+ *              key    - log key
+ *              entry  - decoded log entry [modified]
+ * Return:      SUCCESS: record is valid and has been decoded
+ *              FAIL:    MAC mismatch
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareTxlogDecode(uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/],
+                      uint8_t uid[/*7*/], mifare_desfire_key *key,
+                      mifare_txlog_entry *entry)
+{
+  uint8_t mac[MAC_LENGTH];
+
+  RecordMac(record, uid, key, mac);
+  if (memcmp(mac, record + MIFARE_TXLOG_MAC_OFS, MAC_LENGTH))
+    return FAIL;
+
+  entry->amount = MifareGetLe32(record + MIFARE_TXLOG_AMOUNT_OFS);
+  entry->terminal = MifareGetLe32(record + MIFARE_TXLOG_TERMINAL_OFS);
+  entry->time = MifareGetLe32(record + MIFARE_TXLOG_TIME_OFS);
+  entry->seq = (uint16_t) record[MIFARE_TXLOG_SEQ_OFS] |
+    ((uint16_t) record[MIFARE_TXLOG_SEQ_OFS+1] << 8);
+
+  return SUCCESS;
+}
+
+
+/*
+ * MifareTxlogDebit
+ * Description: Debit a value file and log it in one transaction
+ *
+ * Arguments:   tag           - DESFire tag, with the EasyCard application
+ *                              selected and authenticated with a key allowing
+ *                              debits and record writes
+ *              value_file_no - value file to debit
+ *              key           - log key
+ *              entry         - payment to debit and log
+ * Return:      SUCCESS: debit and log record committed
+ *              FAIL:    nothing changed on the card
+ *
+ * Operation:   Debit, write the log record then CommitTransaction. DESFire
+ *              holds both changes until the commit, so if anything fails
+ *              AbortTransaction drops both and the card is untouched.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareTxlogDebit(mifare_tag *tag, uint8_t value_file_no,
+                     mifare_desfire_key *key, mifare_txlog_entry *entry)
+{
+  uint8_t record[MIFARE_TXLOG_RECORD_SIZE];
+  size_t sent;
+
+  MifareTxlogEncode(entry, tag->uid, key, record);
+
+  if ((MifareDebit(tag, value_file_no, (int32_t) entry->amount) < 0) ||
+      (MifareWriteRecord(tag, MIFARE_TXLOG_FILE_NO, 0, sizeof(record), record,
+                         &sent) < 0) ||
+      (sent != sizeof(record)) ||
+      (MifareCommitTransaction(tag) < 0)) {
+    MifareAbortTransaction(tag);
+    return FAIL;
+  }
+
+  return SUCCESS;
+}
+
+
+/*
+ * MifareTxlogReadLast
+ * Description: Read the last n log entries in one command
+ *
+ * Arguments:   tag     - DESFire tag, with the EasyCard application selected
+ *                        and authenticated with a key allowing reads
+ *              key     - log key
+ *              entries - log entries, most recent first [modified]
+ *              n       - # of entries wanted
+ *              count   - # of entries read [modified]
+ * Return:      SUCCESS: count entries read and verified
+ *              FAIL:    read failed, or a record failed verification
+ *
+ * Operation:   The file holds at most MIFARE_TXLOG_RECORDS records, so a
+ *              single ReadRecords of all of them (a length of 0) gets them
+ *              across as many frames as needed, and the size of the reply
+ *              gives the record count. There's no GetFileSettings to learn
+ *              the count, and the communication mode comes from the file
+ *              settings cache. An empty file is a boundary error.
+ *              The card returns the records oldest first, so decode the last
+ *              n into entries in reverse.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Record count from the reply
+ */
+int MifareTxlogReadLast(mifare_tag *tag, mifare_desfire_key *key,
+                        mifare_txlog_entry entries[], uint8_t n,
+                        uint8_t *count)
+{
+  /* room for records, then CRC/MAC and padding, and status byte */
+  uint8_t buffer[MIFARE_TXLOG_RECORDS*MIFARE_TXLOG_RECORD_SIZE +
+                 2*MAX_CRYPTO_BLOCK_SIZE + 1];
+  ssize_t size;
+  uint8_t records, i;
+
+  *count = 0;
+
+  tag->last_picc_error = MF_OPERATION_OK;
+  if (MifareReadRecords(tag, MIFARE_TXLOG_FILE_NO, 0, 0, buffer,
+                        sizeof(buffer), &size) < 0)
+    return (tag->last_picc_error == MF_BOUNDARY_ERROR) ? SUCCESS : FAIL;
+
+  if ((size <= 0) || (size % MIFARE_TXLOG_RECORD_SIZE != 0))
+    return FAIL;
+  records = size / MIFARE_TXLOG_RECORD_SIZE;
+  if (n > records)
+    n = records;
+
+  for (i = 0; i < n; i++) {          /* latest record is the last one */
+    if (MifareTxlogDecode(buffer + (records-1-i)*MIFARE_TXLOG_RECORD_SIZE,
+                          tag->uid, key, &entries[i]) < 0)
+      return FAIL;
+  }
+
+  *count = n;
+  return SUCCESS;
+}
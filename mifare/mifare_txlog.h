@@ -0,0 +1,90 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         MIFARE_TXLOG.H                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for mifare_txlog.c, the library of functions for
+ *   the EasyCard's on-card transaction log.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed MIFARE_TXLOG_READ_MAX
+ */
+
+#ifndef MIFARE_TXLOG_H
+#define MIFARE_TXLOG_H
+
+/* library include files */
+#include <stdint.h>    /* for uint*_t */
+
+/* local include files */
+#include "mifare.h"
+
+
+/* --------------------------------------
+ * Transaction Log Constants
+ * --------------------------------------
+ */
+#define MIFARE_TXLOG_FILE_NO    0x02 /* cyclic record file holding the log */
+#define MIFARE_TXLOG_RECORDS    10   /* records kept (file is created with +1) */
+
+/*
+ * Log record layout. Multi-byte fields are little endian, like DESFire.
+ * +--------+----------+------+-----+-----+
+ * | amount | terminal | time | seq | MAC |
+ * +--------+----------+------+-----+-----+
+ *      4        4        4      2     4
+ */
+#define MIFARE_TXLOG_AMOUNT_OFS    0
+#define MIFARE_TXLOG_TERMINAL_OFS  4
+#define MIFARE_TXLOG_TIME_OFS      8
+#define MIFARE_TXLOG_SEQ_OFS       12
+#define MIFARE_TXLOG_MAC_OFS       14  /* end of MAC'd data */
+#define MIFARE_TXLOG_RECORD_SIZE   18
+
+
+/* --------------------------------------
+ * Transaction Log Data Objects
+ * --------------------------------------
+ */
+typedef struct {
+  uint32_t amount;                       /* amount paid (in kobo) */
+  uint32_t terminal;                     /* ID of terminal that took payment */
+  uint32_t time;                         /* time of payment (in seconds) */
+  uint16_t seq;                          /* card's transaction sequence # */
+} mifare_txlog_entry;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* encode a log entry into its on-card record */
+extern void MifareTxlogEncode(mifare_txlog_entry *entry, uint8_t uid[/*7*/],
+                              mifare_desfire_key *key,
+                              uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/]);
+
+/* decode and verify an on-card log record */
+extern int MifareTxlogDecode(uint8_t record[/*MIFARE_TXLOG_RECORD_SIZE*/],
+                             uint8_t uid[/*7*/], mifare_desfire_key *key,
+                             mifare_txlog_entry *entry);
+
+/* debit a value file and log it in one transaction */
+extern int MifareTxlogDebit(mifare_tag *tag, uint8_t value_file_no,
+                            mifare_desfire_key *key, mifare_txlog_entry *entry);
+
+/* read the last n log entries in one command */
+extern int MifareTxlogReadLast(mifare_tag *tag, mifare_desfire_key *key,
+                               mifare_txlog_entry entries[], uint8_t n,
+                               uint8_t *count);
+
+
+#endif                                                      /* MIFARE_TXLOG_H */
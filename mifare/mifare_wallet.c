@@ -0,0 +1,228 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                        MIFARE_WALLET.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is a library of functions for the EasyCard wallet record: a fixed
+ *   layout, versioned record in one standard data file holding everything the
+ *   home screen needs (account, balance and parking state). A tap reads it
+ *   with a single authenticated ReadData instead of a server call per field.
+ *
+ *   The record ends with a CMAC over the card's UID and the record's fields,
+ *   computed with a key the terminal holds. This catches corrupted records and
+ *   records copied over from another card.
+ *
+ * Table of Contents:
+ *   (local)
+ *   WalletCmac      - get the CMAC of a wallet record
+ *
+ *   (public)
+ *   MifareWalletEncode - encode a wallet into its on-card record
+ *   MifareWalletDecode - decode and verify an on-card wallet record
+ *   MifareWalletLoad   - read a card's wallet in one command
+ *   MifareWalletSave   - write a card's wallet in one command
+ *
+ * Limitations:
+ *   Only MIFARE_WALLET_VERSION records are understood.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Load reads into a buffer with room
+ *                                           for the CRC/MAC and status byte;
+ *                                           little endian helpers in mifare.c
+ */
+
+#include <string.h>   /* for mem* operations */
+#include "mifare_wallet.h"
+#include "mifare_crypto.h"
+
+
+/* local functions */
+static void WalletCmac(uint8_t blob[/*MIFARE_WALLET_SIZE*/], uint8_t uid[/*7*/],
+                       mifare_desfire_key *key, uint8_t cmac[/*CMAC_LENGTH*/]);
+
+
+/*
+ * WalletCmac
+ * Description: Get the CMAC of a wallet record
+ *
+ * Arguments:   blob - wallet record; only fields before the CMAC are used
+ *              uid  - UID of card the record belongs to
+ *              key  - wallet key [subkeys modified]
+ *              cmac - CMAC_LENGTH bytes of CMAC [modified]
+ * Return:      None
+ *
+ * Operation:   CMAC the UID followed by the record fields, starting with an
+ *              all 0s ivect, and keep the first CMAC_LENGTH bytes.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void WalletCmac(uint8_t blob[/*MIFARE_WALLET_SIZE*/], uint8_t uid[/*7*/],
+                       mifare_desfire_key *key, uint8_t cmac[/*CMAC_LENGTH*/])
+{
+  uint8_t data[MIFARE_UID_BYTES + MIFARE_WALLET_CMAC_OFS];
+  uint8_t ivect[MAX_CRYPTO_BLOCK_SIZE];
+  uint8_t full_cmac[MAX_CRYPTO_BLOCK_SIZE];
+
+  memcpy(data, uid, MIFARE_UID_BYTES);
+  memcpy(data + MIFARE_UID_BYTES, blob, MIFARE_WALLET_CMAC_OFS);
+  memset(ivect, 0, MAX_CRYPTO_BLOCK_SIZE);
+
+  CmacGenerateSubkeys(key);
+  Cmac(key, ivect, data, sizeof(data), full_cmac);
+  memcpy(cmac, full_cmac, CMAC_LENGTH);
+}
+
+
+/*
+ * MifareWalletEncode
+ * Description: Encode a wallet into its on-card record
+ *
+ * Arguments:   wallet - wallet to encode
+ *              uid    - UID of card the record is for
+ *              key    - wallet key
+ *              blob   - MIFARE_WALLET_SIZE bytes of record [modified]
+ * Return:      None
+ *
+ * Operation:   Lay out the fields as described in mifare_wallet.h, zero the
+ *              reserved bytes and append the CMAC.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void MifareWalletEncode(mifare_wallet *wallet, uint8_t uid[/*7*/],
+                        mifare_desfire_key *key,
+                        uint8_t blob[/*MIFARE_WALLET_SIZE*/])
+{
+  memset(blob, 0, MIFARE_WALLET_SIZE);
+
+  blob[MIFARE_WALLET_VERSION_OFS] = MIFARE_WALLET_VERSION;
+  blob[MIFARE_WALLET_FLAGS_OFS] = wallet->flags;
+  blob[MIFARE_WALLET_SEQ_OFS] = (uint8_t) wallet->seq;
+  blob[MIFARE_WALLET_SEQ_OFS+1] = (uint8_t) (wallet->seq >> 8);
+  MifarePutLe32(blob + MIFARE_WALLET_ACCOUNT_OFS, wallet->account);
+  MifarePutLe32(blob + MIFARE_WALLET_BALANCE_OFS, wallet->balance);
+  MifarePutLe32(blob + MIFARE_WALLET_SPACE_OFS, wallet->park_space);
+  MifarePutLe32(blob + MIFARE_WALLET_TIME_OFS, (uint32_t) wallet->park_time);
+
+  WalletCmac(blob, uid, key, blob + MIFARE_WALLET_CMAC_OFS);
+}
+
+
+/*
+ * MifareWalletDecode
+ * Description: Decode and verify an on-card wallet record
+ *
+ * Arguments:   blob   - MIFARE_WALLET_SIZE bytes of record
+ *              uid    - UID of card the record was read from
+ *              key    - wallet key
+ *              wallet - decoded wallet [modified]
+ * Return:      SUCCESS: record is valid and has been decoded
+ *              FAIL:    unknown version or CMAC mismatch
+ *
+ * Operation:   Check the version and CMAC before touching wallet, so a bad
+ *              record never leaks partial fields.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareWalletDecode(uint8_t blob[/*MIFARE_WALLET_SIZE*/], uint8_t uid[/*7*/],
+                       mifare_desfire_key *key, mifare_wallet *wallet)
+{
+  uint8_t cmac[CMAC_LENGTH];
+
+  if (blob[MIFARE_WALLET_VERSION_OFS] != MIFARE_WALLET_VERSION)
+    return FAIL;
+
+  WalletCmac(blob, uid, key, cmac);
+  if (memcmp(cmac, blob + MIFARE_WALLET_CMAC_OFS, CMAC_LENGTH))
+    return FAIL;
+
+  wallet->flags = blob[MIFARE_WALLET_FLAGS_OFS];
+  wallet->seq = (uint16_t) blob[MIFARE_WALLET_SEQ_OFS] |
+    ((uint16_t) blob[MIFARE_WALLET_SEQ_OFS+1] << 8);
+  wallet->account = MifareGetLe32(blob + MIFARE_WALLET_ACCOUNT_OFS);
+  wallet->balance = MifareGetLe32(blob + MIFARE_WALLET_BALANCE_OFS);
+  wallet->park_space = MifareGetLe32(blob + MIFARE_WALLET_SPACE_OFS);
+  wallet->park_time =
+    (int32_t) MifareGetLe32(blob + MIFARE_WALLET_TIME_OFS);
+
+  return SUCCESS;
+}
+
+
+/*
+ * MifareWalletLoad
+ * Description: Read a card's wallet in one command
+ *
+ * Arguments:   tag    - DESFire tag, with the EasyCard application selected
+ *                       and authenticated with a key allowing reads
+ *              key    - wallet key
+ *              wallet - decoded wallet [modified]
+ * Return:      SUCCESS: wallet read and verified
+ *              FAIL:    read failed, short read or invalid record
+ *
+ * Operation:   A single ReadData of MIFARE_WALLET_SIZE bytes from the wallet
+ *              file, in the file's communication mode, then decode the record
+ *              bound to the tag's UID.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Room for the CRC/MAC and status
+ */
+int MifareWalletLoad(mifare_tag *tag, mifare_desfire_key *key,
+                     mifare_wallet *wallet)
+{
+  /* room for the record, then CRC/MAC and padding, and status byte */
+  uint8_t blob[MIFARE_WALLET_SIZE + 2*MAX_CRYPTO_BLOCK_SIZE + 1];
+  ssize_t size;
+
+  if ((MifareReadData(tag, MIFARE_WALLET_FILE_NO, 0, MIFARE_WALLET_SIZE,
+                      blob, sizeof(blob), &size) < 0) ||
+      (size != MIFARE_WALLET_SIZE))
+    return FAIL;
+
+  return MifareWalletDecode(blob, tag->uid, key, wallet);
+}
+
+
+/*
+ * MifareWalletSave
+ * Description: Write a card's wallet in one command
+ *
+ * Arguments:   tag    - DESFire tag, with the EasyCard application selected
+ *                       and authenticated with a key allowing writes
+ *              key    - wallet key
+ *              wallet - wallet to save; seq is bumped [modified]
+ * Return:      SUCCESS: wallet written
+ *              FAIL:    write failed
+ *
+ * Operation:   Bump the sequence number, encode and write the whole record
+ *              with a single WriteData.
+ *              If the wallet file is a backup data file the caller must still
+ *              CommitTransaction.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int MifareWalletSave(mifare_tag *tag, mifare_desfire_key *key,
+                     mifare_wallet *wallet)
+{
+  uint8_t blob[MIFARE_WALLET_SIZE];
+  size_t sent;
+
+  wallet->seq++;
+  MifareWalletEncode(wallet, tag->uid, key, blob);
+
+  if ((MifareWriteData(tag, MIFARE_WALLET_FILE_NO, 0, MIFARE_WALLET_SIZE,
+                       blob, &sent) < 0) || (sent != MIFARE_WALLET_SIZE))
+    return FAIL;
+
+  return SUCCESS;
+}
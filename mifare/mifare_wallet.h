@@ -0,0 +1,95 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                        MIFARE_WALLET.H                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for mifare_wallet.c, the library of functions for
+ *   encoding, decoding, loading and saving the EasyCard wallet record.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef MIFARE_WALLET_H
+#define MIFARE_WALLET_H
+
+/* library include files */
+#include <stdint.h>    /* for uint*_t */
+
+/* local include files */
+#include "mifare.h"
+
+
+/* --------------------------------------
+ * Wallet Constants
+ * --------------------------------------
+ */
+#define MIFARE_WALLET_VERSION   1    /* layout version written by this code */
+#define MIFARE_WALLET_FILE_NO   0x01 /* standard data file holding wallet */
+
+#define MIFARE_WALLET_PARKED    0x01 /* flags: parking time is running */
+
+/*
+ * Wallet record layout. Multi-byte fields are little endian, like DESFire.
+ * +-------+-------+-------+---------+---------+-------+-------+------+------+
+ * |version| flags |  seq  | account | balance | space | time  | rsvd | CMAC |
+ * +-------+-------+-------+---------+---------+-------+-------+------+------+
+ *     1       1       2        4         4        4       4      4      8
+ */
+#define MIFARE_WALLET_VERSION_OFS  0
+#define MIFARE_WALLET_FLAGS_OFS    1
+#define MIFARE_WALLET_SEQ_OFS      2
+#define MIFARE_WALLET_ACCOUNT_OFS  4
+#define MIFARE_WALLET_BALANCE_OFS  8
+#define MIFARE_WALLET_SPACE_OFS    12
+#define MIFARE_WALLET_TIME_OFS     16
+#define MIFARE_WALLET_CMAC_OFS     24  /* end of CMAC'd data */
+#define MIFARE_WALLET_SIZE         32  /* bytes of wallet file used */
+
+
+/* --------------------------------------
+ * Wallet Data Objects
+ * --------------------------------------
+ */
+typedef struct {
+  uint8_t flags;                         /* MIFARE_WALLET_* flags */
+  uint16_t seq;                          /* bumped on every save */
+  uint32_t account;                      /* server side account number */
+  uint32_t balance;                      /* account balance (in kobo) */
+  uint32_t park_space;                   /* parking space number */
+  int32_t park_time;                     /* parking time left (in seconds) */
+} mifare_wallet;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* encode a wallet into its on-card record */
+extern void MifareWalletEncode(mifare_wallet *wallet, uint8_t uid[/*7*/],
+                               mifare_desfire_key *key,
+                               uint8_t blob[/*MIFARE_WALLET_SIZE*/]);
+
+/* decode and verify an on-card wallet record */
+extern int MifareWalletDecode(uint8_t blob[/*MIFARE_WALLET_SIZE*/],
+                              uint8_t uid[/*7*/], mifare_desfire_key *key,
+                              mifare_wallet *wallet);
+
+/* read a card's wallet in one command */
+extern int MifareWalletLoad(mifare_tag *tag, mifare_desfire_key *key,
+                            mifare_wallet *wallet);
+
+/* write a card's wallet in one command */
+extern int MifareWalletSave(mifare_tag *tag, mifare_desfire_key *key,
+                            mifare_wallet *wallet);
+
+
+#endif                                                     /* MIFARE_WALLET_H */
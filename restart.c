@@ -0,0 +1,285 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            RESTART.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the warm restart support. The watchdog resets the MCU out of any
+ *   hang (e.g. waiting on a silent SIM5218 or card reader). A small block of
+ *   persistent RAM, which the C startup code doesn't clear, keeps what is
+ *   needed to get back into service right away after such a reset: if the 3G
+ *   module was up, if the data module's state was set up, and the session in
+ *   progress.
+ *
+ *   The block is trusted only if the reset wasn't a power-on or brown-out
+ *   (which leave RAM undefined) and its magic number and checksum match.
+ *
+ * Table of Contents:
+ *   (local)
+ *   Checksum          - compute the checksum of the persistent RAM block
+ *   Seal              - update the persistent RAM block's checksum
+ *
+ *   (public)
+ *   RestartInit       - find out how the MCU came out of reset
+ *   RestartIsWarm     - did the persistent RAM survive the reset?
+ *   RestartSetModem   - record if the 3G module is up and idle
+ *   RestartModemReady - was the 3G module up and idle before the reset?
+ *   RestartSetDataInit - record if the data module's state is set up
+ *   RestartDataInit   - was the data module's state set up before the reset?
+ *   RestartSetUid     - record the session's EasyCard UID
+ *   RestartSetState   - record the session's FSM state
+ *   RestartSession    - get the session from before the reset
+ *
+ * Limitations:
+ *   There is no payment journal yet, so there is no pending journal index to
+ *   keep.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RestartRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Keep if the data module is set up
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed RestartRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#include "general.h"
+#include <htc.h>
+#include <string.h>
+#include "restart.h"
+
+
+/* persistent RAM block */
+typedef struct {
+  uint16_t magic;       /* RESTART_MAGIC */
+  uint8_t modem_ready;  /* (bool) 3G module was up and idle */
+  uint8_t data_init;    /* (bool) data module's state was set up */
+  uint8_t state;        /* FSM state of the session */
+  uint8_t uid[7];       /* EasyCard UID of the session */
+  uint8_t check;        /* checksum of all the above */
+} restart_data;
+
+
+/* shared variables have to be local to this file */
+static persistent restart_data saved;  /* not cleared by the startup code */
+static uint8_t warm;                   /* (bool) saved survived the reset */
+
+
+/* local functions */
+static uint8_t Checksum(void);
+static void Seal(void);
+
+
+/*
+ * Checksum
+ * Description: Compute the checksum of the persistent RAM block
+ *
+ * Arguments:   None
+ * Return:      complement of the sum of every byte but the checksum
+ *
+ * Operation:   Complement the sum, so an all zero block doesn't check out.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t Checksum(void)
+{
+  const uint8_t *p = (const uint8_t *) &saved;
+  uint8_t sum = 0;
+  size_t i;
+  
+  for (i = 0; i < sizeof(saved) - 1; i++)
+    sum += p[i];
+  
+  return (uint8_t) ~sum;
+}
+
+
+/*
+ * Seal
+ * Description: Update the persistent RAM block's checksum after a change
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void Seal(void)
+{
+  saved.check = Checksum();
+}
+
+
+/*
+ * RestartInit
+ * Description: Find out how the MCU came out of reset, and check the
+ *              persistent RAM block. If it can't be trusted, clear it.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   The POR and BOR flags in RCON are cleared by their resets and
+ *              have to be set again by software, so that the next reset can be
+ *              told apart. The watchdog, MCLR and RESET instruction resets
+ *              leave them set.
+ *
+ * Assumptions: Called first thing in main, before anything is saved
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RestartInit(void)
+{
+  uint8_t rcon = RCON;
+  
+  warm = ((rcon & RESTART_RCON_POR) && (rcon & RESTART_RCON_BOR) &&
+          (saved.magic == RESTART_MAGIC) && (saved.check == Checksum()));
+  RCON = rcon | RESTART_RCON_POR | RESTART_RCON_BOR;
+  
+  if (!warm) {                         /* start over with nothing kept */
+    memset(&saved, 0, sizeof(saved));
+    saved.magic = RESTART_MAGIC;
+    Seal();
+  }
+}
+
+
+/*
+ * RestartIsWarm
+ * Description: Did the MCU come out of reset with the persistent RAM intact?
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RestartIsWarm(void)
+{
+  return warm;
+}
+
+
+/*
+ * RestartSetModem
+ * Description: Record if the 3G module is known to be up and idle, so it
+ *              doesn't have to be brought up again after a reset.
+ *
+ * Arguments:   ready - TRUE/FALSE
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RestartSetModem(uint8_t ready)
+{
+  saved.modem_ready = ready;
+  Seal();
+}
+
+
+/*
+ * RestartModemReady
+ * Description: Was the 3G module up and idle before the reset?
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE (FALSE after a cold start)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RestartModemReady(void)
+{
+  return saved.modem_ready;
+}
+
+
+/*
+ * RestartSetDataInit
+ * Description: Record if the data module's state (the module representation
+ *              and tariff table) is set up, so it isn't set up again after a
+ *              reset.
+ *
+ * Arguments:   done - TRUE/FALSE
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RestartSetDataInit(uint8_t done)
+{
+  saved.data_init = done;
+  Seal();
+}
+
+
+/*
+ * RestartDataInit
+ * Description: Was the data module's state set up before the reset?
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE (FALSE after a cold start, or a warm restart that
+ *              came before the data module was ready)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RestartDataInit(void)
+{
+  return saved.data_init;
+}
+
+
+/*
+ * RestartSetUid
+ * Description: Record the EasyCard UID of the current session
+ *
+ * Arguments:   uid - 7 byte UID
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RestartSetUid(const uint8_t *uid)
+{
+  memcpy(saved.uid, uid, sizeof(saved.uid));
+  Seal();
+}
+
+
+/*
+ * RestartSetState
+ * Description: Record the FSM state of the current session
+ *
+ * Arguments:   state - FSM state
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RestartSetState(uint8_t state)
+{
+  saved.state = state;
+  Seal();
+}
+
+
+/*
+ * RestartSession
+ * Description: Get the session from before the reset
+ *
+ * Arguments:   uid - 7 byte UID of the session's EasyCard [modified]
+ * Return:      FSM state of the session (0 after a cold start)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RestartSession(uint8_t *uid)
+{
+  memcpy(uid, saved.uid, sizeof(saved.uid));
+  return saved.state;
+}
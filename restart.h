@@ -0,0 +1,76 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            RESTART.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for restart.c, the warm restart support: state
+ *   kept in persistent RAM across watchdog (and other non power-on) resets.
+ *
+ * Assumptions:
+ *   The watchdog is enabled in CONFIG2H (see configs.h).
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RestartRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RestartSetDataInit and
+ *                                           RestartDataInit
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed RestartRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#ifndef RESTART_H
+#define RESTART_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * RESTART CONSTANTS
+ * --------------------------------------
+ */
+#define RESTART_MAGIC     0xEA5E   /* marks persistent RAM as set up */
+
+/* RCON reset flags; each reads 0 when its reset happened */
+#define RESTART_RCON_POR  0x02     /* Power-on Reset */
+#define RESTART_RCON_BOR  0x01     /* Brown-out Reset */
+
+
+/* --------------------------------------
+ * RESTART FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* find out how the MCU came out of reset, and check the persistent RAM */
+extern void RestartInit(void);
+
+/* did the MCU come out of a reset with the persistent RAM intact? */
+extern uint8_t RestartIsWarm(void);
+
+/* record if the 3G module is known to be up and idle */
+extern void RestartSetModem(uint8_t ready);
+
+/* was the 3G module up and idle before the reset? */
+extern uint8_t RestartModemReady(void);
+
+/* record if the data module's state is set up */
+extern void RestartSetDataInit(uint8_t done);
+
+/* was the data module's state set up before the reset? */
+extern uint8_t RestartDataInit(void);
+
+/* record the EasyCard UID of the current session */
+extern void RestartSetUid(const uint8_t *uid);
+
+/* record the FSM state of the current session */
+extern void RestartSetState(uint8_t state);
+
+/* get the session from before the reset */
+extern uint8_t RestartSession(uint8_t *uid);
+
+
+#endif                                                           /* RESTART_H */
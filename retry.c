@@ -0,0 +1,265 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              RETRY.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the retry policy used for server requests: exponential backoff
+ *   with jitter between retries, and a circuit breaker that fails operations
+ *   fast once they keep failing.
+ *
+ *   The circuit starts closed. After `threshold` consecutive failures it
+ *   opens, and operations are refused without being tried until a backoff
+ *   delay has passed. Then it's half-open: a single probe operation goes
+ *   ahead, closing the circuit if it succeeds, or opening it again for twice
+ *   as long (up to the cap) if it fails.
+ *
+ *   Delays get "equal jitter": a random time in [d/2, d] for a backoff of d,
+ *   so terminals that lost the network together don't all retry together.
+ *
+ * Table of Contents:
+ *   (local)
+ *   RetryRand    - get the next jitter random number
+ *
+ *   (public)
+ *   RetryInit    - start a policy with a closed circuit
+ *   RetrySeed    - seed the jitter
+ *   RetryDelay   - get the backoff delay before a retry, with jitter
+ *   RetryAllow   - may an operation go ahead?
+ *   RetrySuccess - record that an operation succeeded
+ *   RetryFailure - record that an operation failed
+ *   RetryTrip    - open the circuit now
+ *   RetryState   - get the circuit state
+ *
+ * Limitations:
+ *   Clock times wrap at 2^16, so delays must be under 2^15 clock units.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RetryTrip
+ */
+
+#include "general.h"
+#include "retry.h"
+
+
+/* local functions */
+static uint16_t RetryRand(retry_policy *p);
+
+
+/*
+ * RetryRand
+ * Description: Get the next jitter random number
+ *
+ * Arguments:   p - policy [modified]
+ * Return:      random number in [1, 2^16-1]
+ *
+ * Operation:   16-bit xorshift (shifts 7, 9, 8), which takes a few shifts
+ *              and XORs per number and never leaves a non-zero state.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint16_t RetryRand(retry_policy *p)
+{
+  uint16_t x = p->seed;
+
+  x ^= x << 7;
+  x ^= x >> 9;
+  x ^= x << 8;
+  p->seed = x;
+
+  return x;
+}
+
+
+/*
+ * RetryInit
+ * Description: Start a policy with a closed circuit
+ *
+ * Arguments:   p         - policy [modified]
+ *              threshold - consecutive failures that open the circuit
+ *              base      - first backoff delay
+ *              cap       - longest backoff delay
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RetryInit(retry_policy *p, uint8_t threshold, uint16_t base,
+               uint16_t cap)
+{
+  p->base = base;
+  p->cap = cap;
+  p->threshold = threshold;
+  p->retry_at = 0;
+  p->failures = 0;
+  p->opens = 0;
+  p->state = RETRY_CLOSED;
+  RetrySeed(p, 1);
+}
+
+
+/*
+ * RetrySeed
+ * Description: Seed the jitter, e.g. with something device specific, so
+ *              devices don't all pick the same delays.
+ *
+ * Arguments:   p    - policy [modified]
+ *              seed - any number
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RetrySeed(retry_policy *p, uint16_t seed)
+{
+  p->seed = (seed != 0) ? seed : 1;          /* xorshift sticks at 0 */
+}
+
+
+/*
+ * RetryDelay
+ * Description: Get the backoff delay before a retry, with jitter
+ *
+ * Arguments:   p       - policy [modified]
+ *              attempt - retries so far, 0 for the first retry
+ * Return:      delay in [d/2, d] for d = min(base * 2^attempt, cap)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t RetryDelay(retry_policy *p, uint8_t attempt)
+{
+  uint32_t d = p->base;
+  uint16_t half;
+
+  while ((attempt-- > 0) && (d < p->cap))
+    d <<= 1;
+  if (d > p->cap) d = p->cap;
+
+  half = (uint16_t) (d >> 1);
+  return (uint16_t) d - half + (RetryRand(p) % (half + 1));
+}
+
+
+/*
+ * RetryAllow
+ * Description: May an operation go ahead?
+ *
+ * Arguments:   p   - policy [modified]
+ *              now - clock time
+ * Return:      TRUE:  go ahead, and report how it went with RetrySuccess or
+ *                     RetryFailure
+ *              FALSE: fail it without trying
+ *
+ * Operation:   A closed circuit allows everything. An open circuit allows
+ *              nothing until its retry time, then goes half-open and allows
+ *              one probe. While half-open the probe hasn't reported back, so
+ *              nothing else is allowed.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RetryAllow(retry_policy *p, uint16_t now)
+{
+  switch (p->state) {
+  case RETRY_CLOSED:
+    return TRUE;
+
+  case RETRY_OPEN:
+    if ((int16_t) (now - p->retry_at) < 0)   /* still backing off */
+      return FALSE;
+    p->state = RETRY_HALF_OPEN;              /* let a probe through */
+    return TRUE;
+
+  default:                                   /* probe already out */
+    return FALSE;
+  }
+}
+
+
+/*
+ * RetrySuccess
+ * Description: Record that an operation succeeded, which closes the circuit
+ *
+ * Arguments:   p - policy [modified]
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RetrySuccess(retry_policy *p)
+{
+  p->failures = 0;
+  p->opens = 0;
+  p->state = RETRY_CLOSED;
+}
+
+
+/*
+ * RetryFailure
+ * Description: Record that an operation failed
+ *
+ * Arguments:   p   - policy [modified]
+ *              now - clock time
+ * Return:      None
+ *
+ * Operation:   A failed probe, or reaching the threshold of consecutive
+ *              failures, opens the circuit for a backoff delay that doubles
+ *              each time it opens without a success in between.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Open with RetryTrip
+ */
+void RetryFailure(retry_policy *p, uint16_t now)
+{
+  if (p->failures < 0xFF) p->failures++;
+
+  if ((p->state == RETRY_HALF_OPEN) || (p->failures >= p->threshold))
+    RetryTrip(p, now);
+}
+
+
+/*
+ * RetryTrip
+ * Description: Open the circuit now, without waiting for failures, e.g.
+ *              when what the operations need has just been taken down.
+ *
+ * Arguments:   p   - policy [modified]
+ *              now - clock time
+ * Return:      None
+ *
+ * Operation:   Open it for a backoff delay as a failure would, so the next
+ *              probe is still backed off, doubling if it fails.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RetryTrip(retry_policy *p, uint16_t now)
+{
+  p->retry_at = now + RetryDelay(p, p->opens);
+  if (p->opens < 0xFF) p->opens++;
+  p->state = RETRY_OPEN;
+}
+
+
+/*
+ * RetryState
+ * Description: Get the circuit state
+ *
+ * Arguments:   p - policy
+ * Return:      RETRY_CLOSED/RETRY_OPEN/RETRY_HALF_OPEN
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RetryState(const retry_policy *p)
+{
+  return p->state;
+}
@@ -0,0 +1,85 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              RETRY.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for retry.c, the retry policy of backoff with
+ *   jitter and a circuit breaker.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RetryTrip
+ */
+
+#ifndef RETRY_H
+#define RETRY_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * RETRY CIRCUIT STATES
+ * --------------------------------------
+ */
+#define RETRY_CLOSED     0    /* operations go ahead */
+#define RETRY_OPEN       1    /* operations fail fast till the retry time */
+#define RETRY_HALF_OPEN  2    /* one probe operation is going ahead */
+
+
+/* --------------------------------------
+ * RETRY DATA OBJECTS
+ * --------------------------------------
+ * times are in whatever unit the caller's clock counts, e.g. seconds
+ */
+typedef struct {
+  uint16_t base;      /* first backoff delay */
+  uint16_t cap;       /* longest backoff delay */
+  uint16_t retry_at;  /* clock time an open circuit lets a probe through */
+  uint16_t seed;      /* jitter generator state, never 0 */
+  uint8_t threshold;  /* consecutive failures that open the circuit */
+  uint8_t failures;   /* consecutive failures */
+  uint8_t opens;      /* times opened since the last success */
+  uint8_t state;      /* RETRY_CLOSED/OPEN/HALF_OPEN */
+} retry_policy;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* start a policy with a closed circuit */
+extern void RetryInit(retry_policy *p, uint8_t threshold, uint16_t base,
+                      uint16_t cap);
+
+/* seed the jitter, e.g. with something device specific */
+extern void RetrySeed(retry_policy *p, uint16_t seed);
+
+/* get the backoff delay before a retry, with jitter */
+extern uint16_t RetryDelay(retry_policy *p, uint8_t attempt);
+
+/* may an operation go ahead? */
+extern uint8_t RetryAllow(retry_policy *p, uint16_t now);
+
+/* record that an operation succeeded */
+extern void RetrySuccess(retry_policy *p);
+
+/* record that an operation failed */
+extern void RetryFailure(retry_policy *p, uint16_t now);
+
+/* open the circuit now */
+extern void RetryTrip(retry_policy *p, uint16_t now);
+
+/* get the circuit state */
+extern uint8_t RetryState(const retry_policy *p);
+
+
+#endif                                                             /* RETRY_H */
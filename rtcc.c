@@ -0,0 +1,388 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              RTCC.C                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the wall clock, kept by the PIC18's Real-Time Clock and Calendar
+ *   module off the 32.768 kHz SOSC crystal. It gives epoch timestamps for
+ *   payment journals and card logs, and the local time of day for tariffs.
+ *
+ *   The RTCC raises an alarm interrupt once a second, which counts the uptime
+ *   used for timing parking sessions. The wall clock is the uptime plus an
+ *   offset, so setting the clock never makes a running session jump.
+ *
+ *   The clock is set from the server's time (its HTTP Date header, or the
+ *   time in a socket response frame) or the modem's network time (AT+CCLK). The RTCC keeps counting through every reset but a power-on
+ *   reset, so after a watchdog reset the time is read back from it.
+ *
+ * Table of Contents:
+ *   (local)
+ *   RtccToBcd       - convert a byte to BCD
+ *   RtccFromBcd     - convert a byte from BCD
+ *   RtccRead        - read the calendar fields off the RTCC
+ *   RtccWrite       - write the calendar fields to the RTCC
+ *
+ *   (public)
+ *   RtccInit        - start the RTCC and its once a second alarm
+ *   RtccISR         - RTCC alarm interrupt service routine
+ *   RtccUptime      - get the seconds counted since startup
+ *   RtccNow         - get the wall clock time
+ *   RtccSynced      - has the wall clock been set?
+ *   RtccSync        - set the wall clock from a trusted time
+ *   RtccSyncAge     - get the seconds since the wall clock was last set
+ *   RtccMinuteOfDay - get the local time of day
+ *
+ * Limitations:
+ *   The RTCC's own calibration (RTCCAL) isn't used; the server corrects the
+ *   crystal's drift instead.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RtccRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read ISR counters with READ_STABLE
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed RtccRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#include "general.h"
+#include <htc.h>
+#include "datetime.h"
+#include "rtcc.h"
+
+
+/* shared variables have to be local to this file */
+static volatile uint32_t uptime;   /* seconds since startup, counted by ISR */
+static uint32_t offset;            /* wall clock minus uptime */
+static uint32_t syncStamp;         /* uptime when the clock was last set */
+static uint8_t synced;             /* (bool) wall clock has been set */
+
+
+/* local functions */
+static uint8_t RtccToBcd(uint8_t n);
+static uint8_t RtccFromBcd(uint8_t bcd);
+static void RtccRead(datetime *dt);
+static void RtccWrite(const datetime *dt);
+
+
+/*
+ * RtccToBcd
+ * Description: Convert a byte to BCD
+ *
+ * Arguments:   n - [0, 99]
+ * Return:      n as 2 BCD digits
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t RtccToBcd(uint8_t n)
+{
+  return (uint8_t) (((n / 10) << 4) | (n % 10));
+}
+
+
+/*
+ * RtccFromBcd
+ * Description: Convert a byte from BCD
+ *
+ * Arguments:   bcd - 2 BCD digits
+ * Return:      bcd as a binary number
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t RtccFromBcd(uint8_t bcd)
+{
+  return (uint8_t) (10*(bcd >> 4) + (bcd & 0x0F));
+}
+
+
+/*
+ * RtccRead
+ * Description: Read the calendar fields off the RTCC
+ *
+ * Arguments:   dt - date and time read [modified]
+ * Return:      None
+ *
+ * Operation:   Wait out RTCSYNC, which is set just before the registers ripple
+ *              over to the next second. Then set RTCPTR to the year and read
+ *              the register pairs down to the seconds; each read of RTCVALH
+ *              moves RTCPTR down a pair.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void RtccRead(datetime *dt)
+{
+  uint8_t dummy;
+
+  while (RTCSYNC) continue;                  /* takes under 2 SOSC cycles */
+
+  RTCPTR1 = 1;
+  RTCPTR0 = 1;
+  dt->year = RtccFromBcd(RTCVALL);
+  dummy = RTCVALH;                           /* RTCPTR = 10 */
+  dt->day = RtccFromBcd(RTCVALL);
+  dt->month = RtccFromBcd(RTCVALH);          /* RTCPTR = 01 */
+  dt->hour = RtccFromBcd(RTCVALL);
+  dt->weekday = RtccFromBcd(RTCVALH);        /* RTCPTR = 00 */
+  dt->second = RtccFromBcd(RTCVALL);
+  dt->minute = RtccFromBcd(RTCVALH);
+  (void) dummy;
+}
+
+
+/*
+ * RtccWrite
+ * Description: Write the calendar fields to the RTCC
+ *
+ * Arguments:   dt - valid date and time to write
+ * Return:      None
+ *
+ * Operation:   With interrupts disabled, do the 0x55/0xAA unlock sequence and
+ *              set RTCWREN. Stop the RTCC, write the register pairs from the
+ *              year down to the seconds like RtccRead reads them, then restart
+ *              it and lock it again.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void RtccWrite(const datetime *dt)
+{
+  uint8_t gie;                      /* saved interrupt enable state */
+
+  gie = GIE;                        /* unlock sequence must not be */
+  GIE = 0;                          /* interrupted */
+  EECON2 = 0x55;
+  EECON2 = 0xAA;
+  RTCWREN = 1;
+  GIE = gie;
+
+  RTCEN = 0;                        /* hold the clock while it's set */
+  RTCPTR1 = 1;
+  RTCPTR0 = 1;
+  RTCVALL = RtccToBcd(dt->year);
+  RTCVALH = 0;                      /* RTCPTR = 10 */
+  RTCVALL = RtccToBcd(dt->day);
+  RTCVALH = RtccToBcd(dt->month);   /* RTCPTR = 01 */
+  RTCVALL = RtccToBcd(dt->hour);
+  RTCVALH = RtccToBcd(dt->weekday); /* RTCPTR = 00 */
+  RTCVALL = RtccToBcd(dt->second);
+  RTCVALH = RtccToBcd(dt->minute);
+  RTCEN = 1;
+
+  RTCWREN = 0;
+}
+
+
+/*
+ * RtccInit
+ * Description: Start the RTCC and its once a second alarm. If the RTCC was
+ *              left running with a set clock, carry on with its time.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   Keep the SOSC running. A set clock reads no earlier than
+ *              DATETIME_EPOCH_MIN; an unset RTCC is restarted at 2000-01-01.
+ *              Then set the alarm to chime every second, forever.
+ *
+ * Shared:      offset, syncStamp, synced [modified]
+ *
+ * Assumptions: Called before interrupts are enabled
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RtccInit(void)
+{
+  datetime dt;
+  uint32_t epoch = 0;
+
+  SOSCGO = 1;                       /* SOSC runs even with the RTCC stopped */
+
+  if (RTCEN) {                      /* running since before an MCU reset */
+    RtccRead(&dt);
+    if (DateTimeValid(&dt))
+      epoch = DateTimeToEpoch(&dt);
+  }
+
+  if (epoch >= DATETIME_EPOCH_MIN) {
+    offset = epoch;                 /* uptime is 0 */
+    syncStamp = 0;
+    synced = TRUE;
+  } else {
+    DateTimeFromEpoch(DATETIME_EPOCH_2000, &dt);
+    RtccWrite(&dt);
+    synced = FALSE;
+  }
+
+  ALRMCFG = RTCC_ALARM_EVERY_SEC;
+  ALRMRPT = RTCC_ALARM_REPEAT;
+  RTCCIF = 0;
+  RTCCIE = 1;                       /* enable the alarm interrupt */
+}
+
+
+/*
+ * RtccISR
+ * Description: RTCC alarm interrupt service routine, once a second.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      uptime [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RtccISR(void)
+{
+  uptime++;
+}
+
+
+/*
+ * RtccUptime
+ * Description: Get the seconds counted since startup. This never jumps, so
+ *              it's what time spans are measured with.
+ *
+ * Arguments:   None
+ * Return:      seconds since RtccInit
+ *
+ * Shared:      uptime
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+uint32_t RtccUptime(void)
+{
+  uint32_t s;
+
+  READ_STABLE(s, uptime);
+
+  return s;
+}
+
+
+/*
+ * RtccNow
+ * Description: Get the wall clock time
+ *
+ * Arguments:   None
+ * Return:      seconds since 1970-01-01 00:00:00 UTC, or 0 if the clock has
+ *              never been set
+ *
+ * Shared:      offset, synced
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t RtccNow(void)
+{
+  return synced ? (RtccUptime() + offset) : 0;
+}
+
+
+/*
+ * RtccSynced
+ * Description: Has the wall clock been set?
+ *
+ * Arguments:   None
+ * Return:      TRUE if it has, else FALSE
+ *
+ * Shared:      synced
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t RtccSynced(void)
+{
+  return synced;
+}
+
+
+/*
+ * RtccSync
+ * Description: Set the wall clock from a trusted time
+ *
+ * Arguments:   epoch - seconds since 1970-01-01 00:00:00 UTC
+ * Return:      None
+ *
+ * Operation:   Times before DATETIME_EPOCH_MIN are ignored. If the clock is
+ *              already within RTCC_SYNC_SLACK seconds, only note that it was
+ *              checked: the time given is itself only good to a second.
+ *              Else move the offset and rewrite the RTCC, so it comes back
+ *              right after a reset.
+ *
+ * Shared:      offset, syncStamp, synced [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RtccSync(uint32_t epoch)
+{
+  datetime dt;
+  uint32_t now = RtccUptime();
+  uint32_t drift;
+
+  if (epoch < DATETIME_EPOCH_MIN)
+    return;
+
+  drift = (epoch > now + offset) ? (epoch - (now + offset)) :
+    ((now + offset) - epoch);
+  if (!synced || (drift > RTCC_SYNC_SLACK)) {
+    offset = epoch - now;
+    if (DateTimeFromEpoch(epoch, &dt) == SUCCESS)
+      RtccWrite(&dt);
+    synced = TRUE;
+  }
+  syncStamp = now;
+}
+
+
+/*
+ * RtccSyncAge
+ * Description: Get the seconds since the wall clock was last set or checked
+ *
+ * Arguments:   None
+ * Return:      seconds since the last RtccSync, or RTCC_NEVER if the clock
+ *              has never been set
+ *
+ * Shared:      syncStamp, synced
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t RtccSyncAge(void)
+{
+  return synced ? (RtccUptime() - syncStamp) : RTCC_NEVER;
+}
+
+
+/*
+ * RtccMinuteOfDay
+ * Description: Get the local time of day
+ *
+ * Arguments:   None
+ * Return:      minutes since local midnight, [0, DATETIME_DAY_MINS-1], or
+ *              RTCC_DEFAULT_MINUTE if the clock has never been set
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t RtccMinuteOfDay(void)
+{
+  uint32_t local;
+
+  if (!synced)
+    return RTCC_DEFAULT_MINUTE;
+
+  local = RtccNow() + 60UL*RTCC_UTC_OFFSET;
+  return (uint16_t) ((local % DATETIME_DAY_SECS) / 60);
+}
@@ -0,0 +1,76 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                              RTCC.H                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for rtcc.c, the wall clock kept by the PIC18's
+ *   Real-Time Clock and Calendar module.
+ *
+ * Assumptions:
+ *   A 32.768 kHz crystal is on the SOSC pins (RC0/RC1), set up as the RTCC's
+ *   reference clock in CONFIG1L and CONFIG3L (see configs.h).
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added RtccRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed RtccRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#ifndef RTCC_H
+#define RTCC_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * RTCC CONSTANTS
+ * --------------------------------------
+ */
+#define RTCC_UTC_OFFSET      60       /* local time (WAT) - UTC, in minutes */
+#define RTCC_DEFAULT_MINUTE  (12*60)  /* local time of day (in minutes) used */
+                                      /* until the clock is first set */
+#define RTCC_SYNC_SLACK      2        /* drift (in seconds) left uncorrected */
+#define RTCC_NEVER           0xFFFFFFFFUL /* RtccSyncAge of an unset clock */
+
+#define RTCC_ALARM_EVERY_SEC 0xC4     /* ALRMCFG: alarm on, chime on, */
+                                      /* AMASK = every second */
+#define RTCC_ALARM_REPEAT    0xFF     /* ALRMRPT: chime re-arms it anyway */
+
+
+/* --------------------------------------
+ * RTCC FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* start the RTCC and its once a second alarm */
+extern void RtccInit(void);
+
+/* RTCC alarm interrupt service routine */
+extern void RtccISR(void);
+
+/* get the seconds counted since startup */
+extern uint32_t RtccUptime(void);
+
+/* get the wall clock time */
+extern uint32_t RtccNow(void);
+
+/* has the wall clock been set? */
+extern uint8_t RtccSynced(void);
+
+/* set the wall clock from a trusted time */
+extern void RtccSync(uint32_t epoch);
+
+/* get the seconds since the wall clock was last set */
+extern uint32_t RtccSyncAge(void);
+
+/* get the local time of day */
+extern uint16_t RtccMinuteOfDay(void);
+
+
+#endif                                                              /* RTCC_H */
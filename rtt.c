@@ -0,0 +1,192 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                               RTT.C                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the round trip time estimator used to set serial exchange
+ *   timeouts. Each class of exchange (e.g. the first byte of a card reader
+ *   reply) keeps its own estimate, so a fast link stops waiting out a fixed
+ *   worst case timeout and a slow link stops failing early.
+ *
+ *   It's the TCP retransmission timer estimator (RFC 6298): a smoothed RTT and
+ *   mean deviation in fixed point, with the timeout at srtt + 4*rttvar kept
+ *   within bounds, and doubled on each timeout until the next sample.
+ *
+ * Table of Contents:
+ *   (local)
+ *   Clamp        - keep a timeout within an estimate's bounds
+ *
+ *   (public)
+ *   RttInit      - start an estimate
+ *   RttSample    - add a measured round trip time
+ *   RttBackoff   - back off the timeout after a timeout
+ *   RttTimeout   - get the timeout to use
+ *   RttSmoothed  - get the smoothed RTT
+ *   RttDeviation - get the smoothed mean deviation
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "general.h"
+#include "rtt.h"
+
+
+/* local functions */
+static uint16_t Clamp(const rtt_est *est, uint32_t ms);
+
+
+/*
+ * Clamp
+ * Description: Keep a timeout within an estimate's bounds
+ *
+ * Arguments:   est - estimate
+ *              ms  - timeout
+ * Return:      timeout in [est->min, est->max]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint16_t Clamp(const rtt_est *est, uint32_t ms)
+{
+  if (ms < est->min) return est->min;
+  if (ms > est->max) return est->max;
+  return (uint16_t) ms;
+}
+
+
+/*
+ * RttInit
+ * Description: Start an estimate with no samples
+ *
+ * Arguments:   est     - estimate [modified]
+ *              initial - timeout to use until the first sample
+ *              min     - smallest timeout
+ *              max     - largest timeout
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RttInit(rtt_est *est, uint16_t initial, uint16_t min, uint16_t max)
+{
+  est->srtt = 0;
+  est->rttvar = 0;
+  est->min = min;
+  est->max = max;
+  est->rto = Clamp(est, initial);
+}
+
+
+/*
+ * RttSample
+ * Description: Add a measured round trip time to an estimate
+ *
+ * Arguments:   est - estimate [modified]
+ *              ms  - measured round trip time
+ * Return:      None
+ *
+ * Operation:   The first sample sets srtt = ms and rttvar = ms/2. After that
+ *                rttvar += (|ms - srtt| - rttvar)/4
+ *                srtt   += (ms - srtt)/8
+ *              done on the scaled values, so the divisions are shifts that
+ *              are absorbed by the scaling. Then
+ *                rto = srtt + 4*rttvar
+ *              which with rttvar scaled by 4 is just the sum. A sample of 0
+ *              counts as 1ms, so 0 can still mean no samples.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RttSample(rtt_est *est, uint16_t ms)
+{
+  int32_t err;
+
+  if (ms == 0) ms = 1;
+
+  if (est->srtt == 0) {                      /* first sample */
+    est->srtt = (uint32_t) ms << RTT_SRTT_SHIFT;
+    est->rttvar = (uint32_t) ms << (RTT_VAR_SHIFT - 1);
+  } else {
+    err = (int32_t) ms - (int32_t) (est->srtt >> RTT_SRTT_SHIFT);
+    est->srtt = (uint32_t) ((int32_t) est->srtt + err);
+    if (err < 0) err = -err;
+    err -= (int32_t) (est->rttvar >> RTT_VAR_SHIFT);
+    est->rttvar = (uint32_t) ((int32_t) est->rttvar + err);
+  }
+
+  est->rto = Clamp(est, (est->srtt >> RTT_SRTT_SHIFT) + est->rttvar);
+}
+
+
+/*
+ * RttBackoff
+ * Description: Back off an estimate's timeout after a timeout, since the
+ *              exchange may just be slower than the estimate says.
+ *
+ * Arguments:   est - estimate [modified]
+ * Return:      None
+ *
+ * Operation:   Double the timeout, up to the max. The next sample sets it from
+ *              the estimate again.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void RttBackoff(rtt_est *est)
+{
+  est->rto = Clamp(est, 2 * (uint32_t) est->rto);
+}
+
+
+/*
+ * RttTimeout
+ * Description: Get the timeout to use for the next exchange
+ *
+ * Arguments:   est - estimate
+ * Return:      timeout (in ms)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t RttTimeout(const rtt_est *est)
+{
+  return est->rto;
+}
+
+
+/*
+ * RttSmoothed
+ * Description: Get the smoothed RTT, e.g. for telemetry
+ *
+ * Arguments:   est - estimate
+ * Return:      smoothed RTT (in ms), 0 before the first sample
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t RttSmoothed(const rtt_est *est)
+{
+  return (uint16_t) (est->srtt >> RTT_SRTT_SHIFT);
+}
+
+
+/*
+ * RttDeviation
+ * Description: Get the smoothed mean deviation, e.g. for telemetry
+ *
+ * Arguments:   est - estimate
+ * Return:      smoothed mean deviation (in ms), 0 before the first sample
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t RttDeviation(const rtt_est *est)
+{
+  return (uint16_t) (est->rttvar >> RTT_VAR_SHIFT);
+}
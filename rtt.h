@@ -0,0 +1,74 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                               RTT.H                               -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for rtt.c, the round trip time estimator used to
+ *   set serial exchange timeouts.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#ifndef RTT_H
+#define RTT_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * RTT CONSTANTS
+ * --------------------------------------
+ */
+#define RTT_SRTT_SHIFT    3    /* srtt is kept scaled by 8 */
+#define RTT_VAR_SHIFT     2    /* rttvar is kept scaled by 4 */
+
+
+/* --------------------------------------
+ * RTT DATA OBJECTS
+ * --------------------------------------
+ */
+/* round trip time estimate of one class of exchange, all times in ms */
+typedef struct {
+  uint32_t srtt;      /* smoothed RTT, scaled by 8; 0 before first sample */
+  uint32_t rttvar;    /* smoothed mean deviation, scaled by 4 */
+  uint16_t rto;       /* current timeout */
+  uint16_t min;       /* bounds on the timeout */
+  uint16_t max;
+} rtt_est;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* start an estimate with an initial timeout and bounds */
+extern void RttInit(rtt_est *est, uint16_t initial, uint16_t min,
+                    uint16_t max);
+
+/* add a measured round trip time */
+extern void RttSample(rtt_est *est, uint16_t ms);
+
+/* back off the timeout after a timeout */
+extern void RttBackoff(rtt_est *est);
+
+/* get the timeout to use */
+extern uint16_t RttTimeout(const rtt_est *est);
+
+/* get the smoothed RTT (in ms) */
+extern uint16_t RttSmoothed(const rtt_est *est);
+
+/* get the smoothed mean deviation (in ms) */
+extern uint16_t RttDeviation(const rtt_est *est);
+
+
+#endif                                                               /* RTT_H */
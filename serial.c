@@ -42,6 +42,9 @@
  *   Dec. 19, 2012      Nnoduka Eruchalu     Initial Revision
  *   Dec. 21, 2012      Nnoduka Eruchalu     Start Implementation
  *   May. 01, 2013      Nnoduka Eruchalu     Added routines for serial channel 2
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SerialRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed SerialRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #include <htc.h>
@@ -17,6 +17,9 @@
  * Revision History:
  *   Dec. 19, 2012      Nnoduka Eruchalu     Initial Revision
  *   May. 01, 2013      Nnoduka Eruchalu     Added routines for serial channel 2
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SerialRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed SerialRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #ifndef SERIAL_H
@@ -12,24 +12,53 @@
  *   (local)
  *   CheckForOk              - Check for OK at the end of a message buffer
  *   ParseHttpBodyJson       - Parse json data in HTTP response body
+ *   ParseHttpDate           - Parse the Date header of a HTTP response
+ *   ScanStartupLine         - collect a startup message line
+ *   SimReadByte             - get a byte, within the running timer
+ *   SimReadLine             - get a line, within the running timer
+ *   SimWaitLine             - wait for an expected line
+ *   SimNetworkAttach        - network registration and APN
+ *   SimTcpClose             - drop the server socket
+ *   SimTcpConnect           - open the server socket if it isn't open
+ *   SimTcpRequest           - perform a request on the server socket
+ *   SimHttpAct              - perform a request with AT+CHTTPACT
  *
  *   (timer)
  *   SimStartTimer           - start a countdown timer with a Timer
  *   SimTimerISR             - Timer interrupt service routine.
  *
+ *   (startup)
+ *   SimPowerOn              - start bringing up the module
+ *   SimResume               - carry on with a module that is already up
+ *   SimPoll                 - move module startup along
+ *
  *   (communication)
  *   SimPutStr               - output a command string to the serial channel
  *   SimPutStrLn             - output a string to serial channel and a newline
  *   SimGetBuf               - get a buffer of bytes from the serial channel
  *   SimPrintBuf             - (debug) useful for debugging
  *
+ *   (adaptive timeouts)
+ *   SimRttInit              - start the round trip time estimates
+ *   SimTimerLeft            - get the time left on the timer
+ *   SimRttDone              - update an estimate after a wait
+ *   SimRtt                  - get an estimate, for telemetry
+ *
  *   (memory management) 
  *   SimDataInit             - initialize the sim5218 data representation
  *  
+ *   (DNS cache)
+ *   SimMinutes              - get the minutes counted by the timer ISR
+ *   SimDnsLoad              - load the server IP saved in data EEPROM
+ *   SimDnsResolve           - resolve the server's hostname and cache its IP
+ *   SimServerHost           - get the server's cached IP or hostname
+ *
  *   (AT Commands)
  *   SimReset                - reset the module
  *   SimNetworkReg           - check for network registration
  *   SimSetApn               - set IP APN
+ *   SimSignalQuality        - get signal quality
+ *   SimClock                - get the network time
  *   SimHttpLaunch           - launch a Http Operation
  *   SimHttpLaunchGet        - launch a Http Get Operation 
  *   SimHttpLaunchPost       - launch a Http Post Operation
@@ -37,6 +66,18 @@
  *   SimHttpGet              - perform a HTTP GET Operation
  *   SimHttpPost             - perform a HTTP POST Operation
  *   SimHttpParseResponse    - Parse HTTP Response
+ *
+ *   (retry policy)
+ *   SimSeconds              - get the seconds counted by the timer ISR
+ *   SimWait                 - wait on the timer
+ *   SimRetryInit            - start the retry policies
+ *   SimOnline               - are server requests being tried?
+ *   SimProbe                - probe the network while requests fail fast
+ *
+ *   (health monitor)
+ *   SimHealthInit           - start the health monitor
+ *   SimHealthPoll           - poll registration and signal quality
+ *   SimHealth               - get the module's health
  * 
  * Limitations:
  *   None
@@ -68,15 +109,42 @@
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
  *   May 16, 2013      Nnoduka Eruchalu     Added number2 to http_response
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use format.c instead of sprintf
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Non-blocking startup
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Watchdog support and SimResume
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Kept-open socket transport
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Cache the server's IP
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Adaptive timeouts
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Retry backoff and circuit breaker
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Health monitor
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Server and network time
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SimRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Bounded wait for CHTTPACT launch
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read replies to their final result
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read ISR counters with READ_STABLE
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed SimRam; diag.c takes
+ *                                           RAM from the map file
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Server time on the socket too
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Back off the socket after a failed
+ *                                           connect, keeping the cached IP
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Offline while the health monitor's
+ *                                           reset runs
  */
 
 #include "general.h"
 #include <stdint.h>     /* for uint*_t */
 #include <string.h>
+#include <htc.h>
 #include "sim5218.h"
 #include "serial.h"
 #include "delay.h"
 #include "lcd.h"
+#include "format.h"
+#include "restart.h"
+#include "eeprom.h"
+#include "retry.h"
+#include "datetime.h"
+#include "at.h"
 
 
 /* shared variables have to be local to this file */
@@ -85,11 +153,47 @@ static unsigned char timerOvertime;           /* serial comm. timeout flag */
 static unsigned char rxBuf[800];              /* serial channel Rx buffer */
 static unsigned int rxCount;
 
+/* startup */
+static uint8_t simState;                      /* SIM_STATE_* */
+static volatile unsigned int bootTimer;       /* startup ms time counter */
+static volatile unsigned char bootOvertime;   /* startup timeout flag */
+static char bootLine[12];                     /* startup message line */
+static uint8_t bootLineLen;
+
 /* connection strings */
 static const char *protocol = "http";
 static const char *server = "easypay.strivinglink.com";
 static const char *port = "80";
 static const char *apn_att_ipad = "broadband"; /* AT&T ipad2 3G APN */
+static const char *tcp_port = "8000";         /* server's framed request port */
+
+/* socket transport */
+static uint8_t tcpOpen;                       /* (bool) server socket is open */
+static uint16_t requestId;                    /* ID of last framed request */
+
+/* DNS cache */
+static char serverIp[EEPROM_DNS_SIZE];        /* server's IP, dotted decimal */
+static uint8_t dnsLoaded;                     /* (bool) EEPROM copy loaded */
+static uint8_t dnsValid;                      /* (bool) serverIp is usable */
+static uint16_t dnsStamp;                     /* minutes at resolve time */
+static volatile uint16_t secondMs;            /* ms into current second */
+static volatile uint8_t minuteSecs;           /* seconds into current minute */
+static volatile uint16_t seconds;             /* seconds since startup */
+static volatile uint16_t minutes;             /* minutes since startup */
+
+/* adaptive timeouts */
+static rtt_est simRtt[SIM_RTT_CLASSES];       /* estimates per SIM_RTT_* */
+
+/* retry policy */
+static retry_policy simBreaker;               /* server requests, in seconds */
+static retry_policy netregRetry;              /* netreg trials, in ms */
+static retry_policy tcpRetry;                 /* socket connects, in seconds */
+
+/* health monitor */
+static uint8_t healthState;                   /* SIM_HEALTH_* */
+static uint8_t healthRssi;                    /* smoothed rssi, scaled by 4 */
+static uint8_t healthBad;                     /* polls in a row not good */
+static uint16_t healthStamp;                  /* seconds at last poll */
 
 /* HTTP response JSON key strings */
 static const char json_key_number[]  = "num1";
@@ -103,6 +207,29 @@ static const char json_key_bool[] = "bool";
 static int CheckForOk(void);
 static void ParseHttpBodyJson(uint16_t start_index, uint16_t end_index,
                               http_data *http_response);
+static void ParseHttpDate(uint16_t end_index, http_data *http_response);
+static int ScanStartupLine(const char *line);
+static int SimReadByte(unsigned char *c);
+static int SimReadLine(char *line, size_t size);
+static int SimWaitLine(const char *want, unsigned int ms);
+static int SimNetworkAttach(void);
+static void SimTcpClose(void);
+static int SimTcpConnect(void);
+static int SimTcpRequest(uint8_t method, const char *url,
+                         const char *param_str, http_data *http_response);
+static int SimHttpAct(uint8_t method, const char *url, const char *param_str, 
+                      http_data *http_response);
+static uint16_t SimMinutes(void);
+static void SimDnsLoad(void);
+static int SimDnsResolve(void);
+static const char *SimServerHost(void);
+static void SimRttInit(void);
+static uint16_t SimTimerLeft(void);
+static void SimRttDone(uint8_t cls, uint16_t wait);
+static uint16_t SimSeconds(void);
+static void SimWait(uint16_t ms);
+static void SimRetryInit(void);
+static void SimHealthInit(void);
 
 
 /*
@@ -251,6 +378,82 @@ static void ParseHttpBodyJson(uint16_t start_index, uint16_t end_index,
 }
 
 
+/*
+ * ParseHttpDate
+ * Description: Parse the Date header of a HTTP response, so the terminal's
+ *              clock can be set from the server's.
+ *
+ * Operation:   Look for a line starting "date: ", in any case, before the
+ *              body. The module lower cases the headers it passes on, which
+ *              DateTimeParseHttp allows for.
+ * 
+ * Arguments:   end_index     - index of the start of the body in rxBuf
+ *              http_response - date set to the header's time, or 0 if there
+ *                              is no valid one [modified]
+ * Return:      None
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void ParseHttpDate(uint16_t end_index, http_data *http_response)
+{
+  static const char tag[] = "\ndate: ";
+  uint16_t i;
+  uint8_t j;
+  
+  http_response->date = 0;
+  for(i = 0; i + sizeof(tag)-1 + DATETIME_HTTP_LEN <= end_index; i++) {
+    for(j = 0; (j < sizeof(tag)-1) && ((rxBuf[i+j] | 0x20) == (tag[j] | 0x20));
+        j++);
+    if(j == sizeof(tag)-1) {
+      if(DateTimeParseHttp((const char *) &rxBuf[i+j], &http_response->date)
+         == FAIL)
+        http_response->date = 0;
+      return;
+    }
+  }
+}
+
+
+/*
+ * ScanStartupLine
+ * Description: Collect the bytes the module has sent so far into lines, and
+ *              look for a given line.
+ *
+ * Operation:   Append each received byte to bootLine. A <CR> or <LF> ends the
+ *              line, so compare it to the wanted line then start a new one.
+ *              Bytes past the end of bootLine are dropped; such a long line
+ *              isn't wanted anyway.
+ *
+ * Arguments:   line - wanted line, shorter than bootLine
+ * Return:      SUCCESS: wanted line seen
+ *              FAIL:    not seen yet
+ *
+ * Shared:      bootLine, bootLineLen [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int ScanStartupLine(const char *line)
+{
+  unsigned char c;
+  
+  while (SerialInRdy2()) {
+    c = SerialGetChar2();
+    if ((c == '\r') || (c == '\n')) {          /* end of line */
+      bootLine[bootLineLen] = '\0';
+      bootLineLen = 0;
+      if (strcmp(bootLine, line) == 0)
+        return SUCCESS;
+    } else if (bootLineLen < sizeof(bootLine)-1) {
+      bootLine[bootLineLen++] = c;
+    }
+  }
+  
+  return FAIL;
+}
+
+
 /*
  * SimStartTimer
  * Description: Start a countdown timer with a Timer. Countdown for passed in 
@@ -261,14 +464,18 @@ static void ParseHttpBodyJson(uint16_t start_index, uint16_t end_index,
  *
  * Operation:   Start timer countdown to passed in argument, and clear out 
  *              overtime flag, as timer hasn't timed out yet.
+ *              Waits started with a timer are bounded, so also clear the
+ *              watchdog; only a wait without one can hang long enough for it.
  *
  * Limitations: Critical code on timerOvertime
  *
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Clear the watchdog
  */
 void SimStartTimer(unsigned int ms)
 {
+  CLRWDT();               /* a bounded wait is starting */
   timer = ms;             /* Start timer */
   timerOvertime = FALSE;  /* timer hasn't timed out yet */
 }
@@ -285,10 +492,17 @@ void SimStartTimer(unsigned int ms)
  *              the timer has hit timed out/hit overtime, so set the overtime 
  *              flag.
  * 
+ *              Do the same for the startup timer.
+ *              Also count seconds, for the circuit breaker, and minutes, for
+ *              the DNS cache's TTL.
+ * 
  * Limitations: Critical code on timerOvertime
  *
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added startup timer
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Count minutes
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Count seconds
  */
 void SimTimerISR(void)
 {
@@ -296,6 +510,152 @@ void SimTimerISR(void)
     timer--;                               /* decrement it; set the overtime */
     if(timer == 0) timerOvertime = TRUE;   /* flag when it does time out */
   }
+  
+  if(bootTimer > 0) {                      /* same for the startup timer */
+    bootTimer--;
+    if(bootTimer == 0) bootOvertime = TRUE;
+  }
+  
+  if(++secondMs >= 1000) {                 /* count seconds for breaker */
+    secondMs = 0;
+    seconds++;
+    if(++minuteSecs >= 60) {               /* and minutes for DNS TTL */
+      minuteSecs = 0;
+      minutes++;
+    }
+  }
+}
+
+
+/*
+ * SimPowerOn
+ * Description: Start bringing up the module. This returns right away; call
+ *              SimPoll to move the startup along.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   The module may still be running from before a reset of just the
+ *              MCU (e.g. a brownout), and toggling its power key would then
+ *              turn it off. So first send an "AT" and give it SIM_PROBE_TIME
+ *              to answer.
+ *
+ * Shared:      simState, bootTimer, bootOvertime, bootLineLen [modified]
+ *
+ * Assumptions: Called after setting up Serial channel 2 and interrupts
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the RTT estimates and
+ *                                           retry policies
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the health monitor
+ */
+void SimPowerOn(void)
+{
+  SimRttInit();
+  SimRetryInit();
+  SimHealthInit();
+  
+  DATAPOWER_MCU_TRIS = 0;         /* power control is an output */
+  DATAPOWER_MCU = 0;              /* and power key released     */
+  
+  bootLineLen = 0;
+  simState = SIM_STATE_PROBE;
+  bootOvertime = FALSE;
+  bootTimer = SIM_PROBE_TIME;
+  SimPutStrLn("AT");              /* is the module already running? */
+}
+
+
+/*
+ * SimResume
+ * Description: Carry on with a module that is known to be up, e.g. after a
+ *              warm restart of just the MCU. This skips SimPowerOn's probe.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      simState [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the RTT estimates and
+ *                                           retry policies
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the health monitor
+ */
+void SimResume(void)
+{
+  SimRttInit();
+  SimRetryInit();
+  SimHealthInit();
+  
+  DATAPOWER_MCU_TRIS = 0;         /* power control is an output */
+  DATAPOWER_MCU = 0;              /* and power key released     */
+  
+  simState = SIM_STATE_READY;
+}
+
+
+/*
+ * SimPoll
+ * Description: Move the module startup along, without waiting on it.
+ *
+ * Arguments:   None
+ * Return:      startup state: SIM_STATE_PROBE, SIM_STATE_POWERING,
+ *              SIM_STATE_BOOTING or SIM_STATE_READY
+ *
+ * Operation:   SIM_STATE_PROBE:    an "OK" means the module is already
+ *                                  running, so it's ready. On timeout press
+ *                                  the power key.
+ *              SIM_STATE_POWERING: after SIM_POWER_PULSE release the key.
+ *              SIM_STATE_BOOTING:  the module is ready once it reports
+ *                                  "PB DONE", its last startup message. If it
+ *                                  hasn't after SIM_STARTUP_TIME, assume it's
+ *                                  ready anyway, as was always done before.
+ *              SIM_STATE_READY:    nothing left to do. Serial channel 2 is no
+ *                                  longer read here.
+ *
+ *              The power key pulse is high, low for at least 64ms, then high,
+ *              and DATAPOWER_MCU is inverted.
+ *
+ * Shared:      simState, bootTimer, bootOvertime [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t SimPoll(void)
+{
+  switch (simState) {
+  case SIM_STATE_PROBE:
+    if (ScanStartupLine("OK") == SUCCESS) {
+      simState = SIM_STATE_READY;
+    } else if (bootOvertime) {
+      DATAPOWER_MCU = 1;                        /* press power key */
+      bootOvertime = FALSE;
+      bootTimer = SIM_POWER_PULSE;
+      simState = SIM_STATE_POWERING;
+    }
+    break;
+    
+  case SIM_STATE_POWERING:
+    if (bootOvertime) {
+      DATAPOWER_MCU = 0;                        /* release power key */
+      bootOvertime = FALSE;
+      bootTimer = SIM_STARTUP_TIME * 1000U;
+      simState = SIM_STATE_BOOTING;
+    }
+    break;
+    
+  case SIM_STATE_BOOTING:
+    if ((ScanStartupLine("PB DONE") == SUCCESS) || bootOvertime)
+      simState = SIM_STATE_READY;
+    break;
+    
+  default:                                      /* SIM_STATE_READY */
+    break;
+  }
+  
+  return simState;
 }
 
 
@@ -379,8 +739,16 @@ void SimPutStrLn(const char *cmdstr)
  *              timeout.
  *              In each iteration, set timer and wait for a timeout or a serial 
  *              byte.
- *              If there are byte(s), grab. Else was a timeout so break from
- *              loop.
+ *              If there are byte(s), grab, and stop once the reply ends in a
+ *              final result code. Else was a timeout: break from the loop if
+ *              nothing came, or the reply has run out of time.
+ *
+ *              The first wait is for the reply to start, and uses its
+ *              adaptive timeout instead of a fixed SIM_TIMERCOUNT. The rest
+ *              are SIM_TIMERCOUNT long, and a reply gets SIM_FINAL_TIME of
+ *              them to reach its final result, since some commands (e.g.
+ *              AT+COPS=0) pause for seconds before it. Bytes left unread
+ *              would be taken for the next command's reply.
  *
  *              Note that checking for overtime is about more than just checking
  *              the flag.
@@ -395,24 +763,32 @@ void SimPutStrLn(const char *cmdstr)
  *
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Adaptive timeouts
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Read to the final result; only
+ *                                          the reply's start is adaptive
  */
 void SimGetBuf(void)
 {
-  int rxCountOld; /* use to track changed rxCount */
-  rxCount = 0;    /* 0-index'd number of bytes received */
+  uint16_t wait;
+  uint8_t waits_left = SIM_FINAL_TIME / SIM_TIMERCOUNT; /* for final result */
+  rxCount = 0;                    /* 0-index'd number of bytes received */
   
-  /* no way of detecting length so just keep looping till timeout */
+  wait = RttTimeout(&simRtt[SIM_RTT_REPLY]); /* first wait is for the reply */
   while(TRUE) {
-    SimStartTimer(SIM_TIMERCOUNT); /* set timer; wait for timeout or byte */
-    while(!SerialInRdy2() && !(timerOvertime && timer == 0));
+    SimStartTimer(wait);           /* set timer; wait for timeout or byte */
+    while(!SerialInRdy2() && !(timerOvertime && timer == 0)) CLRWDT();
+    if(rxCount == 0) SimRttDone(SIM_RTT_REPLY, wait);
+    wait = SIM_TIMERCOUNT;
     
-    rxCountOld = rxCount;                       /* record old timer value   */
+    if(!SerialInRdy2()) {                       /* timed out */
+      if((rxCount == 0) || (waits_left == 0)) break;
+      waits_left--;
+      continue;
+    }
     while(SerialInRdy2()) {                     /* if no timeout grab bytes */
       rxBuf[rxCount++] = SerialGetChar2();      /* from serial channel      */
     }
-    if (rxCount == rxCountOld){                 /* if there were no new bytes */
-      break;                                    /* then we timed out; break   */
-    }
+    if(AtFinal(rxBuf, rxCount)) break;          /* that's the whole reply */
   } 
 }
 
@@ -443,6 +819,96 @@ void SimPrintBuf(void)
 }
 
 
+/*
+ * SimRttInit
+ * Description: Start the round trip time estimates of each class of wait,
+ *              with the fixed timeouts they used to have.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      simRtt [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimRttInit(void)
+{
+  RttInit(&simRtt[SIM_RTT_REPLY], SIM_TIMERCOUNT, SIM_RTT_MIN,
+          2*SIM_TIMERCOUNT);
+  RttInit(&simRtt[SIM_RTT_HTTP], SIM_HTTP_RESPONSE_TIME, SIM_RTT_HTTP_MIN,
+          SIM_RTT_HTTP_MAX);
+  RttInit(&simRtt[SIM_RTT_TCP], SIM_HTTP_RESPONSE_TIME, SIM_RTT_HTTP_MIN,
+          SIM_RTT_HTTP_MAX);
+}
+
+
+/*
+ * SimTimerLeft
+ * Description: Get the time left on the timer started by SimStartTimer
+ *
+ * Arguments:   None
+ * Return:      ms left, 0 if timed out
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+static uint16_t SimTimerLeft(void)
+{
+  uint16_t left;
+  
+  READ_STABLE(left, timer);
+  
+  return left;
+}
+
+
+/*
+ * SimRttDone
+ * Description: Update a class's round trip time estimate after a wait on the
+ *              timer.
+ *
+ * Arguments:   cls  - SIM_RTT_* class of the wait
+ *              wait - ms the timer was started with
+ * Return:      None
+ *
+ * Operation:   If the timer ran out, back off the class's timeout. Else the
+ *              time it took is the time used up on the timer.
+ *
+ * Shared:      simRtt [modified]
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimRttDone(uint8_t cls, uint16_t wait)
+{
+  uint16_t left = SimTimerLeft();
+  
+  if(left == 0)
+    RttBackoff(&simRtt[cls]);
+  else
+    RttSample(&simRtt[cls], wait - left);
+}
+
+
+/*
+ * SimRtt
+ * Description: Get the round trip time estimate of a class of wait, for
+ *              telemetry.
+ *
+ * Arguments:   cls - SIM_RTT_* class
+ * Return:      estimate
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+const rtt_est *SimRtt(uint8_t cls)
+{
+  return &simRtt[cls];
+}
+
+
 /*
  * SimDataInit
  * Description: Initialize the SIM5218A data object with it's IMEI and IMSI
@@ -461,6 +927,9 @@ void SimPrintBuf(void)
  *              So rxCount is expected to be at least 25
  *                -> [accounting for initial <CR><LF> before digits]
  *
+ *              The IMEI is device specific, so it also seeds the retry
+ *              jitter.
+ *
  * Shared Variables: SIM5218A data representation
  *
  * Assumptions: Called after setting up Serial channel 2 and interrupts
@@ -470,11 +939,13 @@ void SimPrintBuf(void)
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
  *   May 11, 2013      Nnoduka Eruchalu     Fleshed out the details
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Seed retry jitter with the IMEI
  *   May 13, 2013      Nnoduka Eruchalu     Make module an argument
  */
 void SimDataInit(sim_data *module)
 {
   size_t i;
+  uint16_t seed = 0;
   SimStartTimer(0);                             /* clear timer */
 
   SimPutStrLn("AT"); SimGetBuf();        /* read startup messages */
@@ -482,7 +953,11 @@ void SimDataInit(sim_data *module)
   SimPutStrLn("AT+CGSN"); SimGetBuf();          /* get the IMEI   */
   for(i=0;((i<15) && (rxCount >= 24));i++) {    /* and save it as */
     module->imei[i] = rxBuf[rxCount-23+i] - '0'; /* numeric digits */
+    seed = 10*seed + module->imei[i];
   }
+  RetrySeed(&simBreaker, seed);
+  RetrySeed(&netregRetry, ~seed);
+  RetrySeed(&tcpRetry, seed ^ 0x5A5A);
   
   SimPutStrLn("AT+CIMI"); SimGetBuf();          /* get the IMSI   */
   for(i=0;((i<15) && (rxCount >= 24));i++) {    /* and save it as */
@@ -497,7 +972,8 @@ void SimDataInit(sim_data *module)
  * SimReset
  * Description: Reset the module
  *
- * Operation:   Send the reset AT-command, and wait appropriate # of seconds
+ * Operation:   Send the reset AT-command. This doesn't wait for the module to
+ *              restart; the caller has to leave it alone for SIM_RESET_TIME.
  *
  * Arguments:   None
  * Return:      SUCCESS/FAIL
@@ -506,19 +982,14 @@ void SimDataInit(sim_data *module)
  *
  * Revision History:
  *   May 11, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't wait out the restart
  */
 int SimReset(void) 
 {
-  int status;
   SimPutStrLn("AT+CRESET");      /* send reset AT-command   */
   SimGetBuf();                   /* get results immediately */
-  status = CheckForOk();
-  
-  if (status == SUCCESS) {       /* if reset was successful    */
-    __delay_s(SIM_RESET_TIME);   /* give SIM time to restart */
-  }
-  
-  return status;
+  tcpOpen = FALSE;               /* a reset drops the socket */
+  return CheckForOk();
 }
 
 
@@ -595,6 +1066,224 @@ int SimSetApn(const char *apn)
 }
 
 
+/*
+ * SimSignalQuality
+ * Description: Get signal quality
+ *
+ * Operation:   Send the CSQ AT-command and check "OK" is returned at the end.
+ *              The response is:
+ *                <CR><LF>+CSQ: <rssi>,<ber><CR><LF><CR><LF>OK<CR><LF>
+ *              so find the "+CSQ: " and read the rssi digits after it.
+ *
+ * Arguments:   rssi - pointer to rssi [modified]
+ * Return:      SUCCESS/FAIL
+ *              On SUCCESS, rssi is 0 (-113dBm or less) to 31 (-51dBm or more),
+ *              or SIM_CSQ_UNKNOWN
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int SimSignalQuality(uint8_t *rssi)
+{
+  unsigned int i;
+  
+  SimPutStrLn("AT+CSQ");                   /* send signal quality AT-command */
+  SimGetBuf();                             /* get response from module */
+  if(CheckForOk() == FAIL) return FAIL;
+  
+  for(i = 0; i + 6 < rxCount; i++) {
+    if(memcmp(&rxBuf[i], "+CSQ: ", 6) == 0) {
+      *rssi = 0;
+      for(i += 6; (i < rxCount) && (rxBuf[i] >= '0') && (rxBuf[i] <= '9'); i++)
+        *rssi = 10*(*rssi) + (rxBuf[i] - '0');
+      return SUCCESS;
+    }
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * SimClock
+ * Description: Get the network time
+ *
+ * Operation:   Send the CCLK AT-command and check "OK" is returned at the end.
+ *              The response is:
+ *                <CR><LF>+CCLK: "yy/MM/dd,hh:mm:ss+zz"<CR><LF>
+ *                <CR><LF>OK<CR><LF>
+ *              so find the "+CCLK: \"" and parse the time after it. The time
+ *              is only right if the network sent it (NITZ); until then the
+ *              module counts from its power on default, which is rejected.
+ *
+ * Arguments:   epoch - pointer to network time, in UTC [modified]
+ * Return:      SUCCESS/FAIL
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int SimClock(uint32_t *epoch)
+{
+  unsigned int i;
+  
+  SimPutStrLn("AT+CCLK?");                 /* send clock AT-command */
+  SimGetBuf();                             /* get response from module */
+  if(CheckForOk() == FAIL) return FAIL;
+  
+  for(i = 0; i + 8 + DATETIME_CCLK_LEN <= rxCount; i++) {
+    if(memcmp(&rxBuf[i], "+CCLK: \"", 8) == 0)
+      return DateTimeParseCclk((const char *) &rxBuf[i+8], epoch);
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * SimMinutes
+ * Description: Get the minutes counted by the timer ISR.
+ *
+ * Arguments:   None
+ * Return:      minutes since startup, wrapping at 2^16
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+static uint16_t SimMinutes(void)
+{
+  uint16_t m;
+  
+  READ_STABLE(m, minutes);
+  
+  return m;
+}
+
+
+/*
+ * SimDnsLoad
+ * Description: Load the server IP saved in data EEPROM into the DNS cache.
+ *
+ * Operation:   Accept the saved IP if it's a NULL-terminated string of digits
+ *              and dots; an erased region isn't. The time it was resolved
+ *              isn't kept, so it gets a fresh TTL. A stale IP only costs a
+ *              failed connection, which makes SimHttp resolve again.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      serverIp, dnsValid, dnsStamp, dnsLoaded [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimDnsLoad(void)
+{
+  size_t i;
+  
+  dnsLoaded = TRUE;
+  EepromRead(EEPROM_DNS_ADDR, serverIp, sizeof(serverIp));
+  
+  for(i = 0; (i < sizeof(serverIp)) && (serverIp[i] != '\0'); i++) {
+    if(((serverIp[i] < '0') || (serverIp[i] > '9')) && (serverIp[i] != '.'))
+      return;                                  /* not an IP */
+  }
+  if((i == 0) || (i == sizeof(serverIp))) return;
+  
+  dnsValid = TRUE;
+  dnsStamp = SimMinutes();
+}
+
+
+/*
+ * SimDnsResolve
+ * Description: Resolve the server's hostname with the module's DNS client,
+ *              and cache the IP in RAM and data EEPROM.
+ *
+ * Operation:   Send AT+CDNSGIP="<server>". A resolved name comes back as
+ *                +CDNSGIP: 1,"easypay.strivinglink.com","1.2.3.4"
+ *              and a failure as +CDNSGIP: 0,<err> or ERROR.
+ *              Take the last quoted string as the IP. Only write it to EEPROM
+ *              if it changed, to save EEPROM wear.
+ *
+ * Arguments:   None
+ * Return:      SUCCESS/FAIL
+ *
+ * Shared:      serverIp, dnsValid, dnsStamp [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int SimDnsResolve(void)
+{
+  char line[2*SIM_LINE_SIZE];                  /* fits hostname and IP */
+  char *ip, *end;
+  
+  dnsValid = FALSE;
+  SimPutStr("AT+CDNSGIP=\"");
+  SimPutStr(server);
+  SimPutStrLn("\"");
+  
+  SimStartTimer(SIM_DNS_TIME);
+  while(SimReadLine(line, sizeof(line)) == SUCCESS) {
+    if(strstr(line, "ERROR") || (strncmp(line, "+CDNSGIP: 0", 11) == 0))
+      return FAIL;
+    if(strncmp(line, "+CDNSGIP: 1", 11) != 0)
+      continue;                                /* echo, or other line */
+    
+    end = strrchr(line, '"');                  /* IP is the last string */
+    if(!end) return FAIL;
+    *end = '\0';
+    ip = strrchr(line, '"');
+    if(!ip || (strlen(ip+1) >= sizeof(serverIp)) || (ip[1] == '\0'))
+      return FAIL;
+    ip++;
+    
+    if(strcmp(ip, serverIp) != 0) {           /* a new IP, so save it */
+      strcpy(serverIp, ip);
+      EepromWrite(EEPROM_DNS_ADDR, serverIp, sizeof(serverIp));
+    }
+    dnsValid = TRUE;
+    dnsStamp = SimMinutes();
+    SimGetBuf();                               /* and the trailing OK */
+    return SUCCESS;
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * SimServerHost
+ * Description: Get the host to connect to the server with: its cached IP if
+ *              there is one within its TTL, else its hostname.
+ *
+ * Operation:   Load the EEPROM copy the first time through. Resolve the
+ *              hostname if there is no IP or its TTL has run out. If that
+ *              fails, use the hostname and let the module resolve it.
+ *
+ * Arguments:   None
+ * Return:      IP or hostname string
+ *
+ * Shared:      dnsLoaded, dnsValid, dnsStamp [read only]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static const char *SimServerHost(void)
+{
+  if(!dnsLoaded) SimDnsLoad();
+  
+  if(dnsValid && ((uint16_t) (SimMinutes() - dnsStamp) >= SIM_DNS_TTL))
+    dnsValid = FALSE;                          /* TTL ran out */
+  
+  if(!dnsValid && (SimDnsResolve() == FAIL))
+    return server;
+  
+  return serverIp;
+}
+
+
 /*
  * SimHttpLaunch
  * Description: Launch a HTTP Operation like GET or POST by first establishing
@@ -604,6 +1293,8 @@ int SimSetApn(const char *apn)
  *              Be sure to send a <Ctrl+Z> (0x1A) after it
  *              Sample command string is: 
  *                 "AT+CHTTPACT=\"easypay.strivinglink.com\",80"
+ *              The server's cached IP is used in place of its hostname when
+ *              there is one; the GET/POST still names the host.
  *
  * Arguments:   None
  * Return:      None
@@ -614,10 +1305,13 @@ int SimSetApn(const char *apn)
  *
  * Revision History:
  *   May 11, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Connect with cached IP
  */
 void SimHttpLaunch(void) {  
+  const char *host = SimServerHost();
+  
   SimPutStr("AT+CHTTPACT=\"");    /* start connection to server */
-  SimPutStr(server);
+  SimPutStr(host);
   SimPutStr("\",");
   SimPutStrLn(port);
   SerialPutChar2(0x1A);           /* send a <Ctrl+Z> */
@@ -698,10 +1392,11 @@ void SimHttpLaunchGet(const char *url, const char *param_str)
  *
  * Revision History:
  *   May 13, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Content-Length without sprintf
  */
 void SimHttpLaunchPost(const char *url, const char *param_str)
 {
-  char contentlength[6];            /* buffer to save param string length */
+  char contentlength[FORMAT_UINT_SIZE]; /* buffer to save param str length */
   
   if(!param_str) return;            /* parameter string required for post */
 
@@ -718,7 +1413,7 @@ void SimHttpLaunchPost(const char *url, const char *param_str)
   /* send content-type */  
   SimPutStrLn("Content-Type: application/x-www-form-urlencoded"); 
 
-  sprintf(contentlength, "%u", strlen(param_str)); /* determine and       */
+  FormatUint(contentlength, strlen(param_str));    /* determine and       */
   SimPutStr("Content-Length: ");                   /* send content-length */
   SimPutStrLn(contentlength);  
   
@@ -731,106 +1426,393 @@ void SimHttpLaunchPost(const char *url, const char *param_str)
 
 
 /*
- * SimHttp
- * Description: Perform HTTP GET Operation with the following steps:
- *               - Network registration
- *               - Set APN
- *               - Launch HTTP Operation (start connection)
- *               - Launch HTTP GET/POST Operation
- *               - Parse HTTP Response
+ * SimReadByte
+ * Description: Get the next byte from the module, without waiting past the
+ *              running timer.
  *
- * Operation:   First ensure Network Registration is done
- *              Keep trying to get network registration up to max number of
- *              tries. If trial count maxes out, reset the module and try again.
- *              continue this reset cycle up to max allowed, and if still no
- *              network registration, return FAIL;
+ * Arguments:   c - received byte [modified]
+ * Return:      SUCCESS: got a byte
+ *              FAIL:    timed out
  *
- *              After network registration, launch http operation. If return
- *              is what's expected then launch http get operation, and wait for
- *              return value. If it's valid proceed to launch http get, else
- *              end this function and return FAIL.
+ * Operation:   Wait for a byte or a timeout, clearing the watchdog since the
+ *              wait is bounded by the timer.
  *
- * Arguments:   method - SIM_HTTP_GET/SIM_HTTP_POST
- *              url - GET/POST URL assuming servername is already known. So to
- *                    access http://servname.com/location/ set url="/location/"
- *              param_str - complete parameter string
- *                          Example: myparam1=test1&myparam2=test2
- *              http_response - pointer to structure to save http response data
- * Return:      SUCCESS/FAIL
+ * Assumptions: SimStartTimer was called for the whole exchange
  *
- * Assumptions: None
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int SimReadByte(unsigned char *c)
+{
+  while(!SerialInRdy2() && !(timerOvertime && timer == 0)) CLRWDT();
+  if(!SerialInRdy2()) return FAIL;             /* timed out */
+  
+  *c = SerialGetChar2();
+  return SUCCESS;
+}
+
+
+/*
+ * SimReadLine
+ * Description: Get the next non-empty line from the module, without waiting
+ *              past the running timer.
  *
- * Error Checking: Check for appropriate response 
+ * Arguments:   line - NULL-terminated line, without <CR><LF> [modified]
+ *              size - bytes in line; longer lines are cut short
+ * Return:      SUCCESS: got a line
+ *              FAIL:    timed out
+ *
+ * Assumptions: SimStartTimer was called for the whole exchange
  *
  * Revision History:
- *  May 12, 2013      Nnoduka Eruchalu     Initial Revision
- *  May 13, 2013      Nnoduka Eruchalu     Changed from SimHttpGet -> SimHttp
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
  */
-int SimHttp(uint8_t method, const char *url, const char *param_str, 
-            http_data *http_response)
+static int SimReadLine(char *line, size_t size)
+{
+  unsigned char c;
+  size_t len = 0;
+  
+  while(SimReadByte(&c) == SUCCESS) {
+    if((c == '\r') || (c == '\n')) {
+      if(len == 0) continue;                   /* skip empty lines */
+      line[len] = '\0';
+      return SUCCESS;
+    }
+    if(len < size-1) line[len++] = c;
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * SimWaitLine
+ * Description: Wait for the module to report an expected line.
+ *
+ * Arguments:   want - start of expected line, e.g. "Connect ok"
+ *              ms   - time to wait
+ * Return:      SUCCESS: got the expected line, or was told it's "already"
+ *                       done (e.g. "+IP ERROR: Network is already opened")
+ *              FAIL:    timed out, or got an ERROR or a "fail" line
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int SimWaitLine(const char *want, unsigned int ms)
 {
-  uint8_t netreg_trials = 0;    /* # of network reg attempts since last reset */
-  uint8_t reset_trials = 0;     /* number of system resets */
+  char line[SIM_LINE_SIZE];
+  
+  SimStartTimer(ms);
+  while(SimReadLine(line, sizeof(line)) == SUCCESS) {
+    if(strncmp(line, want, strlen(want)) == 0) return SUCCESS;
+    if(strstr(line, "already")) return SUCCESS;
+    if(strstr(line, "ERROR") || strstr(line, "fail")) return FAIL;
+  }
+  
+  return FAIL;
+}
+
+
+/*
+ * SimNetworkAttach
+ * Description: Get the module registered on the network, with its APN set.
+ *
+ * Operation:   Keep trying to get network registration up to max number of
+ *              tries, backing off (with jitter) between tries. If trial count
+ *              maxes out, return FAIL.
+ *              After network registration, set the APN.
+ *              The module isn't reset here; that's left to SimProbe once the
+ *              circuit breaker has stopped requests, so a customer never
+ *              waits out a reset.
+ *
+ * Arguments:   None
+ * Return:      SUCCESS/FAIL
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision, moved out of
+ *                                          SimHttp
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Back off between trials, no resets
+ */
+static int SimNetworkAttach(void)
+{
+  uint8_t netreg_trials = 0;    /* # of network reg attempts */
   uint8_t netreg_status = 0;    /* start by assuming not registered */
-  int netreg_success;           /* variables for operation success/fail */
-  int apn_success;
-  uint8_t num_crlf = 0;         /* # of <CR><LF> recorded          */
+  int netreg_success = FAIL;    /* variables for operation success/fail */
   
-  /* POST requires param_str */
-  if((method == SIM_HTTP_POST) && (!param_str)) return FAIL;
+  /* keep trying network reg up till max # of trials */
+  while(TRUE) {
+    netreg_success = SimNetworkReg(&netreg_status);  /* attempt network reg */
+    if((netreg_success == SUCCESS) && (netreg_status == 1))
+      break;                                         /* if successful, break */
+    
+    if(++netreg_trials >= SIM_HTTP_NETREG_TRIALS)    /* record attempt */
+      return FAIL;
+    SimWait(RetryDelay(&netregRetry, netreg_trials-1)); /* back off */
+  }
+  
+  /* if a successful network registration, set APN */
+  return SimSetApn(apn_att_ipad);
+}
+
+
+/*
+ * SimTcpClose
+ * Description: Drop the server socket, so the next request opens a new one.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      tcpOpen [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimTcpClose(void)
+{
+  SimPutStrLn("AT+NETCLOSE");   /* closes the socket along with the network */
+  SimGetBuf();
+  tcpOpen = FALSE;
+}
+
 
-  /* keep attempting connections, until # of system resets max's out */
-  while (reset_trials < SIM_HTTP_RESET_TRIALS) {
+/*
+ * SimTcpConnect
+ * Description: Make sure there is an open socket to the server's framed
+ *              request port.
+ *
+ * Operation:   If the socket is already open there is nothing to do; this is
+ *              what saves a connection setup per request. Else open the
+ *              module's network (AT+NETOPEN) and connect to the server
+ *              (AT+TCPCONNECT), waiting for each to report back. Connect by
+ *              the server's cached IP.
+ *              A failed connect backs the socket off for SIM_TCP_BACKOFF,
+ *              doubling up to SIM_TCP_BACKOFF_MAX, so a server without the
+ *              framed port doesn't cost every request a connect attempt. It
+ *              keeps the cached IP: a refused port doesn't mean the IP moved,
+ *              and CHTTPACT forgets it if it did.
+ *
+ * Arguments:   None
+ * Return:      SUCCESS: socket is open
+ *              FAIL:    no socket, or backing off; nothing was sent to the
+ *                       server
+ *
+ * Assumptions: Module is attached to the network if the socket isn't open
+ *
+ * Shared:      tcpOpen [modified]
+ *              tcpRetry [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Connect with cached IP
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Back off after a failed connect,
+ *                                          keeping the cached IP
+ */
+static int SimTcpConnect(void)
+{
+  if(tcpOpen) return SUCCESS;
+  if(!RetryAllow(&tcpRetry, SimSeconds())) return FAIL; /* backing off */
+  
+  SimPutStrLn("AT+NETOPEN=\"TCP\"");
+  if(SimWaitLine("Network opened", SIM_TCP_OPEN_TIME) == FAIL) goto fail;
+  
+  SimPutStr("AT+TCPCONNECT=\"");
+  SimPutStr(SimServerHost());
+  SimPutStr("\",");
+  SimPutStrLn(tcp_port);
+  if(SimWaitLine("Connect ok", SIM_TCP_OPEN_TIME) == FAIL) {
+    SimTcpClose();
+    goto fail;
+  }
+  
+  RetrySuccess(&tcpRetry);
+  tcpOpen = TRUE;
+  return SUCCESS;
+  
+ fail:
+  RetryFailure(&tcpRetry, SimSeconds());
+  return FAIL;
+}
+
+
+/*
+ * SimTcpRequest
+ * Description: Perform a request as a frame on the open server socket.
+ *
+ * Operation:   Send the request frame with AT+TCPWRITE: wait for its '>'
+ *              prompt, send the frame and wait for "Send ok". Frames are:
+ *                request:  <len><LF><id> <G|P> <url> <params>
+ *                response: <len><LF><id> <time> <json>
+ *              where <len> is the number of bytes after the <LF>, <id>
+ *              is a request ID that goes up by 1 per request and <time> is
+ *              the server's time in epoch seconds, in place of the Date
+ *              header. A response without <time> leaves the date 0.
+ *              Received data comes as +IPD<n><CR><LF><data>, so skip lines up
+ *              to a +IPD, then read the frame length and the frame. A frame
+ *              with another ID is a late response to an earlier request that
+ *              timed out, so skip it and wait for the next one. When the ID
+ *              matches, parse the time and the json in the frame.
+ *              On any failure the socket's state is unknown, so drop it.
+ *
+ * Arguments:   method - SIM_HTTP_GET/SIM_HTTP_POST
+ *              url - request URL, e.g. "/location/"
+ *              param_str - complete parameter string, or NULL
+ *              http_response - pointer to structure to save response data
+ * Return:      SUCCESS/FAIL
+ *
+ * Limitations: A response frame has to come in a single +IPD, which holds
+ *              for the server's short json replies.
+ *
+ * Shared:      requestId [modified]
+ *              rxBuf, rxCount [modified]
+ *              simRtt [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Adaptive response timeout
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Server time in the response frame
+ */
+static int SimTcpRequest(uint8_t method, const char *url,
+                         const char *param_str, http_data *http_response)
+{
+  char id_str[FORMAT_UINT_SIZE];      /* request ID */
+  char len_str[FORMAT_UINT_SIZE];     /* frame length */
+  char line[SIM_LINE_SIZE];           /* module's response line */
+  size_t id_len, len_len, frame_len;
+  uint16_t start_body, end_body;      /* indices of '{' and '}' in rxBuf */
+  uint16_t wait = 0;                  /* response timeout, 0 before waiting */
+  unsigned char c;
+  
+  if(!param_str) param_str = "";
+  
+  /* build frame header */
+  requestId++;
+  id_len = FormatUint(id_str, requestId);
+  frame_len = id_len + 3 + strlen(url) + 1 + strlen(param_str);
+  len_len = FormatUint(len_str, frame_len);
+  
+  /* send frame */
+  SimPutStr("AT+TCPWRITE=");
+  FormatUint(line, len_len + 1 + frame_len);
+  SimPutStrLn(line);
+  SimStartTimer(SIM_TIMERCOUNT);
+  do {                                          /* wait for '>' prompt */
+    if(SimReadByte(&c) == FAIL) goto fail;
+  } while(c != '>');
+  
+  SimPutStr(len_str); SerialPutChar2('\n');
+  SimPutStr(id_str);
+  SimPutStr((method == SIM_HTTP_GET) ? " G " : " P ");
+  SimPutStr(url); SerialPutChar2(' ');
+  SimPutStr(param_str);
+  if(SimWaitLine("Send ok", SIM_TCP_SEND_TIME) == FAIL) goto fail;
+  
+  /* get the response frame with our ID */
+  wait = RttTimeout(&simRtt[SIM_RTT_TCP]);
+  SimStartTimer(wait);
+  while(TRUE) {
+    do {                                        /* skip to received data */
+      if(SimReadLine(line, sizeof(line)) == FAIL) goto fail;
+      if(strstr(line, "CLOSE")) goto fail;      /* server dropped socket */
+    } while(strncmp(line, "+IPD", 4) != 0);
     
-    /* in a recet cycle, keep trying network reg up till max # of trials */
-    while(netreg_trials < SIM_HTTP_NETREG_TRIALS) {
-      netreg_success = SimNetworkReg(&netreg_status);/* attempt network reg */
-      netreg_trials++;                               /* and record attempt  */
-      
-      if((netreg_success == SUCCESS) && (netreg_status == 1))
-        break;                                       /* if successful, break */
+    do {                                        /* skip rest of +IPD line */
+      if(SimReadByte(&c) == FAIL) goto fail;
+    } while((c == '\r') || (c == '\n'));
+    
+    frame_len = 0;                              /* get frame length */
+    while((c >= '0') && (c <= '9')) {
+      frame_len = 10*frame_len + (c - '0');
+      if(SimReadByte(&c) == FAIL) goto fail;
     }
+    if((c != '\n') || (frame_len == 0) || (frame_len >= sizeof(rxBuf)))
+      goto fail;
     
-    /* get here from either a successful network registration attempt or 
-     * it's simply time for a system reset.
-     */
-    if((netreg_success == SUCCESS) && (netreg_status == 1))
-      break;
-   
-    SimReset();                                      /* if here, then reset */
-    reset_trials++;                                  /* and record reset    */
+    for(rxCount = 0; rxCount < frame_len; rxCount++) {
+      if(SimReadByte(&rxBuf[rxCount]) == FAIL) goto fail;
+    }
+    
+    if((frame_len > id_len) && (memcmp(rxBuf, id_str, id_len) == 0) &&
+       (rxBuf[id_len] == ' '))
+      break;                                    /* it's our response */
   }
+  SimRttDone(SIM_RTT_TCP, wait);
   
-  /* if still an unsuccessful network registration, return fail. */
-  if(!((netreg_success == SUCCESS) && (netreg_status == 1)))
-    return FAIL;
+  /* parse server time, if the frame has one */
+  for(start_body = id_len + 1; (start_body < rxCount) &&
+        (rxBuf[start_body] >= '0') && (rxBuf[start_body] <= '9'); start_body++)
+    http_response->date = 10*http_response->date + (rxBuf[start_body] - '0');
   
-  /* if a successful network registration, set APN */
-  apn_success = SimSetApn(apn_att_ipad);
-  /* fail operation if APN setting is uncessful */
-  if(apn_success == FAIL) return FAIL;
- 
-  /* if apn set successfully launch http operation */
+  /* parse json body */
+  for(; (start_body < rxCount) && (rxBuf[start_body] != '{');
+      start_body++);
+  for(end_body = rxCount-1; (end_body > start_body) && (rxBuf[end_body] != '}');
+      end_body--);
+  if(end_body <= start_body) goto fail;
+  
+  ParseHttpBodyJson(start_body, end_body, http_response);
+  return SUCCESS;
+  
+ fail:
+  if((wait != 0) && (SimTimerLeft() == 0))      /* response timed out */
+    SimRttDone(SIM_RTT_TCP, wait);
+  SimTcpClose();
+  return FAIL;
+}
+
+
+/*
+ * SimHttpAct
+ * Description: Perform a HTTP GET/POST Operation with AT+CHTTPACT, which
+ *              connects to the server and sends full headers for just this
+ *              request.
+ *
+ * Operation:   Launch http operation. If return is what's expected then
+ *              launch http get operation, and wait for return value. If it's
+ *              valid proceed to launch http get, else end this function and
+ *              return FAIL.
+ *              The launch reply is waited on for at most SIM_HTTPACT_TIME,
+ *              clearing the watchdog, so a module that never answers fails
+ *              the request instead of resetting the MCU.
+ *
+ * Arguments:   method - SIM_HTTP_GET/SIM_HTTP_POST
+ *              url - GET/POST URL
+ *              param_str - complete parameter string
+ *              http_response - pointer to structure to save http response data
+ * Return:      SUCCESS/FAIL
+ *
+ * Assumptions: Module is attached to the network
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision, moved out of
+ *                                          SimHttp
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Forget cached IP on failed launch
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Time out waiting on the launch
+ */
+static int SimHttpAct(uint8_t method, const char *url, const char *param_str, 
+                      http_data *http_response)
+{
+  char line[SIM_LINE_SIZE];      /* module's response line          */
+  
+  /* launch http operation */
   SimHttpLaunch();
   
-  /* and don't go anywhere till a response is received
+  /* and wait for its response line
    * A valid response is:   +CHTTPACT: REQUEST, and
    * invalid responses are: +CHTTPACT: 22[0-7]
    *                        network error
    *                        and many others
-   * A response has been received when <CR><LF> characters have appeared twice
    */
-  rxCount = 0;
-  do {
-    rxBuf[rxCount++] = SerialGetChar2();   /* get char and INC rxBuf index */
-    if((rxCount>=2) && (rxBuf[rxCount-2]=='\r') && (rxBuf[rxCount-1]=='\n'))
-      num_crlf++;                          /* record <CR><LF> cluster count */
-    
-  }while(num_crlf < 2);
+  SimStartTimer(SIM_HTTPACT_TIME);
+  if(SimReadLine(line, sizeof(line)) == FAIL)
+    line[0] = '\0';                        /* timed out */
   
-  /* if http launch was unsuccessful then return a failed operation */
-  if(!((rxBuf[rxCount-4] == 'S') && (rxBuf[rxCount-3] == 'T')))
+  /* if http launch was unsuccessful then return a failed operation, and
+   * resolve the server's IP again next time in case it moved
+   */
+  if(strncmp(line, "+CHTTPACT: REQUEST", 18) != 0) {
+    dnsValid = FALSE;
     return FAIL;
+  }
   
   /* a successful http launch, so go finally execute http get/post */
   if(method == SIM_HTTP_GET) SimHttpLaunchGet(url, param_str);
@@ -840,6 +1822,88 @@ int SimHttp(uint8_t method, const char *url, const char *param_str,
 }
 
 
+/*
+ * SimHttp
+ * Description: Perform HTTP GET Operation with the following steps:
+ *               - Network registration
+ *               - Set APN
+ *               - Send the request, on the kept-open server socket or as a
+ *                 separate HTTP operation (AT+CHTTPACT)
+ *               - Parse the response
+ *
+ * Operation:   With the socket transport, an open socket means the network
+ *              is up, so go straight to the request. Else get the module
+ *              attached to the network, then try to (re)open the socket.
+ *              If it can't be opened (e.g. the server doesn't take framed
+ *              requests) nothing has been sent, so fall back on a HTTP
+ *              operation. A request that fails once sent isn't retried, since
+ *              the server may have acted on it.
+ *
+ *              While this runs the module isn't idle, so it's not recorded
+ *              as ready for a warm restart until the operation succeeds.
+ *
+ *              Each request goes through the circuit breaker: once requests
+ *              keep failing they fail right away, without touching the
+ *              module, till SimProbe (or a request let through as a probe)
+ *              finds the network is back.
+ *
+ * Arguments:   method - SIM_HTTP_GET/SIM_HTTP_POST
+ *              url - GET/POST URL assuming servername is already known. So to
+ *                    access http://servname.com/location/ set url="/location/"
+ *              param_str - complete parameter string
+ *                          Example: myparam1=test1&myparam2=test2
+ *              http_response - pointer to structure to save http response data
+ * Return:      SUCCESS/FAIL
+ *
+ * Assumptions: None
+ *
+ * Error Checking: Check for appropriate response 
+ *
+ * Revision History:
+ *  May 12, 2013      Nnoduka Eruchalu     Initial Revision
+ *  May 13, 2013      Nnoduka Eruchalu     Changed from SimHttpGet -> SimHttp
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Record module state for restarts
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Socket transport; moved network
+ *                                          attach and CHTTPACT out
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Circuit breaker
+ *  Oct. 17, 2026      Nnoduka Eruchalu     No date unless the response has one
+ */
+int SimHttp(uint8_t method, const char *url, const char *param_str, 
+            http_data *http_response)
+{
+  int status;
+  
+  /* POST requires param_str */
+  if((method == SIM_HTTP_POST) && (!param_str)) return FAIL;
+  http_response->date = 0;
+  
+  /* fail fast while the breaker is open */
+  if(!RetryAllow(&simBreaker, SimSeconds())) return FAIL;
+  
+  /* a hang from here on could leave the module in any state */
+  RestartSetModem(FALSE);
+  
+  /* an open socket means the module is already attached */
+  if((SIM_SOCKET_TRANSPORT && tcpOpen) || (SimNetworkAttach() == SUCCESS)) {
+    if(SIM_SOCKET_TRANSPORT && (SimTcpConnect() == SUCCESS))
+      status = SimTcpRequest(method, url, param_str, http_response);
+    else
+      status = SimHttpAct(method, url, param_str, http_response);
+  } else {
+    status = FAIL;
+  }
+  
+  if(status == SUCCESS) {
+    RetrySuccess(&simBreaker);
+    RestartSetModem(TRUE);                     /* module is idle and fine */
+  } else {
+    RetryFailure(&simBreaker, SimSeconds());
+  }
+  
+  return status;
+}
+
+
 /*
  * SimHttpGet
  * Description: Perform HTTP GET Operation.
@@ -991,6 +2055,9 @@ transfer-encoding: chunked
  *
  * Revision History:
  *   May 12, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Don't wait for a byte past timeout
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Adaptive timeout
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Get the Date header
  */
 int SimHttpParseResponse(http_data *http_response)
 {
@@ -998,10 +2065,15 @@ int SimHttpParseResponse(http_data *http_response)
   uint16_t start_body = 0;     /* index to where '{' is in rxBuf */
   uint16_t end_body = 0;       /* index to where '}' is in rxBuf */
   size_t i;                    /* index into body section of rxBuf */
+  uint16_t wait = RttTimeout(&simRtt[SIM_RTT_HTTP]);
   
   /* wait for timeout or entire content of body */
-  SimStartTimer(SIM_HTTP_RESPONSE_TIME);
+  SimStartTimer(wait);
   do {
+    /* this wait is bounded, and longer than the watchdog period */
+    while(!SerialInRdy2() && !(timerOvertime && timer==0)) CLRWDT();
+    if(!SerialInRdy2()) break;                     /* timed out */
+    
     rxBuf[rxCount] = SerialGetChar2();             /* get char from channel  */
     if(rxBuf[rxCount]=='{') start_body = rxCount;  /* get index to '{'       */
     if(rxBuf[rxCount]=='}') {                      /* get index to '}' which */
@@ -1009,6 +2081,7 @@ int SimHttpParseResponse(http_data *http_response)
     }
     rxCount++;                                     /* move to next buffer slot*/
   }while((have_body == FALSE) && !(timerOvertime && timer==0));
+  SimRttDone(SIM_RTT_HTTP, wait);
   
   /* if still don't have body, return FAIL */
   if(have_body == FALSE) {     
@@ -1017,6 +2090,253 @@ int SimHttpParseResponse(http_data *http_response)
   
   /* if here, then have body and start and end tags, so extract content */
   ParseHttpBodyJson(start_body, end_body, http_response);
+  ParseHttpDate(start_body, http_response);
   
   return SUCCESS; /* frankly, if function got here, all is well */
 }
+
+
+/*
+ * SimSeconds
+ * Description: Get the seconds counted by the timer ISR.
+ *
+ * Arguments:   None
+ * Return:      seconds since startup, wrapping at 2^16
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Use READ_STABLE
+ */
+static uint16_t SimSeconds(void)
+{
+  uint16_t s;
+  
+  READ_STABLE(s, seconds);
+  
+  return s;
+}
+
+
+/*
+ * SimWait
+ * Description: Wait on the timer, e.g. to back off before a retry.
+ *
+ * Arguments:   ms - time to wait
+ * Return:      None
+ *
+ * Operation:   __delay_ms needs a constant, so count down on the timer
+ *              instead. The wait is bounded, so clear the watchdog while in
+ *              it.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimWait(uint16_t ms)
+{
+  SimStartTimer(ms);
+  while(!(timerOvertime && timer == 0)) CLRWDT();
+}
+
+
+/*
+ * SimRetryInit
+ * Description: Start the retry policies, with the circuit breaker closed.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      simBreaker, netregRetry, tcpRetry [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added socket connect backoff
+ */
+static void SimRetryInit(void)
+{
+  RetryInit(&simBreaker, SIM_BREAKER_FAILURES, SIM_BREAKER_BACKOFF,
+            SIM_BREAKER_BACKOFF_MAX);
+  RetryInit(&netregRetry, SIM_HTTP_NETREG_TRIALS, SIM_NETREG_BACKOFF,
+            SIM_NETREG_BACKOFF_MAX);
+  RetryInit(&tcpRetry, 1, SIM_TCP_BACKOFF, SIM_TCP_BACKOFF_MAX);
+}
+
+
+/*
+ * SimOnline
+ * Description: Are server requests being tried? They aren't while the circuit
+ *              breaker is open, so callers can go straight to their offline
+ *              behaviour.
+ *
+ * Arguments:   None
+ * Return:      TRUE/FALSE
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t SimOnline(void)
+{
+  return (RetryState(&simBreaker) != RETRY_OPEN);
+}
+
+
+/*
+ * SimProbe
+ * Description: Probe the network in the background while the circuit breaker
+ *              has requests failing fast.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   When the breaker lets a probe through, check for network
+ *              registration once and set the APN. If that works requests can
+ *              go ahead again. Else reset the module, and the breaker's
+ *              backoff (at least SIM_BREAKER_BACKOFF/2, longer than
+ *              SIM_RESET_TIME) gives it time to restart before the next probe.
+ *              Each probe is a couple of short AT commands, so it's fine to
+ *              call from an idle page.
+ *
+ * Shared:      simBreaker [modified]
+ *
+ * Assumptions: Module is ready for AT commands
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void SimProbe(void)
+{
+  uint8_t netreg_status = 0;
+  
+  if((RetryState(&simBreaker) != RETRY_OPEN) ||
+     !RetryAllow(&simBreaker, SimSeconds()))
+    return;
+  
+  RestartSetModem(FALSE);
+  if((SimNetworkReg(&netreg_status) == SUCCESS) && (netreg_status == 1) &&
+     (SimSetApn(apn_att_ipad) == SUCCESS)) {
+    RetrySuccess(&simBreaker);
+    RestartSetModem(TRUE);
+  } else {
+    RetryFailure(&simBreaker, SimSeconds());
+    SimReset();
+  }
+}
+
+
+/*
+ * SimHealthInit
+ * Description: Start the health monitor, assuming good health till the first
+ *              poll says otherwise.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Shared:      healthState, healthRssi, healthBad, healthStamp [modified]
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void SimHealthInit(void)
+{
+  healthState = SIM_HEALTH_GOOD;
+  healthRssi = 4*(SIM_CSQ_WEAK + SIM_CSQ_HYSTERESIS);
+  healthBad = 0;
+  healthStamp = SimSeconds();
+}
+
+
+/*
+ * SimHealthPoll
+ * Description: Poll the module's registration and signal quality, when it's
+ *              time to, and act on a module in bad health before a customer
+ *              runs into it.
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   Poll every SIM_HEALTH_PERIOD while in good health, and every
+ *              SIM_HEALTH_PERIOD_BAD otherwise. Don't poll while the circuit
+ *              breaker is open; SimProbe is looking after the module then.
+ *              Not registered (or not answering) is down. Else smooth the
+ *              rssi (EWMA, 1/4 weight to the new sample) so one bad sample
+ *              doesn't count, and it's weak under SIM_CSQ_WEAK, good again
+ *              only past SIM_CSQ_WEAK + SIM_CSQ_HYSTERESIS, so the health
+ *              doesn't flap at the boundary.
+ *              After SIM_HEALTH_REREG_POLLS bad polls in a row, drop the socket
+ *              and ask for automatic operator selection, which re-registers.
+ *              After SIM_HEALTH_RESET_POLLS reset the module and open the
+ *              circuit breaker, so the terminal is offline while the module
+ *              restarts. The breaker's backoff is longer than SIM_RESET_TIME,
+ *              and SimProbe then checks the module before requests go ahead.
+ *
+ * Shared:      healthState, healthRssi, healthBad, healthStamp [modified]
+ *              simBreaker [modified]
+ *
+ * Assumptions: Called between customers, e.g. from an idle page, with the
+ *              module ready for AT commands
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Offline while a reset module restarts
+ */
+void SimHealthPoll(void)
+{
+  uint8_t netreg_status = 0;
+  uint8_t rssi = 0;
+  uint16_t period;
+  
+  period = (healthState == SIM_HEALTH_GOOD) ? SIM_HEALTH_PERIOD :
+                                              SIM_HEALTH_PERIOD_BAD;
+  if(!SimOnline() ||
+     ((int16_t) (SimSeconds() - healthStamp) < (int16_t) period))
+    return;
+  healthStamp = SimSeconds();
+  
+  if((SimNetworkReg(&netreg_status) == FAIL) || (netreg_status != 1)) {
+    healthState = SIM_HEALTH_DOWN;
+  } else {
+    if((SimSignalQuality(&rssi) == FAIL) || (rssi == SIM_CSQ_UNKNOWN))
+      rssi = 0;
+    healthRssi = healthRssi + rssi - healthRssi/4;     /* EWMA, scaled by 4 */
+    
+    if(healthRssi < 4*SIM_CSQ_WEAK)
+      healthState = SIM_HEALTH_WEAK;
+    else if(healthRssi >= 4*(SIM_CSQ_WEAK + SIM_CSQ_HYSTERESIS))
+      healthState = SIM_HEALTH_GOOD;
+    else if(healthState == SIM_HEALTH_DOWN)          /* in hysteresis band */
+      healthState = SIM_HEALTH_WEAK;
+    RestartSetModem(TRUE);                           /* module is fine */
+  }
+  
+  if(healthState == SIM_HEALTH_GOOD) {
+    healthBad = 0;
+    return;
+  }
+  
+  healthBad++;
+  if(healthBad >= SIM_HEALTH_RESET_POLLS) {
+    healthBad = 0;
+    RestartSetModem(FALSE);
+    SimReset();
+    RetryTrip(&simBreaker, SimSeconds());            /* offline till it's up */
+  } else if(healthBad == SIM_HEALTH_REREG_POLLS) {
+    if(tcpOpen) SimTcpClose();
+    SimPutStrLn("AT+COPS=0");                        /* re-register */
+    SimGetBuf();
+  }
+}
+
+
+/*
+ * SimHealth
+ * Description: Get the module's health, as of the last poll
+ *
+ * Arguments:   None
+ * Return:      SIM_HEALTH_GOOD/SIM_HEALTH_WEAK/SIM_HEALTH_DOWN
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint8_t SimHealth(void)
+{
+  return healthState;
+}
@@ -17,6 +17,25 @@
  * Revision History:
  *   May 07, 2013      Nnoduka Eruchalu     Initial Revision
  *   May 16, 2013      Nnoduka Eruchalu     Added number2 to http_response
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added startup states and power
+ *                                           control, moved from main.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SimResume
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added socket transport settings
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added DNS cache settings
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added adaptive timeout classes
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added retry and circuit breaker
+ *                                           settings, dropped reset trials
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added health monitor
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added server date and SimClock
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SimRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SIM_HTTPACT_TIME
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added SIM_FINAL_TIME; gaps in a
+ *                                           reply aren't timed adaptively
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed SimRam; diag.c takes
+ *                                           RAM from the map file
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Server date from a response frame
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Socket transport off by default;
+ *                                           added socket connect backoff
  */
 
 #ifndef SIM5218_H
@@ -24,6 +43,7 @@
 
 /* library include files */
 #include <stdint.h>
+#include "rtt.h"
 
 /* --------------------------------------
  * SIM5218 Timer Counters
@@ -31,16 +51,102 @@
  */
 #define SIM_TIMERCOUNT         500   /* ms to wait before comm. timeout   */
 #define SIM_STARTUP_TIME       10    /* startup time of module in seconds */
+#define SIM_PROBE_TIME         300   /* ms to wait for a running module's OK */
+#define SIM_POWER_PULSE        100   /* ms to hold power key (at least 64ms) */
 #define SIM_RESET_TIME         20    /* module reset time in seconds      */
 #define SIM_HTTP_RESPONSE_TIME 10000 /* ms to wait for HTTP response      */
+#define SIM_HTTPACT_TIME       10000 /* ms to wait for CHTTPACT to connect */
+#define SIM_FINAL_TIME         10000 /* ms to wait for a reply's final result */
+#define SIM_TCP_OPEN_TIME      10000 /* ms to wait for network/socket open */
+#define SIM_TCP_SEND_TIME      2000  /* ms to wait for socket send         */
+#define SIM_DNS_TIME           10000 /* ms to wait for DNS resolution      */
+#define SIM_DNS_TTL            1440  /* minutes a resolved server IP is used */
+
+
+/* --------------------------------------
+ * SIM5218 Adaptive Timeouts
+ * --------------------------------------
+ * each class of wait keeps its own round trip time estimate (see rtt.c)
+ */
+#define SIM_RTT_REPLY          0     /* command to first byte of its reply */
+#define SIM_RTT_HTTP           1     /* CHTTPACT request to its json body  */
+#define SIM_RTT_TCP            2     /* socket request to its response frame */
+#define SIM_RTT_CLASSES        3
+
+#define SIM_RTT_MIN            100   /* shortest reply wait in ms          */
+#define SIM_RTT_HTTP_MIN       2000  /* shortest HTTP/TCP response wait    */
+#define SIM_RTT_HTTP_MAX       30000 /* longest HTTP/TCP response wait     */
+
+
+/* --------------------------------------
+ * SIM5218 Transport
+ * --------------------------------------
+ */
+#define SIM_SOCKET_TRANSPORT   FALSE /* send requests as frames on a kept-open
+                                        socket; FALSE: always use CHTTPACT.
+                                        Needs a server with a framed port */
+#define SIM_TCP_BACKOFF        300   /* s CHTTPACT is used after a failed  */
+#define SIM_TCP_BACKOFF_MAX    3600  /* socket connect, doubling to this   */
+#define SIM_LINE_SIZE          40    /* chars kept of a module response line */
+
+
+/* --------------------------------------
+ * SIM5218 Power Control
+ * --------------------------------------
+ * the power key comes out of an inverting switch so DATAPOWER_MCU (from MCU)
+ * is the exact opposite of the module's power key
+ */
+#define DATAPOWER_MCU_TRIS TRISG0
+#define DATAPOWER_MCU      LATG0
+
+
+/* --------------------------------------
+ * SIM5218 Startup States
+ * --------------------------------------
+ */
+#define SIM_STATE_PROBE    0  /* checking if module is already running */
+#define SIM_STATE_POWERING 1  /* holding down the power key */
+#define SIM_STATE_BOOTING  2  /* waiting for startup to finish */
+#define SIM_STATE_READY    3  /* module takes AT commands */
 
 
 /* --------------------------------------
  * SIM5218 HTTP Trial Counters
  * --------------------------------------
  */
-#define SIM_HTTP_NETREG_TRIALS 10  /* max trials for network reg during http */
-#define SIM_HTTP_RESET_TRIALS   2  /* max number of reset cycles during http */
+#define SIM_HTTP_NETREG_TRIALS 4   /* max trials for network reg during http */
+#define SIM_NETREG_BACKOFF     250 /* ms backoff after first netreg trial */
+#define SIM_NETREG_BACKOFF_MAX 1000/* longest ms backoff between trials */
+
+
+/* --------------------------------------
+ * SIM5218 Circuit Breaker
+ * --------------------------------------
+ * after SIM_BREAKER_FAILURES failed requests in a row, requests fail without
+ * being tried, and the network is probed in the background instead
+ */
+#define SIM_BREAKER_FAILURES   3   /* failed requests in a row that open it */
+#define SIM_BREAKER_BACKOFF    45  /* s to first probe (/2 > SIM_RESET_TIME) */
+#define SIM_BREAKER_BACKOFF_MAX 600/* longest s between probes             */
+
+
+/* --------------------------------------
+ * SIM5218 Health Monitor
+ * --------------------------------------
+ * signal quality is the rssi from AT+CSQ: 0 (-113dBm) to 31 (-51dBm), or 99
+ * if not known
+ */
+#define SIM_HEALTH_GOOD        0   /* registered, good signal */
+#define SIM_HEALTH_WEAK        1   /* registered, weak signal */
+#define SIM_HEALTH_DOWN        2   /* not registered, or module not answering */
+
+#define SIM_HEALTH_PERIOD      60  /* s between polls while good           */
+#define SIM_HEALTH_PERIOD_BAD  15  /* s between polls otherwise            */
+#define SIM_CSQ_UNKNOWN        99  /* rssi when signal isn't known         */
+#define SIM_CSQ_WEAK           10  /* smoothed rssi under this is weak     */
+#define SIM_CSQ_HYSTERESIS     2   /* rssi over SIM_CSQ_WEAK to be good again */
+#define SIM_HEALTH_REREG_POLLS 2   /* bad polls in a row to re-register    */
+#define SIM_HEALTH_RESET_POLLS 4   /* bad polls in a row to reset module   */
 
 
 /* --------------------------------------
@@ -65,6 +171,8 @@ typedef struct {        /* HTTP response data */
   uint32_t number2;     /* numeric 2 */
   uint8_t message[40];  /* message string */
   uint8_t boolean;      /* binary with possible values: TRUE/FALSE */
+  uint32_t date;        /* server time (epoch seconds) from the Date header */
+                        /* or response frame, or 0 if there wasn't one */
 } http_data; 
 
 
@@ -83,6 +191,20 @@ extern void SimStartTimer(unsigned int ms);
 extern void SimTimerISR(void);
 
 
+/* --------------------------------------
+ * Startup Functions
+ * --------------------------------------
+ */
+/* start bringing up the module */
+extern void SimPowerOn(void);
+
+/* carry on with a module that is already up */
+extern void SimResume(void);
+
+/* move module startup along, and get the startup state */
+extern uint8_t SimPoll(void);
+
+
 /* --------------------------------------
  * Memory Management Functions
  * --------------------------------------
@@ -107,6 +229,9 @@ extern void SimGetBuf(void);
 /* for debugging */
 extern void SimPrintBuf(void);
 
+/* get the round trip time estimate of a class of wait, for telemetry */
+extern const rtt_est *SimRtt(uint8_t cls);
+
 
 /* --------------------------------------
  * AT Commands
@@ -121,6 +246,12 @@ extern int SimNetworkReg(uint8_t *status);
 /* Set IP APN */
 extern int SimSetApn(const char *apn);
 
+/* Get signal quality */
+extern int SimSignalQuality(uint8_t *rssi);
+
+/* Get the network time */
+extern int SimClock(uint32_t *epoch);
+
 /* Launch a HTTP Operation */
 extern void SimHttpLaunch(void);
 
@@ -145,5 +276,22 @@ extern int SimHttpPost(const char *url, const char *param_str,
 /* Parse HTTP Response */
 extern int SimHttpParseResponse(http_data *http_response);
 
+/* are server requests being tried? */
+extern uint8_t SimOnline(void);
+
+/* probe the network in the background while requests fail fast */
+extern void SimProbe(void);
+
+
+/* --------------------------------------
+ * Health Monitor
+ * --------------------------------------
+ */
+/* poll the module's registration and signal quality, when it's time to */
+extern void SimHealthPoll(void);
+
+/* get the module's health */
+extern uint8_t SimHealth(void);
+
 
 #endif                                                           /* SIM5218_H */
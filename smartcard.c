@@ -11,6 +11,7 @@
  * Table of Contents:
  *  (private)
  *   CardValidate    - validate a tapped card and return it's card code.
+ *   CardSessionUpdate - check on the card session; open one for a new card
  *
  *  (public)
  *   CardInit        - initializes the card and the CardScan variables
@@ -18,6 +19,11 @@
  *   GetCard         - get smartcard details
  *   GetCardTag      - get a pointer to smartcard representation
  *
+ *   A card session lasts while a card stays in the field. DESFire cards keep
+ *   their ISO14443-4 (T=CL) session open, so each check is a cheap presence
+ *   check instead of select + RATS. The card is only re-selected when the
+ *   presence check fails, and the same card coming back is not a new tap.
+ *
  * Assumptions:
  *   Hardware Hookup defined in include file.
  *
@@ -26,6 +32,8 @@
  *     registered as a card tap.
  *   - If a card tap has been registered and not processed, and another card is
  *     tapped, the first card's info will be lost.
+ *   - A card left in the field is a single tap; it must leave the field (or
+ *     another card be tapped) to register another tap.
  *
  * Compiler:
  *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
@@ -38,21 +46,36 @@
  *   May  14, 2013      Nnoduka Eruchalu     changed CARD_USER->CARD_TAP
  *   May  15, 2013      Nnoduka Eruchalu     Add call to DataCardValidate
  *   May  25, 2013      Nnoduka Eruchalu     Remove call to DataCardValidate
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added card sessions
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Check the card denylist
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added CardRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed unused CardSessionActive
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed CardRam; diag.c takes
+ *                                           RAM from the map file
  */
 #include "general.h"
 #include <stdint.h>
 #include "smartcard.h"
 #include "mifare.h"
+#include "denylist.h"
+#include "data.h"
 #include "string.h" /* for memcmp */
 
 /* shared variables have to be local to this file */
 static uint8_t cardDetected; /* (bool) has a card tap been registered? */
 static uint8_t cardValue;    /* cardcode of last tapped card */
 static mifare_tag tag;       /* MIFARE tag holding user info */
+static uint8_t sessionOpen;  /* (bool) is tag's card in the field? */
+
+/* results of CardSessionUpdate */
+#define SESSION_NONE  0      /* no card in the field */
+#define SESSION_SAME  1      /* session's card is still in the field */
+#define SESSION_NEW   2      /* a new card is in the field */
 
 
 /* local functions that need not be public */
 static uint8_t CardValidate(mifare_tag *tag);
+static uint8_t CardSessionUpdate(void);
 
 
 /*
@@ -74,6 +97,10 @@ static uint8_t CardValidate(mifare_tag *tag);
  *                Local CardType: saved in a sector on card says "easytopup"
  *                Server CardType: Server side check of UID returns "easytopup"
  *
+ *              A card on the local denylist (or sharing a fingerprint with
+ *              one) is left to the server, and is invalid while offline.
+ *              Every other card is typed locally, with no round trip.
+ *
  *  Todo:         Actually do a check based on card values
  *  
  * Revision History:
@@ -81,6 +108,7 @@ static uint8_t CardValidate(mifare_tag *tag);
  *   May 15, 2013      Nnoduka Eruchalu     Add server side check with
  *                                          DataCardValidate()
  *   May 25, 2013      Nnoduka Eruchalu     Remove call to DataCardValidate()
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Server check for denylist hits
  */
 static uint8_t CardValidate(mifare_tag *tag)
 {
@@ -89,6 +117,9 @@ static uint8_t CardValidate(mifare_tag *tag)
   uint8_t tapcard_uid[7] =   {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
   uint8_t topupcard_uid[7] = {0x04, 0x3B, 0x11, 0x7A, 0xEC, 0x22, 0x80};
   
+  if(DenylistCheck(tag->uid))          /* maybe blocked: server decides */
+    return DataCardValidate(tag);      /* CARD_INVALID while offline */
+  
   if(memcmp(tapcard_uid, tag->uid, 7) == 0)
     card_type = CARD_TAP;
   else if (memcmp(topupcard_uid, tag->uid, 7) == 0)
@@ -100,6 +131,54 @@ static uint8_t CardValidate(mifare_tag *tag)
 }
 
 
+/*
+ * CardSessionUpdate
+ * Description: Check on the card session, and open a session for a new card.
+ *
+ * Arguments:   None
+ * Return:      SESSION_NONE: no card in the field; session closed
+ *              SESSION_SAME: the session's card is still in the field
+ *              SESSION_NEW:  a new card is in the field; session opened on it
+ *
+ * Operation:   If the session's card has a T=CL session, a presence check is
+ *              all it takes to know it is still there.
+ *              Otherwise (or if the presence check failed) select whatever
+ *              card is in the field. Nothing means the session is over. The
+ *              same UID means the card is still there, so quietly re-open its
+ *              T=CL session. A different UID is a new card: save it in tag
+ *              and open its T=CL session if it is a DESFire card.
+ *              Cards without T=CL (EasyTopup) are checked with a select each
+ *              time, as before.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t CardSessionUpdate(void)
+{
+  mifare_tag found;                  /* card currently in the field */
+  
+  if (sessionOpen && (MifarePresent(&tag) == SUCCESS))
+    return SESSION_SAME;             /* cheap check; session still open */
+  
+  MifareTagInit(&found);
+  if (MifareDetect(&found) == FAIL) {
+    sessionOpen = FALSE;             /* card left the field */
+    MifareDisconnect(&tag);
+    return SESSION_NONE;
+  }
+  
+  if (sessionOpen && (memcmp(found.uid, tag.uid, MIFARE_UID_BYTES) == 0)) {
+    MifareRats(&tag);                /* re-open T=CL session if possible */
+    return SESSION_SAME;
+  }
+  
+  memcpy(&tag, &found, sizeof(tag)); /* new card: start a session on it */
+  MifareRats(&tag);
+  sessionOpen = TRUE;
+  return SESSION_NEW;
+}
+
+
 /*
  * CardInit
  * Description: This procedure initializes the shared variables.
@@ -111,16 +190,21 @@ static uint8_t CardValidate(mifare_tag *tag)
  *              tags, by setting canScan and cardDetected to FALSE.
  *              Also the cardValue's type is set to an invalid card code.
  *              Initialize the Mifare ISR Timer to a clear state and initialize 
- *              the tag representation.
+ *              the tag representation, with no card session.
+ *              Start the reader's adaptive timeouts.
  *  
  * Revision History:
  *   May 05, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start with no card session
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Start the reader's RTT estimates
  */
 void CardInit(void)
 {
   cardDetected = FALSE;        /* no detected card tap */
+  sessionOpen = FALSE;         /* no card in the field */
   cardValue= CARD_INVALID;     /* start with an invalid card type */
   MifareStartTimer(0);         /* reset Mifare Timer */
+  MifareRttInit();             /* start reader's adaptive timeouts */
   MifareTagInit(&tag);         /* initialize tg object */
 }
 
@@ -134,16 +218,20 @@ void CardInit(void)
  *              - TRUE : A fully debounced key is available
  *              - FALSE: A fully debounced key is not available.
  *
- * Operation:   This function returns the value in cardDetected
+ * Operation:   If no tap is pending, update the card session. Only a new
+ *              card in the field counts as a tap; a card left in the field
+ *              keeps its session and isn't tapped again.
+ *              This function returns the value in cardDetected
  *
  * Revision History:
  *   May 05, 2013      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Use card session
  */
 uint8_t IsACard(void)
 {
   if (cardDetected == FALSE) {
 
-    if (MifareDetect(&tag) == SUCCESS) {
+    if (CardSessionUpdate() == SESSION_NEW) {
       cardDetected = TRUE;
     }
   }
@@ -19,6 +19,11 @@
  *   May  06, 2013      Nnoduka Eruchalu     Updated to use mifare_tag_simple
  *   May  14, 2013      Nnoduka Eruchalu     removed unused scanning functions
  *                                          changed CARD_USER->CARD_TAP
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added CardSessionActive
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added CardRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed CardSessionActive
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed CardRam; diag.c takes
+ *                                           RAM from the map file
  */
 
 #ifndef SMARTCARD_H
@@ -55,4 +60,5 @@ extern uint8_t GetCard(void);
 extern mifare_tag *GetCardTag(void);
 
 
+
 #endif                                                         /* SMARTCARD_H */
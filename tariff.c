@@ -0,0 +1,418 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             TARIFF.C                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the parking tariff engine. It prices parking locally from a
+ *   compact table of rules (zone, time window, block length, block price and
+ *   cap), so the parking time page can show the cost as the time is typed in
+ *   instead of waiting on a server quote.
+ *
+ *   The table lives in data EEPROM and is mirrored in RAM. The server keeps the
+ *   master copy and sends the terminal one changed rule at a time, each tagged
+ *   with the table version it brings the terminal up to (see DataTariffSync).
+ *
+ * Table of Contents:
+ *   (local)
+ *   RuleFromBytes    - unpack a rule from its 8 byte form
+ *   RuleToBytes      - pack a rule into its 8 byte form
+ *   RuleIsValid      - check a rule's fields are in range
+ *   RuleInWindow     - check a quarter hour is within a rule's window
+ *   FindRule         - find the rule pricing a zone at a quarter hour
+ *   HexValue         - get the value of a hex digit
+ *
+ *   (public)
+ *   TariffInit       - load the tariff table from data EEPROM
+ *   TariffVersion    - get the version of the tariff table
+ *   TariffPrice      - price parking in a zone
+ *   TariffUpdate     - apply a server update to the tariff table
+ *   TariffDecodeRule - decode a rule from its hex string form
+ *
+ * Limitations:
+ *   At most TARIFF_MAX_RULES rules. The first matching rule wins, so the
+ *   server has to order specific rules before general ones.
+ *   Prices and caps top out at N655.35.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added TariffRam for diag.c
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Only grow the table by a new rule
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed TariffRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#include "general.h"
+#include "eeprom.h"
+#include "tariff.h"
+
+
+/* EEPROM table layout: header then rules */
+#define TARIFF_FORMAT_OFS    0      /* TARIFF_FORMAT */
+#define TARIFF_COUNT_OFS     1      /* number of rules in use */
+#define TARIFF_VERSION_OFS   2      /* table version, LSB first */
+#define TARIFF_RULES_OFS     4      /* first rule */
+
+#define TARIFF_NO_RULE       TARIFF_MAX_RULES /* FindRule: use the default */
+
+
+/* shared variables have to be local to this file */
+static tariff_rule rules[TARIFF_MAX_RULES]; /* RAM copy of table */
+static uint8_t rule_count;                  /* rules in use */
+static uint16_t table_version;              /* server's version of table */
+
+
+/* local functions */
+static void RuleFromBytes(const uint8_t *bytes, tariff_rule *rule);
+static void RuleToBytes(const tariff_rule *rule, uint8_t *bytes);
+static uint8_t RuleIsValid(const tariff_rule *rule);
+static uint8_t RuleInWindow(const tariff_rule *rule, uint8_t quarter);
+static uint8_t FindRule(uint8_t zone, uint8_t quarter);
+static int HexValue(char c);
+
+
+/*
+ * RuleFromBytes
+ * Description: Unpack a rule from its 8 byte form
+ *
+ * Arguments:   bytes - TARIFF_RULE_SIZE bytes
+ *              rule  - unpacked rule [modified]
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void RuleFromBytes(const uint8_t *bytes, tariff_rule *rule)
+{
+  rule->zone  = bytes[0];
+  rule->start = bytes[1];
+  rule->end   = bytes[2];
+  rule->block = bytes[3];
+  rule->price = (uint16_t) bytes[4] | ((uint16_t) bytes[5] << 8);
+  rule->cap   = (uint16_t) bytes[6] | ((uint16_t) bytes[7] << 8);
+}
+
+
+/*
+ * RuleToBytes
+ * Description: Pack a rule into its 8 byte form
+ *
+ * Arguments:   rule  - rule to pack
+ *              bytes - TARIFF_RULE_SIZE bytes [modified]
+ * Return:      None
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static void RuleToBytes(const tariff_rule *rule, uint8_t *bytes)
+{
+  bytes[0] = rule->zone;
+  bytes[1] = rule->start;
+  bytes[2] = rule->end;
+  bytes[3] = rule->block;
+  bytes[4] = (uint8_t) rule->price;
+  bytes[5] = (uint8_t) (rule->price >> 8);
+  bytes[6] = (uint8_t) rule->cap;
+  bytes[7] = (uint8_t) (rule->cap >> 8);
+}
+
+
+/*
+ * RuleIsValid
+ * Description: Check a rule's fields are in range
+ *
+ * Arguments:   rule - rule to check
+ * Return:      TRUE if the rule can be used, FALSE otherwise
+ *
+ * Operation:   Blocks must be at least a minute long, and the window must lie
+ *              within a day.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t RuleIsValid(const tariff_rule *rule)
+{
+  return ((rule->block != 0) && (rule->start < TARIFF_DAY_QUARTERS) &&
+          (rule->end <= TARIFF_DAY_QUARTERS));
+}
+
+
+/*
+ * RuleInWindow
+ * Description: Check a quarter hour is within a rule's time window
+ *
+ * Arguments:   rule    - rule to check
+ *              quarter - quarter hours since midnight
+ * Return:      TRUE if in the window, FALSE otherwise
+ *
+ * Operation:   A window with start == end is all day. One with end < start
+ *              wraps past midnight.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t RuleInWindow(const tariff_rule *rule, uint8_t quarter)
+{
+  if (rule->start == rule->end)                 /* all day */
+    return TRUE;
+  else if (rule->start < rule->end)             /* within a day */
+    return ((quarter >= rule->start) && (quarter < rule->end));
+  else                                          /* wraps past midnight */
+    return ((quarter >= rule->start) || (quarter < rule->end));
+}
+
+
+/*
+ * FindRule
+ * Description: Find the rule pricing a zone at a quarter hour
+ *
+ * Arguments:   zone    - parking zone
+ *              quarter - quarter hours since midnight
+ * Return:      index of first matching rule, or TARIFF_NO_RULE
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static uint8_t FindRule(uint8_t zone, uint8_t quarter)
+{
+  uint8_t i;
+
+  for (i = 0; i < rule_count; i++) {
+    if (((rules[i].zone == zone) || (rules[i].zone == TARIFF_ANY_ZONE)) &&
+        RuleInWindow(&rules[i], quarter))
+      return i;
+  }
+
+  return TARIFF_NO_RULE;
+}
+
+
+/*
+ * HexValue
+ * Description: Get the value of a hex digit
+ *
+ * Arguments:   c - hex digit, upper or lower case
+ * Return:      0 to 15, or FAIL if c isn't a hex digit
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+static int HexValue(char c)
+{
+  if ((c >= '0') && (c <= '9')) return c - '0';
+  if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+  if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+  return FAIL;
+}
+
+
+/*
+ * TariffInit
+ * Description: Load the tariff table from data EEPROM
+ *
+ * Arguments:   None
+ * Return:      None
+ *
+ * Operation:   A header in an unknown format (like a never written EEPROM)
+ *              means an empty table at version 0, so every price comes from
+ *              the default tariff until the first sync.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+void TariffInit(void)
+{
+  uint8_t header[TARIFF_RULES_OFS];
+  uint8_t bytes[TARIFF_RULE_SIZE];
+  uint8_t i;
+
+  EepromRead(EEPROM_TARIFF_ADDR, header, sizeof(header));
+
+  rule_count = 0;
+  table_version = 0;
+  if ((header[TARIFF_FORMAT_OFS] != TARIFF_FORMAT) ||
+      (header[TARIFF_COUNT_OFS] > TARIFF_MAX_RULES))
+    return;
+
+  rule_count = header[TARIFF_COUNT_OFS];
+  table_version = (uint16_t) header[TARIFF_VERSION_OFS] |
+    ((uint16_t) header[TARIFF_VERSION_OFS+1] << 8);
+
+  for (i = 0; i < rule_count; i++) {
+    EepromRead(EEPROM_TARIFF_ADDR + TARIFF_RULES_OFS + i*TARIFF_RULE_SIZE,
+               bytes, TARIFF_RULE_SIZE);
+    RuleFromBytes(bytes, &rules[i]);
+  }
+}
+
+
+/*
+ * TariffVersion
+ * Description: Get the version of the tariff table
+ *
+ * Arguments:   None
+ * Return:      server's version number of the loaded table, 0 if empty
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint16_t TariffVersion(void)
+{
+  return table_version;
+}
+
+
+/*
+ * TariffPrice
+ * Description: Price parking in a zone
+ *
+ * Arguments:   zone    - parking zone
+ *              start   - time parking starts (in minutes since midnight)
+ *              minutes - parking duration (in minutes)
+ * Return:      price (in kobo)
+ *
+ * Operation:   Walk the duration a block at a time. Each block is priced by
+ *              the rule in effect when it starts, so parking across a window
+ *              boundary picks up the next window's tariff. A started block is
+ *              paid in full. Blocks charged under the same rule in a row add up
+ *              to at most that rule's cap.
+ *              Blocks no rule covers use the default tariff.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+uint32_t TariffPrice(uint8_t zone, uint16_t start, uint16_t minutes)
+{
+  uint32_t total = 0;            /* price so far */
+  uint32_t window_total = 0;     /* charged under current rule */
+  uint8_t curr = TARIFF_NO_RULE; /* rule charging the previous block */
+  uint8_t i;
+  uint16_t block, price, cap;
+
+  start %= 24*60;
+  while (minutes > 0) {
+    i = FindRule(zone, (uint8_t) (start/15));
+    if (i == TARIFF_NO_RULE) {
+      block = TARIFF_DEFAULT_BLOCK;
+      price = TARIFF_DEFAULT_PRICE;
+      cap = 0;
+    } else {
+      block = rules[i].block;
+      price = rules[i].price;
+      cap = rules[i].cap;
+    }
+
+    if (i != curr) {             /* new window, so new cap */
+      curr = i;
+      window_total = 0;
+    }
+
+    if ((cap != 0) && (window_total + price > cap))
+      price = (uint16_t) (cap - window_total);
+    window_total += price;
+    total += price;
+
+    minutes -= MIN(block, minutes);
+    start = (start + block) % (24*60);
+  }
+
+  return total;
+}
+
+
+/*
+ * TariffUpdate
+ * Description: Apply a server update to the tariff table
+ *
+ * Arguments:   index   - index of rule to replace
+ *              count   - number of rules in the updated table
+ *              version - table version after this update
+ *              rule    - new rule at index, or NULL to only change the count
+ *                        (dropping rules off the end) and version
+ * Return:      SUCCESS: table updated, in RAM and EEPROM
+ *              FAIL:    update out of range, or it grows the table by other
+ *                       than the new rule; nothing changed
+ *
+ * Operation:   Write the rule before the header so an update cut short by a
+ *              reset leaves the old version in place, and the server sends it
+ *              again on the next sync.
+ *              Slots past the end of the table still hold rules that were
+ *              dropped, so the table only grows by one rule at a time, with
+ *              that rule written into the new slot. Raising the count any
+ *              other way would bring a stale rule back into use.
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Only grow the table by a new rule
+ */
+int TariffUpdate(uint8_t index, uint8_t count, uint16_t version,
+                 const tariff_rule *rule)
+{
+  uint8_t header[TARIFF_RULES_OFS];
+  uint8_t bytes[TARIFF_RULE_SIZE];
+
+  if ((count > TARIFF_MAX_RULES) ||
+      ((rule != NULL) && ((index >= TARIFF_MAX_RULES) || !RuleIsValid(rule))))
+    return FAIL;
+  if ((count > rule_count) &&
+      ((rule == NULL) || (index != rule_count) || (count != rule_count + 1)))
+    return FAIL;                        /* would revive a stale rule */
+
+  if (rule != NULL) {
+    RuleToBytes(rule, bytes);
+    EepromWrite(EEPROM_TARIFF_ADDR + TARIFF_RULES_OFS + index*TARIFF_RULE_SIZE,
+                bytes, TARIFF_RULE_SIZE);
+    rules[index] = *rule;
+  }
+
+  header[TARIFF_FORMAT_OFS] = TARIFF_FORMAT;
+  header[TARIFF_COUNT_OFS] = count;
+  header[TARIFF_VERSION_OFS] = (uint8_t) version;
+  header[TARIFF_VERSION_OFS+1] = (uint8_t) (version >> 8);
+  EepromWrite(EEPROM_TARIFF_ADDR, header, sizeof(header));
+  rule_count = count;
+  table_version = version;
+
+  return SUCCESS;
+}
+
+
+/*
+ * TariffDecodeRule
+ * Description: Decode a rule from its hex string form
+ *
+ * Arguments:   hex  - TARIFF_RULE_HEX hex digits of the rule's 8 byte form,
+ *                     NULL-terminated
+ *              rule - decoded rule [modified]
+ * Return:      SUCCESS: rule decoded and valid
+ *              FAIL:    wrong length, bad digit or invalid rule
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+int TariffDecodeRule(const char *hex, tariff_rule *rule)
+{
+  uint8_t bytes[TARIFF_RULE_SIZE];
+  int hi, lo;
+  uint8_t i;
+
+  for (i = 0; i < TARIFF_RULE_SIZE; i++) {
+    if ((hex[0] == '\0') || (hex[1] == '\0'))     /* too short */
+      return FAIL;
+    hi = HexValue(hex[0]);
+    lo = HexValue(hex[1]);
+    if ((hi < 0) || (lo < 0))
+      return FAIL;
+    bytes[i] = (uint8_t) ((hi << 4) | lo);
+    hex += 2;
+  }
+  if (*hex != '\0')                                /* too long */
+    return FAIL;
+
+  RuleFromBytes(bytes, rule);
+  return (RuleIsValid(rule) ? SUCCESS : FAIL);
+}
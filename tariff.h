@@ -0,0 +1,91 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             TARIFF.H                              -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *   This is the header file for tariff.c, the parking tariff engine.
+ *
+ * Assumptions:
+ *   None.
+ *
+ * Compiler:
+ *   HI-TECH C Compiler for PIC18 MCUs (http://www.htsoft.com/)
+ *
+ * Revision History:
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Added TariffRam
+ *   Oct. 17, 2026      Nnoduka Eruchalu     Removed TariffRam; diag.c takes
+ *                                           RAM from the map file
+ */
+
+#ifndef TARIFF_H
+#define TARIFF_H
+
+/* library include files */
+#include <stdint.h>     /* for uint*_t */
+
+
+/* --------------------------------------
+ * TARIFF CONSTANTS
+ * --------------------------------------
+ */
+#define TARIFF_ZONE          1      /* parking zone this terminal serves */
+#define TARIFF_ANY_ZONE      0xFF   /* rule zone that matches every zone */
+
+#define TARIFF_MAX_RULES     16     /* rules kept in data EEPROM */
+#define TARIFF_FORMAT        1      /* EEPROM table format written by code */
+#define TARIFF_RULE_SIZE     8      /* bytes of a rule in EEPROM/on the wire */
+#define TARIFF_RULE_HEX      (2*TARIFF_RULE_SIZE) /* hex digits of a rule */
+
+#define TARIFF_DAY_QUARTERS  96     /* quarter hours in a day */
+
+/* tariff charged when no rule matches: N10.00 per 30 minutes */
+#define TARIFF_DEFAULT_BLOCK 30     /* in minutes */
+#define TARIFF_DEFAULT_PRICE 1000   /* in kobo */
+
+
+/* --------------------------------------
+ * TARIFF DATA OBJECTS
+ * --------------------------------------
+ */
+/*
+ * A rule prices parking that starts within its time window. Windows are in
+ * quarter hours since midnight, [start, end), and wrap past midnight when
+ * end < start. start == end is all day.
+ * Rules are stored and sent over the wire as 8 bytes, multi-byte fields LSB
+ * first: zone, start, end, block, price (2), cap (2)
+ */
+typedef struct {
+  uint8_t zone;       /* zone the rule applies to, or TARIFF_ANY_ZONE */
+  uint8_t start;      /* window start (in quarter hours) */
+  uint8_t end;        /* window end, exclusive (in quarter hours) */
+  uint8_t block;      /* block length, a started block is paid in full (mins) */
+  uint16_t price;     /* price of a block (in kobo) */
+  uint16_t cap;       /* max charged per window in a session, 0 for none */
+} tariff_rule;
+
+
+/* --------------------------------------
+ * FUNCTION PROTOTYPES
+ * --------------------------------------
+ */
+/* load the tariff table from data EEPROM */
+extern void TariffInit(void);
+
+/* get the version of the tariff table */
+extern uint16_t TariffVersion(void);
+
+/* price parking in a zone (in kobo) */
+extern uint32_t TariffPrice(uint8_t zone, uint16_t start, uint16_t minutes);
+
+/* apply a server update to the tariff table */
+extern int TariffUpdate(uint8_t index, uint8_t count, uint16_t version,
+                        const tariff_rule *rule);
+
+/* decode a rule from its hex string form */
+extern int TariffDecodeRule(const char *hex, tariff_rule *rule);
+
+
+#endif                                                            /* TARIFF_H */
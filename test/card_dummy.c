@@ -0,0 +1,111 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                           CARD_DUMMY.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A fake SL032 reader with a DESFire card in its field, on the other end of
+ *  serial_dummy.c. Use this for unix based tests of mifare/mifare.c.
+ *
+ *  The card answers each T=CL command with the next reply a test queued, and
+ *  keeps the commands it got so the test can check what was sent. With no
+ *  reply queued it stays quiet and the Mifare timer runs down, so the
+ *  command times out rather than hanging the test.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../serial.h"
+#include "../mifare/mifare.h"
+#include "serial_dummy.h"
+#include "card_dummy.h"
+
+/* shared variables have to be local to this file */
+static uint8_t replies[CARD_DUMMY_FRAMES][CARD_DUMMY_FRAME_SIZE];
+static size_t replySize[CARD_DUMMY_FRAMES];
+static uint8_t repliesQueued;        /* replies queued by the test */
+static uint8_t repliesSent;          /* replies sent to the reader */
+static uint8_t commands[CARD_DUMMY_FRAMES][CARD_DUMMY_FRAME_SIZE];
+static size_t commandSize[CARD_DUMMY_FRAMES];
+static uint8_t commandCount;         /* commands received */
+
+
+/* take a frame the reader sent, and answer it */
+static void CardDummyPoll(void)
+{
+  uint8_t frame[CARD_DUMMY_FRAME_SIZE + 5];  /* + SL032 bytes */
+  size_t n = 0, i;
+  uint8_t checksum;
+  
+  if (!SerialDummyTxRdy()) {         /* nothing to answer: time passes */
+    MifareTimerISR();
+    return;
+  }
+  
+  /* 0xBA, Len, 0x21, T=CL command, Checksum; Len counts from 0x21 on */
+  while (SerialDummyTxRdy() && (n < sizeof(frame)) &&
+         ((n < 2) || (n < (size_t) frame[1] + 2)))
+    frame[n++] = SerialDummyTxGet();
+  
+  if ((n >= 4) && (commandCount < CARD_DUMMY_FRAMES)) {
+    commandSize[commandCount] = n - 4;
+    memcpy(commands[commandCount], &frame[3], n - 4);
+    commandCount++;
+  }
+  
+  if (repliesSent == repliesQueued)  /* card says nothing */
+    return;
+  
+  /* 0xBD, Len, 0x21, SL032 status, DESFire status and data, Checksum */
+  n = replySize[repliesSent];
+  frame[0] = 0xBD;
+  frame[1] = (uint8_t) (n + 3);
+  frame[2] = SL_TCL;
+  frame[3] = SL_OPERATION_SUCC;
+  memcpy(&frame[4], replies[repliesSent], n);
+  repliesSent++;
+  
+  checksum = 0;
+  for (i = 0; i < n + 4; i++) {
+    checksum ^= frame[i];
+    SerialDummyRxPut(frame[i]);
+  }
+  SerialDummyRxPut(checksum);
+}
+
+
+void CardDummyInit(void)
+{
+  SerialInit();                      /* drop bytes of earlier exchanges */
+  SerialDummyHook(CardDummyPoll);
+  repliesQueued = 0;
+  repliesSent = 0;
+  commandCount = 0;
+}
+
+
+void CardDummyReply(const uint8_t reply[], size_t n)
+{
+  if ((repliesQueued < CARD_DUMMY_FRAMES) && (n <= CARD_DUMMY_FRAME_SIZE)) {
+    memcpy(replies[repliesQueued], reply, n);
+    replySize[repliesQueued] = n;
+    repliesQueued++;
+  }
+}
+
+
+uint8_t CardDummyCommands(void)
+{
+  return commandCount;
+}
+
+
+const uint8_t *CardDummyCommand(uint8_t i, size_t *n)
+{
+  *n = commandSize[i];
+  return commands[i];
+}
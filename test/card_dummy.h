@@ -0,0 +1,38 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                           CARD_DUMMY.H                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the header file for card_dummy.c, a fake SL032 reader with a
+ *  DESFire card in its field.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+#ifndef CARD_DUMMY_H
+#define CARD_DUMMY_H
+
+/* library includes */
+#include <stddef.h>
+#include <stdint.h>
+
+/* CARD_DUMMY CONSTANTS */
+#define CARD_DUMMY_FRAMES      16     /* replies queued/commands kept */
+#define CARD_DUMMY_FRAME_SIZE  60     /* max bytes of a reply/command */
+
+/* FUNCTION PROTOTYPES */
+/* put the card in the field, with no replies queued or commands received */
+extern void CardDummyInit(void);
+
+/* queue the card's reply, status byte first, to its next command */
+extern void CardDummyReply(const uint8_t reply[], size_t n);
+
+/* get the number of T=CL commands the card received */
+extern uint8_t CardDummyCommands(void);
+
+/* get a T=CL command the card received */
+extern const uint8_t *CardDummyCommand(uint8_t i, size_t *n);
+
+#endif                                                        /* CARD_DUMMY_H */
@@ -0,0 +1,44 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          EEPROM_DUMMY.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  A version of eeprom.c that doesn't depend on hardware. Use this for unix
+ *  based tests
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../eeprom.h"
+
+/* shared variables have to be local to this file */
+static uint8_t eeprom[EEPROM_SIZE];  /* "data EEPROM" */
+static uint8_t erased = FALSE;       /* has eeprom been put in erased state? */
+
+
+static void EepromErase(void)
+{
+  if(!erased) {                      /* a new part comes erased */
+    memset(eeprom, EEPROM_ERASED, sizeof(eeprom));
+    erased = TRUE;
+  }
+}
+
+
+void EepromRead(uint16_t addr, void *data, size_t size)
+{
+  EepromErase();
+  memcpy(data, &eeprom[addr], size);
+}
+
+
+void EepromWrite(uint16_t addr, const void *data, size_t size)
+{
+  EepromErase();
+  memcpy(&eeprom[addr], data, size);
+}
@@ -8,18 +8,25 @@
  *  A version of serial.c that doesn't depend on hardware. Use this for unix
  *  based tests
  *
+ *  A test can play the device at the other end of the channel: it takes what
+ *  was sent with SerialDummyTxGet, and answers with SerialDummyRxPut from a
+ *  hook that's called whenever the code polls an empty Rx queue.
+ *
  * Revision History:
  *  Jan. 20, 2013      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Added a hook for fake devices
  */
 
 #include "../general.h"
 #include "../queue.h"
 #include "../serial.h"
+#include "serial_dummy.h"
 
 /* shared variables have to be local to this file */
 static queue serialRxQueue; /* queue holding serially RX'd data */
 static queue serialTxQueue; /* queue holding data to be serially TX'd*/
 static unsigned char serialErrors;   /* byte holding serial channel errors */
+static void (*rxHook)(void);         /* fake device polled for Rx data */
 
 
 void SerialInit(void)
@@ -32,6 +39,8 @@ void SerialInit(void)
 
 unsigned char SerialInRdy(void)
 {
+  if (QueueEmpty(&serialRxQueue) && rxHook)
+    rxHook();                        /* let the fake device answer */
   return (!QueueEmpty(&serialRxQueue)); /* there's a byte in non-empty queue */
 }
 
@@ -121,3 +130,27 @@ void SerialTxISR(void)
     txval = Dequeue(&serialTxQueue);/* dequeued, and the obtained byte should */
   }
 }
+
+
+void SerialDummyHook(void (*hook)(void))
+{
+  rxHook = hook;
+}
+
+
+unsigned char SerialDummyTxRdy(void)
+{
+  return (!QueueEmpty(&serialTxQueue));
+}
+
+
+unsigned char SerialDummyTxGet(void)
+{
+  return Dequeue(&serialTxQueue);
+}
+
+
+void SerialDummyRxPut(unsigned char b)
+{
+  Enqueue(&serialRxQueue, b);
+}
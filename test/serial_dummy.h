@@ -0,0 +1,30 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          SERIAL_DUMMY.H                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the header file for the parts of serial_dummy.c that let a test
+ *  play the device at the other end of the serial channel.
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+#ifndef SERIAL_DUMMY_H
+#define SERIAL_DUMMY_H
+
+/* FUNCTION PROTOTYPES */
+/* set the function called when the Rx queue is polled while empty */
+extern void SerialDummyHook(void (*hook)(void));
+
+/* is there a byte sent out? */
+extern unsigned char SerialDummyTxRdy(void);
+
+/* get a byte sent out */
+extern unsigned char SerialDummyTxGet(void);
+
+/* receive a byte */
+extern void SerialDummyRxPut(unsigned char b);
+
+#endif                                                      /* SERIAL_DUMMY_H */
@@ -0,0 +1,77 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                             TEST_AT.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for at.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../at.h"
+#include "test_general.h"
+
+
+/* does a reply string end in a final result code? */
+static uint8_t final(const char *reply)
+{
+  return AtFinal((const unsigned char *) reply, (uint16_t) strlen(reply));
+}
+
+
+void test_at(void)
+{
+  unsigned char buf[64];
+  uint16_t len;
+
+  /* final result codes */
+  assert_equal_bool(TRUE, final("\r\nOK\r\n"), "AT: OK");
+  assert_equal_bool(TRUE, final("\r\nERROR\r\n"), "AT: ERROR");
+  assert_equal_bool(TRUE, final("\r\n+CME ERROR: 30\r\n"), "AT: +CME ERROR");
+  assert_equal_bool(TRUE, final("\r\n+CMS ERROR: 500\r\n"), "AT: +CMS ERROR");
+  assert_equal_bool(TRUE, final("\r\n+CREG: 0,1\r\n\r\nOK\r\n"),
+                    "AT: information then OK");
+  assert_equal_bool(TRUE, final("AT\r\r\nOK\r\n"), "AT: echo then OK");
+  assert_equal_bool(TRUE, final("\r\nOK\r"), "AT: OK with only <CR>");
+
+  /* not (yet) final */
+  assert_equal_bool(FALSE, final(""), "AT: nothing");
+  assert_equal_bool(FALSE, final("\r\n"), "AT: empty line");
+  assert_equal_bool(FALSE, final("\r\nO"), "AT: partial OK");
+  assert_equal_bool(FALSE, final("\r\nOK"), "AT: OK without line end");
+  assert_equal_bool(FALSE, final("\r\n+CREG: 0,1\r\n"), "AT: information");
+  assert_equal_bool(FALSE, final("\r\nOKAY\r\n"), "AT: not OK");
+  assert_equal_bool(FALSE, final("\r\nNO ERROR\r\n"), "AT: not ERROR");
+  assert_equal_bool(FALSE, final("\r\n+IP ERROR: Network is already opened"
+                                 "\r\n"), "AT: +IP ERROR isn't final");
+  assert_equal_bool(FALSE, final("\r\nOK\r\n\r\n+CSQ: 9,99\r\n"),
+                    "AT: OK then more");
+
+  /* a slow final result, arriving in chunks seconds apart (AT+COPS=0) */
+  len = 0;
+  memcpy(&buf[len], "\r\n+COPS: 0", 10); len += 10;
+  assert_equal_bool(FALSE, AtFinal(buf, len), "AT: delayed final, chunk 1");
+  memcpy(&buf[len], "\r\n", 2); len += 2;
+  assert_equal_bool(FALSE, AtFinal(buf, len), "AT: delayed final, chunk 2");
+  memcpy(&buf[len], "\r\nO", 3); len += 3;
+  assert_equal_bool(FALSE, AtFinal(buf, len), "AT: delayed final, chunk 3");
+  memcpy(&buf[len], "K\r", 2); len += 2;
+  assert_equal_bool(TRUE, AtFinal(buf, len), "AT: delayed final, chunk 4");
+  memcpy(&buf[len], "\n", 1); len += 1;
+  assert_equal_bool(TRUE, AtFinal(buf, len), "AT: delayed final, chunk 5");
+
+  /* a slow error, e.g. AT+NETCLOSE with no network */
+  len = 0;
+  memcpy(&buf[len], "\r\n", 2); len += 2;
+  assert_equal_bool(FALSE, AtFinal(buf, len), "AT: delayed error, start");
+  memcpy(&buf[len], "\r\n+CME ERROR: 3\r\n", 17); len += 17;
+  assert_equal_bool(TRUE, AtFinal(buf, len), "AT: delayed error, end");
+}
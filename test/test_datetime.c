@@ -0,0 +1,123 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         TEST_DATETIME.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for datetime.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../datetime.h"
+#include "test_general.h"
+
+
+static void check_round_trip(uint32_t epoch, uint8_t year, uint8_t month,
+                             uint8_t day, uint8_t weekday, const char *msg)
+{
+  datetime dt;
+
+  assert_equal_int(SUCCESS, DateTimeFromEpoch(epoch, &dt), msg);
+  assert_equal_int(year, dt.year, msg);
+  assert_equal_int(month, dt.month, msg);
+  assert_equal_int(day, dt.day, msg);
+  assert_equal_int(weekday, dt.weekday, msg);
+  assert_equal_int(TRUE, DateTimeValid(&dt), msg);
+  assert_equal_int(epoch, DateTimeToEpoch(&dt), msg);
+}
+
+
+static void test_datetime_epoch(void)
+{
+  datetime dt;
+
+  check_round_trip(DATETIME_EPOCH_2000, 0, 1, 1, 6, "DATETIME: 2000");
+  check_round_trip(DATETIME_EPOCH_MIN, 26, 1, 1, 4, "DATETIME: 2026");
+  check_round_trip(1792240496UL, 26, 10, 17, 6, "DATETIME: today");
+  check_round_trip(1835395200UL, 28, 2, 29, 2, "DATETIME: leap day");
+  check_round_trip(1803859200UL, 27, 3, 1, 1, "DATETIME: after Feb");
+  check_round_trip(4102444799UL, 99, 12, 31, 4, "DATETIME: last second");
+
+  DateTimeFromEpoch(1792240496UL, &dt);
+  assert_equal_int(12, dt.hour, "DATETIME: hour");
+  assert_equal_int(34, dt.minute, "DATETIME: minute");
+  assert_equal_int(56, dt.second, "DATETIME: second");
+
+  assert_equal_int(FAIL, DateTimeFromEpoch(DATETIME_EPOCH_2000-1, &dt),
+                   "DATETIME: before 2000");
+  assert_equal_int(FAIL, DateTimeFromEpoch(4102444800UL, &dt),
+                   "DATETIME: after 2099");
+
+  dt.year = 27; dt.month = 2; dt.day = 29;
+  dt.hour = 0; dt.minute = 0; dt.second = 0;
+  assert_equal_int(FALSE, DateTimeValid(&dt), "DATETIME: not a leap year");
+  dt.month = 13; dt.day = 1;
+  assert_equal_int(FALSE, DateTimeValid(&dt), "DATETIME: month 13");
+  dt.month = 4; dt.day = 31;
+  assert_equal_int(FALSE, DateTimeValid(&dt), "DATETIME: April 31");
+  dt.day = 30; dt.second = 60;
+  assert_equal_int(FALSE, DateTimeValid(&dt), "DATETIME: leap second");
+}
+
+
+static void test_datetime_parse(void)
+{
+  uint32_t epoch = 0;
+
+  assert_equal_int(SUCCESS,
+                   DateTimeParseHttp("Sat, 17 Oct 2026 12:34:56 GMT", &epoch),
+                   "DATETIME: http");
+  assert_equal_int(1792240496UL, epoch, "DATETIME: http epoch");
+  epoch = 0;
+  assert_equal_int(SUCCESS,
+                   DateTimeParseHttp("sat, 17 oct 2026 12:34:56 gmt\r\n",
+                                     &epoch),
+                   "DATETIME: http lower case");
+  assert_equal_int(1792240496UL, epoch, "DATETIME: http lower case epoch");
+  assert_equal_int(FAIL, DateTimeParseHttp("Sat, 17 Oct 2026 12:34", &epoch),
+                   "DATETIME: http short");
+  assert_equal_int(FAIL,
+                   DateTimeParseHttp("Sat, 17 Okt 2026 12:34:56 GMT", &epoch),
+                   "DATETIME: http bad month");
+  assert_equal_int(FAIL,
+                   DateTimeParseHttp("Sat, 31 Sep 2026 12:34:56 GMT", &epoch),
+                   "DATETIME: http bad day");
+  assert_equal_int(FAIL,
+                   DateTimeParseHttp("Sun, 06 Nov 1994 08:49:37 GMT", &epoch),
+                   "DATETIME: http too old");
+  assert_equal_int(FAIL,
+                   DateTimeParseHttp("Saturday, 17-Oct-26 12:34:56 GMT",
+                                     &epoch),
+                   "DATETIME: http obsolete format");
+
+  epoch = 0;
+  assert_equal_int(SUCCESS, DateTimeParseCclk("26/10/17,12:34:56+00", &epoch),
+                   "DATETIME: cclk");
+  assert_equal_int(1792240496UL, epoch, "DATETIME: cclk epoch");
+  assert_equal_int(SUCCESS, DateTimeParseCclk("26/10/17,13:34:56+04", &epoch),
+                   "DATETIME: cclk ahead of UTC");
+  assert_equal_int(1792240496UL, epoch, "DATETIME: cclk ahead epoch");
+  assert_equal_int(SUCCESS, DateTimeParseCclk("26/10/17,07:34:56-20", &epoch),
+                   "DATETIME: cclk behind UTC");
+  assert_equal_int(1792240496UL, epoch, "DATETIME: cclk behind epoch");
+  assert_equal_int(FAIL, DateTimeParseCclk("04/01/01,00:00:29+00", &epoch),
+                   "DATETIME: cclk power on default");
+  assert_equal_int(FAIL, DateTimeParseCclk("26/10/17,12:34:56", &epoch),
+                   "DATETIME: cclk no zone");
+  assert_equal_int(FAIL, DateTimeParseCclk("26/10/17 12:34:56+00", &epoch),
+                   "DATETIME: cclk bad separator");
+}
+
+
+void test_datetime(void)
+{
+  test_datetime_epoch();
+  test_datetime_parse();
+}
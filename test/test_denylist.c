@@ -0,0 +1,138 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         TEST_DENYLIST.C                           -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for denylist.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../denylist.h"
+#include "test_general.h"
+
+
+void test_denylist(void)
+{
+  uint8_t tap[DENYLIST_UID_BYTES] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  uint8_t topup[DENYLIST_UID_BYTES] = {0x04, 0x3B, 0x11, 0x7A, 0xEC, 0x22,
+                                       0x80};
+  uint8_t uid[DENYLIST_UID_BYTES];
+  uint8_t i;
+
+  /* never synced: nothing blocked */
+  DenylistInit();
+  assert_equal_int(0, DenylistVersion(), "DENYLIST: empty list version");
+  assert_equal_int(0, DenylistCount(), "DENYLIST: empty list count");
+  assert_equal_int(FALSE, DenylistCheck(tap), "DENYLIST: empty list hit");
+
+  /* fingerprints are FNV-1a, which the server computes too */
+  assert_equal_int(0xD3EEC27EUL, DenylistHash(tap), "DENYLIST: hash");
+
+  /* UID decoding */
+  assert_equal_int(SUCCESS, DenylistDecodeUid("04537aEC228000", uid),
+                   "DENYLIST: decode failed");
+  assert_equal_int(0x7A, uid[2], "DENYLIST: decoded byte");
+  assert_equal_int(FAIL, DenylistDecodeUid("04537AEC2280", uid),
+                   "DENYLIST: decoded short UID");
+  assert_equal_int(FAIL, DenylistDecodeUid("04537AEC22800000", uid),
+                   "DENYLIST: decoded long UID");
+  assert_equal_int(FAIL, DenylistDecodeUid("04537AEC2280G0", uid),
+                   "DENYLIST: decoded bad digit");
+
+  /* block and unblock */
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_ADD, 1, tap),
+                   "DENYLIST: add failed");
+  assert_equal_int(TRUE, DenylistCheck(tap), "DENYLIST: blocked card missed");
+  assert_equal_int(FALSE, DenylistCheck(topup), "DENYLIST: other card hit");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_ADD, 2, tap),
+                   "DENYLIST: re-add failed");
+  assert_equal_int(1, DenylistCount(), "DENYLIST: re-add duplicated");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_ADD, 3, topup),
+                   "DENYLIST: second add failed");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_REMOVE, 4, tap),
+                   "DENYLIST: remove failed");
+  assert_equal_int(FALSE, DenylistCheck(tap), "DENYLIST: unblocked card hit");
+  assert_equal_int(TRUE, DenylistCheck(topup),
+                   "DENYLIST: moved entry missed");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_REMOVE, 5, tap),
+                   "DENYLIST: removing missing card failed");
+  assert_equal_int(1, DenylistCount(), "DENYLIST: count after removes");
+  assert_equal_int(5, DenylistVersion(), "DENYLIST: version");
+  assert_equal_int(FALSE, DenylistIncomplete(), "DENYLIST: complete");
+
+  /* list survives a reboot */
+  DenylistInit();
+  assert_equal_int(5, DenylistVersion(), "DENYLIST: version after reboot");
+  assert_equal_int(TRUE, DenylistCheck(topup),
+                   "DENYLIST: blocked card after reboot");
+  assert_equal_int(FALSE, DenylistCheck(tap),
+                   "DENYLIST: unblocked card after reboot");
+
+  /* full list */
+  for (i = 0; DenylistCount() < DENYLIST_MAX; i++) {
+    uid[0] = i;
+    if (DenylistUpdate(DENYLIST_OP_ADD, 6, uid) < 0)
+      break;
+  }
+  assert_equal_int(DENYLIST_MAX, DenylistCount(), "DENYLIST: filled");
+  assert_equal_int(FALSE, DenylistIncomplete(), "DENYLIST: full, complete");
+  assert_equal_int(FALSE, DenylistCheck(tap), "DENYLIST: full list hit");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_ADD, 7, topup),
+                   "DENYLIST: re-add to full list failed");
+
+  /* overflow: skipped, but the version moves on and the list fails closed */
+  uid[0] = 0xFF;
+  assert_equal_int(FAIL, DenylistUpdate(DENYLIST_OP_ADD, 8, uid),
+                   "DENYLIST: added to full list");
+  assert_equal_int(8, DenylistVersion(), "DENYLIST: version after overflow");
+  assert_equal_int(DENYLIST_MAX, DenylistCount(), "DENYLIST: overflowed");
+  assert_equal_int(TRUE, DenylistIncomplete(), "DENYLIST: overflow missed");
+  assert_equal_int(TRUE, DenylistCheck(uid), "DENYLIST: overflowed card");
+  assert_equal_int(TRUE, DenylistCheck(tap), "DENYLIST: not failing closed");
+  uid[0] = 0;
+  assert_equal_int(TRUE, DenylistCheck(uid), "DENYLIST: first of full list");
+  assert_equal_int(TRUE, DenylistCheck(topup), "DENYLIST: kept in full list");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_REMOVE, 9, uid),
+                   "DENYLIST: remove from overflowed list failed");
+  assert_equal_int(TRUE, DenylistIncomplete(),
+                   "DENYLIST: remove completed overflowed list");
+  DenylistInit();
+  assert_equal_int(9, DenylistVersion(), "DENYLIST: version after reboot");
+  assert_equal_int(TRUE, DenylistIncomplete(),
+                   "DENYLIST: overflow lost on reboot");
+
+  /* full resync */
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_CLEAR, 10, NULL),
+                   "DENYLIST: clear failed");
+  assert_equal_int(0, DenylistCount(), "DENYLIST: count after clear");
+  assert_equal_int(FALSE, DenylistIncomplete(), "DENYLIST: clear left flag");
+  assert_equal_int(FALSE, DenylistCheck(topup), "DENYLIST: hit after clear");
+  DenylistInit();
+  assert_equal_int(10, DenylistVersion(), "DENYLIST: version after clear");
+  assert_equal_int(0, DenylistCount(), "DENYLIST: cleared after reboot");
+
+  /* bad records: skipped, only a maybe-lost add fails closed */
+  assert_equal_int(FAIL, DenylistUpdate(DENYLIST_OP_REMOVE, 11, NULL),
+                   "DENYLIST: removed bad UID");
+  assert_equal_int(11, DenylistVersion(), "DENYLIST: version after bad remove");
+  assert_equal_int(FALSE, DenylistIncomplete(), "DENYLIST: bad remove");
+  assert_equal_int(FAIL, DenylistUpdate(DENYLIST_OP_ADD, 12, NULL),
+                   "DENYLIST: added bad UID");
+  assert_equal_int(12, DenylistVersion(), "DENYLIST: version after bad add");
+  assert_equal_int(TRUE, DenylistIncomplete(), "DENYLIST: bad add");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_CLEAR, 13, NULL),
+                   "DENYLIST: clear after bad add failed");
+  assert_equal_int(FAIL, DenylistUpdate(9, 14, tap), "DENYLIST: bad op");
+  assert_equal_int(14, DenylistVersion(), "DENYLIST: version after bad op");
+  assert_equal_int(TRUE, DenylistIncomplete(), "DENYLIST: bad op");
+  assert_equal_int(SUCCESS, DenylistUpdate(DENYLIST_OP_CLEAR, 15, NULL),
+                   "DENYLIST: clear after bad op failed");
+}
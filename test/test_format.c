@@ -0,0 +1,109 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          TEST_FORMAT.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for format.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../general.h"
+#include "../format.h"
+#include "test_general.h"
+
+
+static void check_string(const char *expected, const char *actual,
+                         size_t len, const char *msg)
+{
+  assert_equal_int(strlen(expected), len, msg);
+  assert_equal_memory((uint8_t *) expected, strlen(expected)+1,
+                      (uint8_t *) actual, strlen(expected)+1, msg);
+}
+
+
+static void test_format_numbers(void)
+{
+  char buf[FORMAT_MONEY_SIZE];
+  uint8_t uid[7] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  char hex[2*7+1];
+
+  check_string("0", buf, FormatUint(buf, 0), "FORMAT: uint 0");
+  check_string("7", buf, FormatUint(buf, 7), "FORMAT: uint 1 digit");
+  check_string("1000", buf, FormatUint(buf, 1000), "FORMAT: uint zeros");
+  check_string("4294967295", buf, FormatUint(buf, 4294967295UL),
+               "FORMAT: uint max");
+
+  check_string("007", buf, FormatUintWidth(buf, 7, 3), "FORMAT: width pad");
+  check_string("12345", buf, FormatUintWidth(buf, 12345, 3),
+               "FORMAT: width overflow");
+  check_string("0000000000", buf, FormatUintWidth(buf, 0, 20),
+               "FORMAT: width clipped");
+
+  check_string("0.00", buf, FormatMoney(buf, 0), "FORMAT: money 0");
+  check_string("0.05", buf, FormatMoney(buf, 5), "FORMAT: money kobo");
+  check_string("10.00", buf, FormatMoney(buf, 1000), "FORMAT: money naira");
+  check_string("999.99", buf, FormatMoney(buf, 99999),
+               "FORMAT: money no comma");
+  check_string("1,000.00", buf, FormatMoney(buf, 100000),
+               "FORMAT: money comma");
+  check_string("50,000.00", buf, FormatMoney(buf, 5000000),
+               "FORMAT: money comma 2");
+  check_string("42,949,672.95", buf, FormatMoney(buf, 4294967295UL),
+               "FORMAT: money max");
+
+  check_string("00:00", buf, FormatTime(buf, 0, FORMAT_TIME_MINS),
+               "FORMAT: time 0");
+  check_string("12:01", buf, FormatTime(buf, 721, FORMAT_TIME_MINS),
+               "FORMAT: time mins");
+  check_string("99:59", buf, FormatTime(buf, 5999, FORMAT_TIME_MINS),
+               "FORMAT: time max mins");
+  check_string("12:01:09", buf, FormatTime(buf, 721*60+9, FORMAT_TIME_SECS),
+               "FORMAT: time secs");
+  check_string("79:00:00", buf, FormatTime(buf, 79*3600UL, FORMAT_TIME_SECS),
+               "FORMAT: time over 60 hours");
+
+  check_string("0453167AEC2280", hex, FormatHex(hex, uid, 7),
+               "FORMAT: hex");
+  check_string("", hex, FormatHex(hex, uid, 0), "FORMAT: hex empty");
+}
+
+
+static void test_format_buf(void)
+{
+  char buf[4+14+5+4+1];                      /* "uid=" UID "&pin=" pin */
+  char small[6];
+  uint8_t uid[7] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  format_buf fb;
+
+  FormatBufInit(&fb, buf, sizeof(buf));
+  check_string("", buf, fb.len, "FORMAT BUF: empty");
+  assert_equal_int(SUCCESS, FormatBufStr(&fb, "uid="), "FORMAT BUF: str");
+  assert_equal_int(SUCCESS, FormatBufHex(&fb, uid, 7), "FORMAT BUF: hex");
+  assert_equal_int(SUCCESS, FormatBufStr(&fb, "&pin="), "FORMAT BUF: str 2");
+  assert_equal_int(SUCCESS, FormatBufUint(&fb, 1234), "FORMAT BUF: uint");
+  check_string("uid=0453167AEC2280&pin=1234", buf, fb.len,
+               "FORMAT BUF: params");
+
+  /* bounded */
+  FormatBufInit(&fb, small, sizeof(small));
+  assert_equal_int(SUCCESS, FormatBufStr(&fb, "s="), "FORMAT BUF: fits");
+  assert_equal_int(FAIL, FormatBufUint(&fb, 123456), "FORMAT BUF: overflow");
+  check_string("s=123", small, fb.len, "FORMAT BUF: truncated");
+  assert_equal_int(FAIL, FormatBufHex(&fb, uid, 1), "FORMAT BUF: full");
+  check_string("s=123", small, fb.len, "FORMAT BUF: still truncated");
+}
+
+
+void test_format(void)
+{
+  test_format_numbers();
+  test_format_buf();
+}
@@ -15,6 +15,19 @@ int main(void)
   test_mifare_desfire_key();
   test_mifare_aid();
   test_mifare_crypto();
+  test_mifare_dir();
+  test_mifare_wallet();
+  test_mifare_txlog();
+  test_mifare_pin();
+  test_tariff();
+  test_format();
+  test_rtt();
+  test_retry();
+  test_datetime();
+  test_denylist();
+  test_at();
+  test_mifare_desfire_cache();
+  test_mifare_desfire_stream();
  
   test_print_stats();
   return 0;
@@ -6,4 +6,17 @@ extern void test_mifare_desfire_des(void);
 extern void test_mifare_desfire_key(void);
 extern void test_mifare_aid(void);
 extern void test_mifare_crypto(void);
+extern void test_mifare_dir(void);
+extern void test_mifare_wallet(void);
+extern void test_mifare_txlog(void);
+extern void test_mifare_pin(void);
+extern void test_tariff(void);
+extern void test_format(void);
+extern void test_rtt(void);
+extern void test_retry(void);
+extern void test_datetime(void);
+extern void test_denylist(void);
+extern void test_at(void);
+extern void test_mifare_desfire_cache(void);
+extern void test_mifare_desfire_stream(void);
 
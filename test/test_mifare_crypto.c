@@ -122,9 +122,122 @@ void test_mifare_crypto_des_w_offset(void)
 
 
 
+/* run message through the crypto stream and MifareCryptoPreprocessData on two
+ * identically keyed tags and check both give the same bytes, ivect and cmac
+ */
+static void check_crypto_stream(mifare_desfire_key *key, uint8_t scheme,
+                                size_t len, off_t offset, int settings,
+                                const char *assert_message)
+{
+  mifare_tag tag1, tag2;
+  mifare_crypto_stream stream;
+  uint8_t PCD_RndA[16] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                          0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10};
+  uint8_t PICC_RndB[16] = {0x0F, 0x1E, 0x2D, 0x3C, 0x4B, 0x5A, 0x69, 0x78,
+                           0x87, 0x96, 0xA5, 0xB4, 0xC3, 0xD2, 0xE1, 0xF0};
+  uint8_t message[MAX_FRAME_SIZE];  /* preprocess limits this */
+  uint8_t streamed[MAX_CRYPTO_BUFFER_SIZE];
+  uint8_t *expected;
+  size_t nbytes = len, n = 0, i;
+  
+  for (i = 0; i < len; i++)
+    message[i] = (uint8_t) (7*i + 3);
+  
+  MifareTagInit(&tag1);
+  tag1.authentication_scheme = scheme;
+  MifareSessionKeyNew(&tag1.session_key, PCD_RndA, PICC_RndB, key);
+  CmacGenerateSubkeys(&tag1.session_key);
+  memset(tag1.ivect, 0x5A, MAX_CRYPTO_BLOCK_SIZE); /* mid-session ivect */
+  memset(tag1.cmac, 0, MAX_CRYPTO_BLOCK_SIZE);
+  memcpy(&tag2, &tag1, sizeof(tag1));
+  
+  MifareCryptoStreamInit(&stream, &tag2, offset, settings);
+  for (i = 0; i < len; i++)
+    n += MifareCryptoStreamPut(&stream, message[i], streamed + n);
+  n += MifareCryptoStreamFinal(&stream, streamed + n);
+  
+  expected = MifareCryptoPreprocessData(&tag1, message, &nbytes, offset,
+                                        settings);
+  
+  assert_equal_memory(expected, nbytes, streamed, n, assert_message);
+  assert_equal_memory(tag1.ivect, MAX_CRYPTO_BLOCK_SIZE,
+                      tag2.ivect, MAX_CRYPTO_BLOCK_SIZE, assert_message);
+  assert_equal_memory(tag1.cmac, MAX_CRYPTO_BLOCK_SIZE,
+                      tag2.cmac, MAX_CRYPTO_BLOCK_SIZE, assert_message);
+}
+
+
+void test_mifare_crypto_stream(void)
+{
+  mifare_desfire_key des, aes;
+  int write_settings = MAC_COMMAND | CMAC_COMMAND | ENC_COMMAND;
+  des.type = T_3DES;
+  aes.type = T_AES;
+  
+  /* legacy authentication */
+  check_crypto_stream(&des, AS_LEGACY, 8+20, 8, MDCM_PLAIN | write_settings,
+                      "CryptoStream: legacy plain failed");
+  check_crypto_stream(&des, AS_LEGACY, 8+20, 8, MDCM_MACED | write_settings,
+                      "CryptoStream: legacy MAC failed");
+  check_crypto_stream(&des, AS_LEGACY, 8+24, 8, MDCM_MACED | write_settings,
+                      "CryptoStream: legacy MAC full block failed");
+  check_crypto_stream(&des, AS_LEGACY, 8+45, 8, 
+                      MDCM_ENCIPHERED | write_settings,
+                      "CryptoStream: legacy encipher failed");
+  check_crypto_stream(&des, AS_LEGACY, 8+22, 8, 
+                      MDCM_ENCIPHERED | write_settings,
+                      "CryptoStream: legacy encipher CRC block failed");
+  
+  /* new authentication */
+  check_crypto_stream(&aes, AS_NEW, 8+20, 8, MDCM_PLAIN | write_settings,
+                      "CryptoStream: AES plain failed");
+  check_crypto_stream(&aes, AS_NEW, 8+40, 8, MDCM_MACED | write_settings,
+                      "CryptoStream: AES CMAC full block failed");
+  check_crypto_stream(&aes, AS_NEW, 8+33, 8, MDCM_MACED | write_settings,
+                      "CryptoStream: AES CMAC failed");
+  check_crypto_stream(&aes, AS_NEW, 8+47, 8, 
+                      MDCM_ENCIPHERED | write_settings,
+                      "CryptoStream: AES encipher failed");
+  check_crypto_stream(&aes, AS_NEW, 8+52, 8, 
+                      MDCM_ENCIPHERED | write_settings,
+                      "CryptoStream: AES encipher CRC block failed");
+  check_crypto_stream(&des, AS_NEW, 8+49, 8, 
+                      MDCM_ENCIPHERED | write_settings,
+                      "CryptoStream: 3DES encipher failed");
+}
+
+
+void test_mifare_crypto_crc_update(void)
+{
+  uint8_t data[30];
+  uint8_t crc[4];
+  uint32_t reg32 = MIFARE_CRC32_INIT;
+  uint16_t reg16 = MIFARE_CRC16_INIT;
+  size_t i;
+  
+  for (i = 0; i < sizeof(data); i++)
+    data[i] = (uint8_t) (i * 13);
+  
+  MifareCrc32(data, sizeof(data), crc);
+  for (i = 0; i < sizeof(data); i++)
+    reg32 = MifareCrc32Update(reg32, data + i, 1);
+  assert_equal_int((long) (crc[0] | ((uint32_t) crc[1] << 8) |
+                           ((uint32_t) crc[2] << 16) |
+                           ((uint32_t) crc[3] << 24)), (long) reg32,
+                   "CRC32 update failed");
+  
+  MifareCrc16(data, sizeof(data), crc);
+  reg16 = MifareCrc16Update(reg16, data, 10);
+  reg16 = MifareCrc16Update(reg16, data + 10, sizeof(data) - 10);
+  assert_equal_int(crc[0] | (crc[1] << 8), reg16, "CRC16 update failed");
+}
+
+
 
 void test_mifare_crypto(void)
 {
   test_mifare_crypto_des_no_offset(); /* MDCM_ENCIPHERED | ENC_COMMAND */
   test_mifare_crypto_des_w_offset();  /* MDCM_ENCIPHERED | ENC_COMMAND */
+  test_mifare_crypto_stream();        /* stream matches preprocess */
+  test_mifare_crypto_crc_update();    /* incremental CRCs */
 }
@@ -0,0 +1,157 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                    TEST_MIFARE_DESFIRE_CACHE.C                    -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for the file settings cache in mifare.c, run
+ *  against the fake card of card_dummy.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "card_dummy.h"
+#include "test_general.h"
+
+
+/* standard data file of 32 bytes, plain, free access */
+static const uint8_t settings_reply[] = {
+  0x00, MDFT_STANDARD_DATA_FILE, MDCM_PLAIN, 0xEE, 0xEE, 0x20, 0x00, 0x00
+};
+static const uint8_t data_reply[] = {0x00, 0x11, 0x22, 0x33, 0x44};
+static const uint8_t ok_reply[] = {0x00};
+static const uint8_t not_found_reply[] = {MF_FILE_NOT_FOUND};
+
+
+/* get the command code of the i-th command the card got */
+static uint8_t CommandCode(uint8_t i)
+{
+  size_t n;
+  return CardDummyCommand(i, &n)[0];
+}
+
+
+/* read a file, with the card answering from settings (if asked) and data */
+static int ReadFile(mifare_tag *tag, uint8_t file_no, uint8_t settings)
+{
+  uint8_t data[16];
+  ssize_t size;
+
+  CardDummyInit();
+  if (settings)
+    CardDummyReply(settings_reply, sizeof(settings_reply));
+  CardDummyReply(data_reply, sizeof(data_reply));
+
+  return MifareReadData(tag, file_no, 0, 4, data, sizeof(data), &size);
+}
+
+
+void test_mifare_desfire_cache(void)
+{
+  mifare_tag tag;
+  uint8_t data[16];
+  uint8_t files[MIFARE_FILE_SETTINGS_CACHE + 1];
+  ssize_t size;
+  size_t sent;
+  uint8_t i;
+
+  MifareTagInit(&tag);
+  tag.active = TRUE;
+  tag.authentication_scheme = AS_LEGACY;
+
+  /* miss: settings come from the card */
+  CardDummyInit();
+  CardDummyReply(settings_reply, sizeof(settings_reply));
+  CardDummyReply(data_reply, sizeof(data_reply));
+  assert_equal_int(SUCCESS, MifareReadData(&tag, 1, 0, 4, data, sizeof(data),
+                                           &size),
+                   "MIFARE CACHE: read on a miss failed");
+  assert_equal_memory(&data_reply[1], 4, data, size,
+                      "MIFARE CACHE: wrong data on a miss");
+  assert_equal_int(2, CardDummyCommands(), "MIFARE CACHE: miss commands");
+  assert_equal_int(0xF5, CommandCode(0), "MIFARE CACHE: miss didn't fetch");
+  assert_equal_int(0xBD, CommandCode(1), "MIFARE CACHE: miss didn't read");
+
+  /* hit: no GetFileSettings, for reads or writes */
+  assert_equal_int(SUCCESS, ReadFile(&tag, 1, FALSE),
+                   "MIFARE CACHE: read on a hit failed");
+  assert_equal_int(1, CardDummyCommands(), "MIFARE CACHE: hit fetched");
+  assert_equal_int(0xBD, CommandCode(0), "MIFARE CACHE: hit didn't read");
+
+  CardDummyInit();
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(SUCCESS, MifareWriteData(&tag, 1, 0, 4, data, &sent),
+                   "MIFARE CACHE: write on a hit failed");
+  assert_equal_int(4, sent, "MIFARE CACHE: write on a hit sent");
+  assert_equal_int(1, CardDummyCommands(), "MIFARE CACHE: write fetched");
+  assert_equal_int(0x3D, CommandCode(0), "MIFARE CACHE: write didn't write");
+
+  /* changing a file's settings drops them */
+  CardDummyInit();
+  CardDummyReply(settings_reply, sizeof(settings_reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(SUCCESS, MifareChangeFileSettings(&tag, 1, MDCM_PLAIN,
+                                                     0xEEEE),
+                   "MIFARE CACHE: change settings failed");
+  ReadFile(&tag, 1, TRUE);
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE CACHE: kept settings after a change");
+  assert_equal_int(0xF5, CommandCode(0),
+                   "MIFARE CACHE: no fetch after a change");
+
+  /* selecting another application drops them all */
+  CardDummyInit();
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(SUCCESS, MifareSelectApplication(&tag, 0x000002),
+                   "MIFARE CACHE: select application failed");
+  ReadFile(&tag, 1, TRUE);
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE CACHE: kept settings of another application");
+
+  /* so does a new card */
+  MifareTagInit(&tag);
+  tag.active = TRUE;
+  tag.authentication_scheme = AS_LEGACY;
+  ReadFile(&tag, 1, TRUE);
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE CACHE: kept settings of another card");
+
+  /* the oldest file is replaced when the cache is full */
+  for (i = 0; i < sizeof(files); i++)
+    files[i] = i + 2;
+  CardDummyInit();
+  for (i = 0; i < sizeof(files); i++)
+    CardDummyReply(settings_reply, sizeof(settings_reply));
+  assert_equal_int(SUCCESS, MifarePrefetchFileSettings(&tag, files,
+                                                       sizeof(files)),
+                   "MIFARE CACHE: prefetch failed");
+  ReadFile(&tag, files[sizeof(files) - 1], FALSE);
+  assert_equal_int(1, CardDummyCommands(),
+                   "MIFARE CACHE: prefetched file fetched");
+  ReadFile(&tag, 1, TRUE);
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE CACHE: replaced file not fetched");
+
+  /* a failed fetch isn't cached, and the read isn't attempted */
+  CardDummyInit();
+  CardDummyReply(not_found_reply, sizeof(not_found_reply));
+  assert_equal_int(FAIL, MifareReadData(&tag, 0x1F, 0, 4, data, sizeof(data),
+                                        &size),
+                   "MIFARE CACHE: read of a missing file passed");
+  assert_equal_int(1, CardDummyCommands(),
+                   "MIFARE CACHE: read a missing file");
+  assert_equal_int(MF_FILE_NOT_FOUND, tag.last_picc_error,
+                   "MIFARE CACHE: missing file error");
+  CardDummyInit();
+  CardDummyReply(not_found_reply, sizeof(not_found_reply));
+  MifareReadData(&tag, 0x1F, 0, 4, data, sizeof(data), &size);
+  assert_equal_int(0xF5, CommandCode(0),
+                   "MIFARE CACHE: cached a failed fetch");
+}
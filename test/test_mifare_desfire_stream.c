@@ -0,0 +1,141 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                   TEST_MIFARE_DESFIRE_STREAM.C                    -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for reads and writes in mifare.c that span
+ *  several frames, run against the fake card of card_dummy.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "card_dummy.h"
+#include "test_general.h"
+
+#define STREAM_LENGTH  100  /* > MF_MAX_WRITE_LENGTH, so streamed */
+
+
+/* start a tag with no authentication, so plain transfers need no crypto */
+static void TagStart(mifare_tag *tag)
+{
+  MifareTagInit(tag);
+  tag->active = TRUE;
+  tag->authentication_scheme = AS_LEGACY;
+}
+
+
+void test_mifare_desfire_stream(void)
+{
+  const uint8_t more_reply[] = {MF_ADDITIONAL_FRAME};
+  const uint8_t ok_reply[] = {MF_OPERATION_OK};
+  const uint8_t denied_reply[] = {MF_PERMISSION_ERROR};
+  const uint8_t boundary_reply[] = {MF_BOUNDARY_ERROR};
+  const uint8_t header[8] = {0x3D, 0x01, 0x00, 0x00, 0x00,
+                             STREAM_LENGTH, 0x00, 0x00};
+  uint8_t data[STREAM_LENGTH];
+  uint8_t sent[8 + STREAM_LENGTH];
+  uint8_t reply[CARD_DUMMY_FRAME_SIZE];
+  uint8_t read[STREAM_LENGTH + 1];
+  mifare_tag tag;
+  const uint8_t *cmd;
+  size_t n, total, data_sent;
+  ssize_t size;
+  uint8_t i;
+
+  for (i = 0; i < STREAM_LENGTH; i++)
+    data[i] = i;
+  TagStart(&tag);
+
+  /* streamed write: a command frame, then 0xAF continuation frames */
+  CardDummyInit();
+  CardDummyReply(more_reply, sizeof(more_reply));
+  CardDummyReply(more_reply, sizeof(more_reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(SUCCESS, MifareWriteDataEx(&tag, 1, 0, STREAM_LENGTH, data,
+                                              &data_sent, MDCM_PLAIN),
+                   "MIFARE STREAM: write failed");
+  assert_equal_int(STREAM_LENGTH, data_sent, "MIFARE STREAM: write sent");
+  assert_equal_int(3, CardDummyCommands(), "MIFARE STREAM: write frames");
+
+  cmd = CardDummyCommand(0, &n);
+  memcpy(sent, cmd, n);
+  total = n;
+  for (i = 1; i < CardDummyCommands(); i++) {
+    cmd = CardDummyCommand(i, &n);
+    assert_equal_int(MF_ADDITIONAL_FRAME, cmd[0],
+                     "MIFARE STREAM: continuation isn't 0xAF");
+    if (total + n - 1 <= sizeof(sent))
+      memcpy(sent + total, cmd + 1, n - 1);
+    total += n - 1;
+  }
+  assert_equal_memory(header, sizeof(header), sent, MIN(total, sizeof(header)),
+                      "MIFARE STREAM: wrong write header");
+  assert_equal_memory(data, STREAM_LENGTH, sent + 8, total - 8,
+                      "MIFARE STREAM: wrong write data");
+
+  /* PICC stops the write mid-stream: nothing more is sent */
+  CardDummyInit();
+  CardDummyReply(more_reply, sizeof(more_reply));
+  CardDummyReply(denied_reply, sizeof(denied_reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  MifareWriteDataEx(&tag, 1, 0, STREAM_LENGTH, data, &data_sent, MDCM_PLAIN);
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE STREAM: kept writing after an error");
+  assert_equal_int((size_t) -1, data_sent,
+                   "MIFARE STREAM: stopped write sent data");
+  assert_equal_int(MF_PERMISSION_ERROR, tag.last_picc_error,
+                   "MIFARE STREAM: stopped write error");
+
+  /* multi-frame read: additional frames are asked for with a lone 0xAF */
+  TagStart(&tag);
+  CardDummyInit();
+  reply[0] = MF_ADDITIONAL_FRAME;
+  memcpy(&reply[1], data, CARD_DUMMY_FRAME_SIZE - 1);
+  CardDummyReply(reply, CARD_DUMMY_FRAME_SIZE);
+  reply[0] = MF_OPERATION_OK;
+  memcpy(&reply[1], data + CARD_DUMMY_FRAME_SIZE - 1,
+         STREAM_LENGTH - (CARD_DUMMY_FRAME_SIZE - 1));
+  CardDummyReply(reply, STREAM_LENGTH - (CARD_DUMMY_FRAME_SIZE - 1) + 1);
+  assert_equal_int(SUCCESS, MifareReadDataEx(&tag, 1, 0, STREAM_LENGTH, read,
+                                             sizeof(read), &size, MDCM_PLAIN),
+                   "MIFARE STREAM: read failed");
+  assert_equal_memory(data, STREAM_LENGTH, read, size,
+                      "MIFARE STREAM: wrong read data");
+  assert_equal_int(2, CardDummyCommands(), "MIFARE STREAM: read frames");
+  cmd = CardDummyCommand(1, &n);
+  assert_equal_memory(more_reply, 1, cmd, n,
+                      "MIFARE STREAM: wrong additional frame request");
+
+  /* buffer fills mid-stream: stop, rather than skip a frame */
+  CardDummyInit();
+  reply[0] = MF_ADDITIONAL_FRAME;
+  memcpy(&reply[1], data, CARD_DUMMY_FRAME_SIZE - 1);
+  CardDummyReply(reply, CARD_DUMMY_FRAME_SIZE);
+  CardDummyReply(reply, CARD_DUMMY_FRAME_SIZE);
+  reply[0] = MF_OPERATION_OK;
+  CardDummyReply(reply, 2);
+  assert_equal_int(FAIL, MifareReadDataEx(&tag, 1, 0, 0, read, sizeof(read),
+                                          &size, MDCM_PLAIN),
+                   "MIFARE STREAM: read past the buffer passed");
+  assert_equal_int(2, CardDummyCommands(),
+                   "MIFARE STREAM: kept reading past the buffer");
+  assert_equal_int(BUFFER_ERROR, tag.last_pcd_error,
+                   "MIFARE STREAM: read past the buffer error");
+
+  /* PICC error */
+  CardDummyInit();
+  CardDummyReply(boundary_reply, sizeof(boundary_reply));
+  assert_equal_int(FAIL, MifareReadDataEx(&tag, 1, 0x20, 4, read, sizeof(read),
+                                          &size, MDCM_PLAIN),
+                   "MIFARE STREAM: read past the file passed");
+  assert_equal_int(MF_BOUNDARY_ERROR, tag.last_picc_error,
+                   "MIFARE STREAM: read past the file error");
+}
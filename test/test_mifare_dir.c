@@ -0,0 +1,107 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         TEST_MIFARE_DIR.C                         -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for mifare_dir.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Repeat hits don't write EEPROM
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "../mifare/mifare_dir.h"
+#include "../eeprom.h"
+#include "test_general.h"
+
+
+static void make_card(uint8_t n, uint8_t uid[], 
+                      mifare_desfire_version_info *version_info,
+                      mifare_dir *dir)
+{
+  memset(uid, n, MIFARE_UID_BYTES);
+  memset(version_info, 0, sizeof(mifare_desfire_version_info));
+  version_info->hardware.storage_size = 0x18;
+  version_info->software.version_major = 1;
+  
+  memset(dir, 0, sizeof(mifare_dir));
+  dir->count = 1;
+  dir->apps[0].aid = 0x00AA0000 + n;
+  dir->apps[0].files = 0x0007;
+}
+
+
+void test_mifare_dir(void)
+{
+  uint8_t uid[MIFARE_UID_BYTES];
+  mifare_desfire_version_info version_info;
+  mifare_dir dir, cached;
+  uint8_t before[EEPROM_MIFARE_DIR_SIZE], after[EEPROM_MIFARE_DIR_SIZE];
+  uint8_t n;
+  
+  /* cache miss on an empty cache */
+  make_card(1, uid, &version_info, &dir);
+  assert_equal_int(FAIL, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: lookup on empty cache");
+  
+  /* store then hit */
+  MifareDirStore(uid, &version_info, &dir);
+  assert_equal_int(SUCCESS, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: lookup after store");
+  assert_equal_memory(&dir, sizeof(dir), &cached, sizeof(cached),
+                      "MIFARE DIR: wrong directory cached");
+  assert_equal_bool(TRUE, MifareDirFindApp(&cached, 0x00AA0001) != NULL,
+                    "MIFARE DIR: app not found");
+  assert_equal_bool(TRUE, MifareDirFindApp(&cached, 0x00AA0002) == NULL,
+                    "MIFARE DIR: unexpected app found");
+  
+  /* same UID, different card type is a miss and drops the record */
+  version_info.software.version_major = 0;
+  assert_equal_int(FAIL, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: version mismatch not detected");
+  version_info.software.version_major = 1;
+  assert_equal_int(FAIL, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: mismatched record not dropped");
+  
+  /* fill the cache, touch card 1, then add one more: card 2 is the LRU */
+  for(n=1; n<=MIFARE_DIR_RECORDS; n++) {
+    make_card(n, uid, &version_info, &dir);
+    MifareDirStore(uid, &version_info, &dir);
+  }
+  make_card(1, uid, &version_info, &dir);
+  assert_equal_int(SUCCESS, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: lookup card 1");
+  
+  /* another hit of the most recently used card doesn't write */
+  EepromRead(EEPROM_MIFARE_DIR_ADDR, before, sizeof(before));
+  assert_equal_int(SUCCESS, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: lookup card 1 again");
+  EepromRead(EEPROM_MIFARE_DIR_ADDR, after, sizeof(after));
+  assert_equal_memory(before, sizeof(before), after, sizeof(after),
+                      "MIFARE DIR: hit of newest card written");
+  
+  make_card(MIFARE_DIR_RECORDS+1, uid, &version_info, &dir);
+  MifareDirStore(uid, &version_info, &dir);
+  
+  make_card(2, uid, &version_info, &dir);
+  assert_equal_int(FAIL, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: LRU card not evicted");
+  make_card(1, uid, &version_info, &dir);
+  assert_equal_int(SUCCESS, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: recently used card evicted");
+  make_card(MIFARE_DIR_RECORDS+1, uid, &version_info, &dir);
+  assert_equal_int(SUCCESS, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: newest card not cached");
+  
+  /* forget */
+  MifareDirForget(uid);
+  assert_equal_int(FAIL, MifareDirLookup(uid, &version_info, &cached),
+                   "MIFARE DIR: forgotten card still cached");
+}
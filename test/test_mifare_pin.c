@@ -0,0 +1,165 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                         TEST_MIFARE_PIN.C                         -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for mifare_pin.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Verify on a fake card
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "../mifare/mifare_key.h"
+#include "../mifare/mifare_pin.h"
+#include "card_dummy.h"
+#include "test_general.h"
+
+
+void test_mifare_pin(void)
+{
+  uint8_t master_value[16] = {
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+    0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+  };
+  uint8_t uid[MIFARE_UID_BYTES] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  uint8_t other_uid[MIFARE_UID_BYTES] = {0x04, 0x3B, 0x11, 0x7A, 0xEC, 0x22,
+                                         0x80};
+  uint8_t expected_fields[MIFARE_PIN_VERIFIER_OFS] = {
+    0x01, 0x02, 0x03, 0x00,                          /* version,tries,max */
+    0xDE, 0xAD, 0xBE, 0xEF                           /* salt */
+  };
+  /* standard data file of MIFARE_PIN_SIZE bytes, plain, free access */
+  const uint8_t settings_reply[] = {
+    0x00, MDFT_STANDARD_DATA_FILE, MDCM_PLAIN, 0xEE, 0xEE,
+    MIFARE_PIN_SIZE, 0x00, 0x00
+  };
+  const uint8_t ok_reply[] = {0x00};
+  uint8_t blob[MIFARE_PIN_SIZE];
+  uint8_t other_blob[MIFARE_PIN_SIZE];
+  uint8_t reply[1 + MIFARE_PIN_SIZE];
+  mifare_desfire_key master, key, other_key;
+  mifare_pin pin_info, decoded;
+  mifare_tag tag;
+  const uint8_t *cmd;
+  size_t n;
+
+  MifareAesKeyNew(&master, master_value);
+
+  /* keys are diversified per card */
+  MifarePinDiversifyKey(&master, uid, &key);
+  MifarePinDiversifyKey(&master, other_uid, &other_key);
+  assert_equal_int(T_AES, key.type, "MIFARE PIN: diversified key not AES");
+  assert_equal_int(TRUE, memcmp(key.data, other_key.data, 16) != 0,
+                   "MIFARE PIN: same key for different cards");
+  assert_equal_int(TRUE, memcmp(key.data, master.data, 16) != 0,
+                   "MIFARE PIN: master key not diversified");
+
+  pin_info.tries = 2;
+  pin_info.max_tries = MIFARE_PIN_MAX_TRIES;
+  pin_info.salt[0] = 0xDE; pin_info.salt[1] = 0xAD;
+  pin_info.salt[2] = 0xBE; pin_info.salt[3] = 0xEF;
+
+  /* fixed layout */
+  MifarePinEncode(&pin_info, 1234, uid, &master, blob);
+  assert_equal_memory(expected_fields, sizeof(expected_fields),
+                      blob, MIFARE_PIN_VERIFIER_OFS,
+                      "MIFARE PIN: wrong layout");
+
+  /* round trip of counters and salt */
+  memset(&decoded, 0, sizeof(decoded));
+  assert_equal_int(SUCCESS, MifarePinDecode(blob, &decoded),
+                   "MIFARE PIN: decode failed");
+  assert_equal_int(pin_info.tries, decoded.tries, "MIFARE PIN: tries");
+  assert_equal_int(pin_info.max_tries, decoded.max_tries,
+                   "MIFARE PIN: max tries");
+  assert_equal_memory(pin_info.salt, MIFARE_PIN_SALT_LENGTH,
+                      decoded.salt, MIFARE_PIN_SALT_LENGTH,
+                      "MIFARE PIN: salt");
+
+  /* PIN checks */
+  assert_equal_int(TRUE, MifarePinMatch(blob, uid, &master, 1234),
+                   "MIFARE PIN: rejected correct PIN");
+  assert_equal_int(FALSE, MifarePinMatch(blob, uid, &master, 1235),
+                   "MIFARE PIN: accepted wrong PIN");
+  assert_equal_int(FALSE, MifarePinMatch(blob, other_uid, &master, 1234),
+                   "MIFARE PIN: accepted record of another card");
+
+  /* salt changes the verifier of the same PIN */
+  pin_info.salt[3] ^= 0x01;
+  MifarePinEncode(&pin_info, 1234, uid, &master, other_blob);
+  assert_equal_int(TRUE, memcmp(blob + MIFARE_PIN_VERIFIER_OFS,
+                                other_blob + MIFARE_PIN_VERIFIER_OFS,
+                                MIFARE_PIN_VERIFIER_LENGTH) != 0,
+                   "MIFARE PIN: salt ignored");
+
+  /* tampered verifier */
+  blob[MIFARE_PIN_VERIFIER_OFS] ^= 0x80;
+  assert_equal_int(FALSE, MifarePinMatch(blob, uid, &master, 1234),
+                   "MIFARE PIN: accepted tampered verifier");
+  blob[MIFARE_PIN_VERIFIER_OFS] ^= 0x80;
+
+  /* unknown version */
+  blob[MIFARE_PIN_VERSION_OFS] = MIFARE_PIN_VERSION + 1;
+  assert_equal_int(FAIL, MifarePinDecode(blob, &decoded),
+                   "MIFARE PIN: decoded unknown version");
+  assert_equal_int(FALSE, MifarePinMatch(blob, uid, &master, 1234),
+                   "MIFARE PIN: matched unknown version");
+  blob[MIFARE_PIN_VERSION_OFS] = MIFARE_PIN_VERSION;
+
+  MifareTagInit(&tag);
+  tag.active = TRUE;
+  tag.authentication_scheme = AS_LEGACY;
+  memcpy(tag.uid, uid, MIFARE_UID_BYTES);
+
+  /* wrong PIN: a try is used up before the check */
+  CardDummyInit();
+  CardDummyReply(settings_reply, sizeof(settings_reply));
+  reply[0] = 0x00;
+  memcpy(reply + 1, blob, MIFARE_PIN_SIZE);
+  CardDummyReply(reply, sizeof(reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(MIFARE_PIN_WRONG, MifarePinVerify(&tag, &master, 1235),
+                   "MIFARE PIN: verified wrong PIN");
+  assert_equal_int(3, CardDummyCommands(), "MIFARE PIN: wrong PIN commands");
+  cmd = CardDummyCommand(2, &n);
+  assert_equal_int(9, n, "MIFARE PIN: wrong PIN write length");
+  assert_equal_int(0x3D, cmd[0], "MIFARE PIN: wrong PIN not a WriteData");
+  assert_equal_int(MIFARE_PIN_TRIES_OFS, cmd[2],
+                   "MIFARE PIN: wrong PIN write offset");
+  assert_equal_int(1, cmd[8], "MIFARE PIN: wrong PIN tries");
+
+  /* right PIN: the try used up, and any before, are given back */
+  CardDummyInit();
+  CardDummyReply(reply, sizeof(reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(MIFARE_PIN_OK, MifarePinVerify(&tag, &master, 1234),
+                   "MIFARE PIN: rejected right PIN");
+  assert_equal_int(3, CardDummyCommands(), "MIFARE PIN: right PIN commands");
+  cmd = CardDummyCommand(2, &n);
+  assert_equal_int(MIFARE_PIN_MAX_TRIES, cmd[8],
+                   "MIFARE PIN: right PIN tries not restored");
+
+  /* blocked card: PIN isn't checked, nothing is written */
+  CardDummyInit();
+  reply[1 + MIFARE_PIN_TRIES_OFS] = 0;
+  CardDummyReply(reply, sizeof(reply));
+  assert_equal_int(MIFARE_PIN_BLOCKED, MifarePinVerify(&tag, &master, 1234),
+                   "MIFARE PIN: blocked card not reported");
+  assert_equal_int(1, CardDummyCommands(), "MIFARE PIN: blocked commands");
+
+  /* card error: leave it to the server */
+  CardDummyInit();
+  reply[0] = MF_PERMISSION_ERROR;
+  CardDummyReply(reply, 1);
+  assert_equal_int(FAIL, MifarePinVerify(&tag, &master, 1234),
+                   "MIFARE PIN: card error not reported");
+}
@@ -0,0 +1,141 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                        TEST_MIFARE_TXLOG.C                        -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for mifare_txlog.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Read back the log from a fake card
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "../mifare/mifare_key.h"
+#include "../mifare/mifare_txlog.h"
+#include "card_dummy.h"
+#include "test_general.h"
+
+
+void test_mifare_txlog(void)
+{
+  uint8_t key_value[16] = {
+    0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87,
+    0x78, 0x69, 0x5A, 0x4B, 0x3C, 0x2D, 0x1E, 0x0F
+  };
+  uint8_t uid[MIFARE_UID_BYTES] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  uint8_t other_uid[MIFARE_UID_BYTES] = {0x04, 0x3B, 0x11, 0x7A, 0xEC, 0x22,
+                                         0x80};
+  uint8_t expected_fields[MIFARE_TXLOG_MAC_OFS] = {
+    0xF4, 0x01, 0x00, 0x00,                          /* amount */
+    0x01, 0x00, 0xEA, 0x00,                          /* terminal */
+    0x00, 0x5F, 0x5E, 0x52,                          /* time */
+    0x07, 0x00                                       /* seq */
+  };
+  /* cyclic record file of MIFARE_TXLOG_RECORDS+1 records, plain, free */
+  const uint8_t settings_reply[] = {
+    0x00, MDFT_CYCLIC_RECORD_FILE_WITH_BACKUP, MDCM_PLAIN, 0xEE, 0xEE,
+    MIFARE_TXLOG_RECORD_SIZE, 0x00, 0x00, MIFARE_TXLOG_RECORDS + 1, 0x00, 0x00,
+    0x03, 0x00, 0x00
+  };
+  const uint8_t read_all[8] = {0xBB, MIFARE_TXLOG_FILE_NO, 0, 0, 0, 0, 0, 0};
+  const uint8_t empty_reply[] = {MF_BOUNDARY_ERROR};
+  uint8_t record[MIFARE_TXLOG_RECORD_SIZE];
+  uint8_t reply[1 + 3*MIFARE_TXLOG_RECORD_SIZE];
+  mifare_desfire_key key;
+  mifare_txlog_entry entry, decoded;
+  mifare_txlog_entry entries[2];
+  mifare_tag tag;
+  const uint8_t *cmd;
+  size_t n;
+  uint8_t count, i;
+  
+  MifareAesKeyNew(&key, key_value);
+  
+  entry.amount = 500;
+  entry.terminal = 0x00EA0001;
+  entry.time = 0x525E5F00;
+  entry.seq = 7;
+  
+  /* fixed layout */
+  MifareTxlogEncode(&entry, uid, &key, record);
+  assert_equal_memory(expected_fields, sizeof(expected_fields),
+                      record, MIFARE_TXLOG_MAC_OFS,
+                      "MIFARE TXLOG: wrong layout");
+  
+  /* round trip */
+  memset(&decoded, 0, sizeof(decoded));
+  assert_equal_int(SUCCESS, MifareTxlogDecode(record, uid, &key, &decoded),
+                   "MIFARE TXLOG: decode failed");
+  assert_equal_int(entry.amount, decoded.amount, "MIFARE TXLOG: amount");
+  assert_equal_int(entry.terminal, decoded.terminal, "MIFARE TXLOG: terminal");
+  assert_equal_int(entry.time, decoded.time, "MIFARE TXLOG: time");
+  assert_equal_int(entry.seq, decoded.seq, "MIFARE TXLOG: seq");
+  
+  /* record copied to another card */
+  assert_equal_int(FAIL, MifareTxlogDecode(record, other_uid, &key, &decoded),
+                   "MIFARE TXLOG: accepted record of another card");
+  
+  /* tampered amount */
+  record[MIFARE_TXLOG_AMOUNT_OFS] ^= 0x80;
+  assert_equal_int(FAIL, MifareTxlogDecode(record, uid, &key, &decoded),
+                   "MIFARE TXLOG: accepted tampered record");
+  
+  /* read back the last entries: one ReadRecords, newest first */
+  MifareTagInit(&tag);
+  tag.active = TRUE;
+  tag.authentication_scheme = AS_LEGACY;
+  memcpy(tag.uid, uid, MIFARE_UID_BYTES);
+  reply[0] = MF_OPERATION_OK;
+  for (i = 0; i < 3; i++) {                        /* oldest first */
+    entry.seq = 10 + i;
+    MifareTxlogEncode(&entry, uid, &key,
+                      &reply[1 + i*MIFARE_TXLOG_RECORD_SIZE]);
+  }
+  CardDummyInit();
+  CardDummyReply(settings_reply, sizeof(settings_reply));
+  CardDummyReply(reply, sizeof(reply));
+  assert_equal_int(SUCCESS, MifareTxlogReadLast(&tag, &key, entries, 2, &count),
+                   "MIFARE TXLOG: read last failed");
+  assert_equal_int(2, count, "MIFARE TXLOG: read last count");
+  assert_equal_int(12, entries[0].seq, "MIFARE TXLOG: latest entry");
+  assert_equal_int(11, entries[1].seq, "MIFARE TXLOG: entry before latest");
+  assert_equal_int(2, CardDummyCommands(), "MIFARE TXLOG: read last commands");
+  cmd = CardDummyCommand(1, &n);
+  assert_equal_memory(read_all, sizeof(read_all), cmd, n,
+                      "MIFARE TXLOG: read last didn't read all records");
+  
+  /* the file's settings are cached; its record count isn't needed */
+  CardDummyInit();
+  CardDummyReply(reply, sizeof(reply));
+  MifareTxlogReadLast(&tag, &key, entries, 2, &count);
+  assert_equal_int(1, CardDummyCommands(),
+                   "MIFARE TXLOG: read last fetched settings again");
+  
+  /* asking for more than were logged */
+  CardDummyInit();
+  CardDummyReply(reply, 1 + MIFARE_TXLOG_RECORD_SIZE);
+  MifareTxlogReadLast(&tag, &key, entries, 2, &count);
+  assert_equal_int(1, count, "MIFARE TXLOG: read last of a short log");
+  assert_equal_int(10, entries[0].seq, "MIFARE TXLOG: only entry");
+  
+  /* nothing logged yet */
+  CardDummyInit();
+  CardDummyReply(empty_reply, sizeof(empty_reply));
+  assert_equal_int(SUCCESS, MifareTxlogReadLast(&tag, &key, entries, 2, &count),
+                   "MIFARE TXLOG: read last of an empty log failed");
+  assert_equal_int(0, count, "MIFARE TXLOG: read last of an empty log");
+  
+  /* tampered record */
+  reply[1 + MIFARE_TXLOG_AMOUNT_OFS] ^= 0x80;
+  CardDummyInit();
+  CardDummyReply(reply, sizeof(reply));
+  assert_equal_int(FAIL, MifareTxlogReadLast(&tag, &key, entries, 3, &count),
+                   "MIFARE TXLOG: read last accepted tampered record");
+}
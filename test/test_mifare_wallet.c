@@ -0,0 +1,158 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                       TEST_MIFARE_WALLET.C                        -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for mifare_wallet.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Load and save on a fake card
+ */
+
+#include <string.h>
+#include "../mifare/mifare.h"
+#include "../mifare/mifare_key.h"
+#include "../mifare/mifare_wallet.h"
+#include "card_dummy.h"
+#include "test_general.h"
+
+
+void test_mifare_wallet(void)
+{
+  uint8_t key_value[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+  };
+  uint8_t uid[MIFARE_UID_BYTES] = {0x04, 0x53, 0x16, 0x7A, 0xEC, 0x22, 0x80};
+  uint8_t other_uid[MIFARE_UID_BYTES] = {0x04, 0x3B, 0x11, 0x7A, 0xEC, 0x22,
+                                         0x80};
+  uint8_t expected_fields[MIFARE_WALLET_CMAC_OFS] = {
+    0x01, 0x01, 0x34, 0x12,                          /* version,flags,seq */
+    0x78, 0x56, 0x34, 0x12,                          /* account */
+    0x10, 0x27, 0x00, 0x00,                          /* balance */
+    0x2A, 0x00, 0x00, 0x00,                          /* space */
+    0x08, 0x07, 0x00, 0x00,                          /* time */
+    0x00, 0x00, 0x00, 0x00                           /* reserved */
+  };
+  /* standard data file of MIFARE_WALLET_SIZE bytes, plain, free access */
+  const uint8_t settings_reply[] = {
+    0x00, MDFT_STANDARD_DATA_FILE, MDCM_PLAIN, 0xEE, 0xEE,
+    MIFARE_WALLET_SIZE, 0x00, 0x00
+  };
+  const uint8_t read_wallet[8] = {0xBD, MIFARE_WALLET_FILE_NO, 0, 0, 0,
+                                  MIFARE_WALLET_SIZE, 0, 0};
+  const uint8_t ok_reply[] = {0x00};
+  uint8_t blob[MIFARE_WALLET_SIZE];
+  uint8_t reply[1 + MIFARE_WALLET_SIZE];
+  mifare_desfire_key key;
+  mifare_wallet wallet, decoded;
+  mifare_tag tag;
+  const uint8_t *cmd;
+  size_t n;
+  
+  MifareAesKeyNew(&key, key_value);
+  
+  wallet.flags = MIFARE_WALLET_PARKED;
+  wallet.seq = 0x1234;
+  wallet.account = 0x12345678;
+  wallet.balance = 10000;
+  wallet.park_space = 42;
+  wallet.park_time = 1800;
+  
+  /* fixed layout */
+  MifareWalletEncode(&wallet, uid, &key, blob);
+  assert_equal_memory(expected_fields, sizeof(expected_fields), 
+                      blob, MIFARE_WALLET_CMAC_OFS,
+                      "MIFARE WALLET: wrong layout");
+  
+  /* round trip */
+  memset(&decoded, 0, sizeof(decoded));
+  assert_equal_int(SUCCESS, MifareWalletDecode(blob, uid, &key, &decoded),
+                   "MIFARE WALLET: decode failed");
+  assert_equal_int(wallet.flags, decoded.flags, "MIFARE WALLET: flags");
+  assert_equal_int(wallet.seq, decoded.seq, "MIFARE WALLET: seq");
+  assert_equal_int(wallet.account, decoded.account, "MIFARE WALLET: account");
+  assert_equal_int(wallet.balance, decoded.balance, "MIFARE WALLET: balance");
+  assert_equal_int(wallet.park_space, decoded.park_space,
+                   "MIFARE WALLET: space");
+  assert_equal_int(wallet.park_time, decoded.park_time, "MIFARE WALLET: time");
+  
+  /* record copied to another card */
+  assert_equal_int(FAIL, MifareWalletDecode(blob, other_uid, &key, &decoded),
+                   "MIFARE WALLET: accepted record of another card");
+  
+  /* tampered balance */
+  blob[MIFARE_WALLET_BALANCE_OFS+1] ^= 0x01;
+  assert_equal_int(FAIL, MifareWalletDecode(blob, uid, &key, &decoded),
+                   "MIFARE WALLET: accepted tampered record");
+  blob[MIFARE_WALLET_BALANCE_OFS+1] ^= 0x01;
+  
+  /* unknown version */
+  blob[MIFARE_WALLET_VERSION_OFS] = MIFARE_WALLET_VERSION + 1;
+  assert_equal_int(FAIL, MifareWalletDecode(blob, uid, &key, &decoded),
+                   "MIFARE WALLET: accepted unknown version");
+  blob[MIFARE_WALLET_VERSION_OFS] = MIFARE_WALLET_VERSION;
+  
+  /* load from a card: one whole file read */
+  MifareTagInit(&tag);
+  tag.active = TRUE;
+  tag.authentication_scheme = AS_LEGACY;
+  memcpy(tag.uid, uid, MIFARE_UID_BYTES);
+  CardDummyInit();
+  CardDummyReply(settings_reply, sizeof(settings_reply));
+  reply[0] = 0x00;
+  memcpy(reply + 1, blob, MIFARE_WALLET_SIZE);
+  CardDummyReply(reply, sizeof(reply));
+  memset(&decoded, 0, sizeof(decoded));
+  assert_equal_int(SUCCESS, MifareWalletLoad(&tag, &key, &decoded),
+                   "MIFARE WALLET: load failed");
+  assert_equal_int(wallet.seq, decoded.seq, "MIFARE WALLET: loaded seq");
+  assert_equal_int(wallet.balance, decoded.balance,
+                   "MIFARE WALLET: loaded balance");
+  assert_equal_int(wallet.park_time, decoded.park_time,
+                   "MIFARE WALLET: loaded time");
+  assert_equal_int(2, CardDummyCommands(), "MIFARE WALLET: load commands");
+  cmd = CardDummyCommand(1, &n);
+  assert_equal_memory(read_wallet, sizeof(read_wallet), cmd, n,
+                      "MIFARE WALLET: load read command");
+  
+  /* load a tampered record: settings are cached now */
+  CardDummyInit();
+  reply[1 + MIFARE_WALLET_BALANCE_OFS] ^= 0x01;
+  CardDummyReply(reply, sizeof(reply));
+  assert_equal_int(FAIL, MifareWalletLoad(&tag, &key, &decoded),
+                   "MIFARE WALLET: loaded tampered record");
+  
+  /* load a short file */
+  CardDummyInit();
+  CardDummyReply(reply, sizeof(reply) - 1);
+  assert_equal_int(FAIL, MifareWalletLoad(&tag, &key, &decoded),
+                   "MIFARE WALLET: loaded short record");
+  
+  /* save: seq bumped, whole record in one write */
+  CardDummyInit();
+  CardDummyReply(ok_reply, sizeof(ok_reply));
+  assert_equal_int(SUCCESS, MifareWalletSave(&tag, &key, &wallet),
+                   "MIFARE WALLET: save failed");
+  assert_equal_int(0x1235, wallet.seq, "MIFARE WALLET: save seq");
+  MifareWalletEncode(&wallet, uid, &key, blob);
+  assert_equal_int(1, CardDummyCommands(), "MIFARE WALLET: save commands");
+  cmd = CardDummyCommand(0, &n);
+  assert_equal_int(8 + MIFARE_WALLET_SIZE, n, "MIFARE WALLET: save length");
+  assert_equal_int(0x3D, cmd[0], "MIFARE WALLET: save not a WriteData");
+  assert_equal_memory(blob, MIFARE_WALLET_SIZE, cmd + 8, n - 8,
+                      "MIFARE WALLET: save data");
+  
+  /* save refused by the card */
+  CardDummyInit();
+  reply[0] = MF_PERMISSION_ERROR;
+  CardDummyReply(reply, 1);
+  assert_equal_int(FAIL, MifareWalletSave(&tag, &key, &wallet),
+                   "MIFARE WALLET: save error not reported");
+}
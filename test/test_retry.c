@@ -0,0 +1,102 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                           TEST_RETRY.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for retry.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Tripping the breaker
+ */
+
+#include "../general.h"
+#include "../retry.h"
+#include "test_general.h"
+
+
+static void test_retry_delay(void)
+{
+  retry_policy p;
+  uint16_t d;
+  uint8_t i, in_range = TRUE, varied = FALSE;
+
+  /* each delay is in [d/2, d] for d = min(base * 2^attempt, cap) */
+  RetryInit(&p, 3, 100, 1000);
+  RetrySeed(&p, 0x1234);
+  for (i = 0; i < 50; i++) {
+    d = RetryDelay(&p, 0);
+    if ((d < 50) || (d > 100)) in_range = FALSE;
+    if (d != RetryDelay(&p, 0)) varied = TRUE;
+    d = RetryDelay(&p, 2);
+    if ((d < 200) || (d > 400)) in_range = FALSE;
+    d = RetryDelay(&p, 20);
+    if ((d < 500) || (d > 1000)) in_range = FALSE;
+  }
+  assert_equal_int(TRUE, in_range, "RETRY: delay out of range");
+  assert_equal_int(TRUE, varied, "RETRY: no jitter");
+
+  /* a 0 seed still gives jitter */
+  RetrySeed(&p, 0);
+  varied = FALSE;
+  for (i = 0; i < 10; i++)
+    if (RetryDelay(&p, 0) != RetryDelay(&p, 0)) varied = TRUE;
+  assert_equal_int(TRUE, varied, "RETRY: 0 seed");
+}
+
+
+static void test_retry_breaker(void)
+{
+  retry_policy p;
+  uint16_t now = 65000;            /* clock wraps while open */
+
+  RetryInit(&p, 3, 30, 600);
+  assert_equal_int(RETRY_CLOSED, RetryState(&p), "RETRY: starts closed");
+  assert_equal_int(TRUE, RetryAllow(&p, now), "RETRY: closed allows");
+
+  /* failures under the threshold keep it closed; a success resets them */
+  RetryFailure(&p, now);
+  RetryFailure(&p, now);
+  RetrySuccess(&p);
+  RetryFailure(&p, now);
+  RetryFailure(&p, now);
+  assert_equal_int(RETRY_CLOSED, RetryState(&p), "RETRY: under threshold");
+
+  /* threshold opens it for [15, 30] */
+  RetryFailure(&p, now);
+  assert_equal_int(RETRY_OPEN, RetryState(&p), "RETRY: opened");
+  assert_equal_int(FALSE, RetryAllow(&p, now + 14), "RETRY: fails fast");
+  assert_equal_int(TRUE, RetryAllow(&p, now + 30), "RETRY: probe allowed");
+  assert_equal_int(RETRY_HALF_OPEN, RetryState(&p), "RETRY: half-open");
+  assert_equal_int(FALSE, RetryAllow(&p, now + 30), "RETRY: one probe");
+
+  /* failed probe opens it again, for [30, 60] */
+  now += 30;
+  RetryFailure(&p, now);
+  assert_equal_int(RETRY_OPEN, RetryState(&p), "RETRY: reopened");
+  assert_equal_int(FALSE, RetryAllow(&p, now + 29), "RETRY: backed off");
+  assert_equal_int(TRUE, RetryAllow(&p, now + 60), "RETRY: second probe");
+
+  /* successful probe closes it */
+  RetrySuccess(&p);
+  assert_equal_int(RETRY_CLOSED, RetryState(&p), "RETRY: closed by probe");
+  assert_equal_int(TRUE, RetryAllow(&p, now), "RETRY: closed again allows");
+
+  /* tripping opens it with no failures, backed off [15, 30] */
+  RetryTrip(&p, now);
+  assert_equal_int(RETRY_OPEN, RetryState(&p), "RETRY: tripped");
+  assert_equal_int(FALSE, RetryAllow(&p, now + 14), "RETRY: trip backs off");
+  assert_equal_int(TRUE, RetryAllow(&p, now + 30), "RETRY: probe after trip");
+}
+
+
+void test_retry(void)
+{
+  test_retry_delay();
+  test_retry_breaker();
+}
@@ -0,0 +1,76 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                            TEST_RTT.C                             -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for rtt.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../rtt.h"
+#include "test_general.h"
+
+
+void test_rtt(void)
+{
+  rtt_est est;
+  uint8_t i;
+
+  /* no samples: initial timeout, within bounds */
+  RttInit(&est, 500, 50, 2000);
+  assert_equal_int(500, RttTimeout(&est), "RTT: initial timeout");
+  assert_equal_int(0, RttSmoothed(&est), "RTT: no samples");
+  RttInit(&est, 5000, 50, 2000);
+  assert_equal_int(2000, RttTimeout(&est), "RTT: initial above max");
+
+  /* first sample: srtt = m, rttvar = m/2, rto = 3m */
+  RttInit(&est, 500, 50, 2000);
+  RttSample(&est, 100);
+  assert_equal_int(100, RttSmoothed(&est), "RTT: first srtt");
+  assert_equal_int(50, RttDeviation(&est), "RTT: first rttvar");
+  assert_equal_int(300, RttTimeout(&est), "RTT: first rto");
+
+  /* second sample: srtt = 100 + (180-100)/8, rttvar = 50 + (80-50)/4 */
+  RttSample(&est, 180);
+  assert_equal_int(110, RttSmoothed(&est), "RTT: second srtt");
+  assert_equal_int(57, RttDeviation(&est), "RTT: second rttvar");
+  assert_equal_int(340, RttTimeout(&est), "RTT: second rto");
+
+  /* steady link: deviation decays, timeout falls to the min */
+  for (i = 0; i < 100; i++)
+    RttSample(&est, 20);
+  assert_equal_int(20, RttSmoothed(&est), "RTT: converged srtt");
+  assert_equal_int(0, RttDeviation(&est), "RTT: converged rttvar");
+  assert_equal_int(50, RttTimeout(&est), "RTT: min bound");
+
+  /* backoff doubles up to the max, the next sample resets it */
+  RttBackoff(&est);
+  assert_equal_int(100, RttTimeout(&est), "RTT: backoff");
+  for (i = 0; i < 10; i++)
+    RttBackoff(&est);
+  assert_equal_int(2000, RttTimeout(&est), "RTT: backoff max bound");
+  RttSample(&est, 20);
+  assert_equal_int(50, RttTimeout(&est), "RTT: sample after backoff");
+
+  /* slow link: timeout grows, up to the max */
+  for (i = 0; i < 100; i++)
+    RttSample(&est, 1500);
+  assert_equal_int(1500, RttSmoothed(&est), "RTT: slow link srtt");
+  assert_equal_int(TRUE, (RttTimeout(&est) >= 1500) &&
+                   (RttTimeout(&est) < 1510), "RTT: slow link");
+  RttSample(&est, 3000);
+  assert_equal_int(2000, RttTimeout(&est), "RTT: max bound");
+
+  /* 0ms sample counts as 1ms */
+  RttInit(&est, 500, 1, 2000);
+  RttSample(&est, 0);
+  assert_equal_int(1, RttSmoothed(&est), "RTT: 0ms sample");
+}
@@ -0,0 +1,129 @@
+/*
+ * -----------------------------------------------------------------------------
+ * -----                          TEST_TARIFF.C                            -----
+ * -----                             EASYPAY                               -----
+ * -----------------------------------------------------------------------------
+ *
+ * File Description:
+ *  This is the test program for tariff.c
+ *
+ * Compiler:
+ *  GCC
+ *
+ * Revision History:
+ *  Oct. 17, 2026      Nnoduka Eruchalu     Initial Revision
+ */
+
+#include "../general.h"
+#include "../tariff.h"
+#include "test_general.h"
+
+
+void test_tariff(void)
+{
+  tariff_rule day, night;
+
+  /* never synced: default N10.00 per started 30 minutes */
+  TariffInit();
+  assert_equal_int(0, TariffVersion(), "TARIFF: empty table version");
+  assert_equal_int(0, TariffPrice(TARIFF_ZONE, 540, 0), "TARIFF: no time");
+  assert_equal_int(1000, TariffPrice(TARIFF_ZONE, 540, 30),
+                   "TARIFF: default block");
+  assert_equal_int(2000, TariffPrice(TARIFF_ZONE, 540, 45),
+                   "TARIFF: default started block");
+
+  /* rule decoding */
+  assert_equal_int(SUCCESS, TariffDecodeRule("0120483CF401D007", &day),
+                   "TARIFF: decode failed");
+  assert_equal_int(1, day.zone, "TARIFF: zone");
+  assert_equal_int(32, day.start, "TARIFF: start");
+  assert_equal_int(72, day.end, "TARIFF: end");
+  assert_equal_int(60, day.block, "TARIFF: block");
+  assert_equal_int(500, day.price, "TARIFF: price");
+  assert_equal_int(2000, day.cap, "TARIFF: cap");
+  assert_equal_int(SUCCESS, TariffDecodeRule("ff4820f02c010000", &night),
+                   "TARIFF: decode lower case failed");
+  assert_equal_int(FAIL, TariffDecodeRule("0120483CF401D0", &day),
+                   "TARIFF: decoded short rule");
+  assert_equal_int(FAIL, TariffDecodeRule("0120483CF401D00700", &day),
+                   "TARIFF: decoded long rule");
+  assert_equal_int(FAIL, TariffDecodeRule("0120483CF401D0G7", &day),
+                   "TARIFF: decoded bad digit");
+  assert_equal_int(FAIL, TariffDecodeRule("01204800F401D007", &day),
+                   "TARIFF: decoded empty block");
+  assert_equal_int(FAIL, TariffDecodeRule("0160483CF401D007", &day),
+                   "TARIFF: decoded start past midnight");
+  TariffDecodeRule("0120483CF401D007", &day);
+
+  /* zone 1 daytime rule: N5.00 per hour, N20.00 cap, 08:00 to 18:00 */
+  assert_equal_int(SUCCESS, TariffUpdate(0, 1, 7, &day),
+                   "TARIFF: update failed");
+  assert_equal_int(7, TariffVersion(), "TARIFF: version");
+  assert_equal_int(1000, TariffPrice(1, 540, 90), "TARIFF: rule blocks");
+  assert_equal_int(2000, TariffPrice(1, 540, 480), "TARIFF: cap");
+  assert_equal_int(2500, TariffPrice(1, 1020, 120),
+                   "TARIFF: window boundary");
+  assert_equal_int(2000, TariffPrice(2, 540, 60), "TARIFF: other zone");
+  assert_equal_int(2000, TariffPrice(1, 1260, 60), "TARIFF: out of window");
+
+  /* any zone night rule: N3.00 per 4 hours, 18:00 to 08:00 */
+  assert_equal_int(SUCCESS, TariffUpdate(1, 2, 8, &night),
+                   "TARIFF: second update failed");
+  assert_equal_int(600, TariffPrice(2, 1380, 300),
+                   "TARIFF: window past midnight");
+  assert_equal_int(300, TariffPrice(1, 30, 60), "TARIFF: after midnight");
+
+  /* table survives a reboot */
+  TariffInit();
+  assert_equal_int(8, TariffVersion(), "TARIFF: version after reboot");
+  assert_equal_int(2000, TariffPrice(1, 540, 480), "TARIFF: rule after reboot");
+  assert_equal_int(600, TariffPrice(2, 1380, 300),
+                   "TARIFF: second rule after reboot");
+
+  /* bad updates change nothing */
+  assert_equal_int(FAIL, TariffUpdate(0, TARIFF_MAX_RULES+1, 9, NULL),
+                   "TARIFF: accepted too many rules");
+  assert_equal_int(FAIL, TariffUpdate(TARIFF_MAX_RULES, 2, 9, &night),
+                   "TARIFF: accepted index out of range");
+  night.block = 0;
+  assert_equal_int(FAIL, TariffUpdate(1, 2, 9, &night),
+                   "TARIFF: accepted invalid rule");
+  assert_equal_int(8, TariffVersion(), "TARIFF: version after bad updates");
+
+  /* dropping rules off the end */
+  assert_equal_int(SUCCESS, TariffUpdate(0, 1, 9, NULL),
+                   "TARIFF: truncate failed");
+  assert_equal_int(2000, TariffPrice(2, 1380, 60), "TARIFF: dropped rule");
+  TariffInit();
+  assert_equal_int(9, TariffVersion(), "TARIFF: version after truncate");
+  assert_equal_int(2000, TariffPrice(2, 1380, 60),
+                   "TARIFF: dropped rule after reboot");
+
+  /* growing the table only takes the new rule: the dropped night rule is */
+  /* still in slot 1, and mustn't come back */
+  assert_equal_int(FAIL, TariffUpdate(0, 2, 10, NULL),
+                   "TARIFF: grew table without a rule");
+  assert_equal_int(FAIL, TariffUpdate(0, 2, 10, &day),
+                   "TARIFF: grew table with a rule in an old slot");
+  TariffDecodeRule("ff4820f02c010000", &night);
+  assert_equal_int(FAIL, TariffUpdate(2, 3, 10, &night),
+                   "TARIFF: grew table past a stale slot");
+  assert_equal_int(FAIL, TariffUpdate(1, 3, 10, &night),
+                   "TARIFF: grew table by two rules");
+  assert_equal_int(9, TariffVersion(), "TARIFF: version after bad growth");
+  assert_equal_int(2000, TariffPrice(2, 1380, 60),
+                   "TARIFF: stale rule came back");
+  TariffInit();
+  assert_equal_int(2000, TariffPrice(2, 1380, 60),
+                   "TARIFF: stale rule came back after reboot");
+
+  /* the new rule in the new slot */
+  night.price = 200;
+  assert_equal_int(SUCCESS, TariffUpdate(1, 2, 10, &night),
+                   "TARIFF: grow failed");
+  assert_equal_int(400, TariffPrice(2, 1380, 300), "TARIFF: grown rule");
+  TariffInit();
+  assert_equal_int(10, TariffVersion(), "TARIFF: version after grow");
+  assert_equal_int(400, TariffPrice(2, 1380, 300),
+                   "TARIFF: grown rule after reboot");
+}